@@ -24,6 +24,11 @@ inline constexpr char kSavedModelAssetsDirectory[] = "assets";
 // SavedModel assets.extra directory.
 inline constexpr char kSavedModelAssetsExtraDirectory[] = "assets.extra";
 
+// File in the assets.extra directory with the requests replayed to warm up a
+// SavedModel when it is loaded.
+inline constexpr char kSavedModelWarmupRequestsFilename[] =
+    "saved_model_warmup_requests";
+
 // SavedModel assets key for graph collection-def.
 inline constexpr char kSavedModelAssetsKey[] = "saved_model_assets";
 
@@ -0,0 +1,564 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/lazy_restore.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/graph/tensor_id.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/file_system_helper.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/threadpool_options.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+bool IsVariable(const NodeDef& node) {
+  return node.op() == "VarHandleOp" || node.op() == "VariableV2" ||
+         node.op() == "Variable";
+}
+
+bool IsAssign(const NodeDef& node) {
+  return node.op() == "Assign" || node.op() == "AssignVariableOp";
+}
+
+// Returns the resource of the variable `node`. Variable nodes with the same
+// container and shared name refer to the same variable.
+std::string VariableResource(const NodeDef& node) {
+  std::string container, shared_name;
+  if (auto it = node.attr().find("container"); it != node.attr().end()) {
+    container = it->second.s();
+  }
+  if (auto it = node.attr().find("shared_name"); it != node.attr().end()) {
+    shared_name = it->second.s();
+  }
+  return absl::StrCat(container, "/",
+                      shared_name.empty() ? node.name() : shared_name);
+}
+
+// Returns element `index` of the string Const `node`, or nullopt if `node` is
+// not such a Const.
+std::optional<std::string> ConstString(const NodeDef& node, int index) {
+  if (node.op() != "Const") return std::nullopt;
+  auto it = node.attr().find("value");
+  if (it == node.attr().end()) return std::nullopt;
+  Tensor tensor;
+  if (!tensor.FromProto(it->second.tensor()) || tensor.dtype() != DT_STRING ||
+      index >= tensor.NumElements()) {
+    return std::nullopt;
+  }
+  return std::string(tensor.flat<tstring>()(index));
+}
+
+// Session wrapper that restores the variables of each run before running it.
+class LazyRestoreSession : public Session {
+ public:
+  LazyRestoreSession(std::unique_ptr<Session> wrapped,
+                     std::unique_ptr<LazyVariableRestorer> restorer,
+                     const RunOptions& run_options)
+      : wrapped_(std::move(wrapped)),
+        restorer_(std::move(restorer)),
+        run_options_(run_options) {}
+
+  absl::Status Create(const GraphDef& graph) override {
+    return wrapped_->Create(graph);
+  }
+  absl::Status Create(GraphDef&& graph) override {
+    return wrapped_->Create(std::move(graph));
+  }
+  absl::Status Create(const RunOptions& run_options,
+                      const GraphDef& graph) override {
+    return wrapped_->Create(run_options, graph);
+  }
+  absl::Status Create(const RunOptions& run_options,
+                      GraphDef&& graph) override {
+    return wrapped_->Create(run_options, std::move(graph));
+  }
+
+  absl::Status Extend(const GraphDef& graph) override {
+    return wrapped_->Extend(graph);
+  }
+  absl::Status Extend(GraphDef&& graph) override {
+    return wrapped_->Extend(std::move(graph));
+  }
+  absl::Status Extend(const RunOptions& run_options,
+                      const GraphDef& graph) override {
+    return wrapped_->Extend(run_options, graph);
+  }
+  absl::Status Extend(const RunOptions& run_options,
+                      GraphDef&& graph) override {
+    return wrapped_->Extend(run_options, std::move(graph));
+  }
+
+  absl::Status Run(const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs) override {
+    TF_RETURN_IF_ERROR(restorer_->Restore(run_options_, output_tensor_names,
+                                          target_node_names, wrapped_.get()));
+    return wrapped_->Run(inputs, output_tensor_names, target_node_names,
+                         outputs);
+  }
+
+  absl::Status Run(const RunOptions& run_options,
+                   const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs,
+                   RunMetadata* run_metadata) override {
+    TF_RETURN_IF_ERROR(restorer_->Restore(run_options, output_tensor_names,
+                                          target_node_names, wrapped_.get()));
+    return wrapped_->Run(run_options, inputs, output_tensor_names,
+                         target_node_names, outputs, run_metadata);
+  }
+
+  absl::Status Run(
+      const RunOptions& run_options,
+      const std::vector<std::pair<std::string, Tensor>>& inputs,
+      const std::vector<std::string>& output_tensor_names,
+      const std::vector<std::string>& target_tensor_names,
+      std::vector<Tensor>* outputs, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options) override {
+    TF_RETURN_IF_ERROR(restorer_->Restore(run_options, output_tensor_names,
+                                          target_tensor_names, wrapped_.get()));
+    return wrapped_->Run(run_options, inputs, output_tensor_names,
+                         target_tensor_names, outputs, run_metadata,
+                         threadpool_options);
+  }
+
+  absl::Status PRunSetup(const std::vector<string>& input_names,
+                         const std::vector<string>& output_names,
+                         const std::vector<string>& target_nodes,
+                         string* handle) override {
+    TF_RETURN_IF_ERROR(restorer_->Restore(run_options_, output_names,
+                                          target_nodes, wrapped_.get()));
+    return wrapped_->PRunSetup(input_names, output_names, target_nodes,
+                               handle);
+  }
+
+  absl::Status PRun(const string& handle,
+                    const std::vector<std::pair<string, Tensor>>& inputs,
+                    const std::vector<string>& output_names,
+                    std::vector<Tensor>* outputs) override {
+    return wrapped_->PRun(handle, inputs, output_names, outputs);
+  }
+
+  absl::Status ListDevices(std::vector<DeviceAttributes>* response) override {
+    return wrapped_->ListDevices(response);
+  }
+
+  absl::Status Close() override { return wrapped_->Close(); }
+  absl::Status Close(const RunOptions& run_options) override {
+    return wrapped_->Close(run_options);
+  }
+
+  absl::Status LocalDeviceManager(const DeviceMgr** device_mgr) override {
+    return wrapped_->LocalDeviceManager(device_mgr);
+  }
+
+  // The variables of a callable are restored when it is made, so running it
+  // has no overhead.
+  absl::Status MakeCallable(const CallableOptions& callable_options,
+                            CallableHandle* out_handle) override {
+    TF_RETURN_IF_ERROR(restorer_->Restore(
+        callable_options.run_options(),
+        {callable_options.fetch().begin(), callable_options.fetch().end()},
+        {callable_options.target().begin(), callable_options.target().end()},
+        wrapped_.get()));
+    return wrapped_->MakeCallable(callable_options, out_handle);
+  }
+
+  absl::Status RunCallable(CallableHandle handle,
+                           const std::vector<Tensor>& feed_tensors,
+                           std::vector<Tensor>* fetch_tensors,
+                           RunMetadata* run_metadata) override {
+    return wrapped_->RunCallable(handle, feed_tensors, fetch_tensors,
+                                 run_metadata);
+  }
+
+  absl::Status RunCallable(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options) override {
+    return wrapped_->RunCallable(handle, feed_tensors, fetch_tensors,
+                                 run_metadata, threadpool_options);
+  }
+
+  absl::Status ReleaseCallable(CallableHandle handle) override {
+    return wrapped_->ReleaseCallable(handle);
+  }
+
+  absl::Status Finalize() override { return wrapped_->Finalize(); }
+
+ private:
+  const std::unique_ptr<Session> wrapped_;
+  const std::unique_ptr<LazyVariableRestorer> restorer_;
+  const RunOptions run_options_;
+};
+
+// Identifies the variables a run reads by its fetches and targets, in any
+// order. Node names can't contain ',' or ';'.
+std::string RunKey(std::vector<std::string> output_tensor_names,
+                   std::vector<std::string> target_node_names) {
+  std::sort(output_tensor_names.begin(), output_tensor_names.end());
+  std::sort(target_node_names.begin(), target_node_names.end());
+  return absl::StrCat(absl::StrJoin(output_tensor_names, ","), ";",
+                      absl::StrJoin(target_node_names, ","));
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<LazyVariableRestorer>>
+LazyVariableRestorer::Create(const MetaGraphDef& meta_graph,
+                             const std::string& export_dir) {
+  if (!meta_graph.has_saver_def()) return nullptr;
+  const std::string variables_path = io::JoinPath(
+      export_dir, kSavedModelVariablesDirectory, kSavedModelVariablesFilename);
+  TF_ASSIGN_OR_RETURN(bool variables_index_exists,
+                      internal::FileExists(Env::Default(),
+                                           MetaFilename(variables_path)));
+  if (!variables_index_exists) return nullptr;
+
+  const GraphDef& graph_def = meta_graph.graph_def();
+  auto restorer = absl::WrapUnique(new LazyVariableRestorer);
+  auto& node_ids = restorer->node_ids_;
+  auto& node_inputs = restorer->node_inputs_;
+  for (int i = 0; i < graph_def.node_size(); ++i) {
+    node_ids[graph_def.node(i).name()] = i;
+  }
+  node_inputs.resize(graph_def.node_size());
+  for (int i = 0; i < graph_def.node_size(); ++i) {
+    for (const std::string& input : graph_def.node(i).input()) {
+      auto it = node_ids.find(ParseTensorName(input).node());
+      if (it != node_ids.end()) node_inputs[i].push_back(it->second);
+    }
+  }
+  // Returns the node producing `tensor`, looking through Identity ops, and
+  // sets `*index` to the output of that node.
+  auto resolve = [&](const std::string& tensor, int* index) -> const NodeDef* {
+    TensorId id = ParseTensorName(tensor);
+    while (true) {
+      auto it = node_ids.find(id.node());
+      if (it == node_ids.end()) return nullptr;
+      const NodeDef& node = graph_def.node(it->second);
+      if (node.op() != "Identity" || node.input_size() == 0) {
+        *index = id.index();
+        return &node;
+      }
+      id = ParseTensorName(node.input(0));
+    }
+  };
+  auto unsupported = [&](absl::string_view reason) {
+    LOG(INFO) << "Variables of the SavedModel at " << export_dir
+              << " can't be restored lazily: " << reason;
+    return nullptr;
+  };
+
+  auto restore_op = node_ids.find(
+      ParseTensorName(meta_graph.saver_def().restore_op_name()).node());
+  if (restore_op == node_ids.end()) {
+    return unsupported("the restore op is missing");
+  }
+  const std::vector<bool> in_restore_graph =
+      restorer->Reachable({restore_op->second});
+  absl::flat_hash_map<std::string, std::vector<int>> saved_tensors_by_resource;
+  for (int i = 0; i < graph_def.node_size(); ++i) {
+    const NodeDef& assign = graph_def.node(i);
+    if (!in_restore_graph[i] || !IsAssign(assign)) continue;
+    if (assign.input_size() < 2) return unsupported(assign.name());
+    int unused;
+    const NodeDef* variable = resolve(assign.input(0), &unused);
+    if (variable == nullptr || !IsVariable(*variable)) {
+      return unsupported(absl::StrCat(assign.name(), " assigns no variable"));
+    }
+    int entry;
+    const NodeDef* restore = resolve(assign.input(1), &entry);
+    if (restore == nullptr || restore->op() != "RestoreV2" ||
+        restore->input_size() < 3) {
+      return unsupported(
+          absl::StrCat(assign.name(), " does not assign a RestoreV2 output"));
+    }
+    const NodeDef* tensor_names = resolve(restore->input(1), &unused);
+    const NodeDef* shape_and_slices = resolve(restore->input(2), &unused);
+    std::optional<std::string> key =
+        tensor_names ? ConstString(*tensor_names, entry) : std::nullopt;
+    std::optional<std::string> slice =
+        shape_and_slices ? ConstString(*shape_and_slices, entry)
+                         : std::nullopt;
+    if (!key.has_value() || !slice.has_value()) {
+      return unsupported(absl::StrCat(restore->name(), " is not constant"));
+    }
+    if (!slice->empty()) {
+      return unsupported(absl::StrCat(*key, " is partitioned"));
+    }
+    saved_tensors_by_resource[VariableResource(*variable)].push_back(
+        restorer->saved_tensors_.size());
+    restorer->saved_tensors_.push_back(
+        {*std::move(key), ParseTensorName(assign.input(1)).ToString(),
+         assign.name()});
+  }
+
+  if (restorer->saved_tensors_.empty()) return nullptr;
+
+  // A variable is readable by runs other than the saver's if a node outside
+  // the saver depends on one of the nodes of its resource.
+  std::vector<int> saver_roots = {restore_op->second};
+  auto save_op = node_ids.find(
+      ParseTensorName(meta_graph.saver_def().save_tensor_name()).node());
+  if (save_op != node_ids.end()) saver_roots.push_back(save_op->second);
+  const std::vector<bool> in_saver = restorer->Reachable(saver_roots);
+  std::vector<int> non_saver_nodes;
+  for (int i = 0; i < graph_def.node_size(); ++i) {
+    if (!in_saver[i]) non_saver_nodes.push_back(i);
+  }
+  const std::vector<bool> readable = restorer->Reachable(non_saver_nodes);
+  for (int i = 0; i < graph_def.node_size(); ++i) {
+    if (!IsVariable(graph_def.node(i))) continue;
+    auto it = saved_tensors_by_resource.find(
+        VariableResource(graph_def.node(i)));
+    if (it == saved_tensors_by_resource.end()) continue;
+    restorer->saved_tensors_by_variable_[i] = it->second;
+    if (!readable[i]) continue;
+    for (int id : it->second) {
+      SavedTensor& saved_tensor = restorer->saved_tensors_[id];
+      if (!saved_tensor.readable) {
+        saved_tensor.readable = true;
+        ++restorer->num_readable_tensors_;
+      }
+    }
+  }
+  if (restorer->num_readable_tensors_ < restorer->num_saved_tensors() &&
+      save_op != node_ids.end()) {
+    restorer->save_node_ = save_op->first;
+  }
+  restorer->restored_runs_ =
+      std::make_shared<const absl::flat_hash_set<std::string>>();
+
+  absl::MutexLock lock(restorer->mu_);
+  restorer->states_.assign(restorer->saved_tensors_.size(),
+                           RestoreState::kPending);
+  BundleReader::Options options;
+  options.use_mmap = true;
+  restorer->reader_ = std::make_unique<BundleReader>(
+      Env::Default(), variables_path, options);
+  TF_RETURN_IF_ERROR(restorer->reader_->status());
+  LOG(INFO) << "Restoring the " << restorer->saved_tensors_.size()
+            << " variables of the SavedModel at " << export_dir
+            << " on demand, " << restorer->num_readable_tensors_
+            << " of which are read outside the saver.";
+  // No run may read the other variables, so they are restored already.
+  if (restorer->num_readable_tensors_ == 0) {
+    restorer->fully_restored_.store(true, std::memory_order_release);
+  }
+  return restorer;
+}
+
+std::vector<bool> LazyVariableRestorer::Reachable(
+    const std::vector<int>& roots) const {
+  std::vector<bool> reachable(node_inputs_.size());
+  std::vector<int> stack;
+  for (int root : roots) {
+    if (!reachable[root]) {
+      reachable[root] = true;
+      stack.push_back(root);
+    }
+  }
+  while (!stack.empty()) {
+    const int node = stack.back();
+    stack.pop_back();
+    for (int input : node_inputs_[node]) {
+      if (!reachable[input]) {
+        reachable[input] = true;
+        stack.push_back(input);
+      }
+    }
+  }
+  return reachable;
+}
+
+std::vector<int> LazyVariableRestorer::ReachableSavedTensors(
+    const std::vector<std::string>& output_tensor_names,
+    const std::vector<std::string>& target_node_names) const {
+  // Unknown names are left to the session to report.
+  std::vector<int> roots;
+  for (const auto* names : {&output_tensor_names, &target_node_names}) {
+    for (const std::string& name : *names) {
+      auto it = node_ids_.find(ParseTensorName(name).node());
+      if (it != node_ids_.end()) roots.push_back(it->second);
+    }
+  }
+  const std::vector<bool> reachable = Reachable(roots);
+  std::vector<int> saved_tensor_ids;
+  for (const auto& [variable, ids] : saved_tensors_by_variable_) {
+    if (reachable[variable]) {
+      saved_tensor_ids.insert(saved_tensor_ids.end(), ids.begin(), ids.end());
+    }
+  }
+  std::sort(saved_tensor_ids.begin(), saved_tensor_ids.end());
+  saved_tensor_ids.erase(
+      std::unique(saved_tensor_ids.begin(), saved_tensor_ids.end()),
+      saved_tensor_ids.end());
+  return saved_tensor_ids;
+}
+
+bool LazyVariableRestorer::RunsSaveOp(
+    const std::vector<std::string>& names) const {
+  if (save_node_.empty()) return false;
+  return std::any_of(names.begin(), names.end(), [&](const std::string& name) {
+    return ParseTensorName(name).node() == save_node_;
+  });
+}
+
+absl::Status LazyVariableRestorer::Restore(
+    const RunOptions& run_options,
+    const std::vector<std::string>& output_tensor_names,
+    const std::vector<std::string>& target_node_names, Session* session) {
+  // Only the save op may read the variables that are not readable.
+  if (fully_restored_.load(std::memory_order_acquire) &&
+      !RunsSaveOp(output_tensor_names) && !RunsSaveOp(target_node_names)) {
+    return absl::OkStatus();
+  }
+  const std::string run_key = RunKey(output_tensor_names, target_node_names);
+  if (std::atomic_load(&restored_runs_)->contains(run_key)) {
+    return absl::OkStatus();
+  }
+
+  const std::vector<int> saved_tensor_ids =
+      ReachableSavedTensors(output_tensor_names, target_node_names);
+  std::vector<int> claimed_ids;
+  std::vector<std::pair<std::string, Tensor>> inputs;
+  {
+    absl::MutexLock lock(mu_);
+    // Let other runs finish restoring the variables they claimed, so that
+    // this run does not read them before they are assigned.
+    while (std::any_of(saved_tensor_ids.begin(), saved_tensor_ids.end(),
+                       [&](int id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+                         return states_[id] == RestoreState::kRestoring;
+                       })) {
+      restored_cv_.Wait(&mu_);
+    }
+    absl::flat_hash_set<std::string> fed;
+    for (int id : saved_tensor_ids) {
+      if (states_[id] != RestoreState::kPending) continue;
+      claimed_ids.push_back(id);
+      const SavedTensor& saved_tensor = saved_tensors_[id];
+      // Assignments may share their input.
+      if (!fed.insert(saved_tensor.value_tensor).second) continue;
+      Tensor value;
+      TF_RETURN_IF_ERROR(reader_->LookupMapped(saved_tensor.key, &value));
+      if (SharedTensorStore::EnabledByEnvironment()) {
+        value = SharedTensorStore::Global()->Intern(value);
+      }
+      inputs.emplace_back(saved_tensor.value_tensor, std::move(value));
+    }
+    if (claimed_ids.empty()) {
+      AddRestoredRun(run_key);
+      return absl::OkStatus();
+    }
+    for (int id : claimed_ids) states_[id] = RestoreState::kRestoring;
+  }
+
+  const absl::Status status =
+      RestoreTensors(run_options, claimed_ids, std::move(inputs), session);
+  absl::MutexLock lock(mu_);
+  for (int id : claimed_ids) {
+    if (!status.ok()) {
+      states_[id] = RestoreState::kPending;
+      continue;
+    }
+    states_[id] = RestoreState::kRestored;
+    ++num_restored_tensors_;
+    if (saved_tensors_[id].readable) ++num_restored_readable_tensors_;
+  }
+  restored_cv_.SignalAll();
+  TF_RETURN_IF_ERROR(status);
+  if (num_restored_readable_tensors_ == num_readable_tensors_) {
+    fully_restored_.store(true, std::memory_order_release);
+  }
+  // Nothing is left to restore, so release the reader.
+  if (num_restored_tensors_ == num_saved_tensors()) reader_.reset();
+  AddRestoredRun(run_key);
+  return absl::OkStatus();
+}
+
+absl::Status LazyVariableRestorer::RestoreTensors(
+    const RunOptions& run_options, const std::vector<int>& saved_tensor_ids,
+    std::vector<std::pair<std::string, Tensor>> inputs, Session* session) {
+  std::vector<std::string> targets;
+  targets.reserve(saved_tensor_ids.size());
+  for (int id : saved_tensor_ids) {
+    targets.push_back(saved_tensors_[id].assign_node);
+  }
+  VLOG(1) << "Restoring " << targets.size() << " variables on demand.";
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return session->Run(run_options, inputs, {}, targets, &outputs,
+                      &run_metadata);
+}
+
+void LazyVariableRestorer::AddRestoredRun(const std::string& run_key) {
+  std::shared_ptr<const absl::flat_hash_set<std::string>> restored_runs =
+      std::atomic_load(&restored_runs_);
+  if (restored_runs->contains(run_key)) return;
+  auto new_restored_runs =
+      std::make_shared<absl::flat_hash_set<std::string>>(*restored_runs);
+  new_restored_runs->insert(run_key);
+  std::atomic_store(&restored_runs_,
+                    std::shared_ptr<const absl::flat_hash_set<std::string>>(
+                        std::move(new_restored_runs)));
+}
+
+int LazyVariableRestorer::num_restored_tensors() const {
+  absl::MutexLock lock(mu_);
+  return num_restored_tensors_;
+}
+
+std::unique_ptr<Session> CreateLazyRestoreSession(
+    std::unique_ptr<Session> session,
+    std::unique_ptr<LazyVariableRestorer> restorer,
+    const RunOptions& run_options) {
+  return std::make_unique<LazyRestoreSession>(
+      std::move(session), std::move(restorer), run_options);
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,152 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+/// On-demand restoration of SavedModel variables.
+
+#ifndef TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
+#define TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+
+/// Restores the variables of a SavedModel only once a session run may read
+/// them. Rather than running the restore op of the saver, which reads every
+/// variable, it reads the checkpoint entries of the variables a run reaches
+/// from its fetches and targets, and feeds them to the assignments of the
+/// restore graph. The entries are memory-mapped where the checkpoint allows
+/// it, so only the pages of the variables actually read become resident.
+/// Variables that only the saver reads are never waited for, and runs whose
+/// variables were restored before skip the restorer without locking.
+/// Thread-safe.
+class LazyVariableRestorer {
+ public:
+  /// Returns a restorer for the variables of `meta_graph`, or null if they
+  /// must be restored eagerly: when the graph has no saver or no checkpoint,
+  /// or when its restore graph is not made of RestoreV2 ops of unpartitioned
+  /// variables feeding assignments.
+  static absl::StatusOr<std::unique_ptr<LazyVariableRestorer>> Create(
+      const MetaGraphDef& meta_graph, const std::string& export_dir);
+
+  /// Restores the variables that running `output_tensor_names` and
+  /// `target_node_names` on `session` may read and that were not restored
+  /// yet.
+  absl::Status Restore(const RunOptions& run_options,
+                       const std::vector<std::string>& output_tensor_names,
+                       const std::vector<std::string>& target_node_names,
+                       Session* session);
+
+  /// Returns the number of checkpoint entries the restore graph assigns, and
+  /// how many of them were restored.
+  int num_saved_tensors() const { return saved_tensors_.size(); }
+  int num_restored_tensors() const;
+
+  /// Returns the number of checkpoint entries that a run other than one of
+  /// the saver may read.
+  int num_readable_tensors() const { return num_readable_tensors_; }
+
+ private:
+  // A checkpoint entry and the assignment that restores it.
+  struct SavedTensor {
+    std::string key;
+    // The assignment's input tensor, which is fed with the entry.
+    std::string value_tensor;
+    std::string assign_node;
+    // False if only the saver reads the variable.
+    bool readable = false;
+  };
+
+  enum class RestoreState { kPending, kRestoring, kRestored };
+
+  LazyVariableRestorer() = default;
+
+  // Returns the nodes of the graph that the nodes in `roots` depend on,
+  // including themselves.
+  std::vector<bool> Reachable(const std::vector<int>& roots) const;
+
+  // Returns the saved tensors that running `output_tensor_names` and
+  // `target_node_names` may read.
+  std::vector<int> ReachableSavedTensors(
+      const std::vector<std::string>& output_tensor_names,
+      const std::vector<std::string>& target_node_names) const;
+
+  // Returns true if `names` includes the save op of the saver, which reads
+  // variables no other run reads.
+  bool RunsSaveOp(const std::vector<std::string>& names) const;
+
+  // Feeds `inputs` to the assignments of `saved_tensor_ids`. Called without
+  // `mu_` so that runs whose variables are restored are not held up.
+  absl::Status RestoreTensors(
+      const RunOptions& run_options, const std::vector<int>& saved_tensor_ids,
+      std::vector<std::pair<std::string, Tensor>> inputs, Session* session);
+
+  // Records that the variables of the run `run_key` are restored.
+  void AddRestoredRun(const std::string& run_key)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // The graph index and the saved tensors of the variable resources. They
+  // don't change after Create().
+  std::vector<SavedTensor> saved_tensors_;
+  int num_readable_tensors_ = 0;
+  absl::flat_hash_map<std::string, int> node_ids_;
+  std::vector<std::vector<int>> node_inputs_;
+  // The saved tensors of each variable node. Variable nodes that share a
+  // resource share its saved tensors.
+  absl::flat_hash_map<int, std::vector<int>> saved_tensors_by_variable_;
+  // The node of the saver's save tensor, if some variables are not readable.
+  std::string save_node_;
+
+  // Set once every readable variable is restored.
+  std::atomic<bool> fully_restored_ = false;
+  // The fetches and targets of the runs whose variables were restored, see
+  // RunKey(). Read lock-free with std::atomic_load() and replaced, never
+  // modified, under `mu_`.
+  std::shared_ptr<const absl::flat_hash_set<std::string>> restored_runs_;
+
+  mutable absl::Mutex mu_;
+  absl::CondVar restored_cv_;
+  std::vector<RestoreState> states_ ABSL_GUARDED_BY(mu_);
+  int num_restored_tensors_ ABSL_GUARDED_BY(mu_) = 0;
+  int num_restored_readable_tensors_ ABSL_GUARDED_BY(mu_) = 0;
+  // Released once every variable is restored.
+  std::unique_ptr<BundleReader> reader_ ABSL_GUARDED_BY(mu_);
+};
+
+/// Returns a session that forwards to `session` and restores the variables
+/// each run needs with `restorer` before running it. Runs without explicit
+/// run options use `run_options` for the restores.
+std::unique_ptr<Session> CreateLazyRestoreSession(
+    std::unique_ptr<Session> session,
+    std::unique_ptr<LazyVariableRestorer> restorer,
+    const RunOptions& run_options);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CC_SAVED_MODEL_LAZY_RESTORE_H_
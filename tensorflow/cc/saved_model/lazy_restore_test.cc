@@ -0,0 +1,349 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/lazy_restore.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/cc/saved_model/loader.h"
+#include "tensorflow/cc/saved_model/reader.h"
+#include "tensorflow/cc/saved_model/signature_constants.h"
+#include "tensorflow/cc/saved_model/tag_constants.h"
+#include "tensorflow/core/config/flag_defs.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/meta_graph.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kTestDataSharded[] =
+    "cc/saved_model/testdata/half_plus_two/00000123";
+
+Tensor MakeSerializedExamples(const std::vector<float>& xs) {
+  std::vector<tstring> serialized_examples;
+  for (float x : xs) {
+    Example example;
+    auto* feature_map = example.mutable_features()->mutable_feature();
+    (*feature_map)["x"].mutable_float_list()->add_value(x);
+    serialized_examples.push_back(example.SerializeAsString());
+  }
+  return test::AsTensor<tstring>(
+      serialized_examples, TensorShape({static_cast<int64_t>(xs.size())}));
+}
+
+void CheckHalfPlusTwo(const SavedModelBundleInterface& bundle) {
+  const auto& signature_def = bundle.GetSignatures().at("regress_x_to_y");
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(bundle.GetSession()->Run(
+      {{signature_def.inputs().at(kRegressInputs).name(),
+        MakeSerializedExamples({0, 1, 2, 3})}},
+      {signature_def.outputs().at(kRegressOutputs).name()}, {}, &outputs));
+  ASSERT_EQ(outputs.size(), 1);
+  test::ExpectTensorEqual<float>(
+      outputs[0], test::AsTensor<float>({2, 2.5, 3, 3.5}, TensorShape({4, 1})));
+}
+
+TEST(LazyVariableRestorerTest, RestoresVariablesOnDemand) {
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  MetaGraphDef meta_graph;
+  TF_ASSERT_OK(ReadMetaGraphDefFromSavedModel(export_dir, {kSavedModelTagServe},
+                                              &meta_graph));
+  std::unique_ptr<Session> session;
+  TF_ASSERT_OK(
+      LoadMetagraphIntoSession(SessionOptions(), meta_graph, &session));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<LazyVariableRestorer> restorer,
+                          LazyVariableRestorer::Create(meta_graph, export_dir));
+  ASSERT_NE(restorer, nullptr);
+  EXPECT_GT(restorer->num_saved_tensors(), 0);
+
+  // The asset filename does not depend on any variable.
+  TF_ASSERT_OK(restorer->Restore(RunOptions(), {"filename_tensor:0"}, {},
+                                 session.get()));
+  EXPECT_EQ(restorer->num_restored_tensors(), 0);
+
+  const auto& signature_def =
+      meta_graph.signature_def().at("regress_x_to_y");
+  const string output_name =
+      signature_def.outputs().at(kRegressOutputs).name();
+  TF_ASSERT_OK(
+      restorer->Restore(RunOptions(), {output_name}, {}, session.get()));
+  const int num_restored = restorer->num_restored_tensors();
+  EXPECT_GT(num_restored, 0);
+  // Variables are restored once.
+  TF_ASSERT_OK(
+      restorer->Restore(RunOptions(), {output_name}, {}, session.get()));
+  EXPECT_EQ(restorer->num_restored_tensors(), num_restored);
+
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run(
+      {{signature_def.inputs().at(kRegressInputs).name(),
+        MakeSerializedExamples({0, 1, 2, 3})}},
+      {output_name}, {}, &outputs));
+  test::ExpectTensorEqual<float>(
+      outputs[0], test::AsTensor<float>({2, 2.5, 3, 3.5}, TensorShape({4, 1})));
+  TF_ASSERT_OK(session->Close());
+}
+
+// Variable `a` is restored through a VarHandleOp and read through another
+// one with the same shared name. Variable `b` is only read by the saver.
+constexpr char kSharedNameMetaGraph[] = R"pb(
+  graph_def {
+    node {
+      name: "a"
+      op: "VarHandleOp"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+      attr {
+        key: "shape"
+        value { shape {} }
+      }
+      attr {
+        key: "shared_name"
+        value { s: "a" }
+      }
+    }
+    node {
+      name: "a_handle"
+      op: "VarHandleOp"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+      attr {
+        key: "shape"
+        value { shape {} }
+      }
+      attr {
+        key: "shared_name"
+        value { s: "a" }
+      }
+    }
+    node {
+      name: "read_a"
+      op: "ReadVariableOp"
+      input: "a_handle"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+    }
+    node {
+      name: "b"
+      op: "VarHandleOp"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+      attr {
+        key: "shape"
+        value { shape {} }
+      }
+      attr {
+        key: "shared_name"
+        value { s: "b" }
+      }
+    }
+    node {
+      name: "save/filename"
+      op: "Const"
+      attr {
+        key: "dtype"
+        value { type: DT_STRING }
+      }
+      attr {
+        key: "value"
+        value {
+          tensor {
+            dtype: DT_STRING
+            tensor_shape {}
+            string_val: "variables"
+          }
+        }
+      }
+    }
+    node {
+      name: "save/tensor_names"
+      op: "Const"
+      attr {
+        key: "dtype"
+        value { type: DT_STRING }
+      }
+      attr {
+        key: "value"
+        value {
+          tensor {
+            dtype: DT_STRING
+            tensor_shape { dim { size: 2 } }
+            string_val: "a"
+            string_val: "b"
+          }
+        }
+      }
+    }
+    node {
+      name: "save/shape_and_slices"
+      op: "Const"
+      attr {
+        key: "dtype"
+        value { type: DT_STRING }
+      }
+      attr {
+        key: "value"
+        value {
+          tensor {
+            dtype: DT_STRING
+            tensor_shape { dim { size: 2 } }
+            string_val: ""
+            string_val: ""
+          }
+        }
+      }
+    }
+    node {
+      name: "save/RestoreV2"
+      op: "RestoreV2"
+      input: "save/filename"
+      input: "save/tensor_names"
+      input: "save/shape_and_slices"
+      attr {
+        key: "dtypes"
+        value { list { type: DT_FLOAT type: DT_FLOAT } }
+      }
+    }
+    node {
+      name: "save/assign_a"
+      op: "AssignVariableOp"
+      input: "a"
+      input: "save/RestoreV2"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+    }
+    node {
+      name: "save/assign_b"
+      op: "AssignVariableOp"
+      input: "b"
+      input: "save/RestoreV2:1"
+      attr {
+        key: "dtype"
+        value { type: DT_FLOAT }
+      }
+    }
+    node {
+      name: "save/restore_all"
+      op: "NoOp"
+      input: "^save/assign_a"
+      input: "^save/assign_b"
+    }
+  }
+  saver_def {
+    filename_tensor_name: "save/filename:0"
+    restore_op_name: "save/restore_all"
+  }
+)pb";
+
+TEST(LazyVariableRestorerTest, RestoresSharedNameVariables) {
+  const string export_dir = io::JoinPath(testing::TmpDir(), "shared_name");
+  const string variables_dir =
+      io::JoinPath(export_dir, kSavedModelVariablesDirectory);
+  TF_ASSERT_OK(Env::Default()->RecursivelyCreateDir(variables_dir));
+  BundleWriter writer(
+      Env::Default(), io::JoinPath(variables_dir, kSavedModelVariablesFilename));
+  TF_ASSERT_OK(writer.Add("a", test::AsScalar<float>(1)));
+  TF_ASSERT_OK(writer.Add("b", test::AsScalar<float>(2)));
+  TF_ASSERT_OK(writer.Finish());
+
+  MetaGraphDef meta_graph;
+  ASSERT_TRUE(protobuf::TextFormat::ParseFromString(kSharedNameMetaGraph,
+                                                    &meta_graph));
+  std::unique_ptr<Session> session(NewSession(SessionOptions()));
+  TF_ASSERT_OK(session->Create(meta_graph.graph_def()));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<LazyVariableRestorer> restorer,
+                          LazyVariableRestorer::Create(meta_graph, export_dir));
+  ASSERT_NE(restorer, nullptr);
+  EXPECT_EQ(restorer->num_saved_tensors(), 2);
+  // Only the saver reads `b`.
+  EXPECT_EQ(restorer->num_readable_tensors(), 1);
+
+  // `a_handle` is restored through `a`, which shares its name.
+  TF_ASSERT_OK(
+      restorer->Restore(RunOptions(), {"read_a:0"}, {}, session.get()));
+  EXPECT_EQ(restorer->num_restored_tensors(), 1);
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {"read_a:0"}, {}, &outputs));
+  test::ExpectTensorEqual<float>(outputs[0], test::AsScalar<float>(1));
+
+  // Every readable variable is restored, so `b` is not waited for.
+  TF_ASSERT_OK(restorer->Restore(RunOptions(), {"read_a:0", "a_handle:0"}, {},
+                                 session.get()));
+  EXPECT_EQ(restorer->num_restored_tensors(), 1);
+  TF_ASSERT_OK(session->Close());
+}
+
+TEST(LazyVariableRestorerTest, NoSaver) {
+  MetaGraphDef meta_graph;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<LazyVariableRestorer> restorer,
+      LazyVariableRestorer::Create(meta_graph, testing::TmpDir()));
+  EXPECT_EQ(restorer, nullptr);
+}
+
+class LazyLoadingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    flags::Global().saved_model_lazy_loading.reset(true);
+  }
+  void TearDown() override {
+    flags::Global().saved_model_lazy_loading.reset(false);
+  }
+};
+
+TEST_F(LazyLoadingTest, SavedModelBundle) {
+  SavedModelBundle bundle;
+  TF_ASSERT_OK(LoadSavedModel(
+      SessionOptions(), RunOptions(),
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded),
+      {kSavedModelTagServe}, &bundle));
+  CheckHalfPlusTwo(bundle);
+}
+
+TEST_F(LazyLoadingTest, SavedModelBundleLite) {
+  SavedModelBundleLite bundle;
+  TF_ASSERT_OK(LoadSavedModel(
+      SessionOptions(), RunOptions(),
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded),
+      {kSavedModelTagServe}, &bundle));
+  CheckHalfPlusTwo(bundle);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -21,14 +21,18 @@ limitations under the License.
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "tensorflow/cc/saved_model/constants.h"
 #include "tensorflow/cc/saved_model/fingerprinting.h"
+#include "tensorflow/cc/saved_model/lazy_restore.h"
 #include "tensorflow/cc/saved_model/loader_util.h"
 #include "tensorflow/cc/saved_model/metrics.h"
 #include "tensorflow/cc/saved_model/reader.h"
 #include "tensorflow/cc/saved_model/util.h"
+#include "tensorflow/cc/saved_model/warmup.h"
+#include "tensorflow/core/config/flag_defs.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/graph_debug_info.pb.h"
@@ -269,6 +273,63 @@ absl::Status RunRestore(const RunOptions& run_options, const string& export_dir,
                  nullptr /* outputs */, &run_metadata, session);
 }
 
+// Replays the warmup requests recorded with the SavedModel, if any, so that
+// the first requests served do not run on cold executors. A failed warmup
+// only makes the first requests slower, so it does not fail the load.
+void WarmupSession(const SessionOptions& session_options,
+                   const RunOptions& run_options, const string& export_dir,
+                   Session* session) {
+  if (session_options.config.experimental().disable_saved_model_warmup()) {
+    return;
+  }
+  const uint64 warmup_start_microseconds = Env::Default()->NowMicros();
+  absl::StatusOr<int> num_requests =
+      RunSavedModelWarmup(session_options, run_options, export_dir, session);
+  if (!num_requests.ok()) {
+    LOG(WARNING) << "Failed to warm up SavedModel bundle at path: "
+                 << export_dir << ": " << num_requests.status();
+    return;
+  }
+  if (*num_requests > 0) {
+    load_latency_by_stage->GetCell(export_dir, "warmup")
+        ->Add(GetLatencyMicroseconds(warmup_start_microseconds));
+  }
+}
+
+// Returns a restorer of the SavedModel variables if they should be restored
+// on demand rather than at load time, or null.
+absl::StatusOr<std::unique_ptr<LazyVariableRestorer>> MaybeCreateLazyRestorer(
+    const MetaGraphDef& meta_graph, const string& export_dir) {
+  if (!flags::Global().saved_model_lazy_loading.value()) return nullptr;
+  return LazyVariableRestorer::Create(meta_graph, export_dir);
+}
+
+// Like RestoreSession(), but only restores the variables the init op needs.
+// The other variables are restored by the returned session when a run first
+// needs them.
+absl::Status RestoreSessionLazily(
+    const RunOptions& run_options, const MetaGraphDef& meta_graph,
+    const string& export_dir, std::unique_ptr<LazyVariableRestorer> restorer,
+    std::unique_ptr<Session>* session) {
+  const uint64 graph_init_start_microseconds = Env::Default()->NowMicros();
+  std::vector<AssetFileDef> asset_file_defs;
+  TF_RETURN_IF_ERROR(internal::GetAssetFileDefs(meta_graph, &asset_file_defs));
+  string init_op_name;
+  TF_RETURN_IF_ERROR(
+      internal::GetInitOp(export_dir, meta_graph, &init_op_name));
+  if (!init_op_name.empty()) {
+    TF_RETURN_IF_ERROR(restorer->Restore(run_options, {}, {init_op_name},
+                                         session->get()));
+  }
+  TF_RETURN_IF_ERROR(RunInitOp(run_options, export_dir, meta_graph,
+                               asset_file_defs, session->get(), init_op_name));
+  load_latency_by_stage->GetCell(export_dir, "init_graph")
+      ->Add(GetLatencyMicroseconds(graph_init_start_microseconds));
+  *session = CreateLazyRestoreSession(std::move(*session), std::move(restorer),
+                                      run_options);
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 SavedModelBundleInterface::~SavedModelBundleInterface() = default;
@@ -304,8 +365,20 @@ absl::Status LoadSavedModelInternal(const SessionOptions& session_options,
       ReadSavedModelDebugInfoIfPresent(export_dir, &bundle->debug_info));
   TF_RETURN_IF_ERROR(LoadMetagraphIntoSession(
       session_options, bundle->meta_graph_def, &bundle->session));
-  TF_RETURN_IF_ERROR(RestoreSession(run_options, bundle->meta_graph_def,
-                                    export_dir, &bundle->session));
+  TF_ASSIGN_OR_RETURN(
+      std::unique_ptr<LazyVariableRestorer> restorer,
+      MaybeCreateLazyRestorer(bundle->meta_graph_def, export_dir));
+  if (restorer != nullptr) {
+    TF_RETURN_IF_ERROR(RestoreSessionLazily(run_options,
+                                            bundle->meta_graph_def, export_dir,
+                                            std::move(restorer),
+                                            &bundle->session));
+  } else {
+    TF_RETURN_IF_ERROR(RestoreSession(run_options, bundle->meta_graph_def,
+                                      export_dir, &bundle->session));
+  }
+  WarmupSession(session_options, run_options, export_dir,
+                bundle->session.get());
   return absl::OkStatus();
 }
 
@@ -449,12 +522,23 @@ absl::Status LoadSavedModelInternal(const SessionOptions& session_options,
   MetaGraphDef meta_graph_def;
   TF_RETURN_IF_ERROR(
       ReadMetaGraphDefFromSavedModel(export_dir, tags, &meta_graph_def));
+  // The restorer indexes the graph, so create it before the graph is moved
+  // into the session.
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<LazyVariableRestorer> restorer,
+                      MaybeCreateLazyRestorer(meta_graph_def, export_dir));
   std::unique_ptr<Session> session;
   TF_RETURN_IF_ERROR(LoadGraphDefIntoSession(
       session_options, std::move(*meta_graph_def.mutable_graph_def()),
       &session));
-  TF_RETURN_IF_ERROR(
-      RestoreSession(run_options, meta_graph_def, export_dir, &session));
+  if (restorer != nullptr) {
+    TF_RETURN_IF_ERROR(RestoreSessionLazily(run_options, meta_graph_def,
+                                            export_dir, std::move(restorer),
+                                            &session));
+  } else {
+    TF_RETURN_IF_ERROR(
+        RestoreSession(run_options, meta_graph_def, export_dir, &session));
+  }
+  WarmupSession(session_options, run_options, export_dir, session.get());
   *bundle = SavedModelBundleLite(
       std::make_unique<LiteSessionWrapper>(std::move(session)),
       std::move(*meta_graph_def.mutable_signature_def()));
@@ -0,0 +1,397 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/warmup.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/batching_util/warmup.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/file_system_helper.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/threadpool_options.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/master.pb.h"
+#include "tensorflow/core/public/session.h"
+
+namespace tensorflow {
+namespace {
+
+std::string WarmupRequestsPath(const std::string& export_dir) {
+  return io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory,
+                      kSavedModelWarmupRequestsFilename);
+}
+
+// Session wrapper that records the requests it runs.
+class WarmupRecordingSession : public Session {
+ public:
+  WarmupRecordingSession(std::unique_ptr<Session> wrapped,
+                         std::shared_ptr<WarmupRequestRecorder> recorder)
+      : wrapped_(std::move(wrapped)), recorder_(std::move(recorder)) {}
+
+  absl::Status Create(const GraphDef& graph) override {
+    return wrapped_->Create(graph);
+  }
+  absl::Status Create(GraphDef&& graph) override {
+    return wrapped_->Create(std::move(graph));
+  }
+  absl::Status Create(const RunOptions& run_options,
+                      const GraphDef& graph) override {
+    return wrapped_->Create(run_options, graph);
+  }
+  absl::Status Create(const RunOptions& run_options,
+                      GraphDef&& graph) override {
+    return wrapped_->Create(run_options, std::move(graph));
+  }
+
+  absl::Status Extend(const GraphDef& graph) override {
+    return wrapped_->Extend(graph);
+  }
+  absl::Status Extend(GraphDef&& graph) override {
+    return wrapped_->Extend(std::move(graph));
+  }
+  absl::Status Extend(const RunOptions& run_options,
+                      const GraphDef& graph) override {
+    return wrapped_->Extend(run_options, graph);
+  }
+  absl::Status Extend(const RunOptions& run_options,
+                      GraphDef&& graph) override {
+    return wrapped_->Extend(run_options, std::move(graph));
+  }
+
+  absl::Status Run(const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs) override {
+    recorder_->Record(inputs, output_tensor_names, target_node_names);
+    return wrapped_->Run(inputs, output_tensor_names, target_node_names,
+                         outputs);
+  }
+
+  absl::Status Run(const RunOptions& run_options,
+                   const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs,
+                   RunMetadata* run_metadata) override {
+    recorder_->Record(inputs, output_tensor_names, target_node_names);
+    return wrapped_->Run(run_options, inputs, output_tensor_names,
+                         target_node_names, outputs, run_metadata);
+  }
+
+  absl::Status Run(
+      const RunOptions& run_options,
+      const std::vector<std::pair<std::string, Tensor>>& inputs,
+      const std::vector<std::string>& output_tensor_names,
+      const std::vector<std::string>& target_tensor_names,
+      std::vector<Tensor>* outputs, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options) override {
+    recorder_->Record(inputs, output_tensor_names, target_tensor_names);
+    return wrapped_->Run(run_options, inputs, output_tensor_names,
+                         target_tensor_names, outputs, run_metadata,
+                         threadpool_options);
+  }
+
+  absl::Status PRunSetup(const std::vector<string>& input_names,
+                         const std::vector<string>& output_names,
+                         const std::vector<string>& target_nodes,
+                         string* handle) override {
+    return wrapped_->PRunSetup(input_names, output_names, target_nodes,
+                               handle);
+  }
+
+  absl::Status PRun(const string& handle,
+                    const std::vector<std::pair<string, Tensor>>& inputs,
+                    const std::vector<string>& output_names,
+                    std::vector<Tensor>* outputs) override {
+    return wrapped_->PRun(handle, inputs, output_names, outputs);
+  }
+
+  absl::Status ListDevices(std::vector<DeviceAttributes>* response) override {
+    return wrapped_->ListDevices(response);
+  }
+
+  absl::Status Close() override { return wrapped_->Close(); }
+  absl::Status Close(const RunOptions& run_options) override {
+    return wrapped_->Close(run_options);
+  }
+
+  absl::Status LocalDeviceManager(const DeviceMgr** device_mgr) override {
+    return wrapped_->LocalDeviceManager(device_mgr);
+  }
+
+  absl::Status MakeCallable(const CallableOptions& callable_options,
+                            CallableHandle* out_handle) override {
+    TF_RETURN_IF_ERROR(wrapped_->MakeCallable(callable_options, out_handle));
+    absl::MutexLock lock(mu_);
+    callables_[*out_handle] = callable_options;
+    return absl::OkStatus();
+  }
+
+  absl::Status RunCallable(CallableHandle handle,
+                           const std::vector<Tensor>& feed_tensors,
+                           std::vector<Tensor>* fetch_tensors,
+                           RunMetadata* run_metadata) override {
+    RecordCallable(handle, feed_tensors);
+    return wrapped_->RunCallable(handle, feed_tensors, fetch_tensors,
+                                 run_metadata);
+  }
+
+  absl::Status RunCallable(
+      CallableHandle handle, const std::vector<Tensor>& feed_tensors,
+      std::vector<Tensor>* fetch_tensors, RunMetadata* run_metadata,
+      const thread::ThreadPoolOptions& threadpool_options) override {
+    RecordCallable(handle, feed_tensors);
+    return wrapped_->RunCallable(handle, feed_tensors, fetch_tensors,
+                                 run_metadata, threadpool_options);
+  }
+
+  absl::Status ReleaseCallable(CallableHandle handle) override {
+    {
+      absl::MutexLock lock(mu_);
+      callables_.erase(handle);
+    }
+    return wrapped_->ReleaseCallable(handle);
+  }
+
+  absl::Status Finalize() override { return wrapped_->Finalize(); }
+
+ private:
+  // Records a run of callable `handle` as the equivalent Session::Run() call.
+  void RecordCallable(CallableHandle handle,
+                      const std::vector<Tensor>& feed_tensors) {
+    std::vector<std::pair<string, Tensor>> inputs;
+    std::vector<string> output_tensor_names;
+    std::vector<string> target_node_names;
+    {
+      absl::MutexLock lock(mu_);
+      auto it = callables_.find(handle);
+      if (it == callables_.end() ||
+          it->second.feed_size() != feed_tensors.size()) {
+        return;
+      }
+      const CallableOptions& options = it->second;
+      for (int i = 0; i < options.feed_size(); ++i) {
+        inputs.emplace_back(options.feed(i), feed_tensors[i]);
+      }
+      output_tensor_names.assign(options.fetch().begin(),
+                                 options.fetch().end());
+      target_node_names.assign(options.target().begin(),
+                               options.target().end());
+    }
+    recorder_->Record(inputs, output_tensor_names, target_node_names);
+  }
+
+  const std::unique_ptr<Session> wrapped_;
+  const std::shared_ptr<WarmupRequestRecorder> recorder_;
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<CallableHandle, CallableOptions> callables_
+      ABSL_GUARDED_BY(mu_);
+};
+
+absl::Status ReadWarmupRequests(const std::string& path,
+                                std::vector<RunStepRequest>* requests) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(path, &file));
+  io::RecordReader reader(file.get());
+  uint64_t offset = 0;
+  tstring record;
+  while (true) {
+    const absl::Status status = reader.ReadRecord(&offset, &record);
+    if (absl::IsOutOfRange(status)) break;
+    TF_RETURN_IF_ERROR(status);
+    RunStepRequest request;
+    if (!request.ParseFromArray(record.data(), record.size())) {
+      return absl::DataLossError(
+          absl::StrCat("Failed to parse a warmup request in ", path));
+    }
+    requests->push_back(std::move(request));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status RunWarmupRequest(const RunOptions& run_options,
+                              const RunStepRequest& request,
+                              Session* session) {
+  std::vector<std::pair<string, Tensor>> inputs;
+  inputs.reserve(request.feed_size());
+  for (const NamedTensorProto& feed : request.feed()) {
+    Tensor tensor;
+    if (!tensor.FromProto(feed.tensor())) {
+      return absl::DataLossError(
+          absl::StrCat("Invalid warmup tensor for feed ", feed.name()));
+    }
+    inputs.emplace_back(feed.name(), std::move(tensor));
+  }
+  const std::vector<string> output_tensor_names(request.fetch().begin(),
+                                                request.fetch().end());
+  const std::vector<string> target_node_names(request.target().begin(),
+                                              request.target().end());
+  std::vector<Tensor> outputs;
+  RunMetadata run_metadata;
+  return session->Run(run_options, inputs, output_tensor_names,
+                      target_node_names, &outputs, &run_metadata);
+}
+
+}  // namespace
+
+void WarmupRequestRecorder::Record(
+    const std::vector<std::pair<std::string, Tensor>>& inputs,
+    const std::vector<std::string>& output_tensor_names,
+    const std::vector<std::string>& target_node_names) {
+  // Reservoir sampling: the n-th request replaces a random sampled request
+  // with probability `max_requests_` / n.
+  int64_t slot;
+  {
+    absl::MutexLock lock(mu_);
+    slot = num_seen_++;
+    if (slot >= max_requests_) {
+      slot = random::New64() % (slot + 1);
+      if (slot >= max_requests_) return;
+    }
+  }
+
+  // Serialize the request outside of the lock, as the feeds may be large.
+  RunStepRequest request;
+  for (const auto& [name, tensor] : inputs) {
+    NamedTensorProto* feed = request.add_feed();
+    feed->set_name(name);
+    tensor.AsProtoTensorContent(feed->mutable_tensor());
+  }
+  request.mutable_fetch()->Add(output_tensor_names.begin(),
+                               output_tensor_names.end());
+  request.mutable_target()->Add(target_node_names.begin(),
+                                target_node_names.end());
+
+  absl::MutexLock lock(mu_);
+  requests_[slot] = std::move(request);
+}
+
+int64_t WarmupRequestRecorder::num_seen() const {
+  absl::MutexLock lock(mu_);
+  return num_seen_;
+}
+
+std::vector<RunStepRequest> WarmupRequestRecorder::requests() const {
+  absl::MutexLock lock(mu_);
+  std::vector<RunStepRequest> requests;
+  for (const std::optional<RunStepRequest>& request : requests_) {
+    if (request.has_value()) requests.push_back(*request);
+  }
+  return requests;
+}
+
+absl::Status WarmupRequestRecorder::Write(const std::string& export_dir) const {
+  const std::vector<RunStepRequest> sampled_requests = requests();
+  Env* env = Env::Default();
+  TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(
+      io::JoinPath(export_dir, kSavedModelAssetsExtraDirectory)));
+
+  // Write to a temporary file first, so that a model loaded concurrently
+  // never sees a partially written file.
+  const std::string path = WarmupRequestsPath(export_dir);
+  const std::string tmp_path = absl::StrCat(path, ".tmp");
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(tmp_path, &file));
+  io::RecordWriter writer(file.get());
+  for (const RunStepRequest& request : sampled_requests) {
+    TF_RETURN_IF_ERROR(writer.WriteRecord(request.SerializeAsString()));
+  }
+  TF_RETURN_IF_ERROR(writer.Close());
+  TF_RETURN_IF_ERROR(file->Close());
+  return env->RenameFile(tmp_path, path);
+}
+
+std::unique_ptr<Session> CreateWarmupRecordingSession(
+    std::unique_ptr<Session> session,
+    std::shared_ptr<WarmupRequestRecorder> recorder) {
+  return std::make_unique<WarmupRecordingSession>(std::move(session),
+                                                  std::move(recorder));
+}
+
+absl::StatusOr<int> RunSavedModelWarmup(const SessionOptions& session_options,
+                                        const RunOptions& run_options,
+                                        const std::string& export_dir,
+                                        Session* session) {
+  const std::string path = WarmupRequestsPath(export_dir);
+  TF_ASSIGN_OR_RETURN(bool exists, internal::FileExists(Env::Default(), path));
+  if (!exists) return 0;
+  std::vector<RunStepRequest> requests;
+  TF_RETURN_IF_ERROR(ReadWarmupRequests(path, &requests));
+  if (requests.empty()) return 0;
+  LOG(INFO) << "Running " << requests.size()
+            << " warmup requests on SavedModel bundle at path: " << export_dir;
+
+  std::optional<serving::WarmupStateRegistry::Handle> warmup_handle;
+  const SessionMetadata& metadata =
+      session_options.config.experimental().session_metadata();
+  if (!metadata.name().empty()) {
+    auto per_model_data =
+        std::make_unique<serving::WarmupStateRegistry::PerModelData>();
+    per_model_data->warmup_all_batch_sizes = true;
+    absl::StatusOr<serving::WarmupStateRegistry::Handle> handle =
+        serving::GetGlobalWarmupStateRegistry().Register(
+            {metadata.name(), metadata.version()}, std::move(per_model_data));
+    if (handle.ok()) {
+      warmup_handle = std::move(*handle);
+    } else {
+      LOG(WARNING) << "Warming up without all batch sizes: "
+                   << handle.status();
+    }
+  }
+
+  absl::Mutex mu;
+  absl::Status status;
+  {
+    thread::ThreadPool pool(
+        Env::Default(), "saved_model_warmup",
+        std::min<int>(requests.size(), port::MaxParallelism()));
+    for (const RunStepRequest& request : requests) {
+      pool.Schedule([&run_options, &request, session, &mu, &status]() {
+        const absl::Status run_status =
+            RunWarmupRequest(run_options, request, session);
+        absl::MutexLock lock(mu);
+        status.Update(run_status);
+      });
+    }
+    // The pool waits for the requests to finish when it is destroyed.
+  }
+  TF_RETURN_IF_ERROR(status);
+  return static_cast<int>(requests.size());
+}
+
+}  // namespace tensorflow
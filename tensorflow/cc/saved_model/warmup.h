@@ -0,0 +1,96 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+/// Recording and replay of SavedModel warmup requests.
+
+#ifndef TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
+#define TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/master.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+
+/// Keeps a uniform sample of the requests a SavedModel served, so that they
+/// can be written to the SavedModel and replayed to warm it up the next time
+/// it is loaded. Only the first `max_requests` requests are kept verbatim;
+/// later ones replace a random earlier one with decreasing probability.
+/// Thread-safe.
+class WarmupRequestRecorder {
+ public:
+  static constexpr int kDefaultMaxRequests = 100;
+
+  explicit WarmupRequestRecorder(int max_requests = kDefaultMaxRequests)
+      : max_requests_(max_requests), requests_(max_requests) {}
+
+  /// Records a Session::Run() call with the given arguments.
+  void Record(const std::vector<std::pair<std::string, Tensor>>& inputs,
+              const std::vector<std::string>& output_tensor_names,
+              const std::vector<std::string>& target_node_names);
+
+  /// Returns the number of requests seen so far, including the ones that
+  /// were not sampled.
+  int64_t num_seen() const;
+
+  /// Returns the sampled requests.
+  std::vector<RunStepRequest> requests() const;
+
+  /// Writes the sampled requests to the assets.extra directory of the
+  /// SavedModel in `export_dir`, replacing any requests written before.
+  absl::Status Write(const std::string& export_dir) const;
+
+ private:
+  const int max_requests_;
+
+  mutable absl::Mutex mu_;
+  int64_t num_seen_ ABSL_GUARDED_BY(mu_) = 0;
+  // The sampled requests, one slot per request kept. A slot is empty until
+  // the request assigned to it has been serialized.
+  std::vector<std::optional<RunStepRequest>> requests_ ABSL_GUARDED_BY(mu_);
+};
+
+/// Returns a session that forwards to `session` and records the requests it
+/// runs in `recorder`.
+std::unique_ptr<Session> CreateWarmupRecordingSession(
+    std::unique_ptr<Session> session,
+    std::shared_ptr<WarmupRequestRecorder> recorder);
+
+/// Reads the warmup requests written to the SavedModel in `export_dir`, if
+/// any, and runs them on `session` in parallel. If the session options carry
+/// a model name, the model is registered as warming up while the requests
+/// run, which makes batch ops run every allowed batch size for each of them.
+/// Returns the number of requests run.
+absl::StatusOr<int> RunSavedModelWarmup(const SessionOptions& session_options,
+                                        const RunOptions& run_options,
+                                        const std::string& export_dir,
+                                        Session* session);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CC_SAVED_MODEL_WARMUP_H_
@@ -0,0 +1,340 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/cc/saved_model/warmup.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/cc/saved_model/loader.h"
+#include "tensorflow/cc/saved_model/signature_constants.h"
+#include "tensorflow/cc/saved_model/tag_constants.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/kernels/batching_util/warmup.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/lib/monitoring/test_utils.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/master.pb.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+using ::tensorflow::monitoring::testing::CellReader;
+using ::tensorflow::monitoring::testing::Histogram;
+
+constexpr char kTestDataSharded[] =
+    "cc/saved_model/testdata/half_plus_two/00000123";
+constexpr char kLoadLatencyByStage[] =
+    "/tensorflow/cc/saved_model/load_latency_by_stage";
+
+Tensor MakeSerializedExamples(const std::vector<float>& xs) {
+  std::vector<tstring> serialized_examples;
+  for (float x : xs) {
+    Example example;
+    auto* feature_map = example.mutable_features()->mutable_feature();
+    (*feature_map)["x"].mutable_float_list()->add_value(x);
+    serialized_examples.push_back(example.SerializeAsString());
+  }
+  return test::AsTensor<tstring>(
+      serialized_examples, TensorShape({static_cast<int64_t>(xs.size())}));
+}
+
+// Copies the test SavedModel to a new directory that warmup requests can be
+// written to, and returns the directory.
+string CopyTestSavedModel(const string& name) {
+  const string src =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  const string dst = io::JoinPath(testing::TmpDir(), name);
+  for (const char* file :
+       {"saved_model.pb", "assets/foo.txt", "variables/variables.index",
+        "variables/variables.data-00000-of-00001"}) {
+    const string dst_file = io::JoinPath(dst, file);
+    TF_CHECK_OK(Env::Default()->RecursivelyCreateDir(
+        string(io::Dirname(dst_file))));
+    TF_CHECK_OK(Env::Default()->CopyFile(io::JoinPath(src, file), dst_file));
+  }
+  return dst;
+}
+
+// Writes warmup requests with the given batches of inputs, fetching
+// `output_name`, to the SavedModel in `export_dir`.
+void WriteWarmupRequests(const string& export_dir,
+                         const std::vector<std::vector<float>>& batches,
+                         const string& output_name) {
+  SavedModelBundle bundle;
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  const string input_name = bundle.GetSignatures()
+                                .at("regress_x_to_y")
+                                .inputs()
+                                .at(kRegressInputs)
+                                .name();
+  WarmupRequestRecorder recorder;
+  for (const std::vector<float>& xs : batches) {
+    recorder.Record({{input_name, MakeSerializedExamples(xs)}}, {output_name},
+                    {});
+  }
+  TF_ASSERT_OK(recorder.Write(export_dir));
+}
+
+string RegressOutputName() {
+  SavedModelBundle bundle;
+  TF_CHECK_OK(LoadSavedModel(
+      SessionOptions(), RunOptions(),
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded),
+      {kSavedModelTagServe}, &bundle));
+  return bundle.GetSignatures()
+      .at("regress_x_to_y")
+      .outputs()
+      .at(kRegressOutputs)
+      .name();
+}
+
+// A session that only runs requests, recording whether its model was
+// registered to warm up all batch sizes while they ran.
+class WarmupStateRecordingSession : public Session {
+ public:
+  explicit WarmupStateRecordingSession(
+      serving::WarmupStateRegistry::Key model_key)
+      : model_key_(std::move(model_key)) {}
+
+  absl::Status Create(const GraphDef& graph) override {
+    return absl::UnimplementedError("Create");
+  }
+  absl::Status Extend(const GraphDef& graph) override {
+    return absl::UnimplementedError("Extend");
+  }
+  absl::Status Run(const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs) override {
+    return Run(RunOptions(), inputs, output_tensor_names, target_node_names,
+               outputs, /*run_metadata=*/nullptr);
+  }
+  absl::Status Run(const RunOptions& run_options,
+                   const std::vector<std::pair<string, Tensor>>& inputs,
+                   const std::vector<string>& output_tensor_names,
+                   const std::vector<string>& target_node_names,
+                   std::vector<Tensor>* outputs,
+                   RunMetadata* run_metadata) override {
+    const serving::WarmupStateRegistry::PerModelData* per_model_data =
+        serving::GetGlobalWarmupStateRegistry().Lookup(model_key_);
+    absl::MutexLock lock(mu_);
+    ++num_runs_;
+    if (per_model_data != nullptr && per_model_data->warmup_all_batch_sizes) {
+      ++num_runs_warming_up_all_batch_sizes_;
+    }
+    return absl::OkStatus();
+  }
+  absl::Status ListDevices(std::vector<DeviceAttributes>* response) override {
+    return absl::OkStatus();
+  }
+  absl::Status Close() override { return absl::OkStatus(); }
+
+  int num_runs() const {
+    absl::MutexLock lock(mu_);
+    return num_runs_;
+  }
+  int num_runs_warming_up_all_batch_sizes() const {
+    absl::MutexLock lock(mu_);
+    return num_runs_warming_up_all_batch_sizes_;
+  }
+
+ private:
+  const serving::WarmupStateRegistry::Key model_key_;
+  mutable absl::Mutex mu_;
+  int num_runs_ ABSL_GUARDED_BY(mu_) = 0;
+  int num_runs_warming_up_all_batch_sizes_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+TEST(WarmupRequestRecorderTest, SamplesAtMostMaxRequests) {
+  WarmupRequestRecorder recorder(/*max_requests=*/2);
+  for (int i = 0; i < 10; ++i) {
+    recorder.Record({{"x:0", test::AsScalar<int32_t>(i)}}, {"y:0"}, {});
+  }
+  EXPECT_EQ(recorder.num_seen(), 10);
+  const std::vector<RunStepRequest> requests = recorder.requests();
+  ASSERT_EQ(requests.size(), 2);
+  for (const RunStepRequest& request : requests) {
+    ASSERT_EQ(request.feed_size(), 1);
+    EXPECT_EQ(request.feed(0).name(), "x:0");
+    ASSERT_EQ(request.fetch_size(), 1);
+    EXPECT_EQ(request.fetch(0), "y:0");
+  }
+}
+
+TEST(WarmupTest, RecordsAndReplaysRequests) {
+  SavedModelBundle bundle;
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  const auto& signature_def = bundle.GetSignatures().at("regress_x_to_y");
+  const string input_name = signature_def.inputs().at(kRegressInputs).name();
+  const string output_name =
+      signature_def.outputs().at(kRegressOutputs).name();
+
+  auto recorder = std::make_shared<WarmupRequestRecorder>();
+  std::unique_ptr<Session> session =
+      CreateWarmupRecordingSession(std::move(bundle.session), recorder);
+  for (const std::vector<float>& xs :
+       std::vector<std::vector<float>>{{0}, {1, 2}, {0, 1, 2, 3}}) {
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run({{input_name, MakeSerializedExamples(xs)}},
+                              {output_name}, {}, &outputs));
+  }
+  EXPECT_EQ(recorder->num_seen(), 3);
+
+  // Write the requests to a copy of the assets.extra directory only, which is
+  // all the replay needs.
+  const string warmup_dir = io::JoinPath(testing::TmpDir(), "warmup");
+  TF_ASSERT_OK(recorder->Write(warmup_dir));
+  TF_EXPECT_OK(Env::Default()->FileExists(
+      io::JoinPath(warmup_dir, kSavedModelAssetsExtraDirectory,
+                   kSavedModelWarmupRequestsFilename)));
+
+  auto replay_recorder = std::make_shared<WarmupRequestRecorder>();
+  std::unique_ptr<Session> replay_session =
+      CreateWarmupRecordingSession(std::move(session), replay_recorder);
+  TF_ASSERT_OK_AND_ASSIGN(
+      int num_requests,
+      RunSavedModelWarmup(SessionOptions(), RunOptions(), warmup_dir,
+                          replay_session.get()));
+  EXPECT_EQ(num_requests, 3);
+  EXPECT_EQ(replay_recorder->num_seen(), 3);
+  std::vector<int64_t> batch_sizes;
+  for (const RunStepRequest& request : replay_recorder->requests()) {
+    ASSERT_EQ(request.feed_size(), 1);
+    EXPECT_EQ(request.feed(0).name(), input_name);
+    const TensorShapeProto& shape = request.feed(0).tensor().tensor_shape();
+    batch_sizes.push_back(shape.dim(0).size());
+  }
+  EXPECT_THAT(batch_sizes, ::testing::UnorderedElementsAre(1, 2, 4));
+  TF_ASSERT_OK(replay_session->Close());
+}
+
+TEST(WarmupTest, NoRecordedRequests) {
+  SavedModelBundle bundle;
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+
+  auto recorder = std::make_shared<WarmupRequestRecorder>();
+  std::unique_ptr<Session> session =
+      CreateWarmupRecordingSession(std::move(bundle.session), recorder);
+  TF_ASSERT_OK_AND_ASSIGN(int num_requests,
+                          RunSavedModelWarmup(SessionOptions(), RunOptions(),
+                                              export_dir, session.get()));
+  EXPECT_EQ(num_requests, 0);
+  EXPECT_EQ(recorder->num_seen(), 0);
+  TF_ASSERT_OK(session->Close());
+}
+
+TEST(WarmupTest, WarmsUpAllBatchSizesOfNamedModel) {
+  const string export_dir = CopyTestSavedModel("all_batch_sizes");
+  WriteWarmupRequests(export_dir, {{0}, {1, 2}}, RegressOutputName());
+
+  SessionOptions session_options;
+  SessionMetadata* metadata = session_options.config.mutable_experimental()
+                                  ->mutable_session_metadata();
+  metadata->set_name("warmup_test_model");
+  metadata->set_version(7);
+  const serving::WarmupStateRegistry::Key model_key("warmup_test_model", 7);
+  WarmupStateRecordingSession session(model_key);
+  TF_ASSERT_OK_AND_ASSIGN(
+      int num_requests,
+      RunSavedModelWarmup(session_options, RunOptions(), export_dir, &session));
+  EXPECT_EQ(num_requests, 2);
+  EXPECT_EQ(session.num_runs(), 2);
+  EXPECT_EQ(session.num_runs_warming_up_all_batch_sizes(), 2);
+  // The model is unregistered once the warmup is done.
+  EXPECT_EQ(serving::GetGlobalWarmupStateRegistry().Lookup(model_key),
+            nullptr);
+
+  // Without a model name, batch ops can't tell the model is warming up.
+  WarmupStateRecordingSession unnamed_session(model_key);
+  TF_ASSERT_OK(RunSavedModelWarmup(SessionOptions(), RunOptions(), export_dir,
+                                   &unnamed_session)
+                   .status());
+  EXPECT_EQ(unnamed_session.num_runs(), 2);
+  EXPECT_EQ(unnamed_session.num_runs_warming_up_all_batch_sizes(), 0);
+}
+
+TEST(WarmupTest, LoadSavedModelReplaysRequests) {
+  const string export_dir = CopyTestSavedModel("loader_replay");
+  WriteWarmupRequests(export_dir, {{0}, {1, 2}}, RegressOutputName());
+
+  CellReader<Histogram> load_latency(kLoadLatencyByStage);
+  SavedModelBundle bundle;
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  EXPECT_EQ(load_latency.Delta(export_dir, "warmup").num(), 1);
+
+  SavedModelBundleLite bundle_lite;
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle_lite));
+  EXPECT_EQ(load_latency.Delta(export_dir, "warmup").num(), 1);
+}
+
+TEST(WarmupTest, LoadSavedModelWithWarmupDisabled) {
+  const string export_dir = CopyTestSavedModel("loader_disabled");
+  WriteWarmupRequests(export_dir, {{0}}, RegressOutputName());
+
+  CellReader<Histogram> load_latency(kLoadLatencyByStage);
+  SessionOptions session_options;
+  session_options.config.mutable_experimental()->set_disable_saved_model_warmup(
+      true);
+  SavedModelBundle bundle;
+  TF_ASSERT_OK(LoadSavedModel(session_options, RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  EXPECT_EQ(load_latency.Delta(export_dir, "warmup").num(), 0);
+}
+
+TEST(WarmupTest, FailedReplayDoesNotFailLoad) {
+  const string export_dir = CopyTestSavedModel("loader_failed_replay");
+  WriteWarmupRequests(export_dir, {{0}}, "no_such_tensor:0");
+
+  CellReader<Histogram> load_latency(kLoadLatencyByStage);
+  SavedModelBundle bundle;
+  TF_ASSERT_OK(LoadSavedModel(SessionOptions(), RunOptions(), export_dir,
+                              {kSavedModelTagServe}, &bundle));
+  EXPECT_EQ(load_latency.Delta(export_dir, "warmup").num(), 0);
+  std::vector<Tensor> outputs;
+  TF_EXPECT_OK(bundle.session->Run(
+      {{bundle.GetSignatures()
+            .at("regress_x_to_y")
+            .inputs()
+            .at(kRegressInputs)
+            .name(),
+        MakeSerializedExamples({1})}},
+      {RegressOutputName()}, {}, &outputs));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -204,6 +204,13 @@ void CostAnalysis::EvaluateCost(mlir::Operation* op) {
     }
   }
 
+  // Try to use the cost measured by a previous load of the model if any.
+  if (const auto measured_cost_attr = op->getAttrOfType<mlir::IntegerAttr>(
+          tfrt_stub::kMeasuredCostAttrName)) {
+    cost_map_[op] = std::max<int64_t>(1, measured_cost_attr.getInt());
+    return;
+  }
+
   // These ops are cheap regardless of their input sizes.
   //
   // TODO(chky): Find a more scalable way to figure out cheap ops.
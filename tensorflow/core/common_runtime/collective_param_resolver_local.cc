@@ -17,12 +17,14 @@ limitations under the License.
 #include <stddef.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -62,13 +64,40 @@ void CollectiveParamResolverLocal::CompleteGroupAsync(
 }
 
 namespace {
+// All-reduces on CPU of at most this many bytes use the binary tree, which
+// sends the whole tensor in each of its 2*log2(N) steps.
+constexpr int64_t kTreeReduceMaxBytes = 16 << 10;
+// Larger ones up to this many bytes use recursive halving-doubling, which
+// sends as much data as the ring but in 2*log2(N) steps instead of 2*(N-1).
+// Beyond it, the ring overlaps transfers of subdivided chunks and is faster.
+constexpr int64_t kRecursiveHalvingDoublingReduceMaxBytes = 4 << 20;
+
+// Returns the all-reduce implementation for `cp` when NCCL is not used.
+const char* GetReduceCollectiveName(const CollectiveParams* cp) {
+  // The ring is kept on GPUs, where merges are asynchronous, for groups too
+  // small to save steps, and when requested by the communication hint, which
+  // may also ask for compression, e.g. "ring:bf16".
+  if (cp->group.device_type != DEVICE_CPU || cp->group.group_size <= 2 ||
+      absl::StartsWith(cp->instance.impl_details.communication_hint,
+                       "ring")) {
+    return "RingReduce";
+  }
+  const int64_t bytes =
+      cp->instance.shape.num_elements() * DataTypeSize(cp->instance.data_type);
+  if (bytes <= kTreeReduceMaxBytes) return "TreeReduce";
+  if (bytes <= kRecursiveHalvingDoublingReduceMaxBytes) {
+    return "RecursiveHalvingDoublingReduce";
+  }
+  return "RingReduce";
+}
+
 const char* GetCollectiveName(const CollectiveParams* cp, bool nccl) {
   switch (cp->instance.type) {
     case BROADCAST_COLLECTIVE:
       return nccl ? "NcclBroadcast" : "HierarchicalTreeBroadcast";
 
     case REDUCTION_COLLECTIVE:
-      return nccl ? "NcclReduce" : "RingReduce";
+      return nccl ? "NcclReduce" : GetReduceCollectiveName(cp);
 
     case GATHER_COLLECTIVE:
       return nccl ? "NcclGather" : "RingGather";
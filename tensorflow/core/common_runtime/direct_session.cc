@@ -1476,6 +1476,8 @@ absl::Status DirectSession::CreateExecutors(
     params.device = device;
     params.session_metadata = session_metadata;
     params.function_library = lib;
+    params.enable_static_memory_plan =
+        options_.config.experimental().enable_static_memory_plan();
     auto opseg = device->op_segment();
     params.create_kernel =
         [this, lib, opseg](const std::shared_ptr<const NodeProperties>& props,
@@ -236,6 +236,28 @@ TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_OptimizeForStaticGraph) {
   EXPECT_TRUE(absl::StrContains(s.message(), "optimize_for_static_graph"));
 }
 
+TEST_F(DirectSessionMinusAXTest, RunSimpleNetwork_StaticMemoryPlan) {
+  Initialize({3, 2, -1, 0});
+  SessionOptions options(DefaultSessionOptions());
+  options.config.mutable_experimental()->set_enable_static_memory_plan(true);
+  auto session = absl::WrapUnique(NewSession(options));
+
+  ASSERT_TRUE(session != nullptr);
+  TF_ASSERT_OK(session->Create(def_));
+  std::vector<std::pair<std::string, Tensor>> inputs;
+
+  // Run repeatedly so that every step gets its own slab.
+  for (int i = 0; i < 3; ++i) {
+    std::vector<std::string> output_names = {y_ + ":0", y_neg_ + ":0"};
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run(inputs, output_names, {}, &outputs));
+
+    ASSERT_EQ(2, outputs.size());
+    EXPECT_FLOAT_EQ(5.0, outputs[0].matrix<float>()(0, 0));
+    EXPECT_FLOAT_EQ(-5.0, outputs[1].matrix<float>()(0, 0));
+  }
+}
+
 TEST_F(DirectSessionMinusAXTest,
        RunSimpleNetwork_DisableOutputPartitionGraphs) {
   Initialize({3, 2, -1, 0});
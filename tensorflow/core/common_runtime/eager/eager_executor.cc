@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
+#include <cstdint>
 #include <forward_list>
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -32,6 +34,18 @@ bool IsAsyncWaitForRemoteFunctionEnabled() {
                                  true, &enabled));
   return enabled;
 }
+
+int64_t MaxCoalescedRemoteNodes() {
+  constexpr int64_t kDefaultMaxNodes = 64;
+  int64_t max_nodes = kDefaultMaxNodes;
+  absl::Status status = ReadInt64FromEnvVar(
+      "TF_EAGER_MAX_COALESCED_REMOTE_NODES", kDefaultMaxNodes, &max_nodes);
+  if (!status.ok()) {
+    LOG(ERROR) << "Ignoring TF_EAGER_MAX_COALESCED_REMOTE_NODES: " << status;
+    max_nodes = kDefaultMaxNodes;
+  }
+  return max_nodes;
+}
 }  // namespace
 
 EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
@@ -45,6 +59,7 @@ EagerExecutor::EagerExecutor(bool async, bool enable_streaming_enqueue,
       last_eager_client_(nullptr),
       enable_async_wait_for_remote_function_(
           IsAsyncWaitForRemoteFunctionEnabled()),
+      max_coalesced_remote_nodes_(MaxCoalescedRemoteNodes()),
       enable_streaming_enqueue_(enable_streaming_enqueue),
       in_flight_nodes_limit_(in_flight_nodes_limit) {
   if (async && in_flight_nodes_limit_ > 0) {
@@ -161,7 +176,7 @@ absl::Status EagerExecutor::AddOrExecute(std::unique_ptr<EagerNode> node) {
     } else {
       status = status_;
       if (status.ok()) {
-        node_queue_.push(std::move(item));
+        node_queue_.push_back(std::move(item));
         // If there were no previous nodes pending, wake the run thread to
         // start processing requests again.
         if (node_queue_.size() == 1) {
@@ -256,7 +271,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
     if (from_queue) {
       // Since this was from the async queue, pop it from the front of the queue
       DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
-      node_queue_.pop();
+      node_queue_.pop_front();
     } else if (async) {
       // If it is an Async node then we will find the node in the unfinished
       // nodes list. However we only notify if we are at the front of the list
@@ -290,7 +305,7 @@ void EagerExecutor::NodeDone(const core::RefCountPtr<NodeItem>& item,
       }
       while (!node_queue_.empty()) {
         items_to_destroy.push_front(std::move(node_queue_.front()));
-        node_queue_.pop();
+        node_queue_.pop_front();
       }
       for (auto& it : unfinished_nodes_) {
         items_to_destroy.push_front(std::move(it.second));
@@ -349,6 +364,7 @@ void EagerExecutor::Run() {
       gtl::MakeCleanup([this] { thread_exited_notification_.Notify(); });
   while (true) {
     core::RefCountPtr<NodeItem> curr_item;
+    std::vector<core::RefCountPtr<NodeItem>> coalesced_items;
     {
       tensorflow::mutex_lock l(node_queue_mutex_);
       while (node_queue_.empty() || !status_.ok()) {
@@ -364,8 +380,34 @@ void EagerExecutor::Run() {
       // and register a notification for its completion.
       curr_item.reset(node_queue_.front().get());
       curr_item->Ref();
+      // Remote nodes queued behind this one may be run together with it.
+      AsyncRemoteExecuteNode* remote_node =
+          curr_item->node->AsAsyncRemoteExecuteNode();
+      if (remote_node != nullptr) {
+        for (auto it = node_queue_.begin() + 1;
+             it != node_queue_.end() &&
+             static_cast<int64_t>(coalesced_items.size()) + 1 <
+                 max_coalesced_remote_nodes_;
+             ++it) {
+          AsyncRemoteExecuteNode* next =
+              (*it)->node->AsAsyncRemoteExecuteNode();
+          if (next == nullptr ||
+              next->eager_client() != remote_node->eager_client() ||
+              !remote_node->CanCoalesceWith(next)) {
+            break;
+          }
+          (*it)->Ref();
+          coalesced_items.emplace_back(it->get());
+        }
+      }
+    }
+    absl::Status status;
+    if (coalesced_items.empty()) {
+      status = RunItem(std::move(curr_item), /*from_queue=*/true);
+    } else {
+      coalesced_items.insert(coalesced_items.begin(), std::move(curr_item));
+      status = RunCoalescedItems(std::move(coalesced_items));
     }
-    absl::Status status = RunItem(std::move(curr_item), /*from_queue=*/true);
     if (!status.ok()) {
       VLOG(1) << "Failed to run item: " << status;
     }
@@ -378,28 +420,11 @@ absl::Status EagerExecutor::RunItem(core::RefCountPtr<NodeItem> item,
            << item->node->DebugString();
   AsyncRemoteExecuteNode* async_remote_node =
       item->node->AsAsyncRemoteExecuteNode();
-  if (enable_async_wait_for_remote_function_) {
-    if (async_remote_node != nullptr) {
-      if (last_eager_client_ != nullptr &&
-          async_remote_node->eager_client() != nullptr &&
-          last_eager_client_ != async_remote_node->eager_client()) {
-        // Running a remote function, need to sync if the function is going to
-        // different device than last time we run remote distributed function.
-        DVLOG(3) << "Executing Sync Executor for node" << item->id;
-        absl::Status status = async_remote_node->SyncExecutors();
-        if (!status.ok()) {
-          NodeDone(item, status, from_queue);
-          return status;
-        }
-        last_eager_client_ = nullptr;
-      }
-      if (async_remote_node->eager_client() != nullptr &&
-          async_remote_node->needs_remote_inputs() &&
-          async_remote_node->allow_multiple_pending_requests()) {
-        // We are running remote distributed function, update
-        // last_remote_device_name_.
-        last_eager_client_ = async_remote_node->eager_client();
-      }
+  if (async_remote_node != nullptr) {
+    absl::Status status = MaybeSyncExecutors(async_remote_node);
+    if (!status.ok()) {
+      NodeDone(item, status, from_queue);
+      return status;
     }
   }
 
@@ -425,6 +450,76 @@ absl::Status EagerExecutor::RunItem(core::RefCountPtr<NodeItem> item,
   return status();
 }
 
+absl::Status EagerExecutor::RunCoalescedItems(
+    std::vector<core::RefCountPtr<NodeItem>> items) {
+  DVLOG(3) << "Running " << items.size() << " coalesced nodes: [id "
+           << items.front()->id << " to " << items.back()->id << "]";
+  std::vector<AsyncRemoteExecuteNode*> nodes;
+  nodes.reserve(items.size());
+  for (const auto& item : items) {
+    AsyncRemoteExecuteNode* node = item->node->AsAsyncRemoteExecuteNode();
+    // Only the first node may need to sync the executors, the others run on
+    // the same worker.
+    absl::Status status = MaybeSyncExecutors(node);
+    if (!status.ok()) {
+      // None of the items has run. They are still at the front of the queue,
+      // in order.
+      for (const auto& item : items) {
+        NodeDone(item, status, /*from_queue=*/true);
+      }
+      return status;
+    }
+    nodes.push_back(node);
+  }
+
+  std::vector<StatusCallback> dones;
+  dones.reserve(items.size());
+  {
+    // Move all the items at once, so that an error can't abort only some of
+    // them.
+    tensorflow::mutex_lock l(node_queue_mutex_);
+    if (!status_.ok()) {
+      return status_;
+    }
+    for (auto& item : items) {
+      DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
+      node_queue_.pop_front();
+      item->state = NodeState::kSCHEDULED;
+      NodeItem* async_ref = item.get();
+      async_ref->Ref();
+      dones.push_back([this, async_ref](const absl::Status& status) {
+        core::RefCountPtr<NodeItem> async_item(async_ref);
+        NodeDone(async_item, status, false);
+      });
+      unfinished_nodes_.emplace_hint(unfinished_nodes_.end(), item->id,
+                                     std::move(item));
+    }
+  }
+
+  nodes.front()->RunAsyncCoalesced(absl::MakeConstSpan(nodes).subspan(1),
+                                   absl::MakeSpan(dones));
+  return status();
+}
+
+absl::Status EagerExecutor::MaybeSyncExecutors(AsyncRemoteExecuteNode* node) {
+  if (!enable_async_wait_for_remote_function_) return absl::OkStatus();
+  if (last_eager_client_ != nullptr && node->eager_client() != nullptr &&
+      last_eager_client_ != node->eager_client()) {
+    // Running a remote function, need to sync if the function is going to
+    // different device than last time we run remote distributed function.
+    DVLOG(3) << "Executing Sync Executor for node " << node->DebugString();
+    TF_RETURN_IF_ERROR(node->SyncExecutors());
+    last_eager_client_ = nullptr;
+  }
+  if (node->eager_client() != nullptr && node->needs_remote_inputs() &&
+      node->allow_multiple_pending_requests()) {
+    // We are running remote distributed function, update
+    // last_remote_device_name_.
+    last_eager_client_ = node->eager_client();
+  }
+  return absl::OkStatus();
+}
+
 absl::Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
                                              bool from_queue) {
   tensorflow::mutex_lock l(node_queue_mutex_);
@@ -434,7 +529,7 @@ absl::Status EagerExecutor::MoveToUnfinished(core::RefCountPtr<NodeItem> item,
 
   if (from_queue) {
     DCHECK(!node_queue_.empty() && item.get() == node_queue_.front().get());
-    node_queue_.pop();
+    node_queue_.pop_front();
   }
 
   DVLOG(3) << "Add Node: [id " << item->id << "] to unfinished map.";
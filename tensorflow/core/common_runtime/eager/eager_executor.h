@@ -18,16 +18,19 @@ limitations under the License.
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
-#include <queue>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
@@ -47,7 +50,8 @@ class AsyncEagerNode;
 class AsyncRemoteExecuteNode;
 namespace eager {
 class EagerClient;
-}
+class RemoteExecuteNode;
+}  // namespace eager
 
 // A unit of execution for the EagerExecutor class below. Example subclasses
 // encapsulate execution of a TFE_Op, or copying a TFE_TensorHandle from one
@@ -104,6 +108,27 @@ class AsyncRemoteExecuteNode : public AsyncEagerNode {
   virtual bool needs_remote_inputs() const = 0;
   virtual bool allow_multiple_pending_requests() const = 0;
   virtual absl::Status SyncExecutors() = 0;
+
+  virtual eager::RemoteExecuteNode* AsRemoteExecuteNode() { return nullptr; }
+
+  // When several nodes are queued back to back, the executor may run them
+  // with a single call to RunAsyncCoalesced() on the first one, e.g. to send
+  // their requests to the remote worker at once.
+  //
+  // Returns whether `next`, queued after this node and the nodes already
+  // coalesced with it, can be run by RunAsyncCoalesced() on this node.
+  virtual bool CanCoalesceWith(AsyncRemoteExecuteNode* next) { return false; }
+
+  // Runs this node and the nodes `next` queued after it. `dones` has one
+  // callback per node, starting with this node's, called with the status of
+  // that node alone.
+  virtual void RunAsyncCoalesced(absl::Span<AsyncRemoteExecuteNode* const> next,
+                                 absl::Span<StatusCallback> dones) {
+    RunAsync(std::move(dones[0]));
+    for (size_t i = 0; i < next.size(); ++i) {
+      next[i]->RunAsync(std::move(dones[i + 1]));
+    }
+  }
 };
 
 // A class for handling async execution (see TFE_ContextSetAsync).
@@ -213,6 +238,13 @@ class EagerExecutor {
   void Run();
 
   absl::Status RunItem(core::RefCountPtr<NodeItem> item, bool from_queue);
+  // Runs the AsyncRemoteExecuteNodes of `items`, the first items of the
+  // queue, with a single call to RunAsyncCoalesced().
+  absl::Status RunCoalescedItems(
+      std::vector<core::RefCountPtr<NodeItem>> items);
+  // Syncs the executors before running `node` if it runs on a different
+  // worker than the last remote function with remote inputs.
+  absl::Status MaybeSyncExecutors(AsyncRemoteExecuteNode* node);
   absl::Status MoveToUnfinished(core::RefCountPtr<NodeItem> item,
                                 bool from_queue);
 
@@ -233,7 +265,7 @@ class EagerExecutor {
   condition_variable nodes_done_ TF_GUARDED_BY(node_queue_mutex_);
 
   // Queue of pending NodeItems. Ordered by NodeItem::id.
-  std::queue<core::RefCountPtr<NodeItem>> node_queue_
+  std::deque<core::RefCountPtr<NodeItem>> node_queue_
       TF_GUARDED_BY(node_queue_mutex_);
 
   // Ordered by NodeItem::id.
@@ -270,6 +302,11 @@ class EagerExecutor {
 
   const bool enable_async_wait_for_remote_function_;
 
+  // The maximum number of queued AsyncRemoteExecuteNodes run together, see
+  // AsyncRemoteExecuteNode::RunAsyncCoalesced(). Set with
+  // TF_EAGER_MAX_COALESCED_REMOTE_NODES, 1 disables coalescing.
+  const int64_t max_coalesced_remote_nodes_;
+
   // Enable sending remote executions through streaming enqueue.
   const bool enable_streaming_enqueue_;
 
@@ -15,8 +15,12 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "xla/tsl/platform/status.h"
 #include "xla/tsl/protobuf/error_codes.pb.h"
@@ -102,6 +106,68 @@ class TestAsyncEagerNode : public AsyncEagerNode {
   absl::Status run_return_status_;
 };
 
+// Blocks the executor thread until `notification` is notified.
+class BlockingAsyncEagerNode : public AsyncEagerNode {
+ public:
+  explicit BlockingAsyncEagerNode(absl::Notification* notification)
+      : notification_(notification) {}
+
+  void RunAsync(StatusCallback done) override {
+    notification_->WaitForNotification();
+    done(absl::OkStatus());
+  }
+
+  void Abort(absl::Status status) override {}
+  std::string DebugString() const override { return "blockingEagerNode"; }
+
+ private:
+  absl::Notification* notification_;
+};
+
+// Records the ids of the nodes run by each call to RunAsync() or
+// RunAsyncCoalesced() in `runs`. Nodes with the same `worker` can be
+// coalesced.
+class TestAsyncRemoteExecuteNode : public AsyncRemoteExecuteNode {
+ public:
+  TestAsyncRemoteExecuteNode(int id, int worker,
+                             std::vector<std::vector<int>>* runs)
+      : id_(id), worker_(worker), runs_(runs) {}
+
+  void RunAsync(StatusCallback done) override {
+    runs_->push_back({id_});
+    done(absl::OkStatus());
+  }
+
+  bool CanCoalesceWith(AsyncRemoteExecuteNode* next) override {
+    return static_cast<TestAsyncRemoteExecuteNode*>(next)->worker_ == worker_;
+  }
+
+  void RunAsyncCoalesced(absl::Span<AsyncRemoteExecuteNode* const> next,
+                         absl::Span<StatusCallback> dones) override {
+    std::vector<int>& run = runs_->emplace_back();
+    run.push_back(id_);
+    for (AsyncRemoteExecuteNode* node : next) {
+      run.push_back(static_cast<TestAsyncRemoteExecuteNode*>(node)->id_);
+    }
+    for (StatusCallback& done : dones) {
+      done(absl::OkStatus());
+    }
+  }
+
+  const eager::EagerClient* eager_client() const override { return nullptr; }
+  bool needs_remote_inputs() const override { return false; }
+  bool allow_multiple_pending_requests() const override { return true; }
+  absl::Status SyncExecutors() override { return absl::OkStatus(); }
+
+  void Abort(absl::Status status) override {}
+  std::string DebugString() const override { return "testRemoteNode"; }
+
+ private:
+  const int id_;
+  const int worker_;
+  std::vector<std::vector<int>>* runs_;
+};
+
 TEST(EagerExecutorTest, TestSyncExecutorWithEagerNode) {
   auto sync_executor = std::make_unique<EagerExecutor>(
       /*async=*/false, /*enable_streaming_enqueue=*/true);
@@ -269,6 +335,34 @@ TEST(EagerExecutorTest, TestAsyncExecutorFailRunWithAsyncNode) {
   ASSERT_EQ(state->read_state(), TestState::State::kFailure);
 }
 
+TEST(EagerExecutorTest, TestAsyncExecutorCoalescesQueuedRemoteNodes) {
+  auto async_executor = std::make_unique<EagerExecutor>(
+      /*async=*/true, /*enable_streaming_enqueue=*/true);
+
+  // Queue the remote nodes while the executor is blocked.
+  absl::Notification unblock;
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<BlockingAsyncEagerNode>(&unblock)));
+  std::vector<std::vector<int>> runs;
+  const int workers[] = {0, 0, 0, 1, 1, 0};
+  for (int id = 0; id < 6; ++id) {
+    TF_ASSERT_OK(async_executor->AddOrExecute(
+        std::make_unique<TestAsyncRemoteExecuteNode>(id, workers[id], &runs)));
+  }
+  auto state = std::make_unique<TestState>();
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestAsyncEagerNode>(state.get())));
+  TF_ASSERT_OK(async_executor->AddOrExecute(
+      std::make_unique<TestAsyncRemoteExecuteNode>(6, 0, &runs)));
+  unblock.Notify();
+  TF_ASSERT_OK(async_executor->WaitForAllPendingNodes());
+
+  // Only consecutive nodes are coalesced, so the order is kept.
+  EXPECT_EQ(runs, (std::vector<std::vector<int>>{{0, 1, 2}, {3, 4}, {5}, {6}}));
+  EXPECT_EQ(state->read_state(), TestState::State::kSuccess);
+  TF_ASSERT_OK(async_executor->ShutDown());
+}
+
 TEST(EagerExecutorTest, TestAsyncExecutorAddNodesAfterShutdown) {
   auto async_executor = std::make_unique<EagerExecutor>(
       /*async=*/true, /*enable_streaming_enqueue=*/true);
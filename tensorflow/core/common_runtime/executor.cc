@@ -37,6 +37,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -184,6 +185,12 @@ class ExecutorImpl : public Executor {
   absl::Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
     kernel_stats_.Initialize(immutable_state_.graph_view());
+    const LocalExecutorParams& params = immutable_state_.params();
+    if (params.enable_static_memory_plan &&
+        params.device->device_type() == DEVICE_CPU) {
+      TF_RETURN_IF_ERROR(StaticMemoryPlan::Compute(graph, &memory_plan_));
+      if (memory_plan_->empty()) memory_plan_.reset();
+    }
     return absl::OkStatus();
   }
 
@@ -262,6 +269,8 @@ class ExecutorImpl : public Executor {
 
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
+  // Non-null if outputs are served from a per-step slab.
+  std::unique_ptr<StaticMemoryPlan> memory_plan_;
 
   ExecutorImpl(const ExecutorImpl&) = delete;
   void operator=(const ExecutorImpl&) = delete;
@@ -321,7 +330,8 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                const StaticMemoryPlan* memory_plan);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -433,6 +443,8 @@ class ExecutorState {
   absl::optional<ManagedStackTrace> stack_trace_ = std::nullopt;
   // If not null, use this device to schedule intra-op operation
   std::unique_ptr<DeviceBase> user_device_;
+  // If not null, serves the outputs planned by the executor's memory plan.
+  std::unique_ptr<StaticMemorySlab> memory_slab_;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
@@ -457,7 +469,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats,
+    const StaticMemoryPlan* memory_plan)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -493,6 +506,11 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (memory_plan != nullptr) {
+    memory_slab_ = std::make_unique<StaticMemorySlab>(
+        *memory_plan,
+        immutable_state_.params().device->GetAllocator(AllocatorAttributes()));
+  }
 }
 
 template <class PropagatorStateType>
@@ -838,6 +856,9 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   // Set the device_context for this device, if it exists.
   params->op_device_context = device_context_;
 
+  // Serve planned outputs from this step's slab, if any.
+  params->planned_output_allocator = memory_slab_.get();
+
   absl::Status s;
   NodeExecStatsInterface* stats = nullptr;
 
@@ -951,6 +972,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
 
       // Set up compute params.
       params->op_kernel = item.kernel;
+      params->planned_output_node_id = item.node_id;
       params->frame_iter = propagator_.GetFrameAndIter(tagged_node);
       params->is_input_dead = is_input_dead;
       params->output_attr_array = item.output_attrs();
@@ -1552,15 +1574,16 @@ void ExecutorState<PropagatorStateType>::Finish() {
 
 void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
   if (OpOrderDeterminismRequired()) {
-    (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
-                                               &kernel_stats_))
+    (new ExecutorState<OrderedPropagatorState>(
+         args, immutable_state_, &kernel_stats_, memory_plan_.get()))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        memory_plan_.get()))
         ->RunAsync(std::move(done));
   } else {
-    (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+    (new ExecutorState<SimplePropagatorState>(
+         args, immutable_state_, &kernel_stats_, memory_plan_.get()))
         ->RunAsync(std::move(done));
   }
 }
@@ -50,6 +50,10 @@ struct LocalExecutorParams {
 
   // Whether control flow nodes are allowed to be executed synchronously.
   bool allow_control_flow_sync_execution = false;
+
+  // Whether to compute a static memory plan for the graph and serve the
+  // planned op outputs of each step from a single slab. Only honored on CPU.
+  bool enable_static_memory_plan = false;
 };
 
 }  // end namespace tensorflow
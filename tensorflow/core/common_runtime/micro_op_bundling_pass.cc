@@ -0,0 +1,357 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/micro_op_bundling_pass.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/platform/errors.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/config/flag_defs.h"
+#include "tensorflow/core/config/flags.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/dump_graph.h"
+
+namespace tensorflow {
+namespace {
+
+// Smaller clusters are not worth rewriting.
+constexpr int kMinBundleSize = 2;
+
+// Bounds the amount of work serialized into a single kernel, which the
+// executor could otherwise spread over its threads.
+constexpr int kMaxBundleSize = 256;
+
+// The number of nodes the cycle check may visit before it conservatively
+// rejects a merge, so that the pass stays linear in the size of the graph.
+constexpr int kMaxCycleCheckVisits = 1024;
+
+// Keep in sync with MicroOpBundleOp in kernels/micro_op_bundle_op.cc.
+bool IsBundleableOp(const Node* n) {
+  static const auto* const ops = new absl::flat_hash_set<absl::string_view>({
+      "Abs",        "Add",          "AddV2",      "Cast",       "Equal",
+      "Greater",    "GreaterEqual", "Identity",   "Less",       "LessEqual",
+      "LogicalAnd", "LogicalNot",   "LogicalOr",  "Maximum",    "Minimum",
+      "Mul",        "Neg",          "NotEqual",   "RealDiv",    "Select",
+      "SelectV2",   "Sub",
+  });
+  return ops->contains(n->type_string());
+}
+
+bool IsBundleableType(DataType dtype) {
+  return dtype == DT_FLOAT || dtype == DT_DOUBLE || dtype == DT_INT32 ||
+         dtype == DT_INT64 || dtype == DT_BOOL;
+}
+
+// `node`'s device is a CPU.
+bool HasCpuDevice(const Node* node) {
+  DeviceNameUtils::ParsedName device;
+  if (!DeviceNameUtils::ParseFullName(node->assigned_device_name(), &device))
+    return false;
+  return device.type == "CPU";
+}
+
+bool IsScalar(shape_inference::InferenceContext* c,
+              shape_inference::ShapeHandle shape) {
+  return c->RankKnown(shape) && c->Rank(shape) == 0;
+}
+
+// Returns true iff `n` can be evaluated by a _MicroOpBundle.
+bool IsCandidate(const Node* n, const ShapeRefiner& refiner) {
+  if (!n->IsOp() || !IsBundleableOp(n) || !HasCpuDevice(n)) return false;
+  if (n->num_outputs() != 1 || !IsBundleableType(n->output_type(0))) {
+    return false;
+  }
+  for (int i = 0; i < n->num_inputs(); ++i) {
+    if (!IsBundleableType(n->input_type(i))) return false;
+  }
+  bool truncate = false;
+  if (TryGetNodeAttr(n->attrs(), "Truncate", &truncate) && truncate) {
+    return false;
+  }
+  shape_inference::InferenceContext* c = refiner.GetContext(n);
+  if (c == nullptr) return false;
+  for (int i = 0; i < c->num_inputs(); ++i) {
+    if (!IsScalar(c, c->input(i))) return false;
+  }
+  return IsScalar(c, c->output(0));
+}
+
+// Grows clusters of candidates visited in topological order. A candidate
+// joins the cluster of one of its data inputs unless that would create a
+// cycle once every cluster is contracted into a single node.
+class Clusterer {
+ public:
+  explicit Clusterer(const Graph& graph)
+      : cluster_of_(graph.num_node_ids(), -1),
+        node_stamps_(graph.num_node_ids(), 0) {}
+
+  void Add(Node* n) {
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) continue;
+      const int cluster = cluster_of_[e->src()->id()];
+      if (cluster < 0 ||
+          static_cast<int>(clusters_[cluster].size()) >= kMaxBundleSize ||
+          clusters_[cluster].front()->assigned_device_name() !=
+              n->assigned_device_name() ||
+          CreatesCycle(n, cluster)) {
+        continue;
+      }
+      cluster_of_[n->id()] = cluster;
+      clusters_[cluster].push_back(n);
+      return;
+    }
+    cluster_of_[n->id()] = clusters_.size();
+    clusters_.push_back({n});
+    cluster_stamps_.push_back(0);
+  }
+
+  // Members of each cluster, in topological order.
+  const std::vector<std::vector<Node*>>& clusters() const { return clusters_; }
+
+ private:
+  // Returns true iff `n` depends on `cluster` through a node outside of it.
+  // A node of another cluster stands for that whole cluster, as the cluster
+  // is going to be a single node as well.
+  bool CreatesCycle(const Node* n, int cluster) {
+    ++stamp_;
+    std::vector<const Node*> stack;
+    const auto push_inputs = [&](const Node* node) {
+      for (const Edge* e : node->in_edges()) {
+        const Node* src = e->src();
+        if (node_stamps_[src->id()] == stamp_) continue;
+        node_stamps_[src->id()] = stamp_;
+        stack.push_back(src);
+      }
+    };
+    for (const Edge* e : n->in_edges()) {
+      const Node* src = e->src();
+      if (cluster_of_[src->id()] == cluster) continue;
+      if (node_stamps_[src->id()] == stamp_) continue;
+      node_stamps_[src->id()] = stamp_;
+      stack.push_back(src);
+    }
+    int visits = 0;
+    while (!stack.empty()) {
+      const Node* node = stack.back();
+      stack.pop_back();
+      const int node_cluster = cluster_of_[node->id()];
+      if (node_cluster == cluster || ++visits > kMaxCycleCheckVisits) {
+        return true;
+      }
+      if (node_cluster < 0) {
+        push_inputs(node);
+      } else if (cluster_stamps_[node_cluster] != stamp_) {
+        cluster_stamps_[node_cluster] = stamp_;
+        for (const Node* member : clusters_[node_cluster]) push_inputs(member);
+      }
+    }
+    return false;
+  }
+
+  std::vector<int> cluster_of_;
+  std::vector<std::vector<Node*>> clusters_;
+  // Visit marks of the current cycle check.
+  int stamp_ = 0;
+  std::vector<int> node_stamps_;
+  std::vector<int> cluster_stamps_;
+};
+
+// Replaces `members`, given in topological order, with one _MicroOpBundle.
+absl::Status Bundle(Graph* graph, const std::vector<Node*>& members) {
+  const absl::flat_hash_set<const Node*> member_set(members.begin(),
+                                                    members.end());
+
+  // Registers of the tensors read by the bundle, inputs first.
+  absl::flat_hash_map<std::pair<const Node*, int>, int32_t> registers;
+  std::vector<NodeDefBuilder::NodeOut> inputs;
+  std::vector<std::pair<Node*, int>> input_srcs;
+  for (const Node* member : members) {
+    for (int i = 0; i < member->num_inputs(); ++i) {
+      const Edge* e;
+      TF_RETURN_IF_ERROR(member->input_edge(i, &e));
+      if (member_set.contains(e->src())) continue;
+      if (registers
+              .try_emplace({e->src(), e->src_output()},
+                           static_cast<int32_t>(inputs.size()))
+              .second) {
+        inputs.emplace_back(e->src()->name(), e->src_output(),
+                            member->input_type(i));
+        input_srcs.emplace_back(e->src(), e->src_output());
+      }
+    }
+  }
+
+  std::vector<std::string> ops;
+  DataTypeVector op_types;
+  std::vector<int32_t> op_num_operands;
+  std::vector<int32_t> op_operands;
+  for (const Node* member : members) {
+    for (int i = 0; i < member->num_inputs(); ++i) {
+      const Edge* e;
+      TF_RETURN_IF_ERROR(member->input_edge(i, &e));
+      op_operands.push_back(registers.at({e->src(), e->src_output()}));
+    }
+    op_num_operands.push_back(member->num_inputs());
+    registers[{member, 0}] = inputs.size() + ops.size();
+    ops.push_back(member->type_string());
+    op_types.push_back(member->output_type(0));
+  }
+
+  struct Consumer {
+    Node* dst;
+    int dst_input;
+    int result;
+  };
+  std::vector<int32_t> result_registers;
+  DataTypeVector result_types;
+  std::vector<Consumer> consumers;
+  std::vector<Node*> control_inputs;
+  std::vector<Node*> control_outputs;
+  for (Node* member : members) {
+    int result = -1;
+    for (const Edge* e : member->out_edges()) {
+      if (member_set.contains(e->dst())) continue;
+      if (e->IsControlEdge()) {
+        control_outputs.push_back(e->dst());
+        continue;
+      }
+      if (result < 0) {
+        result = result_registers.size();
+        result_registers.push_back(registers.at({member, 0}));
+        result_types.push_back(member->output_type(0));
+      }
+      consumers.push_back({e->dst(), e->dst_input(), result});
+    }
+    for (const Edge* e : member->in_edges()) {
+      if (e->IsControlEdge() && !member_set.contains(e->src())) {
+        control_inputs.push_back(e->src());
+      }
+    }
+  }
+  // The op needs at least one output, even if nothing reads the results.
+  if (result_registers.empty()) {
+    result_registers.push_back(registers.at({members.back(), 0}));
+    result_types.push_back(members.back()->output_type(0));
+  }
+
+  NodeDef def;
+  TF_RETURN_IF_ERROR(
+      NodeDefBuilder(graph->NewName(
+                         absl::StrCat(members.front()->name(), "/micro_ops")),
+                     "_MicroOpBundle")
+          .Input(inputs)
+          .Attr("Tresults", result_types)
+          .Attr("ops", ops)
+          .Attr("op_types", op_types)
+          .Attr("op_num_operands", op_num_operands)
+          .Attr("op_operands", op_operands)
+          .Attr("result_registers", result_registers)
+          .Device(members.front()->requested_device())
+          .Finalize(&def));
+  TF_ASSIGN_OR_RETURN(Node * bundle, graph->AddNode(std::move(def)));
+  bundle->set_assigned_device_name(members.front()->assigned_device_name());
+
+  for (int i = 0; i < static_cast<int>(input_srcs.size()); ++i) {
+    graph->AddEdge(input_srcs[i].first, input_srcs[i].second, bundle, i);
+  }
+  for (Node* src : control_inputs) graph->AddControlEdge(src, bundle);
+  for (Node* dst : control_outputs) graph->AddControlEdge(bundle, dst);
+  for (const Consumer& consumer : consumers) {
+    TF_RETURN_IF_ERROR(graph->UpdateEdge(bundle, consumer.result,
+                                         consumer.dst, consumer.dst_input));
+  }
+  for (Node* member : members) graph->RemoveNode(member);
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status MicroOpBundlingPass::Run(
+    const GraphOptimizationPassOptions& options) {
+  if (!flags::Global().enable_micro_op_bundling.value()) {
+    return absl::OkStatus();
+  }
+  if (options.graph == nullptr) {
+    VLOG(1) << "No graph in micro_op_bundling_pass.";
+    return absl::OkStatus();
+  }
+  Graph* graph = options.graph->get();
+
+  // A bundle is dead as soon as one of its inputs is, whereas its members
+  // could be dead independently of each other.
+  for (const Node* n : graph->op_nodes()) {
+    if (n->IsControlFlow() || n->IsRecv()) {
+      VLOG(1) << "micro_op_bundling_pass skipped graph with " << n->name();
+      return absl::OkStatus();
+    }
+  }
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("before_micro_op_bundling_pass", *graph,
+                               options.flib_def);
+  }
+
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  ShapeRefiner refiner(graph->versions(), graph->op_registry());
+  refiner.set_require_shape_inference_fns(false);
+  Clusterer clusterer(*graph);
+  for (Node* n : order) {
+    // Nodes downstream of a shape inference failure are not candidates.
+    if (refiner.AddNode(n).ok() && IsCandidate(n, refiner)) clusterer.Add(n);
+  }
+
+  int num_bundles = 0;
+  int num_bundled_nodes = 0;
+  for (const std::vector<Node*>& members : clusterer.clusters()) {
+    if (static_cast<int>(members.size()) < kMinBundleSize) continue;
+    TF_RETURN_IF_ERROR(Bundle(graph, members));
+    ++num_bundles;
+    num_bundled_nodes += members.size();
+  }
+  VLOG(1) << "micro_op_bundling_pass replaced " << num_bundled_nodes
+          << " nodes with " << num_bundles << " bundles.";
+
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("after_micro_op_bundling_pass", *graph,
+                               options.flib_def);
+  }
+  return absl::OkStatus();
+}
+
+// Runs after the XLA clustering passes, so that ops they compile are not
+// bundled.
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::POST_REWRITE_FOR_EXEC, 50,
+                      MicroOpBundlingPass);
+
+}  // namespace tensorflow
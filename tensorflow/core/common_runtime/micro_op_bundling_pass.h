@@ -0,0 +1,47 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_MICRO_OP_BUNDLING_PASS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_MICRO_OP_BUNDLING_PASS_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+
+// Fuses connected clusters of cheap scalar ops placed on the same CPU device
+// into `_MicroOpBundle` nodes, which evaluate the whole cluster as one kernel
+// invocation. For graphs made of thousands of scalar ops, such as the ones
+// produced by feature engineering code, the per-node cost of the executor
+// dominates the cost of the ops themselves.
+//
+// For example, the graph:
+//   x -> Greater(x, c0) -> Select(_, x, c1) -> Cast -> y
+// is rewritten to:
+//   {x, c0, c1} -> _MicroOpBundle -> y
+//
+// Only elementwise ops whose inputs and outputs are known to be scalars are
+// bundled. Graphs with control flow are left untouched, since a bundle with
+// one dead input would be dead as a whole. The pass is disabled unless the
+// `enable_micro_op_bundling` flag is set.
+
+namespace tensorflow {
+
+class MicroOpBundlingPass : public GraphOptimizationPass {
+ public:
+  absl::Status Run(const GraphOptimizationPassOptions& options) override;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_MICRO_OP_BUNDLING_PASS_H_
@@ -0,0 +1,254 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/micro_op_bundling_pass.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/cc/client/client_session.h"
+#include "tensorflow/cc/framework/ops.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/const_op.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/config/flag_defs.h"
+#include "tensorflow/core/config/flags.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+const char kCpu0[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+
+class MicroOpBundlingPassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    flags::Global().enable_micro_op_bundling.reset(true);
+  }
+  void TearDown() override {
+    flags::Global().enable_micro_op_bundling.reset(false);
+  }
+};
+
+void AssignCpu(Graph* graph) {
+  for (Node* n : graph->op_nodes()) n->set_assigned_device_name(kCpu0);
+}
+
+absl::Status RunPass(std::unique_ptr<Graph>* graph) {
+  GraphOptimizationPassOptions options;
+  options.graph = graph;
+  MicroOpBundlingPass pass;
+  return pass.Run(options);
+}
+
+std::vector<const Node*> Bundles(const Graph& graph) {
+  std::vector<const Node*> bundles;
+  for (const Node* n : graph.op_nodes()) {
+    if (n->type_string() == "_MicroOpBundle") bundles.push_back(n);
+  }
+  return bundles;
+}
+
+std::vector<std::string> BundledOps(const Node* bundle) {
+  std::vector<std::string> ops;
+  TF_CHECK_OK(GetNodeAttr(bundle->attrs(), "ops", &ops));
+  return ops;
+}
+
+TEST_F(MicroOpBundlingPassTest, BundlesScalarChain) {
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  {
+    Scope scope = Scope::NewRootScope().ExitOnError();
+    Output x = ops::Const(scope.WithOpName("x"), 1.0f);
+    Output c = ops::Const(scope.WithOpName("c"), 2.0f);
+    Output sum = ops::AddV2(scope.WithOpName("sum"), x, c);
+    Output greater = ops::Greater(scope.WithOpName("greater"), sum, c);
+    Output select = ops::Select(scope.WithOpName("select"), greater, sum, x);
+    Output cast = ops::Cast(scope.WithOpName("cast"), select, DT_INT64);
+    ops::Exp(scope.WithOpName("exp"), select);
+    ops::Identity(scope.WithOpName("out"),
+                  ops::Reshape(scope, cast, ops::Const(scope, {1})));
+    TF_ASSERT_OK(scope.ToGraph(graph.get()));
+  }
+  AssignCpu(graph.get());
+  TF_ASSERT_OK(RunPass(&graph));
+
+  const std::vector<const Node*> bundles = Bundles(*graph);
+  ASSERT_EQ(bundles.size(), 1);
+  const Node* bundle = bundles[0];
+  EXPECT_EQ(BundledOps(bundle),
+            std::vector<std::string>({"AddV2", "Greater", "Select", "Cast"}));
+  EXPECT_EQ(bundle->assigned_device_name(), kCpu0);
+  EXPECT_EQ(bundle->num_inputs(), 2);
+  // `select` is read by Exp and `cast` by Reshape.
+  ASSERT_EQ(bundle->num_outputs(), 2);
+  EXPECT_EQ(bundle->output_type(0), DT_FLOAT);
+  EXPECT_EQ(bundle->output_type(1), DT_INT64);
+  for (const Node* n : graph->op_nodes()) {
+    EXPECT_NE(n->name(), "sum");
+    EXPECT_NE(n->name(), "cast");
+  }
+}
+
+TEST_F(MicroOpBundlingPassTest, DoesNotCreateCycles) {
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  {
+    Scope scope = Scope::NewRootScope().ExitOnError();
+    Output x = ops::Const(scope.WithOpName("x"), 1.0f);
+    Output neg = ops::Neg(scope.WithOpName("neg"), x);
+    // `neg` and `add` cannot be bundled, as `exp` depends on the former and
+    // the latter depends on `exp`.
+    Output exp = ops::Exp(scope.WithOpName("exp"), neg);
+    Output add = ops::AddV2(scope.WithOpName("add"), neg, exp);
+    ops::Abs(scope.WithOpName("abs"), add);
+    TF_ASSERT_OK(scope.ToGraph(graph.get()));
+  }
+  AssignCpu(graph.get());
+  TF_ASSERT_OK(RunPass(&graph));
+
+  const std::vector<const Node*> bundles = Bundles(*graph);
+  ASSERT_EQ(bundles.size(), 1);
+  EXPECT_EQ(BundledOps(bundles[0]),
+            std::vector<std::string>({"AddV2", "Abs"}));
+}
+
+TEST_F(MicroOpBundlingPassTest, SkipsNonScalars) {
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  {
+    Scope scope = Scope::NewRootScope().ExitOnError();
+    Output x = ops::Const(scope.WithOpName("x"), {1.0f, 2.0f});
+    ops::Neg(scope.WithOpName("neg1"), ops::Neg(scope.WithOpName("neg0"), x));
+    TF_ASSERT_OK(scope.ToGraph(graph.get()));
+  }
+  AssignCpu(graph.get());
+  TF_ASSERT_OK(RunPass(&graph));
+  EXPECT_TRUE(Bundles(*graph).empty());
+}
+
+TEST_F(MicroOpBundlingPassTest, SkipsDisabled) {
+  flags::Global().enable_micro_op_bundling.reset(false);
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  {
+    Scope scope = Scope::NewRootScope().ExitOnError();
+    Output x = ops::Const(scope.WithOpName("x"), 1.0f);
+    ops::Neg(scope.WithOpName("neg1"), ops::Neg(scope.WithOpName("neg0"), x));
+    TF_ASSERT_OK(scope.ToGraph(graph.get()));
+  }
+  AssignCpu(graph.get());
+  TF_ASSERT_OK(RunPass(&graph));
+  EXPECT_TRUE(Bundles(*graph).empty());
+}
+
+TEST_F(MicroOpBundlingPassTest, SessionResultsMatch) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto x = ops::Placeholder(scope, DT_FLOAT);
+  auto y = ops::Placeholder(scope, DT_INT32);
+  // Feeds have unknown shapes once they are rewritten into arguments.
+  Output scalar_shape =
+      ops::Const(scope, Input::Initializer(std::vector<int32_t>{},
+                                           TensorShape({0})));
+  Output x_scalar = ops::Reshape(scope, x, scalar_shape);
+  Output y_scalar = ops::Reshape(scope, y, scalar_shape);
+  Output clipped =
+      ops::Minimum(scope, ops::Maximum(scope, x_scalar, 0.0f), 10.0f);
+  Output scaled =
+      ops::Mul(scope, clipped, ops::Cast(scope, y_scalar, DT_FLOAT));
+  Output large = ops::GreaterEqual(scope, scaled, 5.0f);
+  Output result = ops::SelectV2(
+      scope, ops::LogicalAnd(scope, large, ops::Less(scope, y_scalar, 3)),
+      ops::Sub(scope, scaled, 1.0f), ops::Neg(scope, scaled));
+
+  for (const auto& [x_value, y_value] :
+       std::vector<std::pair<float, int>>{{-1.0f, 2}, {4.0f, 2}, {20.0f, 5}}) {
+    std::vector<Tensor> expected;
+    flags::Global().enable_micro_op_bundling.reset(false);
+    {
+      ClientSession session(scope);
+      TF_ASSERT_OK(session.Run({{x, x_value}, {y, y_value}}, {result},
+                               &expected));
+    }
+    std::vector<Tensor> actual;
+    flags::Global().enable_micro_op_bundling.reset(true);
+    {
+      ClientSession session(scope);
+      TF_ASSERT_OK(session.Run({{x, x_value}, {y, y_value}}, {result},
+                               &actual));
+    }
+    test::ExpectTensorEqual<float>(expected[0], actual[0]);
+  }
+}
+
+// Sums `num_features` clipped and bucketized scalar features, the kind of
+// graph feature engineering code produces.
+Graph* FeatureGraph(int num_features, bool bundle) {
+  auto graph = std::make_unique<Graph>(OpRegistry::Global());
+  Node* zero = test::graph::Constant(graph.get(), test::AsScalar<float>(0));
+  Node* one = test::graph::Constant(graph.get(), test::AsScalar<float>(1));
+  Node* sum = test::graph::Constant(graph.get(), test::AsScalar<int64_t>(0));
+  for (int i = 0; i < num_features; ++i) {
+    Node* x = test::graph::Constant(graph.get(),
+                                    test::AsScalar<float>(i % 7 - 3));
+    Node* clipped = test::graph::Binary(
+        graph.get(), "Minimum",
+        test::graph::Binary(graph.get(), "Maximum", x, zero), one);
+    Node* positive = test::graph::Binary(graph.get(), "Greater", clipped, zero);
+    Node* value = test::graph::Select(graph.get(), positive, clipped, one);
+    sum = test::graph::Binary(graph.get(), "AddV2", sum,
+                              test::graph::Cast(graph.get(), value, DT_INT64));
+  }
+  if (bundle) {
+    AssignCpu(graph.get());
+    flags::Global().enable_micro_op_bundling.reset(true);
+    TF_CHECK_OK(RunPass(&graph));
+    flags::Global().enable_micro_op_bundling.reset(false);
+  }
+  return graph.release();
+}
+
+void BM_ScalarFeatures(::testing::benchmark::State& state) {
+  const int num_features = state.range(0);
+  const bool bundle = state.range(1);
+  test::Benchmark("cpu", FeatureGraph(num_features, bundle),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_features);
+}
+BENCHMARK(BM_ScalarFeatures)
+    ->UseRealTime()
+    ->ArgPair(16, false)
+    ->ArgPair(16, true)
+    ->ArgPair(256, false)
+    ->ArgPair(256, true)
+    ->ArgPair(4096, false)
+    ->ArgPair(4096, true);
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,226 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/point_to_point_reducer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+namespace {
+
+std::string TransferKey(const std::string& exec_key, int step, int src_rank,
+                        int dst_rank) {
+  return absl::StrCat(exec_key, ":", step, ":", src_rank, ":", dst_rank);
+}
+
+}  // namespace
+
+absl::Status PointToPointReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  if (col_params->instance.type != REDUCTION_COLLECTIVE ||
+      col_params->instance.impl_details.collective_name != name_) {
+    return absl::InternalError(absl::StrCat(
+        name_, " cannot run collective ",
+        col_params->instance.impl_details.collective_name, " of type ",
+        col_params->instance.type));
+  }
+  if (col_params->group.device_type != DEVICE_CPU) {
+    return absl::UnimplementedError(absl::StrCat(
+        name_, " only supports CPU devices, got ",
+        col_params->group.device_type.type_string()));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status PointToPointReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  DCHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void PointToPointReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  // Like `RingReducer`, this doesn't require non-overlapping collectives.
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+
+  if ((col_ctx_->input != col_ctx_->output) &&
+      (DMAHelper::base(col_ctx_->input) != DMAHelper::base(col_ctx_->output))) {
+    absl::Notification note;
+    absl::Status status;
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+        col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+        col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+        [&note, &status](const absl::Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+    if (!status.ok()) {
+      done(status);
+      return;
+    }
+  }
+
+  const int64_t total_elts = col_ctx_->output->NumElements();
+  block_elts_ = CollectiveAdapter::AlignedChunkElts(
+      DataTypeSize(col_ctx_->output->dtype()), total_elts, num_blocks());
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  ca_.reset(MakeCollectiveAdapter(col_ctx_->output, num_blocks(),
+                                  col_ctx_->device->GetAllocator(attr)));
+  absl::Status status;
+  {
+    tsl::profiler::TraceMe activity(
+        [&] { return absl::StrCat(name_, ":", col_ctx_->exec_key); },
+        tsl::profiler::TraceMeLevel::kInfo);
+    status = RunReduction();
+  }
+  ca_->ConsumeFinalValue(col_ctx_->output);
+  ca_.reset();
+  done(status);
+}
+
+Tensor PointToPointReducer::Blocks(int begin, int end) const {
+  const Tensor& flat = ca_->Value();
+  const int64_t total_elts = flat.NumElements();
+  const int64_t begin_elt = std::min(total_elts, begin * block_elts_);
+  const int64_t end_elt = std::min(total_elts, end * block_elts_);
+  // Empty ranges are taken from the front of the tensor, as in
+  // `CollectiveAdapter::ChunkAlias`, to stay within bounds.
+  if (begin_elt >= end_elt) return flat.Slice(0, 0);
+  return flat.Slice(begin_elt, end_elt);
+}
+
+Tensor PointToPointReducer::Scratch(const Tensor& t) const {
+  AllocatorAttributes attr = col_ctx_->op_ctx->output_alloc_attr(0);
+  return Tensor(col_ctx_->device->GetAllocator(attr), t.dtype(),
+                TensorShape({t.NumElements()}));
+}
+
+absl::Status PointToPointReducer::Exchange(int step,
+                                           absl::Span<const Transfer> sends,
+                                           absl::Span<Transfer> recvs) {
+  mutex mu;
+  int pending_count = 0;  // TF_GUARDED_BY(mu)
+  absl::Status status;    // TF_GUARDED_BY(mu)
+  condition_variable all_done;
+  auto on_done = [&mu, &pending_count, &status,
+                  &all_done](const absl::Status& s) {
+    mutex_lock l(mu);
+    status.Update(s);
+    if (--pending_count == 0) all_done.notify_all();
+  };
+
+  CollectiveRemoteAccess* remote_access = col_ctx_->col_exec->remote_access();
+  OpKernelContext* op_ctx = col_ctx_->op_ctx;
+  for (Transfer& recv : recvs) {
+    if (recv.tensor.NumElements() == 0) continue;
+    {
+      mutex_lock l(mu);
+      ++pending_count;
+    }
+    const CollGroupMember& peer = col_params_->group.members[recv.rank];
+    remote_access->RecvFromPeer(
+        peer.device.name(), peer.task, peer.is_local,
+        TransferKey(col_ctx_->exec_key, step, recv.rank, rank()),
+        col_ctx_->device, op_ctx->op_device_context(),
+        op_ctx->output_alloc_attr(0), &recv.tensor, col_ctx_->device_locality,
+        0 /*dev_to_dev_stream_index*/, op_ctx->cancellation_manager(),
+        on_done);
+  }
+  for (const Transfer& send : sends) {
+    if (send.tensor.NumElements() == 0) continue;
+    {
+      mutex_lock l(mu);
+      ++pending_count;
+    }
+    const CollGroupMember& peer = col_params_->group.members[send.rank];
+    remote_access->PostToPeer(
+        peer.device.name(), peer.task,
+        TransferKey(col_ctx_->exec_key, step, rank(), send.rank),
+        col_ctx_->device, op_ctx->op_device_context(),
+        op_ctx->output_alloc_attr(0), &send.tensor, col_ctx_->device_locality,
+        op_ctx->cancellation_manager(), on_done);
+  }
+
+  {
+    mutex_lock l(mu);
+    while (pending_count > 0) all_done.wait(l);
+  }
+  if (!status.ok()) return Abort(status);
+  return absl::OkStatus();
+}
+
+absl::Status PointToPointReducer::Merge(Tensor* output, Tensor* input) {
+  if (output->NumElements() == 0) return absl::OkStatus();
+  absl::Status s = collective_util::ComputeBinOp(
+      col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+      col_params_->merge_op, output, input);
+  if (!s.ok()) return Abort(s);
+  return absl::OkStatus();
+}
+
+absl::Status PointToPointReducer::Finalize(Tensor* output) {
+  if (col_params_->final_op == nullptr || output->NumElements() == 0) {
+    return absl::OkStatus();
+  }
+  Tensor group_size_tensor = ca_->Scalar(group_size());
+  absl::Status s = collective_util::ComputeBinOp(
+      col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+      col_params_->final_op, output, &group_size_tensor);
+  if (!s.ok()) return Abort(s);
+  return absl::OkStatus();
+}
+
+absl::Status PointToPointReducer::Abort(const absl::Status& s) {
+  // Peers may be blocked on a transfer with this member, so abort the
+  // outstanding ones unless the op is already being cancelled.
+  LOG(ERROR) << "Aborting " << name_ << " with " << s;
+  CancellationManager* cancel_mgr = col_ctx_->op_ctx->cancellation_manager();
+  if (cancel_mgr == nullptr ||
+      (!cancel_mgr->IsCancelled() && !cancel_mgr->IsCancelling())) {
+    col_ctx_->col_exec->StartAbort(s);
+  }
+  return s;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,102 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_POINT_TO_POINT_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_POINT_TO_POINT_REDUCER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+
+// Base class of the all-reduce implementations that run as a sequence of
+// blocking steps, in each of which a group member exchanges parts of its
+// tensor with a few peers.
+//
+// The tensor is viewed as a flat array of `num_blocks()` blocks of aligned
+// size, as in the ring algorithms, so that any range of blocks can be sent,
+// received or reduced in place. Only CPU devices are supported, where the
+// merge and final ops can run on the calling thread.
+class PointToPointReducer : public CollectiveImplementationInterface {
+ public:
+  explicit PointToPointReducer(std::string name) : name_(std::move(name)) {}
+  ~PointToPointReducer() override = default;
+
+  absl::Status InitializeCollectiveParams(
+      CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  absl::Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Runs the algorithm to completion before calling `done`. Must be called in
+  // a blockable thread.
+  void Run(StatusCallback done) override;
+
+ protected:
+  // A peer to send a tensor to, or receive a tensor from.
+  struct Transfer {
+    int rank;
+    Tensor tensor;
+  };
+
+  // Returns the number of blocks the tensor is divided into.
+  virtual int num_blocks() const = 0;
+
+  // Runs the algorithm on the output, which holds the input on entry.
+  virtual absl::Status RunReduction() = 0;
+
+  // Returns a tensor aliasing blocks [begin, end) of the output.
+  Tensor Blocks(int begin, int end) const;
+
+  // Returns a scratch tensor with the same number of elements as `t`.
+  Tensor Scratch(const Tensor& t) const;
+
+  // Posts `sends` and `recvs` of step `step` concurrently and waits for all of
+  // them. Both sides of a transfer skip it when the tensor is empty.
+  absl::Status Exchange(int step, absl::Span<const Transfer> sends,
+                        absl::Span<Transfer> recvs);
+
+  // Reduces `input` into `output` with the merge op.
+  absl::Status Merge(Tensor* output, Tensor* input);
+
+  // Applies the final op, if any, to `output`.
+  absl::Status Finalize(Tensor* output);
+
+  int rank() const { return col_params_->default_rank; }
+  int group_size() const { return col_params_->group.group_size; }
+
+ private:
+  absl::Status Abort(const absl::Status& s);
+
+  const std::string name_;
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_ = nullptr;  // Not owned
+  std::unique_ptr<CollectiveAdapter> ca_;
+  Tensor flat_output_;
+  int64_t block_elts_ = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_POINT_TO_POINT_REDUCER_H_
@@ -0,0 +1,228 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/point_to_point_reducer.h"
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/device.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetBinOp(const std::string& op, DataType dtype,
+                                   Device* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder(absl::StrCat(op, "_node"), op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  absl::Status status;
+  std::unique_ptr<OpKernel> kernel = CreateOpKernel(
+      DEVICE_CPU, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return kernel;
+}
+
+// Runs the all-reduce `collective_name` in place on `tensors`, one per device
+// of `test_env`, and returns the status of each device.
+std::vector<absl::Status> RunAllReduce(CollectiveTestEnv* test_env,
+                                       const std::string& collective_name,
+                                       std::vector<Tensor>& tensors) {
+  std::vector<absl::Status> statuses(tensors.size());
+  BlockingCounter counter(tensors.size());
+  for (int rank = 0; rank < tensors.size(); ++rank) {
+    SchedClosure([&, rank]() {
+      Tensor& tensor = tensors[rank];
+      auto col_params = CreateCollectiveParams(
+          *test_env, rank, collective_name, REDUCTION_COLLECTIVE,
+          tensor.dtype(), tensor.shape());
+      Device* device = nullptr;
+      TF_CHECK_OK(test_env->device_mgr->LookupDevice(
+          col_params->group.members[rank].device.name(), &device));
+      std::unique_ptr<OpKernel> merge_op =
+          GetBinOp("Add", tensor.dtype(), device);
+      std::unique_ptr<OpKernel> final_op =
+          GetBinOp("Div", tensor.dtype(), device);
+      col_params->merge_op = merge_op.get();
+      col_params->final_op = final_op.get();
+      statuses[rank] =
+          RunCollective(test_env, col_params.get(), device, &tensor, &tensor);
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  return statuses;
+}
+
+// Parameterized by the collective name, the number of workers, the number of
+// devices per worker and the number of elements.
+class PointToPointReducerTest
+    : public ::testing::TestWithParam<std::tuple<std::string, int, int, int>> {
+};
+
+TEST_P(PointToPointReducerTest, Mean) {
+  const auto& [collective_name, num_workers, num_devices, num_elements] =
+      GetParam();
+  auto test_env =
+      CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+  const int group_size = num_workers * num_devices;
+  std::vector<Tensor> tensors;
+  std::vector<float> expected(num_elements);
+  for (int rank = 0; rank < group_size; ++rank) {
+    Tensor& tensor =
+        tensors.emplace_back(DT_FLOAT, TensorShape({num_elements}));
+    for (int i = 0; i < num_elements; ++i) {
+      // Small integers, so that the sum does not depend on the order in which
+      // the algorithm adds them.
+      tensor.flat<float>()(i) = rank * 10 + i;
+      expected[i] += rank * 10 + i;
+    }
+  }
+  for (float& value : expected) value /= static_cast<float>(group_size);
+
+  std::vector<absl::Status> statuses =
+      RunAllReduce(test_env.get(), collective_name, tensors);
+  for (int rank = 0; rank < group_size; ++rank) {
+    TF_EXPECT_OK(statuses[rank]);
+    test::ExpectTensorEqual<float>(test::AsTensor<float>(expected),
+                                   tensors[rank]);
+  }
+}
+
+TEST_P(PointToPointReducerTest, Failure) {
+  const auto& [collective_name, num_workers, num_devices, num_elements] =
+      GetParam();
+  if (num_workers * num_devices == 1) GTEST_SKIP() << "Nothing to send";
+  auto test_env =
+      CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+  test_env->remote_access->set_fail_after(1);
+  std::vector<Tensor> tensors(num_workers * num_devices);
+  for (Tensor& tensor : tensors) {
+    tensor = Tensor(DT_INT32, TensorShape({num_elements}));
+    tensor.flat<int32_t>().setConstant(1);
+  }
+
+  for (const absl::Status& status :
+       RunAllReduce(test_env.get(), collective_name, tensors)) {
+    EXPECT_NE(status.message().find("Deliberate failure"), std::string::npos)
+        << status;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    RecursiveHalvingDoublingReduce, PointToPointReducerTest,
+    ::testing::Combine(
+        ::testing::Values("RecursiveHalvingDoublingReduce"),
+        ::testing::Values(1, 2, 3), ::testing::Values(1, 3, 4),
+        ::testing::Values(1, 7, 1001, 4099)));
+
+INSTANTIATE_TEST_SUITE_P(TreeReduce, PointToPointReducerTest,
+                         ::testing::Combine(::testing::Values("TreeReduce"),
+                                            ::testing::Values(1, 2, 3),
+                                            ::testing::Values(1, 3, 4),
+                                            ::testing::Values(1, 7, 1001)));
+
+TEST(PointToPointReducerInitParamsTest, RejectsGpu) {
+  auto test_env = CreateCollectiveTestEnv(1, 2, DEVICE_CPU);
+  for (const char* collective_name :
+       {"RecursiveHalvingDoublingReduce", "TreeReduce"}) {
+    auto col_params =
+        CreateCollectiveParams(*test_env, 0, collective_name,
+                               REDUCTION_COLLECTIVE, DT_FLOAT, {16});
+    CollectiveImplementationInterface* collective_impl = nullptr;
+    TF_ASSERT_OK(CollectiveRegistry::Lookup(collective_name, &collective_impl));
+    core::ScopedUnref unref(collective_impl);
+    TF_EXPECT_OK(collective_impl->InitializeCollectiveParams(col_params.get()));
+    col_params->group.device_type = DEVICE_GPU;
+    EXPECT_EQ(collective_impl->InitializeCollectiveParams(col_params.get())
+                  .code(),
+              absl::StatusCode::kUnimplemented);
+  }
+}
+
+// Runs the all-reduce `collective_name` on the CPU devices of an in-process
+// cluster. Args: the number of workers with 2 devices each, and the number of
+// float elements.
+void AllReduceBenchmark(::testing::benchmark::State& state,
+                        const std::string& collective_name) {
+  const int num_workers = state.range(0);
+  const int num_elements = state.range(1);
+  auto test_env = CreateCollectiveTestEnv(num_workers, 2, DEVICE_CPU);
+  std::vector<Tensor> tensors(2 * num_workers);
+  for (Tensor& tensor : tensors) {
+    tensor = Tensor(DT_FLOAT, TensorShape({num_elements}));
+    tensor.flat<float>().setConstant(1.0f);
+  }
+  for (auto s : state) {
+    for (const absl::Status& status :
+         RunAllReduce(test_env.get(), collective_name, tensors)) {
+      TF_CHECK_OK(status);
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_elements * sizeof(float));
+}
+
+void BM_RingReduce(::testing::benchmark::State& state) {
+  AllReduceBenchmark(state, "RingReduce");
+}
+
+void BM_RecursiveHalvingDoublingReduce(::testing::benchmark::State& state) {
+  AllReduceBenchmark(state, "RecursiveHalvingDoublingReduce");
+}
+
+void BM_TreeReduce(::testing::benchmark::State& state) {
+  AllReduceBenchmark(state, "TreeReduce");
+}
+
+// The members run on other threads, so wall time is what is compared.
+#define BM_ALL_REDUCE(BM)   \
+  BENCHMARK(BM)             \
+      ->UseRealTime()       \
+      ->ArgPair(2, 256)     \
+      ->ArgPair(2, 16384)   \
+      ->ArgPair(2, 1048576) \
+      ->ArgPair(8, 256)     \
+      ->ArgPair(8, 16384)   \
+      ->ArgPair(8, 1048576)
+
+BM_ALL_REDUCE(BM_RingReduce);
+BM_ALL_REDUCE(BM_RecursiveHalvingDoublingReduce);
+BM_ALL_REDUCE(BM_TreeReduce);
+
+}  // namespace
+}  // namespace tensorflow
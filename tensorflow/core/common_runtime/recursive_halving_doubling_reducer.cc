@@ -0,0 +1,129 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/recursive_halving_doubling_reducer.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace {
+
+// Steps of the transfers between folded members; the halving and doubling
+// steps follow.
+constexpr int kFoldStep = 0;
+constexpr int kUnfoldStep = 1;
+constexpr int kFirstStep = 2;
+
+}  // namespace
+
+int RecursiveHalvingDoublingReducer::num_blocks() const {
+  int pof2 = 1;
+  while (pof2 * 2 <= group_size()) pof2 *= 2;
+  return pof2;
+}
+
+absl::Status RecursiveHalvingDoublingReducer::RunReduction() {
+  const int pof2 = num_blocks();
+  const int num_folded = group_size() - pof2;
+  Tensor value = Blocks(0, pof2);
+
+  // Members 2i and 2i+1 for i < num_folded are folded into 2i+1, which takes
+  // part in the rest of the algorithm as member i of a power-of-two group.
+  int vrank = rank() - num_folded;
+  if (rank() < 2 * num_folded) {
+    if (rank() % 2 == 0) {
+      TF_RETURN_IF_ERROR(Exchange(kFoldStep, {{rank() + 1, value}}, {}));
+      vrank = -1;
+    } else {
+      std::vector<Transfer> recvs = {{rank() - 1, Scratch(value)}};
+      TF_RETURN_IF_ERROR(Exchange(kFoldStep, {}, absl::MakeSpan(recvs)));
+      TF_RETURN_IF_ERROR(Merge(&value, &recvs[0].tensor));
+      vrank = rank() / 2;
+    }
+  }
+  auto rank_of = [num_folded](int v) {
+    return v < num_folded ? 2 * v + 1 : v + num_folded;
+  };
+
+  if (vrank >= 0) {
+    int step = kFirstStep;
+    // Reduce-scatter: halve the range of blocks held at each step, keeping
+    // the half the peer sends and sending it the other half.
+    // The first half of the blocks is the largest, as only the last blocks
+    // can be short.
+    Tensor scratch = Scratch(Blocks(0, pof2 / 2));
+    int begin = 0;
+    int end = pof2;
+    for (int mask = pof2 / 2; mask > 0; mask /= 2, ++step) {
+      const int peer = rank_of(vrank ^ mask);
+      const int mid = begin + (end - begin) / 2;
+      const bool keep_upper = (vrank & mask) != 0;
+      const int send_begin = keep_upper ? begin : mid;
+      const int send_end = keep_upper ? mid : end;
+      if (keep_upper) {
+        begin = mid;
+      } else {
+        end = mid;
+      }
+      Tensor kept = Blocks(begin, end);
+      std::vector<Transfer> recvs = {
+          {peer, scratch.Slice(0, kept.NumElements())}};
+      TF_RETURN_IF_ERROR(Exchange(step, {{peer, Blocks(send_begin, send_end)}},
+                                  absl::MakeSpan(recvs)));
+      TF_RETURN_IF_ERROR(Merge(&kept, &recvs[0].tensor));
+    }
+
+    // This member now holds block `vrank` reduced across the group.
+    Tensor reduced = Blocks(begin, end);
+    TF_RETURN_IF_ERROR(Finalize(&reduced));
+
+    // All-gather: double the range of blocks held at each step, exchanging
+    // it for the adjacent range of the peer.
+    for (int mask = 1; mask < pof2; mask *= 2, ++step) {
+      const int peer = rank_of(vrank ^ mask);
+      const int size = end - begin;
+      const int peer_begin = (vrank & mask) ? begin - size : end;
+      std::vector<Transfer> recvs = {
+          {peer, Blocks(peer_begin, peer_begin + size)}};
+      TF_RETURN_IF_ERROR(Exchange(step, {{peer, Blocks(begin, end)}},
+                                  absl::MakeSpan(recvs)));
+      begin = std::min(begin, peer_begin);
+      end = begin + 2 * size;
+    }
+  }
+
+  if (rank() < 2 * num_folded) {
+    if (rank() % 2 == 0) {
+      std::vector<Transfer> recvs = {{rank() + 1, value}};
+      TF_RETURN_IF_ERROR(Exchange(kUnfoldStep, {}, absl::MakeSpan(recvs)));
+    } else {
+      TF_RETURN_IF_ERROR(Exchange(kUnfoldStep, {{rank() - 1, value}}, {}));
+    }
+  }
+  return absl::OkStatus();
+}
+
+namespace {
+REGISTER_COLLECTIVE(RecursiveHalvingDoublingReduce,
+                    RecursiveHalvingDoublingReducer);
+}  // namespace
+
+}  // namespace tensorflow
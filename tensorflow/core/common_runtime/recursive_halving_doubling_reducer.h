@@ -0,0 +1,46 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_RECURSIVE_HALVING_DOUBLING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_RECURSIVE_HALVING_DOUBLING_REDUCER_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/point_to_point_reducer.h"
+
+namespace tensorflow {
+
+// Recursive halving-doubling (Rabenseifner) implementation of collective
+// all-reduce.
+//
+// The tensor is divided into P blocks, P being the largest power of two not
+// greater than the group size N. A reduce-scatter by recursive halving leaves
+// each of P members with one fully reduced block, which an all-gather by
+// recursive doubling then distributes. Each phase takes log2(P) steps instead
+// of the ring's N-1, for the same amount of data sent, which suits small and
+// medium tensors on large groups. When N is not a power of two, the first
+// 2*(N-P) members are folded in pairs before, and unfolded after, at the cost
+// of two more steps sending the whole tensor.
+class RecursiveHalvingDoublingReducer : public PointToPointReducer {
+ public:
+  RecursiveHalvingDoublingReducer()
+      : PointToPointReducer("RecursiveHalvingDoublingReduce") {}
+
+ protected:
+  int num_blocks() const override;
+  absl::Status RunReduction() override;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_RECURSIVE_HALVING_DOUBLING_REDUCER_H_
@@ -412,11 +412,35 @@ void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
   int send_to_rank = (rf->rank + 1) % group_size_;
   int send_to_dev_idx = col_params_->instance.impl_details
                             .subdiv_permutations[rf->subdiv_idx][send_to_rank];
+  const Tensor* send_tensor = &rf->chunk;
+  if (IsCompressed(rf)) {
+    Allocator* allocator = col_ctx_->device->GetAllocator(
+        col_ctx_->op_ctx->output_alloc_attr(0));
+    if (!rf->second_pass) {
+      Tensor residual;
+      if (compressor_.method() == RingChunkCompressor::Method::kTopK) {
+        residual = RingCompressionResiduals::Global()->Get(
+            col_ctx_->device_name, col_params_->group.group_key,
+            col_params_->instance.instance_key, rf->sc_idx,
+            rf->chunk.NumElements());
+      }
+      rf->wire_chunk = compressor_.Encode(
+          rf->chunk, residual.NumElements() > 0 ? &residual : nullptr,
+          allocator);
+    } else if (!rf->do_recv) {
+      // This device holds the final value of the chunk.  Keep the value the
+      // other devices decode, so that all of them end up with the same one.
+      rf->wire_chunk = compressor_.Encode(rf->chunk, nullptr, allocator);
+      compressor_.Decode(rf->wire_chunk, &rf->chunk);
+    }
+    // Otherwise the final value is forwarded as received.
+    send_tensor = &rf->wire_chunk;
+  }
   col_ctx_->col_exec->remote_access()->PostToPeer(
       col_params_->group.members[send_to_dev_idx].device.name(),
       col_params_->group.members[send_to_dev_idx].task, send_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
-      col_ctx_->op_ctx->output_alloc_attr(0), &rf->chunk,
+      col_ctx_->op_ctx->output_alloc_attr(0), send_tensor,
       col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
       done);
 }
@@ -432,6 +456,25 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
   Tensor* dst_tensor = (!rf->second_pass && (col_params_->merge_op != nullptr))
                            ? &rf->tmp_chunk
                            : &rf->chunk;
+  if (IsCompressed(rf)) {
+    rf->wire_chunk = Tensor(
+        col_ctx_->device->GetAllocator(col_ctx_->op_ctx->output_alloc_attr(0)),
+        DT_UINT8,
+        TensorShape({compressor_.EncodedBytes(dst_tensor->NumElements())}));
+    col_ctx_->col_exec->remote_access()->RecvFromPeer(
+        col_params_->group.members[rf->recv_dev_idx].device.name(),
+        col_params_->group.members[rf->recv_dev_idx].task,
+        col_params_->group.members[rf->recv_dev_idx].is_local, recv_buf_key,
+        col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->output_alloc_attr(0), &rf->wire_chunk,
+        col_ctx_->device_locality, rf->subdiv_idx,
+        col_ctx_->op_ctx->cancellation_manager(),
+        [this, rf, dst_tensor, done](const absl::Status& s) {
+          if (s.ok()) compressor_.Decode(rf->wire_chunk, dst_tensor);
+          done(s);
+        });
+    return;
+  }
   col_ctx_->col_exec->remote_access()->RecvFromPeer(
       col_params_->group.members[rf->recv_dev_idx].device.name(),
       col_params_->group.members[rf->recv_dev_idx].task,
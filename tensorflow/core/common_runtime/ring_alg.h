@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/common_runtime/ring_compression.h"
 #include "tensorflow/core/framework/collective.h"
 
 namespace tensorflow {
@@ -78,12 +79,18 @@ class RingAlg : public CollectiveImplementationInterface {
     bool is_final = false;  // is the last field in the pass for this rank
     Tensor chunk;           // alias to field values
     Tensor tmp_chunk;
+    Tensor wire_chunk;  // compressed value sent or received, if compressing
     absl::Status status;
     std::string DebugString() const;
   };
   virtual void InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
                              int field_idx);
   void AdvanceToSecondPass(RingField* rf);
+  // Returns whether the value of `rf` is compressed in its current pass.
+  bool IsCompressed(const RingField* rf) const {
+    return compressor_.enabled() &&
+           (!rf->second_pass || compressor_.compresses_second_pass());
+  }
   void DispatchSend(RingField* rf, const StatusCallback& done);
   void DispatchRecv(RingField* rf, const StatusCallback& done);
 
@@ -114,6 +121,9 @@ class RingAlg : public CollectiveImplementationInterface {
   Tensor group_size_tensor_;
   absl::Notification group_size_tensor_ready_;
   std::unique_ptr<CollectiveAdapter> ca_;
+  // Compresses the chunks sent by DispatchSend and decompresses those
+  // received by DispatchRecv. Disabled unless set by the subclass.
+  RingChunkCompressor compressor_;
   mutex status_mu_;
   absl::Status status_ TF_GUARDED_BY(status_mu_);
   std::vector<RingField> rfv_;
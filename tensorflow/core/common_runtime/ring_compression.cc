@@ -0,0 +1,256 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/ring_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/float8.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace {
+
+// The largest finite float8_e4m3fn.
+constexpr float kFloat8Max = 448.0f;
+
+int64_t TopKElements(float fraction, int64_t num_elements) {
+  if (num_elements == 0) return 0;
+  int64_t k = static_cast<int64_t>(std::ceil(fraction * num_elements));
+  return std::clamp<int64_t>(k, 1, num_elements);
+}
+
+}  // namespace
+
+absl::StatusOr<RingChunkCompressor> RingChunkCompressor::FromCommunicationHint(
+    absl::string_view communication_hint) {
+  absl::string_view method = communication_hint;
+  if (!absl::ConsumePrefix(&method, "ring:")) return RingChunkCompressor();
+  if (method == "bf16") return RingChunkCompressor(Method::kBfloat16);
+  if (method == "fp8") return RingChunkCompressor(Method::kFloat8);
+  float fraction = 0;
+  if (absl::ConsumePrefix(&method, "topk=") &&
+      absl::SimpleAtof(method, &fraction) && fraction > 0 && fraction <= 1) {
+    return RingChunkCompressor(Method::kTopK, fraction);
+  }
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Invalid ring compression in communication hint ", communication_hint,
+      ", expected ring:bf16, ring:fp8 or ring:topk=<fraction in (0, 1]>"));
+}
+
+int64_t RingChunkCompressor::EncodedBytes(int64_t num_elements) const {
+  switch (method_) {
+    case Method::kNone:
+      return num_elements * sizeof(float);
+    case Method::kBfloat16:
+      return num_elements * sizeof(bfloat16);
+    case Method::kFloat8:
+      // The scale precedes the elements.
+      return num_elements == 0
+                 ? 0
+                 : sizeof(float) + num_elements * sizeof(float8_e4m3fn);
+    case Method::kTopK:
+      return TopKElements(top_k_fraction_, num_elements) *
+             (sizeof(int32_t) + sizeof(float));
+  }
+  return 0;
+}
+
+Tensor RingChunkCompressor::Encode(const Tensor& chunk, Tensor* residual,
+                                   Allocator* allocator) const {
+  DCHECK_EQ(chunk.dtype(), DT_FLOAT);
+  const int64_t n = chunk.NumElements();
+  Tensor encoded(allocator, DT_UINT8, TensorShape({EncodedBytes(n)}));
+  if (n == 0) return encoded;
+  const float* values = chunk.flat<float>().data();
+  uint8_t* out = encoded.flat<uint8_t>().data();
+  switch (method_) {
+    case Method::kNone:
+      std::memcpy(out, values, n * sizeof(float));
+      break;
+    case Method::kBfloat16: {
+      bfloat16* dst = reinterpret_cast<bfloat16*>(out);
+      for (int64_t i = 0; i < n; ++i) {
+        dst[i] = static_cast<bfloat16>(values[i]);
+      }
+      break;
+    }
+    case Method::kFloat8: {
+      // Non-finite elements would make every element non-finite through the
+      // scale, so they are left out of it and only stay non-finite
+      // themselves.
+      float max_abs = 0;
+      for (int64_t i = 0; i < n; ++i) {
+        if (std::isfinite(values[i])) {
+          max_abs = std::max(max_abs, std::abs(values[i]));
+        }
+      }
+      const float scale = max_abs > 0 ? max_abs / kFloat8Max : 1.0f;
+      std::memcpy(out, &scale, sizeof(float));
+      float8_e4m3fn* dst =
+          reinterpret_cast<float8_e4m3fn*>(out + sizeof(float));
+      for (int64_t i = 0; i < n; ++i) {
+        // A subnormal scale loses precision, so scaled elements may slightly
+        // exceed the largest float8; those would become NaN.
+        const float scaled = values[i] / scale;
+        dst[i] = static_cast<float8_e4m3fn>(
+            std::isfinite(scaled) ? std::clamp(scaled, -kFloat8Max, kFloat8Max)
+                                  : scaled);
+      }
+      break;
+    }
+    case Method::kTopK: {
+      std::vector<float> compensated(values, values + n);
+      float* feedback = nullptr;
+      if (residual != nullptr) {
+        DCHECK_EQ(residual->NumElements(), n);
+        feedback = residual->flat<float>().data();
+        for (int64_t i = 0; i < n; ++i) compensated[i] += feedback[i];
+      }
+      const int64_t k = TopKElements(top_k_fraction_, n);
+      std::vector<int32_t> indices(n);
+      std::iota(indices.begin(), indices.end(), 0);
+      std::nth_element(indices.begin(), indices.begin() + k - 1, indices.end(),
+                       [&compensated](int32_t a, int32_t b) {
+                         return std::abs(compensated[a]) >
+                                std::abs(compensated[b]);
+                       });
+      indices.resize(k);
+      std::sort(indices.begin(), indices.end());
+      int32_t* dst_indices = reinterpret_cast<int32_t*>(out);
+      float* dst_values = reinterpret_cast<float*>(out + k * sizeof(int32_t));
+      for (int64_t j = 0; j < k; ++j) {
+        dst_indices[j] = indices[j];
+        dst_values[j] = compensated[indices[j]];
+      }
+      if (feedback != nullptr) {
+        std::copy(compensated.begin(), compensated.end(), feedback);
+        for (int32_t index : indices) feedback[index] = 0;
+      }
+      break;
+    }
+  }
+  return encoded;
+}
+
+void RingChunkCompressor::Decode(const Tensor& encoded, Tensor* chunk) const {
+  DCHECK_EQ(chunk->dtype(), DT_FLOAT);
+  DCHECK_EQ(encoded.NumElements(), EncodedBytes(chunk->NumElements()));
+  const int64_t n = chunk->NumElements();
+  if (n == 0) return;
+  const uint8_t* in = encoded.flat<uint8_t>().data();
+  float* values = chunk->flat<float>().data();
+  switch (method_) {
+    case Method::kNone:
+      std::memcpy(values, in, n * sizeof(float));
+      break;
+    case Method::kBfloat16: {
+      const bfloat16* src = reinterpret_cast<const bfloat16*>(in);
+      for (int64_t i = 0; i < n; ++i) values[i] = static_cast<float>(src[i]);
+      break;
+    }
+    case Method::kFloat8: {
+      float scale;
+      std::memcpy(&scale, in, sizeof(float));
+      const float8_e4m3fn* src =
+          reinterpret_cast<const float8_e4m3fn*>(in + sizeof(float));
+      for (int64_t i = 0; i < n; ++i) {
+        values[i] = static_cast<float>(src[i]) * scale;
+      }
+      break;
+    }
+    case Method::kTopK: {
+      const int64_t k = TopKElements(top_k_fraction_, n);
+      const int32_t* src_indices = reinterpret_cast<const int32_t*>(in);
+      const float* src_values =
+          reinterpret_cast<const float*>(in + k * sizeof(int32_t));
+      std::fill(values, values + n, 0.0f);
+      for (int64_t j = 0; j < k; ++j) values[src_indices[j]] = src_values[j];
+      break;
+    }
+  }
+}
+
+RingCompressionResiduals* RingCompressionResiduals::Global() {
+  static auto* residuals = new RingCompressionResiduals();
+  return residuals;
+}
+
+Tensor RingCompressionResiduals::Get(absl::string_view device_name,
+                                     int32_t group_key, int32_t instance_key,
+                                     int chunk_index, int64_t num_elements) {
+  std::string key =
+      absl::StrCat(device_name, "/", group_key, "/", instance_key, "/",
+                   chunk_index);
+  mutex_lock l(mu_);
+  auto [it, inserted] = residuals_.try_emplace(key);
+  Entry& entry = it->second;
+  if (inserted) {
+    lru_.push_front(std::move(key));
+    entry.lru_position = lru_.begin();
+  } else {
+    lru_.splice(lru_.begin(), lru_, entry.lru_position);
+  }
+  if (!entry.residual.IsInitialized() ||
+      entry.residual.NumElements() != num_elements) {
+    if (entry.residual.IsInitialized()) {
+      num_bytes_ -= entry.residual.TotalBytes();
+    }
+    entry.residual = Tensor(DT_FLOAT, TensorShape({num_elements}));
+    entry.residual.flat<float>().setZero();
+    num_bytes_ += entry.residual.TotalBytes();
+  }
+  Tensor residual = entry.residual;
+  // The residual just returned is never evicted.
+  while (num_bytes_ > max_bytes_ && lru_.size() > 1) {
+    auto victim = residuals_.find(lru_.back());
+    num_bytes_ -= victim->second.residual.TotalBytes();
+    residuals_.erase(victim);
+    lru_.pop_back();
+  }
+  return residual;
+}
+
+void RingCompressionResiduals::Clear() {
+  mutex_lock l(mu_);
+  residuals_.clear();
+  lru_.clear();
+  num_bytes_ = 0;
+}
+
+int64_t RingCompressionResiduals::num_bytes() const {
+  mutex_lock l(mu_);
+  return num_bytes_;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,131 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_RING_COMPRESSION_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_RING_COMPRESSION_H_
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Lossy compression of the float chunks a ring all-reduce sends, for clusters
+// where the all-reduce is bandwidth-bound.
+//
+// It is requested per collective instance with a communication hint of the
+// form "ring:<method>", where <method> is one of
+// - "bf16": chunks are cast to bfloat16, halving the bytes sent;
+// - "fp8": chunks are scaled by their largest magnitude and cast to
+//   float8_e4m3fn, quartering them;
+// - "topk=<fraction>": only the given fraction of the elements of a chunk
+//   with the largest magnitudes is sent, as index and value pairs. What is
+//   left out is kept as a residual and added to the chunk the next time the
+//   instance runs on the device (error feedback).
+//
+// Chunks are encoded into DT_UINT8 tensors whose size only depends on the
+// number of elements, so that receivers can allocate them upfront.
+class RingChunkCompressor {
+ public:
+  enum class Method { kNone, kBfloat16, kFloat8, kTopK };
+
+  // Parses the compression of `communication_hint`, which is kNone unless
+  // the hint has the form above.
+  static absl::StatusOr<RingChunkCompressor> FromCommunicationHint(
+      absl::string_view communication_hint);
+
+  RingChunkCompressor() = default;
+  explicit RingChunkCompressor(Method method, float top_k_fraction = 0)
+      : method_(method), top_k_fraction_(top_k_fraction) {}
+
+  Method method() const { return method_; }
+  bool enabled() const { return method_ != Method::kNone; }
+
+  // Returns whether the fully reduced chunks the ring sends in its second
+  // pass are compressed too. Sparsifying them would drop most of the result,
+  // so they are sent as is with kTopK.
+  bool compresses_second_pass() const { return method_ != Method::kTopK; }
+
+  // Returns the number of bytes `num_elements` floats are encoded into.
+  int64_t EncodedBytes(int64_t num_elements) const;
+
+  // Encodes the float `chunk` into a new tensor allocated from `allocator`.
+  // With kTopK, `residual` holds the error fed back: it is added to `chunk`
+  // before selecting the elements sent and then replaced by what was not.
+  Tensor Encode(const Tensor& chunk, Tensor* residual,
+                Allocator* allocator) const;
+
+  // Decodes `encoded` into the float `chunk`, which has the number of
+  // elements it was encoded from.
+  void Decode(const Tensor& encoded, Tensor* chunk) const;
+
+ private:
+  Method method_ = Method::kNone;
+  float top_k_fraction_ = 0;
+};
+
+// The residuals of the kTopK compression, by device, collective instance and
+// chunk. They persist across runs of an instance, so that the error made in
+// one step is compensated in later ones. Once they take more than a maximum
+// number of bytes, the least recently used ones are evicted, which only drops
+// the error they would have fed back.
+//
+// Thread-safe.
+class RingCompressionResiduals {
+ public:
+  static constexpr int64_t kDefaultMaxBytes = int64_t{1} << 30;
+
+  explicit RingCompressionResiduals(int64_t max_bytes = kDefaultMaxBytes)
+      : max_bytes_(max_bytes) {}
+
+  static RingCompressionResiduals* Global();
+
+  // Returns the residual of a chunk of `num_elements` floats, zeroed when it
+  // is first used or when the number of elements changed. The returned tensor
+  // shares its buffer with the stored one; a chunk is only compressed by one
+  // run of its instance at a time.
+  Tensor Get(absl::string_view device_name, int32_t group_key,
+             int32_t instance_key, int chunk_index, int64_t num_elements);
+
+  void Clear();
+
+  // Returns the number of bytes of the residuals.
+  int64_t num_bytes() const;
+
+ private:
+  struct Entry {
+    Tensor residual;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  const int64_t max_bytes_;
+
+  mutable mutex mu_;
+  absl::flat_hash_map<std::string, Entry> residuals_ TF_GUARDED_BY(mu_);
+  // The keys of the residuals, most recently used first.
+  std::list<std::string> lru_ TF_GUARDED_BY(mu_);
+  int64_t num_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_RING_COMPRESSION_H_
@@ -0,0 +1,183 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/ring_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+using Method = RingChunkCompressor::Method;
+
+Tensor RoundTrip(const RingChunkCompressor& compressor, const Tensor& chunk,
+                 Tensor* residual = nullptr) {
+  Tensor encoded = compressor.Encode(chunk, residual, cpu_allocator());
+  EXPECT_EQ(encoded.dtype(), DT_UINT8);
+  EXPECT_EQ(encoded.NumElements(),
+            compressor.EncodedBytes(chunk.NumElements()));
+  Tensor decoded(DT_FLOAT, chunk.shape());
+  compressor.Decode(encoded, &decoded);
+  return decoded;
+}
+
+TEST(RingChunkCompressorTest, FromCommunicationHint) {
+  for (const char* hint : {"", "auto", "ring", "nccl"}) {
+    auto compressor = RingChunkCompressor::FromCommunicationHint(hint);
+    TF_ASSERT_OK(compressor.status());
+    EXPECT_FALSE(compressor->enabled()) << hint;
+  }
+
+  auto compressor = RingChunkCompressor::FromCommunicationHint("ring:bf16");
+  TF_ASSERT_OK(compressor.status());
+  EXPECT_EQ(compressor->method(), Method::kBfloat16);
+  EXPECT_TRUE(compressor->compresses_second_pass());
+
+  compressor = RingChunkCompressor::FromCommunicationHint("ring:fp8");
+  TF_ASSERT_OK(compressor.status());
+  EXPECT_EQ(compressor->method(), Method::kFloat8);
+
+  compressor = RingChunkCompressor::FromCommunicationHint("ring:topk=0.25");
+  TF_ASSERT_OK(compressor.status());
+  EXPECT_EQ(compressor->method(), Method::kTopK);
+  EXPECT_FALSE(compressor->compresses_second_pass());
+  EXPECT_EQ(compressor->EncodedBytes(10), 3 * 8);
+
+  for (const char* hint : {"ring:", "ring:int4", "ring:topk=0", "ring:topk=2",
+                           "ring:topk=x"}) {
+    EXPECT_EQ(RingChunkCompressor::FromCommunicationHint(hint).status().code(),
+              absl::StatusCode::kInvalidArgument)
+        << hint;
+  }
+}
+
+TEST(RingChunkCompressorTest, Bfloat16) {
+  RingChunkCompressor compressor(Method::kBfloat16);
+  EXPECT_EQ(compressor.EncodedBytes(5), 10);
+  // Exactly representable values round-trip exactly.
+  Tensor chunk = test::AsTensor<float>({0.0f, 1.0f, -2.5f, 256.0f, 0.125f});
+  test::ExpectTensorEqual<float>(RoundTrip(compressor, chunk), chunk);
+  // Others keep 8 significant bits.
+  Tensor pi = test::AsTensor<float>({3.14159265f});
+  EXPECT_NEAR(RoundTrip(compressor, pi).flat<float>()(0), 3.14159265f,
+              3.14159265f / 256);
+}
+
+TEST(RingChunkCompressorTest, Float8) {
+  RingChunkCompressor compressor(Method::kFloat8);
+  EXPECT_EQ(compressor.EncodedBytes(0), 0);
+  EXPECT_EQ(compressor.EncodedBytes(5), 9);
+  std::vector<float> values;
+  for (int i = 0; i < 100; ++i) values.push_back(std::sin(i) * 1000);
+  Tensor chunk = test::AsTensor<float>(values);
+  Tensor decoded = RoundTrip(compressor, chunk);
+  for (int i = 0; i < values.size(); ++i) {
+    // 3 mantissa bits, relative to the largest magnitude for small values.
+    EXPECT_NEAR(decoded.flat<float>()(i), values[i],
+                std::max(std::abs(values[i]) / 16, 1000.0f / 512))
+        << i;
+  }
+
+  Tensor zeros = test::AsTensor<float>({0.0f, 0.0f});
+  test::ExpectTensorEqual<float>(RoundTrip(compressor, zeros), zeros);
+}
+
+TEST(RingChunkCompressorTest, Float8WithNonFiniteElements) {
+  RingChunkCompressor compressor(Method::kFloat8);
+  Tensor chunk = test::AsTensor<float>(
+      {1.0f, -2.0f, std::numeric_limits<float>::infinity(),
+       std::numeric_limits<float>::quiet_NaN(), 4.0f});
+  Tensor decoded = RoundTrip(compressor, chunk);
+  // Only the non-finite elements are lost.
+  EXPECT_FLOAT_EQ(decoded.flat<float>()(0), 1.0f);
+  EXPECT_FLOAT_EQ(decoded.flat<float>()(1), -2.0f);
+  EXPECT_FALSE(std::isfinite(decoded.flat<float>()(2)));
+  EXPECT_TRUE(std::isnan(decoded.flat<float>()(3)));
+  EXPECT_FLOAT_EQ(decoded.flat<float>()(4), 4.0f);
+}
+
+TEST(RingChunkCompressorTest, TopKWithErrorFeedback) {
+  RingChunkCompressor compressor(Method::kTopK, 0.4);
+  Tensor chunk = test::AsTensor<float>({1.0f, -5.0f, 2.0f, 4.0f, -3.0f});
+  Tensor residual = test::AsTensor<float>({0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+
+  // The 2 largest magnitudes are sent and the rest is kept.
+  test::ExpectTensorEqual<float>(
+      RoundTrip(compressor, chunk, &residual),
+      test::AsTensor<float>({0.0f, -5.0f, 0.0f, 4.0f, 0.0f}));
+  test::ExpectTensorEqual<float>(
+      residual, test::AsTensor<float>({1.0f, 0.0f, 2.0f, 0.0f, -3.0f}));
+
+  // The residual is added before selecting the elements sent next time.
+  test::ExpectTensorEqual<float>(
+      RoundTrip(compressor, chunk, &residual),
+      test::AsTensor<float>({0.0f, -5.0f, 0.0f, 0.0f, -6.0f}));
+  test::ExpectTensorEqual<float>(
+      residual, test::AsTensor<float>({2.0f, 0.0f, 4.0f, 4.0f, 0.0f}));
+
+  // Without feedback, the chunk is only sparsified.
+  test::ExpectTensorEqual<float>(
+      RoundTrip(compressor, chunk),
+      test::AsTensor<float>({0.0f, -5.0f, 0.0f, 4.0f, 0.0f}));
+}
+
+TEST(RingCompressionResidualsTest, Get) {
+  RingCompressionResiduals residuals;
+  Tensor residual = residuals.Get("/device:CPU:0", 1, 2, 0, 3);
+  test::ExpectTensorEqual<float>(residual,
+                                 test::AsTensor<float>({0.0f, 0.0f, 0.0f}));
+  residual.flat<float>()(1) = 7.0f;
+  test::ExpectTensorEqual<float>(residuals.Get("/device:CPU:0", 1, 2, 0, 3),
+                                 test::AsTensor<float>({0.0f, 7.0f, 0.0f}));
+  // Other chunks, instances and devices have their own residuals.
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 2, 1, 3).flat<float>()(1), 0);
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 3, 0, 3).flat<float>()(1), 0);
+  EXPECT_EQ(residuals.Get("/device:CPU:1", 1, 2, 0, 3).flat<float>()(1), 0);
+  // A residual is reset when the size of its chunk changes.
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 2, 0, 4).NumElements(), 4);
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 2, 0, 4).flat<float>()(1), 0);
+}
+
+TEST(RingCompressionResidualsTest, EvictsLeastRecentlyUsed) {
+  // Room for two residuals of 3 floats.
+  RingCompressionResiduals residuals(/*max_bytes=*/24);
+  residuals.Get("/device:CPU:0", 1, 1, 0, 3).flat<float>()(0) = 1.0f;
+  residuals.Get("/device:CPU:0", 1, 2, 0, 3).flat<float>()(0) = 2.0f;
+  EXPECT_EQ(residuals.num_bytes(), 24);
+  // Instance 1 is used again, so instance 2 is evicted for instance 3.
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 1, 0, 3).flat<float>()(0), 1.0f);
+  residuals.Get("/device:CPU:0", 1, 3, 0, 3);
+  EXPECT_EQ(residuals.num_bytes(), 24);
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 1, 0, 3).flat<float>()(0), 1.0f);
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 2, 0, 3).flat<float>()(0), 0.0f);
+
+  // A residual larger than the maximum is still returned.
+  EXPECT_EQ(residuals.Get("/device:CPU:0", 1, 4, 0, 10).NumElements(), 10);
+  EXPECT_EQ(residuals.num_bytes(), 40);
+  residuals.Clear();
+  EXPECT_EQ(residuals.num_bytes(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
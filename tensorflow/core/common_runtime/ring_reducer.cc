@@ -26,6 +26,7 @@ limitations under the License.
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/collective_rma_local.h"
@@ -35,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/common_runtime/ring_compression.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -45,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 
@@ -57,6 +60,19 @@ absl::Status RingReducer::InitializeCollectiveParams(
   // TODO(b/113171733): change CHECKs to return errors.
   CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
   CHECK_EQ(col_params->instance.impl_details.collective_name, "RingReduce");
+  const std::string& hint =
+      col_params->instance.impl_details.communication_hint;
+  TF_ASSIGN_OR_RETURN(RingChunkCompressor compressor,
+                      RingChunkCompressor::FromCommunicationHint(hint));
+  if (compressor.enabled() &&
+      (col_params->instance.data_type != DT_FLOAT ||
+       col_params->group.device_type != DEVICE_CPU)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Ring compression ", hint,
+        " only supports float tensors on CPU, got ",
+        DataTypeString(col_params->instance.data_type), " on ",
+        col_params->group.device_type.type_string()));
+  }
   return RingAlg::InitializeCollectiveParams(col_params);
 }
 
@@ -78,6 +94,15 @@ void RingReducer::Run(StatusCallback done) {
         "group_size * num_subdivs exceeds int32 limit"));
     return;
   }
+  absl::StatusOr<RingChunkCompressor> compressor =
+      RingChunkCompressor::FromCommunicationHint(
+          col_params_->instance.impl_details.communication_hint);
+  if (!compressor.ok()) {
+    group_size_tensor_ready_.Notify();  // To unblock destructor.
+    done_(compressor.status());
+    return;
+  }
+  compressor_ = *compressor;
 
   if (VLOG_IS_ON(1)) {
     std::string buf;
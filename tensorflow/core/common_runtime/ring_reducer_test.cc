@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/ring_reducer.h"
 
 #include <algorithm>
+#include <cmath>
 
 #include "absl/memory/memory.h"
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/common_runtime/ring_compression.h"
 #include "tensorflow/core/common_runtime/test_collective_executor_mgr.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -36,8 +38,10 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/platform/unbounded_work_queue.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/public/version.h"
@@ -153,6 +157,50 @@ class RingReducerTest : public ::testing::Test {
     }
   }
 
+  // Runs a compressed float all-reduce `num_runs` times on the same input and
+  // returns the mean absolute error of the averaged result. Every device must
+  // get the same result in each run.
+  float RunCompressionTest(const std::string& communication_hint,
+                           int num_workers, int num_devices, int tensor_len,
+                           int num_runs) {
+    RingCompressionResiduals::Global()->Clear();
+    Init(num_workers, num_devices, DT_FLOAT, TensorShape({tensor_len}),
+         DEVICE_CPU, /*num_subdivs=*/1, /*fail_after=*/0);
+    const int group_size = num_workers * num_devices;
+    std::vector<float> expected(tensor_len);
+    for (int di = 0; di < group_size; ++di) {
+      for (int i = 0; i < tensor_len; ++i) {
+        expected[i] += std::sin(i * (di + 1) + di) / group_size;
+      }
+      instances_[di]->col_params_->instance.impl_details.communication_hint =
+          communication_hint;
+    }
+    std::vector<double> sum(tensor_len);
+    for (int run = 0; run < num_runs; ++run) {
+      for (int di = 0; di < group_size; ++di) {
+        instances_[di]->InitTensor([di](Tensor* t) {
+          for (int i = 0; i < t->NumElements(); ++i) {
+            t->flat<float>()(i) = std::sin(i * (di + 1) + di);
+          }
+        });
+      }
+      Reduce(/*fail_after=*/0);
+      for (int di = 0; di < group_size; ++di) {
+        TF_EXPECT_OK(instances_[di]->status_);
+        test::ExpectTensorEqual<float>(instances_[0]->tensor(),
+                                       instances_[di]->tensor());
+      }
+      for (int i = 0; i < tensor_len; ++i) {
+        sum[i] += instances_[0]->tensor().flat<float>()(i);
+      }
+    }
+    double error = 0;
+    for (int i = 0; i < tensor_len; ++i) {
+      error += std::abs(sum[i] / num_runs - expected[i]);
+    }
+    return error / tensor_len;
+  }
+
   class DeviceInstance {
    public:
     DeviceInstance(int rank, int num_subdivs, DataType dtype,
@@ -427,6 +475,85 @@ DEF_TEST(INT64, CPU, 2, 8, 3, 4095, 0)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 1)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 7)
 DEF_TEST(FLOAT, CPU, 2, 8, 2, 9408, 11)
+
+// Compression tests.  The inputs are in [-1, 1], so that the rounding error of
+// each of the (group size) additions of a chunk is bounded.
+TEST_F(RingReducerTest, CompressionBfloat16) {
+  EXPECT_LT(RunCompressionTest("ring:bf16", 2, 2, 4099, 1), 0.01);
+}
+
+TEST_F(RingReducerTest, CompressionFloat8) {
+  EXPECT_LT(RunCompressionTest("ring:fp8", 2, 2, 4099, 1), 0.1);
+}
+
+TEST_F(RingReducerTest, CompressionTopKFeedsErrorBack) {
+  // A single run drops most of the input, but what is left out is sent in
+  // later runs.
+  EXPECT_LT(RunCompressionTest("ring:topk=0.25", 2, 2, 4099, 50), 0.03);
+}
+
+TEST_F(RingReducerTest, CompressionRejectsOtherTypes) {
+  Init(1, 2, DT_DOUBLE, TensorShape({16}), DEVICE_CPU, 1, 0);
+  for (auto& instance : instances_) {
+    instance->col_params_->instance.impl_details.communication_hint =
+        "ring:bf16";
+  }
+  Reduce(0);
+  for (auto& instance : instances_) {
+    EXPECT_EQ(instance->status_.code(), absl::StatusCode::kInvalidArgument);
+  }
+}
+
+// Args: the compression method (none, bf16, fp8, topk=0.1), and the number
+// of float elements reduced by 2 workers with 4 devices each.
+void BM_RingReduceCompression(::testing::benchmark::State& state) {
+  static const char* const kHints[] = {"auto", "ring:bf16", "ring:fp8",
+                                       "ring:topk=0.1"};
+  const std::string hint = kHints[state.range(0)];
+  const int num_elements = state.range(1);
+  auto test_env = CreateCollectiveTestEnv(2, 4, DEVICE_CPU);
+  const int group_size = 8;
+  std::vector<core::RefCountPtr<CollectiveParams>> col_params;
+  std::vector<Device*> devices(group_size);
+  std::vector<std::unique_ptr<OpKernel>> merge_ops;
+  std::vector<Tensor> tensors;
+  for (int rank = 0; rank < group_size; ++rank) {
+    col_params.push_back(CreateCollectiveParams(
+        *test_env, rank, "RingReduce", REDUCTION_COLLECTIVE, DT_FLOAT,
+        TensorShape({num_elements})));
+    col_params[rank]->instance.impl_details.communication_hint = hint;
+    TF_CHECK_OK(test_env->device_mgr->LookupDevice(
+        col_params[rank]->group.members[rank].device.name(), &devices[rank]));
+    merge_ops.push_back(GetAdd(DT_FLOAT, DEVICE_CPU, devices[rank]));
+    col_params[rank]->merge_op = merge_ops.back().get();
+    tensors.emplace_back(DT_FLOAT, TensorShape({num_elements}));
+    tensors.back().flat<float>().setRandom();
+  }
+  for (auto s : state) {
+    BlockingCounter counter(group_size);
+    for (int rank = 0; rank < group_size; ++rank) {
+      SchedClosure([&, rank]() {
+        TF_CHECK_OK(RunCollective(test_env.get(), col_params[rank].get(),
+                                  devices[rank], &tensors[rank],
+                                  &tensors[rank]));
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_elements * sizeof(float));
+}
+BENCHMARK(BM_RingReduceCompression)
+    ->UseRealTime()
+    ->ArgPair(0, 1 << 16)
+    ->ArgPair(1, 1 << 16)
+    ->ArgPair(2, 1 << 16)
+    ->ArgPair(3, 1 << 16)
+    ->ArgPair(0, 1 << 22)
+    ->ArgPair(1, 1 << 22)
+    ->ArgPair(2, 1 << 22)
+    ->ArgPair(3, 1 << 22);
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
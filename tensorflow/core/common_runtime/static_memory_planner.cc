@@ -0,0 +1,336 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/shape_refiner.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int64_t kSlotAlignment = Allocator::kAllocatorAlignment;
+
+int64_t AlignUp(int64_t bytes) {
+  return (bytes + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+// Dense bitsets of the (strict) ancestors of every node, in node id space.
+class AncestorSets {
+ public:
+  explicit AncestorSets(const Graph& graph, const std::vector<Node*>& order)
+      : words_per_node_((graph.num_node_ids() + 63) / 64),
+        bits_(static_cast<size_t>(graph.num_node_ids()) * words_per_node_) {
+    for (const Node* n : order) {
+      uint64_t* dst = row(n->id());
+      for (const Edge* e : n->in_edges()) {
+        const int src = e->src()->id();
+        const uint64_t* src_row = row(src);
+        for (int w = 0; w < words_per_node_; ++w) dst[w] |= src_row[w];
+        dst[src / 64] |= uint64_t{1} << (src % 64);
+      }
+    }
+  }
+
+  // Returns true iff `a` is a strict ancestor of `b`.
+  bool IsAncestor(int a, int b) const {
+    return (row(b)[a / 64] >> (a % 64)) & 1;
+  }
+
+ private:
+  uint64_t* row(int id) { return &bits_[id * words_per_node_]; }
+  const uint64_t* row(int id) const { return &bits_[id * words_per_node_]; }
+
+  const int words_per_node_;
+  std::vector<uint64_t> bits_;
+};
+
+struct Candidate {
+  int node_id;
+  int output_index;
+  int64_t size;
+  // The producer and the consumers of this tensor that have no descendant
+  // among them. The tensor is dead once all of them have completed.
+  std::vector<int> last_users;
+};
+
+// Returns true iff `a` is certain to be dead before `b` is produced.
+bool Precedes(const Candidate& a, const Candidate& b,
+              const AncestorSets& ancestors) {
+  for (int user : a.last_users) {
+    if (!ancestors.IsAncestor(user, b.node_id)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+/* static */
+absl::Status StaticMemoryPlan::Compute(
+    const Graph& graph, std::unique_ptr<StaticMemoryPlan>* plan) {
+  plan->reset(new StaticMemoryPlan);
+  StaticMemoryPlan& result = **plan;
+  result.output_slots_.resize(graph.num_node_ids());
+
+  if (graph.num_node_ids() > kMaxNodes) {
+    VLOG(1) << "Not planning memory for graph with " << graph.num_node_ids()
+            << " nodes";
+    return absl::OkStatus();
+  }
+  for (const Node* n : graph.op_nodes()) {
+    if (n->IsEnter()) {
+      VLOG(1) << "Not planning memory for graph with loop frame at "
+              << n->name();
+      return absl::OkStatus();
+    }
+  }
+
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+
+  ShapeRefiner refiner(graph.versions(), graph.op_registry());
+  refiner.set_require_shape_inference_fns(false);
+  std::vector<Candidate> candidates;
+  for (const Node* n : order) {
+    // Inputs that failed shape inference make their consumers fail as well,
+    // which leaves the affected outputs unplanned.
+    if (!refiner.AddNode(n).ok() || !n->IsOp() || n->op_def().is_stateful()) {
+      continue;
+    }
+    // Constants hand out their own tensor rather than allocating one.
+    if (n->IsConstant()) continue;
+    shape_inference::InferenceContext* c = refiner.GetContext(n);
+    if (c == nullptr) continue;
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      const DataType dtype = n->output_type(i);
+      if (IsRefType(dtype) || !DataTypeCanUseMemcpy(dtype) ||
+          !c->FullyDefined(c->output(i))) {
+        continue;
+      }
+      const int64_t num_elements = c->Value(c->NumElements(c->output(i)));
+      if (num_elements <= 0) continue;
+      Candidate candidate;
+      candidate.node_id = n->id();
+      candidate.output_index = i;
+      candidate.size = AlignUp(num_elements * DataTypeSize(dtype));
+      candidates.push_back(std::move(candidate));
+    }
+  }
+  if (candidates.empty()) return absl::OkStatus();
+
+  AncestorSets ancestors(graph, order);
+  for (Candidate& candidate : candidates) {
+    const Node* producer = graph.FindNodeId(candidate.node_id);
+    std::vector<int> users = {candidate.node_id};
+    for (const Edge* e : producer->out_edges()) {
+      if (!e->IsControlEdge() && e->src_output() == candidate.output_index) {
+        users.push_back(e->dst()->id());
+      }
+    }
+    for (int user : users) {
+      bool has_descendant_user = false;
+      for (int other : users) {
+        if (ancestors.IsAncestor(user, other)) {
+          has_descendant_user = true;
+          break;
+        }
+      }
+      if (!has_descendant_user) candidate.last_users.push_back(user);
+    }
+  }
+
+  // Largest first, as in TFLite's greedy-by-size arena planner.
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.size > b.size;
+                   });
+
+  std::vector<Slot>& slots = result.slots_;
+  slots.reserve(candidates.size());
+  std::vector<int32_t> conflicts;
+  for (int32_t i = 0; i < static_cast<int32_t>(candidates.size()); ++i) {
+    const Candidate& candidate = candidates[i];
+    conflicts.clear();
+    for (int32_t j = 0; j < i; ++j) {
+      if (!Precedes(candidates[j], candidate, ancestors) &&
+          !Precedes(candidate, candidates[j], ancestors)) {
+        conflicts.push_back(j);
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end(), [&](int32_t a, int32_t b) {
+      return slots[a].offset < slots[b].offset;
+    });
+    // Take the first gap between conflicting slots that is large enough.
+    int64_t offset = 0;
+    for (int32_t j : conflicts) {
+      if (slots[j].offset - offset >= candidate.size) break;
+      offset = std::max(offset, slots[j].offset + slots[j].size);
+    }
+
+    Slot slot;
+    slot.node_id = candidate.node_id;
+    slot.output_index = candidate.output_index;
+    slot.offset = offset;
+    slot.size = candidate.size;
+    slots.push_back(std::move(slot));
+    result.total_bytes_ =
+        std::max(result.total_bytes_, offset + candidate.size);
+    result.unshared_bytes_ += candidate.size;
+  }
+
+  const int32_t num_slots = slots.size();
+  for (int32_t i = 0; i < num_slots; ++i) {
+    Slot& slot = slots[i];
+    for (int32_t j = 0; j < num_slots; ++j) {
+      if (i != j && slots[j].offset < slot.offset + slot.size &&
+          slot.offset < slots[j].offset + slots[j].size) {
+        slot.overlapping_slots.push_back(j);
+      }
+    }
+    std::vector<int32_t>& node_slots = result.output_slots_[slot.node_id];
+    if (static_cast<int>(node_slots.size()) <= slot.output_index) {
+      node_slots.resize(slot.output_index + 1, -1);
+    }
+    node_slots[slot.output_index] = i;
+  }
+
+  VLOG(1) << "Planned " << slots.size() << " tensors totalling "
+          << result.unshared_bytes_ << " bytes into a slab of "
+          << result.total_bytes_ << " bytes";
+  return absl::OkStatus();
+}
+
+// Owns the slab memory and the liveness bit of every slot.
+class StaticMemorySlab::SlabBuffer : public TensorBuffer {
+ public:
+  SlabBuffer(Allocator* allocator, void* data, int64_t size, int num_slots)
+      : TensorBuffer(data),
+        allocator_(allocator),
+        size_(size),
+        live_(new std::atomic<bool>[num_slots]) {
+    for (int i = 0; i < num_slots; ++i) live_[i] = false;
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name(allocator_->Name());
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  std::atomic<bool>& live(int32_t slot) { return live_[slot]; }
+
+ private:
+  ~SlabBuffer() override { allocator_->DeallocateRaw(data()); }
+
+  Allocator* const allocator_;
+  const int64_t size_;
+  std::unique_ptr<std::atomic<bool>[]> live_;
+};
+
+// Aliases one slot of a SlabBuffer and marks it dead when released.
+class StaticMemorySlab::SlotBuffer : public TensorBuffer {
+ public:
+  SlotBuffer(SlabBuffer* slab, int32_t slot, int64_t offset, int64_t size)
+      : TensorBuffer(slab->base<char>() + offset),
+        slab_(slab),
+        slot_(slot),
+        size_(size) {
+    slab_->Ref();
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return slab_; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    slab_->FillAllocationDescription(proto);
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  ~SlotBuffer() override {
+    slab_->live(slot_).store(false);
+    slab_->Unref();
+  }
+
+  SlabBuffer* const slab_;
+  const int32_t slot_;
+  const int64_t size_;
+};
+
+StaticMemorySlab::StaticMemorySlab(const StaticMemoryPlan& plan,
+                                   Allocator* allocator)
+    : plan_(plan) {
+  if (plan.empty()) return;
+  void* data = allocator->AllocateRaw(kSlotAlignment, plan.total_bytes());
+  if (data == nullptr) {
+    LOG(WARNING) << "Failed to allocate " << plan.total_bytes()
+                 << " bytes for the static memory plan; falling back to "
+                    "per-op allocation for this step.";
+    return;
+  }
+  slab_ = new SlabBuffer(allocator, data, plan.total_bytes(),
+                         plan.slots().size());
+}
+
+StaticMemorySlab::~StaticMemorySlab() {
+  if (slab_ != nullptr) slab_->Unref();
+}
+
+bool StaticMemorySlab::AllocateOutput(int node_id, int output_index,
+                                      DataType type, const TensorShape& shape,
+                                      Tensor* tensor) {
+  if (slab_ == nullptr || !DataTypeCanUseMemcpy(type)) return false;
+  const int32_t slot_index = plan_.SlotIndex(node_id, output_index);
+  if (slot_index < 0) return false;
+  const StaticMemoryPlan::Slot& slot = plan_.slots()[slot_index];
+  const int64_t bytes = shape.num_elements() * DataTypeSize(type);
+  if (bytes == 0 || bytes > slot.size) return false;
+
+  // Claim the slot before checking the overlapping ones, so that of two
+  // overlapping slots claimed concurrently at least one sees the other.
+  bool expected = false;
+  if (!slab_->live(slot_index).compare_exchange_strong(expected, true)) {
+    return false;
+  }
+  for (int32_t other : slot.overlapping_slots) {
+    if (slab_->live(other).load()) {
+      slab_->live(slot_index).store(false);
+      return false;
+    }
+  }
+  core::RefCountPtr<TensorBuffer> buffer(
+      new SlotBuffer(slab_, slot_index, slot.offset, bytes));
+  *tensor = Tensor(type, shape, std::move(buffer));
+  return true;
+}
+
+}  // namespace tensorflow
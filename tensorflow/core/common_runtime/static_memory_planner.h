@@ -0,0 +1,136 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+
+namespace tensorflow {
+
+class Graph;
+
+// A static memory plan assigns the outputs of a fixed-shape graph to offsets
+// in a single per-step slab, so that tensors whose lifetimes cannot overlap
+// share memory. It is the executor analogue of TFLite's ArenaPlanner.
+//
+// Lifetimes are derived from the graph's happens-before order rather than
+// from a single topological order, because the executor runs independent
+// nodes concurrently: tensor A may share memory with tensor B only if the
+// producer and every consumer of A are strict ancestors of B's producer (or
+// vice versa). Offsets are then assigned greedily, largest tensor first.
+//
+// The plan is computed once per executor and shared by all its steps.
+class StaticMemoryPlan {
+ public:
+  // A planned output: `size` bytes at `offset` of the slab.
+  struct Slot {
+    int node_id;
+    int output_index;
+    int64_t offset;
+    int64_t size;
+    // Slots whose memory ranges intersect this one. At most one slot of each
+    // overlapping set may be live at any time.
+    std::vector<int32_t> overlapping_slots;
+  };
+
+  // Graphs with more nodes than this are not planned, as the ancestor sets
+  // needed to order tensors grow quadratically with the number of nodes.
+  static constexpr int kMaxNodes = 8192;
+
+  // Computes a plan for `graph`. Only outputs of stateless, non-constant ops
+  // with memcpy-able types and shapes fully defined by shape inference are
+  // planned.
+  // Graphs with loops are not planned at all. The resulting plan may be
+  // empty, which is not an error.
+  static absl::Status Compute(const Graph& graph,
+                              std::unique_ptr<StaticMemoryPlan>* plan);
+
+  // Returns the slot index of output `output_index` of node `node_id`, or -1
+  // if that output is not planned.
+  int32_t SlotIndex(int node_id, int output_index) const {
+    if (node_id < 0 || node_id >= static_cast<int>(output_slots_.size())) {
+      return -1;
+    }
+    const std::vector<int32_t>& slots = output_slots_[node_id];
+    if (output_index < 0 || output_index >= static_cast<int>(slots.size())) {
+      return -1;
+    }
+    return slots[output_index];
+  }
+
+  const std::vector<Slot>& slots() const { return slots_; }
+
+  // The size of the slab backing one step.
+  int64_t total_bytes() const { return total_bytes_; }
+
+  // The sum of the sizes of all planned tensors, i.e. the memory they would
+  // occupy if every one of them was allocated separately.
+  int64_t unshared_bytes() const { return unshared_bytes_; }
+
+  bool empty() const { return slots_.empty(); }
+
+ private:
+  StaticMemoryPlan() = default;
+
+  std::vector<Slot> slots_;
+  // Indexed by node id, then output index.
+  std::vector<std::vector<int32_t>> output_slots_;
+  int64_t total_bytes_ = 0;
+  int64_t unshared_bytes_ = 0;
+};
+
+// Serves planned outputs for a single step from one slab allocated up front.
+//
+// The plan's lifetimes are a prediction: a kernel may alias one of its inputs
+// into an output, or a stateful kernel may retain an output past its
+// consumers. The slab therefore tracks which slots are live at runtime, and a
+// slot whose memory is still held by an overlapping live slot is not handed
+// out; the output is allocated from the device allocator instead. Tensors
+// served from the slab keep it alive, so the slab memory is released once the
+// executor and every such tensor are gone.
+class StaticMemorySlab : public PlannedOutputAllocator {
+ public:
+  // `plan` must outlive this object. Allocation failures leave the slab
+  // unusable, in which case every request falls back to regular allocation.
+  StaticMemorySlab(const StaticMemoryPlan& plan, Allocator* allocator);
+  ~StaticMemorySlab() override;
+
+  bool AllocateOutput(int node_id, int output_index, DataType type,
+                      const TensorShape& shape, Tensor* tensor) override;
+
+ private:
+  class SlabBuffer;
+  class SlotBuffer;
+
+  const StaticMemoryPlan& plan_;
+  SlabBuffer* slab_ = nullptr;  // Owns a ref, may be null.
+
+  StaticMemorySlab(const StaticMemorySlab&) = delete;
+  void operator=(const StaticMemorySlab&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
@@ -0,0 +1,145 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <memory>
+
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kNumElements = 1024;
+constexpr int64_t kTensorBytes = kNumElements * sizeof(float);
+
+Node* FloatConstant(Graph* g) {
+  Tensor v(DT_FLOAT, TensorShape({kNumElements}));
+  v.flat<float>().setZero();
+  return test::graph::Constant(g, v);
+}
+
+TEST(StaticMemoryPlanTest, ChainReusesMemory) {
+  Graph g(OpRegistry::Global());
+  Node* c = FloatConstant(&g);
+  Node* a = test::graph::Unary(&g, "Neg", c);
+  Node* b = test::graph::Unary(&g, "Neg", a);
+  Node* d = test::graph::Unary(&g, "Neg", b);
+  Node* e = test::graph::Unary(&g, "Neg", d);
+
+  std::unique_ptr<StaticMemoryPlan> plan;
+  TF_ASSERT_OK(StaticMemoryPlan::Compute(g, &plan));
+  // The constant is not planned.
+  EXPECT_EQ(plan->SlotIndex(c->id(), 0), -1);
+  ASSERT_EQ(plan->slots().size(), 4);
+  EXPECT_EQ(plan->unshared_bytes(), 4 * kTensorBytes);
+  // Only a tensor and its consumer's output are live at the same time.
+  EXPECT_EQ(plan->total_bytes(), 2 * kTensorBytes);
+
+  const auto offset = [&](Node* n) {
+    return plan->slots()[plan->SlotIndex(n->id(), 0)].offset;
+  };
+  EXPECT_NE(offset(a), offset(b));
+  EXPECT_EQ(offset(a), offset(d));
+  EXPECT_EQ(offset(b), offset(e));
+}
+
+TEST(StaticMemoryPlanTest, ConcurrentBranchesDoNotShare) {
+  Graph g(OpRegistry::Global());
+  Node* c = FloatConstant(&g);
+  Node* a = test::graph::Unary(&g, "Neg", c);
+  Node* b = test::graph::Unary(&g, "Neg", c);
+  test::graph::Add(&g, a, b);
+
+  std::unique_ptr<StaticMemoryPlan> plan;
+  TF_ASSERT_OK(StaticMemoryPlan::Compute(g, &plan));
+  ASSERT_EQ(plan->slots().size(), 3);
+  EXPECT_EQ(plan->total_bytes(), 3 * kTensorBytes);
+}
+
+TEST(StaticMemoryPlanTest, LoopsAreNotPlanned) {
+  Graph g(OpRegistry::Global());
+  Node* c = FloatConstant(&g);
+  Node* enter = test::graph::Enter(&g, c, "frame");
+  test::graph::Unary(&g, "Neg", enter);
+
+  std::unique_ptr<StaticMemoryPlan> plan;
+  TF_ASSERT_OK(StaticMemoryPlan::Compute(g, &plan));
+  EXPECT_TRUE(plan->empty());
+}
+
+TEST(StaticMemorySlabTest, ServesPlannedOutputsWhenSlotIsFree) {
+  Graph g(OpRegistry::Global());
+  Node* c = FloatConstant(&g);
+  Node* a = test::graph::Unary(&g, "Neg", c);
+  Node* b = test::graph::Unary(&g, "Neg", a);
+  Node* d = test::graph::Unary(&g, "Neg", b);
+
+  std::unique_ptr<StaticMemoryPlan> plan;
+  TF_ASSERT_OK(StaticMemoryPlan::Compute(g, &plan));
+  StaticMemorySlab slab(*plan, cpu_allocator());
+  const TensorShape shape({kNumElements});
+
+  Tensor t;
+  EXPECT_FALSE(slab.AllocateOutput(c->id(), 0, DT_FLOAT, shape, &t));
+  EXPECT_FALSE(slab.AllocateOutput(a->id(), 0, DT_FLOAT,
+                                   TensorShape({2 * kNumElements}), &t));
+
+  auto ta = std::make_unique<Tensor>();
+  ASSERT_TRUE(slab.AllocateOutput(a->id(), 0, DT_FLOAT, shape, ta.get()));
+  EXPECT_EQ(ta->shape(), shape);
+  // `a` is still referenced, e.g. because a kernel aliased it, so `d` cannot
+  // take the memory it shares with `a`.
+  EXPECT_FALSE(slab.AllocateOutput(d->id(), 0, DT_FLOAT, shape, &t));
+  // The same slot cannot be handed out twice either.
+  EXPECT_FALSE(slab.AllocateOutput(a->id(), 0, DT_FLOAT, shape, &t));
+
+  Tensor tb;
+  ASSERT_TRUE(slab.AllocateOutput(b->id(), 0, DT_FLOAT, shape, &tb));
+  const void* a_data = ta->data();
+  ta.reset();
+  Tensor td;
+  ASSERT_TRUE(slab.AllocateOutput(d->id(), 0, DT_FLOAT, shape, &td));
+  EXPECT_EQ(td.data(), a_data);
+  EXPECT_NE(td.data(), tb.data());
+}
+
+TEST(StaticMemorySlabTest, TensorsOutliveSlab) {
+  Graph g(OpRegistry::Global());
+  Node* c = FloatConstant(&g);
+  Node* a = test::graph::Unary(&g, "Neg", c);
+
+  std::unique_ptr<StaticMemoryPlan> plan;
+  TF_ASSERT_OK(StaticMemoryPlan::Compute(g, &plan));
+  Tensor t;
+  {
+    StaticMemorySlab slab(*plan, cpu_allocator());
+    ASSERT_TRUE(slab.AllocateOutput(a->id(), 0, DT_FLOAT,
+                                    TensorShape({kNumElements}), &t));
+  }
+  t.flat<float>().setConstant(1.0f);
+  EXPECT_EQ(t.flat<float>()(kNumElements - 1), 1.0f);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,64 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/tree_reducer.h"
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/errors.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr int kReduceStep = 0;
+constexpr int kBroadcastStep = 1;
+
+}  // namespace
+
+absl::Status TreeReducer::RunReduction() {
+  Tensor value = Blocks(0, 1);
+
+  // Receive from both children at once, then reduce in a fixed order so that
+  // the result does not depend on which arrives first.
+  std::vector<Transfer> children;
+  for (int child = 2 * rank() + 1; child <= 2 * rank() + 2; ++child) {
+    if (child < group_size()) children.push_back({child, Scratch(value)});
+  }
+  TF_RETURN_IF_ERROR(Exchange(kReduceStep, {}, absl::MakeSpan(children)));
+  for (Transfer& child : children) {
+    TF_RETURN_IF_ERROR(Merge(&value, &child.tensor));
+  }
+
+  if (rank() == 0) {
+    TF_RETURN_IF_ERROR(Finalize(&value));
+  } else {
+    const int parent = (rank() - 1) / 2;
+    TF_RETURN_IF_ERROR(Exchange(kReduceStep, {{parent, value}}, {}));
+    std::vector<Transfer> recvs = {{parent, value}};
+    TF_RETURN_IF_ERROR(Exchange(kBroadcastStep, {}, absl::MakeSpan(recvs)));
+  }
+
+  for (Transfer& child : children) child.tensor = value;
+  return Exchange(kBroadcastStep, children, {});
+}
+
+namespace {
+REGISTER_COLLECTIVE(TreeReduce, TreeReducer);
+}  // namespace
+
+}  // namespace tensorflow
@@ -0,0 +1,40 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_TREE_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_TREE_REDUCER_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/point_to_point_reducer.h"
+
+namespace tensorflow {
+
+// Binary-tree implementation of collective all-reduce.
+//
+// Members form a binary heap by rank. The whole tensor is reduced up the tree
+// to rank 0, which applies the final op, and then broadcast back down, in
+// 2*log2(N) steps. Every step moves the whole tensor, so this is meant for
+// tensors too small for splitting them into blocks to pay off.
+class TreeReducer : public PointToPointReducer {
+ public:
+  TreeReducer() : PointToPointReducer("TreeReduce") {}
+
+ protected:
+  int num_blocks() const override { return 1; }
+  absl::Status RunReduction() override;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_TREE_REDUCER_H_
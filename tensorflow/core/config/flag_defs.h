@@ -72,6 +72,14 @@ class Flags {
   TF_DECLARE_FLAG(
       enable_fatal_error_on_collective_abort, false,
       "If true, a fatal error will be raised when a collective is aborted.")
+  TF_DECLARE_FLAG(enable_micro_op_bundling, false,
+                  "If true, clusters of cheap scalar CPU ops are fused into "
+                  "_MicroOpBundle nodes before execution.")
+  // Set with TF_FLAG_SAVED_MODEL_LAZY_LOADING=true.
+  TF_DECLARE_FLAG(saved_model_lazy_loading, false,
+                  "If true, LoadSavedModel restores the variables of a "
+                  "SavedModel when a session run first needs them rather "
+                  "than at load time.")
   // LINT.ThenChange(//tensorflow/core/config/flags_api_wrapper.cc)
 };
 
@@ -57,5 +57,7 @@ PYBIND11_MODULE(flags_pybind, m) {
   TF_PY_DECLARE_FLAG(enable_skip_encapsulation_for_non_tpu_graphs)
   TF_PY_DECLARE_FLAG(enable_graph_debug_info_caching_for_stack_frames)
   TF_PY_DECLARE_FLAG(enable_fatal_error_on_collective_abort)
+  TF_PY_DECLARE_FLAG(enable_micro_op_bundling)
+  TF_PY_DECLARE_FLAG(saved_model_lazy_loading)
   // LINT.ThenChange(//tensorflow/core/config/flag_defs.h)
 };
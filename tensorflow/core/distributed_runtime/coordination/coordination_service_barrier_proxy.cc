@@ -15,13 +15,18 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/coordination/coordination_service_barrier_proxy.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -33,6 +38,165 @@ limitations under the License.
 #include "tsl/profiler/lib/traceme_encode.h"
 
 namespace tensorflow {
+namespace {
+
+// Statuses are published as "<code>:<message>".
+std::string EncodeStatus(const absl::Status& status) {
+  return absl::StrCat(static_cast<int>(status.code()), ":", status.message());
+}
+
+absl::Status DecodeStatus(absl::string_view value) {
+  const size_t colon = value.find(':');
+  int code;
+  if (colon == absl::string_view::npos ||
+      !absl::SimpleAtoi(value.substr(0, colon), &code)) {
+    return absl::InternalError(
+        absl::StrCat("Invalid tree barrier result: ", value));
+  }
+  return absl::Status(static_cast<absl::StatusCode>(code),
+                      value.substr(colon + 1));
+}
+
+// Forwards the calls of a `TreeBarrier` to the agent of the task.
+class ServiceAgent : public TreeBarrier::Agent {
+ public:
+  explicit ServiceAgent(tsl::CoordinationServiceAgent* agent) : agent_(agent) {}
+
+  absl::Status WaitAtBarrier(
+      absl::string_view barrier_id, absl::Duration timeout,
+      const std::vector<CoordinatedTask>& tasks) override {
+    return agent_->WaitAtBarrier(barrier_id, timeout, tasks);
+  }
+  absl::StatusOr<std::string> GetKeyValue(absl::string_view key,
+                                          absl::Duration timeout) override {
+    return agent_->GetKeyValue(key, timeout);
+  }
+  absl::Status InsertKeyValue(absl::string_view key,
+                              absl::string_view value) override {
+    return agent_->InsertKeyValue(key, value);
+  }
+  absl::Status DeleteKeyValue(absl::string_view key) override {
+    return agent_->DeleteKeyValue(key);
+  }
+
+ private:
+  tsl::CoordinationServiceAgent* const agent_;  // Not owned.
+};
+
+}  // namespace
+
+absl::Status TreeBarrier::Wait(tsl::CoordinationServiceAgent* agent,
+                               absl::string_view key, absl::Duration timeout,
+                               const std::vector<CoordinatedTask>& tasks,
+                               int64_t own_index) {
+  ServiceAgent service_agent(agent);
+  return Wait(&service_agent, key, timeout, tasks, own_index);
+}
+
+absl::Status TreeBarrier::Wait(Agent* agent, absl::string_view key,
+                               absl::Duration timeout,
+                               const std::vector<CoordinatedTask>& tasks,
+                               int64_t own_index) {
+  DCHECK_GT(fan_in_, 1);
+  const int64_t num_tasks = tasks.size();
+  const size_t group_size = fan_in_;
+  // The key where `tasks[index]` reads the result of its group at `level`.
+  auto result_key = [key](int level, int64_t begin, int64_t index) {
+    return absl::StrCat(key, "/tree/", level, "/", begin, "/", index);
+  };
+
+  // At level `level`, the tasks at multiples of `stride` (fan_in^level) take
+  // part, in groups of `fan_in_` consecutive ones identified by the index of
+  // their first task. All tasks take part in the top one.
+  int top_level = 0;
+  for (int64_t num_groups = num_tasks; num_groups > fan_in_;
+       num_groups = (num_groups + fan_in_ - 1) / fan_in_) {
+    ++top_level;
+  }
+  struct LedGroup {
+    int level;
+    int64_t begin;
+    int64_t stride;
+  };
+  absl::Status status;
+  std::vector<LedGroup> led_groups;
+  int64_t stride = 1;
+  for (int level = 0;; ++level, stride *= fan_in_) {
+    const bool top = level == top_level;
+    const int64_t span = stride * fan_in_;
+    const int64_t begin = top ? 0 : own_index / span * span;
+    std::vector<CoordinatedTask> group;
+    for (int64_t i = begin; i < num_tasks && group.size() < group_size;
+         i += stride) {
+      group.push_back(tasks[i]);
+    }
+    const bool member = !top && own_index != begin;
+    if (member) {
+      // A result published after the task gave up on it in an earlier use is
+      // dropped before the first task of the group can publish a new one.
+      agent->DeleteKeyValue(result_key(level, begin, own_index)).IgnoreError();
+    }
+    if (group.size() > 1) {
+      tsl::profiler::TraceMe traceme([&] {
+        return tsl::profiler::TraceMeEncode("TreeBarrier::Wait::Up",
+                                            {{"level", level}});
+      });
+      status = agent->WaitAtBarrier(
+          absl::StrCat(key, "/tree/", level, "/", begin), timeout, group);
+    }
+    if (!status.ok() || top) break;
+    if (member) {
+      // The first task of the group brings the result down, after up to one
+      // barrier at each level above. Its key is deleted once read.
+      tsl::profiler::TraceMe traceme("TreeBarrier::Wait::Down");
+      const std::string own_key = result_key(level, begin, own_index);
+      absl::StatusOr<std::string> result =
+          agent->GetKeyValue(own_key, timeout * (top_level - level));
+      status = result.ok() ? DecodeStatus(*result) : result.status();
+      agent->DeleteKeyValue(own_key).IgnoreError();
+      break;
+    }
+    if (group.size() > 1) led_groups.push_back({level, begin, stride});
+  }
+
+  for (auto it = led_groups.rbegin(); it != led_groups.rend(); ++it) {
+    size_t num_members = 1;
+    for (int64_t i = it->begin + it->stride;
+         i < num_tasks && num_members < group_size;
+         i += it->stride, ++num_members) {
+      absl::Status s = agent->InsertKeyValue(
+          result_key(it->level, it->begin, i), EncodeStatus(status));
+      if (!s.ok()) {
+        // The task waiting for this result times out, and the results
+        // published after it carry the error.
+        LOG(ERROR) << "Failed to publish the result of tree barrier " << key
+                   << ": " << s;
+        status.Update(s);
+      }
+    }
+  }
+  return status;
+}
+
+absl::Status BarrierProxy::WaitAtTasks() {
+  if (tree_barrier_ != nullptr &&
+      tasks_.size() > static_cast<size_t>(tree_barrier_->fan_in())) {
+    absl::StatusOr<CoordinatedTask> own_task = agent_->GetOwnTask();
+    if (own_task.ok()) {
+      auto it = absl::c_find_if(tasks_, [&](const CoordinatedTask& task) {
+        return task.job_name() == own_task->job_name() &&
+               task.task_id() == own_task->task_id();
+      });
+      if (it != tasks_.end()) {
+        return tree_barrier_->Wait(agent_, key_, timeout_, tasks_,
+                                   it - tasks_.begin());
+      }
+    }
+  }
+  // TODO(b/198475014) the barrier status will be stored in memory forever.
+  // We should have a mechanism to remove it after it has been passed.
+  return agent_->WaitAtBarrier(key_, timeout_, tasks_);
+}
 
 std::pair<absl::Status, bool> BarrierProxy::Wait() {
   mutex_lock l(mu_);
@@ -59,9 +223,7 @@ std::pair<absl::Status, bool> BarrierProxy::Wait() {
     // Now that all threads are waiting, starts waiting at the global barrier.
     if (tasks_.size() != 1) {
       tsl::profiler::TraceMe traceme("BarrierProxy::Wait::WaitAtBarrier");
-      // TODO(b/198475014) the barrier status will be stored in memory forever.
-      // We should have a mechanism to remove it after it has been passed.
-      status_ = agent_->WaitAtBarrier(key_, timeout_, tasks_);
+      status_ = WaitAtTasks();
     } else {
       status_ = absl::OkStatus();
     }
@@ -118,7 +280,7 @@ absl::Status BarrierProxyManager::Wait(
     auto [iter, inserted] = barriers_.try_emplace(key);
     if (inserted) {
       iter->second = std::make_shared<BarrierProxy>(
-          agent, tasks, num_local_threads, key, timeout);
+          agent, tasks, num_local_threads, key, timeout, tree_barrier_.get());
       VLOG(1) << "BarrierProxy key=" << key << " created.";
     }
     barrier = iter->second;
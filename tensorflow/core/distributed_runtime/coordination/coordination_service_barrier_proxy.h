@@ -23,6 +23,7 @@ limitations under the License.
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "xla/tsl/distributed_runtime/coordination/coordination_service_agent.h"
@@ -34,6 +35,62 @@ limitations under the License.
 
 namespace tensorflow {
 
+// A barrier over many tasks, built from a tree of coordination service
+// barriers over at most `fan_in` tasks each. The service checks the task list
+// sent by every participant of a barrier, so one barrier over N tasks costs it
+// O(N^2) and its latency grows with N; the tree bounds each barrier by
+// `fan_in`.
+//
+// Consecutive tasks are grouped first, so tasks should be ordered by host to
+// aggregate per host. On the way up, each group waits at its own barrier and
+// its first task then joins a group of the next level, up to a top barrier of
+// at most `fan_in` tasks. On the way down, the first task of each group
+// publishes the result in the key-value store under one key per other task of
+// the group, which that task deletes once it has read it. No task keeps count
+// of the uses of a barrier, so a task that restarts stays in step. When a
+// group fails, or a result can't be published, the tasks below get the error,
+// while the groups above time out.
+//
+// All participating tasks must use the same `fan_in`, and pass the same tasks
+// in the same order. Thread-safe.
+class TreeBarrier {
+ public:
+  // The calls to the coordination service made by the tree, so that tests can
+  // fake the service.
+  class Agent {
+   public:
+    virtual ~Agent() = default;
+
+    virtual absl::Status WaitAtBarrier(
+        absl::string_view barrier_id, absl::Duration timeout,
+        const std::vector<CoordinatedTask>& tasks) = 0;
+    virtual absl::StatusOr<std::string> GetKeyValue(absl::string_view key,
+                                                    absl::Duration timeout) = 0;
+    virtual absl::Status InsertKeyValue(absl::string_view key,
+                                        absl::string_view value) = 0;
+    virtual absl::Status DeleteKeyValue(absl::string_view key) = 0;
+  };
+
+  explicit TreeBarrier(int fan_in) : fan_in_(fan_in) {}
+
+  // Waits at the barrier `key` with `tasks`, of which the task of `agent` is
+  // `tasks[own_index]`. Each barrier of the tree gets the whole `timeout`, and
+  // a task waiting for the result of its group gets the time of the barriers
+  // left above it.
+  absl::Status Wait(tsl::CoordinationServiceAgent* agent, absl::string_view key,
+                    absl::Duration timeout,
+                    const std::vector<CoordinatedTask>& tasks,
+                    int64_t own_index);
+  absl::Status Wait(Agent* agent, absl::string_view key, absl::Duration timeout,
+                    const std::vector<CoordinatedTask>& tasks,
+                    int64_t own_index);
+
+  int fan_in() const { return fan_in_; }
+
+ private:
+  const int fan_in_;
+};
+
 // A local proxy connecting the coordination service's barrier.
 // The barrier provided by coordination service can only block at tasks (i.e.,
 // TPU workers), but sometimes we need a barrier that can block at different
@@ -58,14 +115,17 @@ class BarrierProxy {
   // `tasks` specifies all participating coordinated tasks and
   // `num_local_threads` specifies the number of threads in this task to
   // particiate. If no tasks are specified, the barrier will block for all the
-  // connected tasks.
+  // connected tasks. If `tree_barrier` is set, it is used when there are more
+  // tasks than its fan-in.
   BarrierProxy(tsl::CoordinationServiceAgent* agent,
                std::vector<CoordinatedTask> tasks, int num_local_threads,
-               absl::string_view key, absl::Duration timeout)
+               absl::string_view key, absl::Duration timeout,
+               TreeBarrier* tree_barrier = nullptr)
       : key_(key),
         agent_(agent),
         tasks_(std::move(tasks)),
         timeout_(timeout),
+        tree_barrier_(tree_barrier),
         num_local_threads_(num_local_threads) {}
 
   ~BarrierProxy() = default;
@@ -76,10 +136,14 @@ class BarrierProxy {
   std::pair<absl::Status, bool> Wait();
 
  private:
+  // Waits at the barrier of the tasks, once all the local threads arrived.
+  absl::Status WaitAtTasks();
+
   const std::string key_;
   tsl::CoordinationServiceAgent* agent_;
   const std::vector<CoordinatedTask> tasks_;
   absl::Duration timeout_;
+  TreeBarrier* const tree_barrier_;  // Not owned.
 
   mutex mu_;
   condition_variable cv_ TF_GUARDED_BY(mu_);
@@ -94,6 +158,8 @@ class BarrierProxy {
 // Usage:
 //   // Main thread creates a `BarrierProxy`:
 //   BarrierProxyManager barrier_mgr;
+//   // Or, for clusters of thousands of tasks:
+//   BarrierProxyManager barrier_mgr(/*tree_fan_in=*/16);
 //
 //   // Exactly `num_local_threads` threads call:
 //   Status s = barrier_mgr.Wait(agent, task, num_local_threads, key, timeout);
@@ -101,7 +167,12 @@ class BarrierProxyManager {
  public:
   BarrierProxyManager(const BarrierProxyManager&) = delete;
   void operator=(const BarrierProxyManager&) = delete;
-  BarrierProxyManager() = default;
+  // With a `tree_fan_in` greater than 1, barriers over more tasks than that
+  // go through a `TreeBarrier`.
+  explicit BarrierProxyManager(int tree_fan_in = 0)
+      : tree_barrier_(tree_fan_in > 1 ? std::make_unique<TreeBarrier>(
+                                            tree_fan_in)
+                                      : nullptr) {}
   ~BarrierProxyManager() = default;
 
   // Waits at the barrier backed by the coord service `agent` and keyed by
@@ -117,6 +188,7 @@ class BarrierProxyManager {
   size_t size() const;
 
  private:
+  const std::unique_ptr<TreeBarrier> tree_barrier_;
   mutable mutex mu_;
   absl::flat_hash_map<std::string, std::shared_ptr<BarrierProxy>> barriers_
       TF_GUARDED_BY(mu_);
@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/distributed_runtime/coordination/coordination_service_barrier_proxy.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -23,7 +25,10 @@ limitations under the License.
 #include <vector>
 
 #include <gmock/gmock.h>
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -32,10 +37,13 @@ limitations under the License.
 #include "xla/tsl/distributed_runtime/coordination/coordination_service_agent.h"
 #include "xla/tsl/protobuf/coordination_config.pb.h"
 #include "xla/tsl/protobuf/coordination_service.pb.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/platform/threadpool.h"
 
 namespace tensorflow {
@@ -231,5 +239,370 @@ TEST(BarrierProxyManagerTest, DifferentKeysDoNotInterfereWithEachOther) {
   }
 }
 
+// An in-process stand-in for the barriers and the key-value store of the
+// coordination service. Like the service, it checks the task list of every
+// barrier call against the first one.
+class FakeCoordinationService {
+ public:
+  // Makes the barrier `barrier_id` fail with `status`.
+  void FailBarrier(absl::string_view barrier_id, absl::Status status) {
+    mutex_lock l(mu_);
+    failed_barriers_[barrier_id] = status;
+  }
+
+  // Makes the insertions of `key` fail with `status`.
+  void FailInsertKeyValue(absl::string_view key, absl::Status status) {
+    mutex_lock l(mu_);
+    failed_keys_[key] = status;
+  }
+
+  // Makes the barrier `barrier_id` return `delay` after it passed.
+  void DelayBarrier(absl::string_view barrier_id, absl::Duration delay) {
+    mutex_lock l(mu_);
+    barrier_delays_[barrier_id] = delay;
+  }
+
+  absl::Duration BarrierDelay(absl::string_view barrier_id) {
+    mutex_lock l(mu_);
+    auto it = barrier_delays_.find(barrier_id);
+    return it == barrier_delays_.end() ? absl::ZeroDuration() : it->second;
+  }
+
+  absl::Status WaitAtBarrier(absl::string_view barrier_id, int64_t counter,
+                             absl::Duration timeout,
+                             const std::vector<CoordinatedTask>& tasks) {
+    const std::string name = absl::StrCat(barrier_id, "#", counter);
+    mutex_lock l(mu_);
+    max_barrier_size_ = std::max<int64_t>(max_barrier_size_, tasks.size());
+    std::unique_ptr<BarrierState>& barrier = barriers_[name];
+    if (barrier == nullptr) {
+      barrier = std::make_unique<BarrierState>();
+      for (const CoordinatedTask& task : tasks) {
+        barrier->tasks.insert(task.task_id());
+      }
+      auto it = failed_barriers_.find(barrier_id);
+      if (it != failed_barriers_.end()) {
+        barrier->status = it->second;
+        barrier->passed = true;
+      }
+    }
+    BarrierState* state = barrier.get();
+    if (!state->passed &&
+        (tasks.size() != state->tasks.size() ||
+         absl::c_any_of(tasks, [state](const CoordinatedTask& task) {
+           return !state->tasks.contains(task.task_id());
+         }))) {
+      state->status = absl::InvalidArgumentError("Conflicting tasks");
+      state->passed = true;
+      state->cv.notify_all();
+    }
+    if (!state->passed && ++state->num_arrived == state->tasks.size()) {
+      state->passed = true;
+      state->cv.notify_all();
+    }
+    while (!state->passed) {
+      if (WaitForMilliseconds(&l, &state->cv,
+                              absl::ToInt64Milliseconds(timeout)) ==
+              kCond_Timeout &&
+          !state->passed) {
+        state->status = absl::DeadlineExceededError(name);
+        state->passed = true;
+        state->cv.notify_all();
+      }
+    }
+    absl::Status status = state->status;
+    if (++state->num_exited == state->tasks.size()) barriers_.erase(name);
+    return status;
+  }
+
+  absl::StatusOr<std::string> GetKeyValue(absl::string_view key,
+                                          absl::Duration timeout) {
+    mutex_lock l(mu_);
+    std::unique_ptr<KeyState>& entry = keys_[key];
+    if (entry == nullptr) entry = std::make_unique<KeyState>();
+    KeyState* state = entry.get();
+    while (!state->value.has_value()) {
+      if (WaitForMilliseconds(&l, &state->cv,
+                              absl::ToInt64Milliseconds(timeout)) ==
+              kCond_Timeout &&
+          !state->value.has_value()) {
+        return absl::DeadlineExceededError(key);
+      }
+    }
+    return *state->value;
+  }
+
+  absl::Status InsertKeyValue(absl::string_view key, absl::string_view value) {
+    mutex_lock l(mu_);
+    auto it = failed_keys_.find(key);
+    if (it != failed_keys_.end()) return it->second;
+    std::unique_ptr<KeyState>& entry = keys_[key];
+    if (entry == nullptr) entry = std::make_unique<KeyState>();
+    if (entry->value.has_value()) return absl::AlreadyExistsError(key);
+    entry->value = std::string(value);
+    entry->cv.notify_all();
+    return absl::OkStatus();
+  }
+
+  absl::Status DeleteKeyValue(absl::string_view key) {
+    mutex_lock l(mu_);
+    keys_.erase(key);
+    return absl::OkStatus();
+  }
+
+  int64_t max_barrier_size() {
+    mutex_lock l(mu_);
+    return max_barrier_size_;
+  }
+
+  int64_t num_keys() {
+    mutex_lock l(mu_);
+    return keys_.size();
+  }
+
+ private:
+  struct BarrierState {
+    absl::flat_hash_set<int> tasks;
+    size_t num_arrived = 0;
+    size_t num_exited = 0;
+    bool passed = false;
+    absl::Status status;
+    condition_variable cv;
+  };
+  struct KeyState {
+    std::optional<std::string> value;
+    condition_variable cv;
+  };
+
+  mutex mu_;
+  absl::flat_hash_map<std::string, std::unique_ptr<BarrierState>> barriers_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, absl::Status> failed_barriers_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, absl::Status> failed_keys_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, absl::Duration> barrier_delays_
+      TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string, std::unique_ptr<KeyState>> keys_
+      TF_GUARDED_BY(mu_);
+  int64_t max_barrier_size_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// The agent of one task, which counts the uses of each barrier like the real
+// one. Not thread-safe.
+class FakeCoordinationServiceAgent : public TreeBarrier::Agent {
+ public:
+  explicit FakeCoordinationServiceAgent(FakeCoordinationService* service)
+      : service_(service) {}
+
+  absl::Status WaitAtBarrier(
+      std::string_view barrier_id, absl::Duration timeout,
+      const std::vector<CoordinatedTask>& tasks) override {
+    absl::Status status = service_->WaitAtBarrier(
+        barrier_id, counters_[barrier_id]++, timeout, tasks);
+    absl::SleepFor(service_->BarrierDelay(barrier_id));
+    return status;
+  }
+  absl::StatusOr<std::string> GetKeyValue(std::string_view key,
+                                          absl::Duration timeout) override {
+    return service_->GetKeyValue(key, timeout);
+  }
+  absl::Status InsertKeyValue(std::string_view key,
+                              std::string_view value) override {
+    return service_->InsertKeyValue(key, value);
+  }
+  absl::Status DeleteKeyValue(std::string_view key) override {
+    return service_->DeleteKeyValue(key);
+  }
+
+ private:
+  FakeCoordinationService* service_;
+  absl::flat_hash_map<std::string, int64_t> counters_;
+};
+
+std::vector<CoordinatedTask> MakeTasks(int num_tasks) {
+  std::vector<CoordinatedTask> tasks(num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    tasks[i].set_job_name("worker");
+    tasks[i].set_task_id(i);
+  }
+  return tasks;
+}
+
+// Simulated tasks, each with its own agent and `TreeBarrier`, or waiting at
+// flat barriers without `fan_in`.
+class SimulatedTasks {
+ public:
+  SimulatedTasks(int num_tasks, std::optional<int> fan_in)
+      : tasks_(MakeTasks(num_tasks)),
+        pool_(Env::Default(), "SimulatedTasks", num_tasks) {
+    for (int i = 0; i < num_tasks; ++i) {
+      agents_.push_back(
+          std::make_unique<FakeCoordinationServiceAgent>(&service_));
+      if (fan_in.has_value()) {
+        tree_barriers_.push_back(std::make_unique<TreeBarrier>(*fan_in));
+      }
+    }
+  }
+
+  // Makes all tasks wait at the barrier `key`, and returns their statuses.
+  std::vector<absl::Status> Wait(absl::string_view key,
+                                 absl::Duration timeout) {
+    std::vector<absl::Status> statuses(tasks_.size());
+    BlockingCounter counter(tasks_.size());
+    for (int i = 0; i < tasks_.size(); ++i) {
+      pool_.Schedule([&, i]() {
+        statuses[i] =
+            tree_barriers_.empty()
+                ? agents_[i]->WaitAtBarrier(key, timeout, tasks_)
+                : tree_barriers_[i]->Wait(agents_[i].get(), key, timeout,
+                                          tasks_, i);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    return statuses;
+  }
+
+  // Replaces the `TreeBarrier` of task `i`, as if the task restarted.
+  void RestartTreeBarrier(int i) {
+    tree_barriers_[i] =
+        std::make_unique<TreeBarrier>(tree_barriers_[i]->fan_in());
+  }
+
+  FakeCoordinationService& service() { return service_; }
+
+ private:
+  FakeCoordinationService service_;
+  const std::vector<CoordinatedTask> tasks_;
+  std::vector<std::unique_ptr<FakeCoordinationServiceAgent>> agents_;
+  std::vector<std::unique_ptr<TreeBarrier>> tree_barriers_;
+  thread::ThreadPool pool_;
+};
+
+TEST(TreeBarrierTest, AllTasksPass) {
+  for (int num_tasks : {2, 4, 5, 16, 17, 64, 100}) {
+    SimulatedTasks tasks(num_tasks, /*fan_in=*/4);
+    // Twice, so that the results of the first use are reclaimed.
+    for (int use = 0; use < 2; ++use) {
+      for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+        ASSERT_EQ(status, absl::OkStatus()) << num_tasks;
+      }
+    }
+    EXPECT_LE(tasks.service().max_barrier_size(), 4);
+    // Every result was read and deleted.
+    EXPECT_EQ(tasks.service().num_keys(), 0);
+  }
+}
+
+TEST(TreeBarrierTest, RestartedTaskStaysInStep) {
+  SimulatedTasks tasks(16, /*fan_in=*/4);
+  for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+    ASSERT_EQ(status, absl::OkStatus());
+  }
+  // Task 5 reads the result of its group, led by task 4, whose barrier has
+  // been used once already.
+  tasks.RestartTreeBarrier(5);
+  for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+    EXPECT_EQ(status, absl::OkStatus());
+  }
+}
+
+TEST(TreeBarrierTest, StaleResultIsIgnored) {
+  SimulatedTasks tasks(16, /*fan_in=*/4);
+  // Left by an earlier use that task 5 gave up on.
+  ASSERT_EQ(tasks.service().InsertKeyValue(
+                absl::StrCat(kTestKey, "/tree/0/4/5"),
+                absl::StrCat(
+                    static_cast<int>(absl::StatusCode::kDeadlineExceeded),
+                    ":stale")),
+            absl::OkStatus());
+  for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+    EXPECT_EQ(status, absl::OkStatus());
+  }
+  EXPECT_EQ(tasks.service().num_keys(), 0);
+}
+
+TEST(TreeBarrierTest, ResultWaitOutlastsOneTimeout) {
+  // 64 tasks in three levels. The barriers above the first level take most
+  // of the timeout each, so that the results reach the first level after
+  // more than one.
+  SimulatedTasks tasks(64, /*fan_in=*/4);
+  for (int begin = 0; begin < 64; begin += 16) {
+    tasks.service().DelayBarrier(absl::StrCat(kTestKey, "/tree/1/", begin),
+                                 kTestTimeout * 0.6);
+  }
+  tasks.service().DelayBarrier(absl::StrCat(kTestKey, "/tree/2/0"),
+                               kTestTimeout * 0.6);
+  for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+    EXPECT_EQ(status, absl::OkStatus());
+  }
+}
+
+TEST(TreeBarrierTest, ErrorReachesAllTasksBelow) {
+  // 16 tasks in 4 groups, whose first tasks form the top barrier.
+  SimulatedTasks tasks(16, /*fan_in=*/4);
+  tasks.service().FailBarrier(absl::StrCat(kTestKey, "/tree/1/0"),
+                              absl::InternalError("top failed"));
+  for (const absl::Status& status : tasks.Wait(kTestKey, kTestTimeout)) {
+    EXPECT_EQ(status, absl::InternalError("top failed"));
+  }
+}
+
+TEST(TreeBarrierTest, PublishErrorIsTheResult) {
+  // 16 tasks in 4 groups. Task 0 fails to publish the result to task 1, the
+  // first of its group to get it.
+  SimulatedTasks tasks(16, /*fan_in=*/4);
+  tasks.service().FailInsertKeyValue(absl::StrCat(kTestKey, "/tree/0/0/1"),
+                                     absl::UnavailableError("insert failed"));
+  const std::vector<absl::Status> statuses =
+      tasks.Wait(kTestKey, kTestTimeout);
+  EXPECT_EQ(statuses[0], absl::UnavailableError("insert failed"));
+  EXPECT_TRUE(absl::IsDeadlineExceeded(statuses[1])) << statuses[1];
+  EXPECT_EQ(statuses[2], absl::UnavailableError("insert failed"));
+  EXPECT_EQ(statuses[3], absl::UnavailableError("insert failed"));
+  for (int i = 4; i < 16; ++i) {
+    EXPECT_EQ(statuses[i], absl::OkStatus()) << i;
+  }
+}
+
+TEST(BarrierProxyTest, UsesTreeBarrierOnlyForManyTasks) {
+  auto agent = std::make_unique<MockCoordinationServiceAgent>();
+  TreeBarrier tree_barrier(/*fan_in=*/4);
+  // The agent is not connected, so its task is unknown and the barrier falls
+  // back to a flat one.
+  EXPECT_CALL(*agent, WaitAtBarrier(kTestKey, kTestTimeout, _))
+      .WillOnce(Return(absl::OkStatus()));
+  BarrierProxy barrier(agent.get(), MakeTasks(8), /*num_local_threads=*/1,
+                       kTestKey, kTestTimeout, &tree_barrier);
+  auto [status, last_exit] = barrier.Wait();
+  EXPECT_EQ(status, absl::OkStatus());
+  EXPECT_TRUE(last_exit);
+}
+
+// Simulates a barrier over `state.range(0)` tasks, flat or through a tree of
+// fan-in `state.range(1)`.
+void BM_Barrier(::testing::benchmark::State& state) {
+  const int num_tasks = state.range(0);
+  const int fan_in = state.range(1);
+  SimulatedTasks tasks(num_tasks, fan_in > 1 ? std::optional<int>(fan_in)
+                                             : std::nullopt);
+  for (auto s : state) {
+    for (const absl::Status& status : tasks.Wait(kTestKey, absl::Minutes(1))) {
+      TF_CHECK_OK(status);
+    }
+  }
+}
+// The tasks run on other threads, so wall time is what is compared.
+BENCHMARK(BM_Barrier)
+    ->UseRealTime()
+    ->ArgPair(256, 0)
+    ->ArgPair(256, 16)
+    ->ArgPair(1024, 0)
+    ->ArgPair(1024, 16)
+    ->ArgPair(4096, 0)
+    ->ArgPair(4096, 16)
+    ->ArgPair(4096, 64);
+
 }  // namespace
 }  // namespace tensorflow
@@ -28,6 +28,7 @@ limitations under the License.
 
 #include "absl/container/fixed_array.h"
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
 #include "tensorflow/c/eager/abstract_tensor_handle.h"
@@ -42,6 +43,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/eager/cluster_function_library_runtime.h"
 #include "tensorflow/core/distributed_runtime/eager/remote_mgr.h"
 #include "tensorflow/core/distributed_runtime/eager/remote_tensor_handle.h"
+#include "tensorflow/core/distributed_runtime/error_payloads.h"
 #include "tensorflow/core/distributed_runtime/message_wrappers.h"
 #include "tensorflow/core/distributed_runtime/rpc_collective_executor_mgr.h"
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
@@ -738,6 +740,14 @@ absl::Status EagerServiceImpl::Enqueue(CallOptions* call_opts,
       if (stream_id != kInvalidStreamId) {
         context->Context()->RemoteMgr()->DeleteExecutorForStream(stream_id);
       }
+      if (item.has_operation() && response->queue_response_size() > 1) {
+        EnqueueFailure failure;
+        failure.set_operation_id(item.operation().id());
+        for (int i = 0; i < response->queue_response_size() - 1; ++i) {
+          *failure.add_queue_response() = response->queue_response(i);
+        }
+        s.SetPayload(kEnqueueFailure, absl::Cord(failure.SerializeAsString()));
+      }
       return s;
     }
   }
@@ -25,6 +25,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/synchronization/notification.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
@@ -34,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/eager/tensor_handle.h"
 #include "tensorflow/core/distributed_runtime/eager/cluster_function_library_runtime.h"
 #include "tensorflow/core/distributed_runtime/eager/remote_mgr.h"
+#include "tensorflow/core/distributed_runtime/error_payloads.h"
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 #include "tensorflow/core/distributed_runtime/session_mgr.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
@@ -525,6 +527,71 @@ TEST_F(EagerServiceImplTest, BasicTest) {
                                                &close_context_response));
 }
 
+TEST_F(EagerServiceImplTest, EnqueueFailureReturnsEarlierResponses) {
+  TestEagerServiceImpl eager_service_impl(&worker_env_);
+
+  uint64_t context_id = random::New64();
+
+  CreateContextRequest request;
+  request.mutable_server_def()->set_job_name("localhost");
+  request.mutable_server_def()->set_task_index(0);
+  request.set_context_id(context_id);
+  CreateContextResponse response;
+
+  TF_ASSERT_OK(eager_service_impl.CreateContext(&request, &response));
+
+  EnqueueRequest remote_enqueue_request;
+  remote_enqueue_request.set_context_id(context_id);
+  EnqueueResponse remote_enqueue_response;
+
+  std::unordered_map<std::string, AttrValue> const_attrs;
+  AttrValue val;
+  val.set_type(tensorflow::DataType::DT_FLOAT);
+  const_attrs.insert({"dtype", val});
+  val.Clear();
+  SetTensorProto(val.mutable_tensor());
+  const_attrs.insert({"value", val});
+
+  AddOperationToEnqueueRequest(1, "Const", {}, const_attrs,
+                               "/job:localhost/replica:0/task:0/device:CPU:0",
+                               &remote_enqueue_request);
+
+  std::unordered_map<std::string, AttrValue> attrs;
+  val.Clear();
+  val.set_type(tensorflow::DataType::DT_FLOAT);
+  attrs.insert({"T", val});
+  val.Clear();
+  val.set_b(false);
+  attrs.insert({"transpose_a", val});
+  attrs.insert({"transpose_b", val});
+
+  // The second input doesn't exist.
+  AddOperationToEnqueueRequest(
+      2, "MatMul", {std::make_pair(1, 0), std::make_pair(3, 0)}, attrs,
+      "/job:localhost/replica:0/task:0/device:CPU:0", &remote_enqueue_request);
+
+  absl::Status status = eager_service_impl.Enqueue(
+      nullptr, &remote_enqueue_request, &remote_enqueue_response);
+  ASSERT_FALSE(status.ok());
+
+  std::optional<absl::Cord> payload = status.GetPayload(kEnqueueFailure);
+  ASSERT_TRUE(payload.has_value());
+  EnqueueFailure failure;
+  ASSERT_TRUE(failure.ParseFromString(std::string(*payload)));
+  EXPECT_EQ(failure.operation_id(), 2);
+  ASSERT_EQ(failure.queue_response_size(), 1);
+  auto& const_result_shape = failure.queue_response(0).shape(0);
+  EXPECT_EQ(const_result_shape.dim(0).size(), 2);
+  EXPECT_EQ(const_result_shape.dim(1).size(), 2);
+
+  CloseContextRequest close_context_request;
+  close_context_request.set_context_id(context_id);
+  close_context_request.set_context_view_id(0);
+  CloseContextResponse close_context_response;
+  TF_ASSERT_OK(eager_service_impl.CloseContext(&close_context_request,
+                                               &close_context_response));
+}
+
 class EagerServiceImplFunctionTest : public EagerServiceImplTest {
  public:
   EagerServiceImplFunctionTest() : EagerServiceImplTest() {}
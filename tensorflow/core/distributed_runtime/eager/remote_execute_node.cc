@@ -15,28 +15,92 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/eager/remote_execute_node.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "tensorflow/core/distributed_runtime/error_payloads.h"
 
 namespace tensorflow {
 namespace eager {
 
+namespace {
+
+// What a node needs once its request is done, since the node may be destroyed
+// as soon as the request of a node coalesced before it is done.
+struct PendingRemoteExecute {
+  absl::InlinedVector<TensorHandle*, 4UL> inputs;
+  absl::InlinedVector<TensorHandle*, 2UL> retvals;
+  Device* device;
+  uint64_t context_view_id;
+  int64_t operation_id;
+  // Index of the queue response of the node's operation.
+  int queue_index;
+  StatusCallback done;
+};
+
+}  // namespace
+
 void RemoteExecuteNode::RunAsync(StatusCallback done) {
+  RunAsyncCoalesced({}, absl::MakeSpan(&done, 1));
+}
+
+bool RemoteExecuteNode::CanCoalesceWith(AsyncRemoteExecuteNode* next) {
+  RemoteExecuteNode* node = next->AsRemoteExecuteNode();
+  // The coalesced request is sent with the call options of this node, so the
+  // nodes must be cancelled together.
+  return node != nullptr && node->eager_context_ == eager_context_ &&
+         node->eager_client_ == eager_client_ &&
+         node->context_view_id_ == context_view_id_ &&
+         node->cancellation_manager_ == cancellation_manager_ &&
+         node->request_->context_id() == request_->context_id();
+}
+
+void RemoteExecuteNode::RunAsyncCoalesced(
+    absl::Span<AsyncRemoteExecuteNode* const> next,
+    absl::Span<StatusCallback> dones) {
+  DCHECK_EQ(dones.size(), next.size() + 1);
   auto response = std::make_shared<EnqueueResponse>();
 
-  const absl::InlinedVector<TensorHandle*, 4UL>& inputs = inputs_;
-  const absl::InlinedVector<TensorHandle*, 2UL>& retvals = retvals_;
-  Device* device = device_;
+  // A single node sends its own request, which outlives the call.
+  EnqueueRequest* request = request_.get();
+  std::shared_ptr<EnqueueRequest> coalesced_request;
+  auto pending = std::make_shared<std::vector<PendingRemoteExecute>>();
+  pending->reserve(dones.size());
+  for (size_t i = 0; i < dones.size(); ++i) {
+    RemoteExecuteNode* node =
+        i == 0 ? this : next[i - 1]->AsRemoteExecuteNode();
+    int queue_index = 0;
+    if (!next.empty()) {
+      if (coalesced_request == nullptr) {
+        coalesced_request = std::make_shared<EnqueueRequest>();
+        coalesced_request->set_context_id(request_->context_id());
+        request = coalesced_request.get();
+      }
+      queue_index = request->queue_size();
+      for (const QueueItem& item : node->request_->queue()) {
+        *request->add_queue() = item;
+      }
+    }
+    pending->push_back({node->inputs_, node->retvals_, node->device_,
+                        node->context_view_id_,
+                        node->request_->queue(0).operation().id(), queue_index,
+                        std::move(dones[i])});
+  }
 
   // Filled and used only when VLOG(3) is on.
   std::string rpc_description;
   if (VLOG_IS_ON(3)) {
     std::vector<std::string> ops;
-    ops.reserve(request_->queue_size());
-    for (const QueueItem& item : request_->queue()) {
+    ops.reserve(request->queue_size());
+    for (const QueueItem& item : request->queue()) {
       if (item.has_operation()) {
         ops.push_back(item.operation().name());
       } else {
@@ -58,67 +122,99 @@ void RemoteExecuteNode::RunAsync(StatusCallback done) {
   if (cm != nullptr) {
     token = cm->get_cancellation_token();
     const bool already_cancelled = !cm->RegisterCallback(
-        token, [call_opts, response, done]() { call_opts->StartCancel(); });
+        token, [call_opts, response]() { call_opts->StartCancel(); });
     if (already_cancelled) {
       absl::Status s = absl::CancelledError("RemoteExecuteNode::RunAsync");
-      for (size_t i = 0; i < retvals.size(); ++i) {
-        retvals[i]->PoisonRemote(s, device, context_view_id_);
+      for (PendingRemoteExecute& node : *pending) {
+        for (auto handle : node.retvals) {
+          handle->PoisonRemote(s, node.device, node.context_view_id);
+        }
+        node.done(s);
       }
-      done(s);
       return;
     }
   }
 
-  for (auto handle : inputs_) {
-    handle->Ref();
-  }
-  for (auto handle : retvals) {
-    handle->Ref();
+  for (const PendingRemoteExecute& node : *pending) {
+    for (auto handle : node.inputs) {
+      handle->Ref();
+    }
+    for (auto handle : node.retvals) {
+      handle->Ref();
+    }
   }
 
   eager_client_->StreamingEnqueueAsync(
-      eager_context_->Executor().StreamingEnqueue(), call_opts.get(),
-      request_.get(), response.get(),
-      [inputs, retvals, call_opts, response, device,
-       context_view_id = context_view_id_, rpc_description, cm, token,
-       done](const absl::Status& status) {
+      eager_context_->Executor().StreamingEnqueue(), call_opts.get(), request,
+      response.get(),
+      [pending, coalesced_request, call_opts, response, rpc_description, cm,
+       token](const absl::Status& status) {
         if (cm != nullptr) {
           cm->TryDeregisterCallback(token);
         }
-        for (auto handle : inputs) {
-          handle->Unref();
-        }
         if (status.ok()) {
           VLOG(3) << "Completed successfully: " << rpc_description;
         } else {
           VLOG(3) << "Failed: " << rpc_description << " with status "
                   << status.ToString();
         }
-        for (size_t i = 0; i < retvals.size(); ++i) {
+        // If the operation of a coalesced node failed, the nodes before it
+        // were run and get their responses from the EnqueueFailure. A failure
+        // of another operation, e.g. of an earlier request on the stream,
+        // fails all the nodes.
+        EnqueueFailure failure;
+        absl::Status error = status;
+        size_t num_run = status.ok() ? pending->size() : 0;
+        std::optional<absl::Cord> payload = status.GetPayload(kEnqueueFailure);
+        if (payload.has_value()) {
+          error.ErasePayload(kEnqueueFailure);
+          if (failure.ParseFromString(std::string(*payload))) {
+            for (size_t i = 0; i < pending->size(); ++i) {
+              if ((*pending)[i].operation_id == failure.operation_id()) {
+                num_run = i;
+                break;
+              }
+            }
+          }
+        }
+        for (size_t n = 0; n < pending->size(); ++n) {
+          PendingRemoteExecute& node = (*pending)[n];
+          const QueueResponse* queue_response = nullptr;
           if (status.ok()) {
-            const std::string output_device =
-                response->queue_response(0).device().empty()
-                    ? ""
-                    : response->queue_response(0).device(i);
-            absl::Status s = retvals[i]->SetRemoteShapeAndDevice(
-                response->queue_response(0).shape(i), device, context_view_id,
-                output_device);
-
-            if (!s.ok()) {
-              LOG(ERROR) << "Ignoring an error encountered when setting "
-                            "remote shape of tensor handle: "
-                         << retvals[i]
-                         << " with execute status: " << status.ToString()
-                         << " and SetRemoteShape status: " << s.ToString()
-                         << "\nThis should never happen. "
-                            "Please file an issue with the TensorFlow Team.";
+            queue_response = &response->queue_response(node.queue_index);
+          } else if (n < num_run &&
+                     node.queue_index < failure.queue_response_size()) {
+            queue_response = &failure.queue_response(node.queue_index);
+          }
+          for (auto handle : node.inputs) {
+            handle->Unref();
+          }
+          for (size_t i = 0; i < node.retvals.size(); ++i) {
+            TensorHandle* retval = node.retvals[i];
+            if (queue_response != nullptr) {
+              const std::string output_device =
+                  queue_response->device().empty() ? ""
+                                                   : queue_response->device(i);
+              absl::Status s = retval->SetRemoteShapeAndDevice(
+                  queue_response->shape(i), node.device, node.context_view_id,
+                  output_device);
+
+              if (!s.ok()) {
+                LOG(ERROR) << "Ignoring an error encountered when setting "
+                              "remote shape of tensor handle: "
+                           << retval
+                           << " with execute status: " << status.ToString()
+                           << " and SetRemoteShape status: " << s.ToString()
+                           << "\nThis should never happen. "
+                              "Please file an issue with the TensorFlow Team.";
+              }
+            } else {
+              retval->PoisonRemote(error, node.device, node.context_view_id);
             }
-          } else {
-            retvals[i]->PoisonRemote(status, device, context_view_id);
+            retval->Unref();
           }
-          retvals[i]->Unref();
+          node.done(queue_response != nullptr ? absl::OkStatus() : error);
         }
-        done(status);
       });
 }
 
@@ -98,6 +98,14 @@ class RemoteExecuteNode : public AsyncRemoteExecuteNode {
 
   void RunAsync(StatusCallback done) override;
 
+  // Consecutive nodes enqueued on the same remote context are sent in a
+  // single EnqueueRequest. Their output handle ids are assigned by the client,
+  // so the remote worker can run them back to back.
+  bool CanCoalesceWith(AsyncRemoteExecuteNode* next) override;
+
+  void RunAsyncCoalesced(absl::Span<AsyncRemoteExecuteNode* const> next,
+                         absl::Span<StatusCallback> dones) override;
+
   absl::Status SyncExecutors() override {
     return eager_context_->SyncExecutors();
   }
@@ -118,6 +126,8 @@ class RemoteExecuteNode : public AsyncRemoteExecuteNode {
     return eager_client_->allow_multiple_pending_requests();
   }
 
+  RemoteExecuteNode* AsRemoteExecuteNode() override { return this; }
+
   std::string DebugString() const override {
     std::string out = "[RemoteExecuteNode]";
     absl::StrAppend(&out, " request: ", request_->DebugString());
@@ -30,5 +30,12 @@ constexpr char kWorkerPossiblyRestarted[] =
 constexpr char kWorkerPreemption[] =
     "type.googleapis.com/tensorflow.distributed_runtime.WorkerPreemption";
 
+// Proto: tensorflow::eager::EnqueueFailure
+// Location: tensorflow/core/protobuf/eager_service.proto
+// Usage: Holds the responses of the queue items that an Enqueue request ran
+// before the one that failed.
+constexpr char kEnqueueFailure[] =
+    "type.googleapis.com/tensorflow.eager.EnqueueFailure";
+
 }  // namespace tensorflow
 #endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_ERROR_PAYLOADS_H_
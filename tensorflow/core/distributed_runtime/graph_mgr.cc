@@ -62,6 +62,9 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_partition.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -107,6 +110,58 @@ GraphMgr::Item::~Item() {
   }
 }
 
+// Returns the pool the partitions of registered graphs are built on, or
+// nullptr if they are built sequentially. Its size is bounded by
+// TF_GRAPH_MGR_REGISTER_THREADS, which defaults to the number of cores.
+static thread::ThreadPool* RegisterThreadPool() {
+  static thread::ThreadPool* pool = []() -> thread::ThreadPool* {
+    const int64_t default_num_threads = port::MaxParallelism();
+    int64_t num_threads;
+    absl::Status status = ReadInt64FromEnvVar(
+        "TF_GRAPH_MGR_REGISTER_THREADS", default_num_threads, &num_threads);
+    if (!status.ok()) {
+      LOG(ERROR) << "Ignoring TF_GRAPH_MGR_REGISTER_THREADS: " << status;
+      num_threads = default_num_threads;
+    }
+    if (num_threads <= 1) return nullptr;
+    return new thread::ThreadPool(Env::Default(), "graph_mgr_register",
+                                  num_threads);
+  }();
+  return pool;
+}
+
+// Runs `fn` for the units [0, num_units) of an item, concurrently if
+// `parallel`, and returns the first error.
+static absl::Status RunForEachUnit(
+    bool parallel, int num_units, const std::function<absl::Status(int)>& fn) {
+  thread::ThreadPool* pool = RegisterThreadPool();
+  if (pool == nullptr || !parallel || num_units <= 1) {
+    for (int i = 0; i < num_units; ++i) {
+      TF_RETURN_IF_ERROR(fn(i));
+    }
+    return absl::OkStatus();
+  }
+  mutex mu;
+  absl::Status status;
+  BlockingCounter counter(num_units - 1);
+  for (int i = 1; i < num_units; ++i) {
+    pool->Schedule([&fn, &mu, &status, &counter, i]() {
+      absl::Status s = fn(i);
+      if (!s.ok()) {
+        mutex_lock l(mu);
+        status.Update(s);
+      }
+      counter.DecrementCount();
+    });
+  }
+  // The calling thread builds the first unit.
+  absl::Status s = fn(0);
+  counter.Wait();
+  mutex_lock l(mu);
+  status.Update(s);
+  return status;
+}
+
 // NOTE: node->device_name() is not set by GraphConstructor.  We
 // expects that NodeDef in GraphDef given to workers fully specifies
 // device names.
@@ -214,109 +269,146 @@ absl::Status GraphMgr::InitItem(const std::string& handle, const GraphDef& gdef,
     TF_RETURN_IF_ERROR(AddControlEdges(popts, &partitions));
   }
 
-  std::unordered_map<std::string, std::unique_ptr<Graph>> partition_graphs;
+  item->graph_mgr = this;
+  if (graph_options.build_cost_model() > 0) {
+    skip_cost_models_ = false;
+  }
+  // Adds the unit of the partition of `device_name`. Units are added before
+  // they are built, so that they can be built concurrently.
+  auto add_unit = [&](const std::string& device_name) -> absl::Status {
+    ExecutionUnit unit;
+    TF_RETURN_IF_ERROR(device_mgr_->LookupDevice(device_name, &unit.device));
+    unit.lib = item->proc_flr->GetFLR(unit.device->name());
+    if (unit.lib == nullptr) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Cannot find FLR for device: ", unit.device->name()));
+    }
+    // Top-level nodes in the graph uses the op segment to cache
+    // kernels. Therefore, as long as the executor is alive, we need
+    // to ensure the kernels cached for the session are alive.
+    unit.device->op_segment()->AddHold(handle);
+    item->units.push_back(std::move(unit));
+    return absl::OkStatus();
+  };
+
+  const int num_partitions = partitions.size();
+  std::vector<const std::string*> partition_names;
+  std::vector<GraphDef*> partition_defs;
+  partition_names.reserve(num_partitions);
+  partition_defs.reserve(num_partitions);
   for (auto& partition : partitions) {
-    std::unique_ptr<Graph> device_graph(new Graph(OpRegistry::Global()));
+    partition_names.push_back(&partition.first);
+    partition_defs.push_back(&partition.second);
+  }
+  std::vector<std::unique_ptr<Graph>> graphs(num_partitions);
+  auto convert = [&partition_defs, &graphs](int i) -> absl::Status {
+    graphs[i] = std::make_unique<Graph>(OpRegistry::Global());
     GraphConstructorOptions device_opts;
     // There are internal operations (e.g., send/recv) that we now allow.
     device_opts.allow_internal_ops = true;
     device_opts.expect_device_spec = true;
-    TF_RETURN_IF_ERROR(ConvertGraphDefToGraph(
-        device_opts, std::move(partition.second), device_graph.get()));
-    partition_graphs.emplace(partition.first, std::move(device_graph));
+    return ConvertGraphDefToGraph(device_opts, std::move(*partition_defs[i]),
+                                  graphs[i].get());
+  };
+  auto build = [&](int i) -> absl::Status {
+    return InitUnit(handle, graph_options, debug_options, std::move(graphs[i]),
+                    &item->units[i]);
+  };
+  // tfdbg publishes the partition graphs one at a time.
+  const bool parallel = debug_options.debug_tensor_watch_opts().empty();
+
+  const auto& groups = OptimizationPassRegistry::Global()->groups();
+  auto post_partitioning =
+      groups.find(OptimizationPassRegistry::POST_PARTITIONING);
+  if (post_partitioning == groups.end() || post_partitioning->second.empty()) {
+    item->units.reserve(num_partitions);
+    for (const std::string* device_name : partition_names) {
+      TF_RETURN_IF_ERROR(add_unit(*device_name));
+    }
+    // Each partition is built as soon as it is converted, so kernels of the
+    // first partitions are created while the others are still converted.
+    return RunForEachUnit(parallel, num_partitions, [&](int i) -> absl::Status {
+      TF_RETURN_IF_ERROR(convert(i));
+      return build(i);
+    });
   }
 
+  // POST_PARTITIONING passes need all the partition graphs at once, and may
+  // add or remove partitions.
+  TF_RETURN_IF_ERROR(RunForEachUnit(parallel, num_partitions, convert));
+  std::unordered_map<std::string, std::unique_ptr<Graph>> partition_graphs;
+  for (int i = 0; i < num_partitions; ++i) {
+    partition_graphs.emplace(*partition_names[i], std::move(graphs[i]));
+  }
   GraphOptimizationPassOptions optimization_options;
   optimization_options.flib_def = item->lib_def.get();
   optimization_options.partition_graphs = &partition_graphs;
   TF_RETURN_IF_ERROR(OptimizationPassRegistry::Global()->RunGrouping(
       OptimizationPassRegistry::POST_PARTITIONING, optimization_options));
-
-  LocalExecutorParams params;
-
-  item->units.reserve(partitions.size());
-  item->graph_mgr = this;
-  const auto& optimizer_opts = graph_options.optimizer_options();
-  GraphOptimizer optimizer(optimizer_opts);
+  const int num_units = partition_graphs.size();
+  graphs.clear();
+  item->units.reserve(num_units);
   for (auto& p : partition_graphs) {
-    const std::string& device_name = p.first;
-    std::unique_ptr<Graph>& subgraph = p.second;
-    item->units.resize(item->units.size() + 1);
-    ExecutionUnit* unit = &(item->units.back());
-
-    // Find the device.
-    absl::Status s = device_mgr_->LookupDevice(device_name, &unit->device);
-    if (!s.ok()) {
-      // Remove the empty unit from the item as the item destructor wants all
-      // units to have valid devices.
-      item->units.pop_back();
-      return s;
-    }
-
-    // Give the device an opportunity to rewrite its subgraph.
-    TF_RETURN_IF_ERROR(unit->device->MaybeRewriteGraph(&subgraph));
-
-    // Top-level nodes in the graph uses the op segment to cache
-    // kernels. Therefore, as long as the executor is alive, we need
-    // to ensure the kernels cached for the session are alive.
-    auto opseg = unit->device->op_segment();
-    opseg->AddHold(handle);
-
-    // Function library runtime.
-    FunctionLibraryRuntime* lib = item->proc_flr->GetFLR(unit->device->name());
-    if (lib == nullptr) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Cannot find FLR for device: ", unit->device->name()));
-    }
+    TF_RETURN_IF_ERROR(add_unit(p.first));
+    graphs.push_back(std::move(p.second));
+  }
+  return RunForEachUnit(parallel, num_units, build);
+}
 
-    // Construct the root executor for the subgraph.
-    params.device = unit->device;
-    params.function_library = lib;
-    params.create_kernel =
-        [handle, lib, opseg](const std::shared_ptr<const NodeProperties>& props,
-                             OpKernel** kernel) {
-          // NOTE(mrry): We must not share function kernels (implemented
-          // using `CallOp`) between subgraphs, because `CallOp::handle_`
-          // is tied to a particular subgraph. Even if the function itself
-          // is stateful, the `CallOp` that invokes it is not.
-          if (!OpSegment::ShouldOwnKernel(lib, props->node_def.op())) {
-            return lib->CreateKernel(props, kernel);
-          }
-          auto create_fn = [lib, &props](OpKernel** kernel) {
-            return lib->CreateKernel(props, kernel);
-          };
-          // Kernels created for subgraph nodes need to be cached.  On
-          // cache miss, create_fn() is invoked to create a kernel based
-          // on the function library here + global op registry.
-          return opseg->FindOrCreate(handle, props->node_def.name(), kernel,
-                                     create_fn);
+absl::Status GraphMgr::InitUnit(const std::string& handle,
+                                const GraphOptions& graph_options,
+                                const DebugOptions& debug_options,
+                                std::unique_ptr<Graph> subgraph,
+                                ExecutionUnit* unit) {
+  // Give the device an opportunity to rewrite its subgraph.
+  TF_RETURN_IF_ERROR(unit->device->MaybeRewriteGraph(&subgraph));
+
+  // Construct the root executor for the subgraph.
+  FunctionLibraryRuntime* lib = unit->lib;
+  OpSegment* opseg = unit->device->op_segment();
+  LocalExecutorParams params;
+  params.device = unit->device;
+  params.function_library = lib;
+  params.create_kernel =
+      [handle, lib, opseg](const std::shared_ptr<const NodeProperties>& props,
+                           OpKernel** kernel) {
+        // NOTE(mrry): We must not share function kernels (implemented
+        // using `CallOp`) between subgraphs, because `CallOp::handle_`
+        // is tied to a particular subgraph. Even if the function itself
+        // is stateful, the `CallOp` that invokes it is not.
+        if (!OpSegment::ShouldOwnKernel(lib, props->node_def.op())) {
+          return lib->CreateKernel(props, kernel);
+        }
+        auto create_fn = [lib, &props](OpKernel** kernel) {
+          return lib->CreateKernel(props, kernel);
         };
-    params.delete_kernel = [lib](OpKernel* kernel) {
-      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string())) {
-        delete kernel;
-      }
-    };
-
-    optimizer.Optimize(lib, worker_env_->env, params.device, &subgraph,
-                       GraphOptimizer::Options());
-
-    // TensorFlow Debugger (tfdbg) inserts debug nodes in the graph.
-    if (!debug_options.debug_tensor_watch_opts().empty()) {
-      TF_RETURN_IF_ERROR(DecorateAndPublishGraphForDebug(
-          debug_options, subgraph.get(), params.device));
+        // Kernels created for subgraph nodes need to be cached.  On
+        // cache miss, create_fn() is invoked to create a kernel based
+        // on the function library here + global op registry.
+        return opseg->FindOrCreate(handle, props->node_def.name(), kernel,
+                                   create_fn);
+      };
+  params.delete_kernel = [lib](OpKernel* kernel) {
+    if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string())) {
+      delete kernel;
     }
+  };
 
-    TF_RETURN_IF_ERROR(
-        EnsureMemoryTypes(DeviceType(unit->device->device_type()),
-                          unit->device->name(), subgraph.get()));
-    unit->graph = std::move(subgraph);
-    unit->build_cost_model = graph_options.build_cost_model();
-    if (unit->build_cost_model > 0) {
-      skip_cost_models_ = false;
-    }
-    TF_RETURN_IF_ERROR(NewLocalExecutor(params, *unit->graph, &unit->root));
+  GraphOptimizer optimizer(graph_options.optimizer_options());
+  optimizer.Optimize(lib, worker_env_->env, params.device, &subgraph,
+                     GraphOptimizer::Options());
+
+  // TensorFlow Debugger (tfdbg) inserts debug nodes in the graph.
+  if (!debug_options.debug_tensor_watch_opts().empty()) {
+    TF_RETURN_IF_ERROR(DecorateAndPublishGraphForDebug(
+        debug_options, subgraph.get(), params.device));
   }
-  return absl::OkStatus();
+
+  TF_RETURN_IF_ERROR(EnsureMemoryTypes(DeviceType(unit->device->device_type()),
+                                       unit->device->name(), subgraph.get()));
+  unit->graph = std::move(subgraph);
+  unit->build_cost_model = graph_options.build_cost_model();
+  return NewLocalExecutor(params, *unit->graph, &unit->root);
 }
 
 absl::Status GraphMgr::Register(const std::string& handle, const GraphDef& gdef,
@@ -203,6 +203,14 @@ class GraphMgr {
                         DistributedFunctionLibraryRuntime* cluster_flr,
                         Item* item);
 
+  // Rewrites and optimizes `subgraph`, the partition of `unit->device`, and
+  // creates the executor of `unit` for it. Called concurrently for the units
+  // of an item.
+  absl::Status InitUnit(const std::string& handle,
+                        const GraphOptions& graph_options,
+                        const DebugOptions& debug_options,
+                        std::unique_ptr<Graph> subgraph, ExecutionUnit* unit);
+
   absl::Status DecorateAndPublishGraphForDebug(
       const DebugOptions& debug_options, Graph* graph, Device* device);
 
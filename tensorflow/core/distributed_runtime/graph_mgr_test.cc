@@ -0,0 +1,205 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/graph_mgr.h"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/distributed_runtime/worker_env.h"
+#include "tensorflow/core/framework/common_shape_fns.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/debug.pb.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+constexpr char kSession[] = "session";
+constexpr char kCpu0[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+constexpr char kCpu1[] = "/job:localhost/replica:0/task:0/device:CPU:1";
+constexpr char kCpu2[] = "/job:localhost/replica:0/task:0/device:CPU:2";
+
+// The kernels of GraphMgrTestBuild being created, at most and overall.
+std::atomic<int> num_building{0};
+std::atomic<int> max_building{0};
+std::atomic<int> num_built{0};
+
+REGISTER_OP("GraphMgrTestBuild")
+    .Attr("delay_ms: int = 0")
+    .Attr("fail: bool = false")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+// Takes `delay_ms` to build, and then fails if `fail` is set.
+class BuildOp : public OpKernel {
+ public:
+  explicit BuildOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    int64_t delay_ms;
+    bool fail;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("delay_ms", &delay_ms));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("fail", &fail));
+    const int building = ++num_building;
+    int max_so_far = max_building.load();
+    while (building > max_so_far &&
+           !max_building.compare_exchange_weak(max_so_far, building)) {
+    }
+    Env::Default()->SleepForMicroseconds(delay_ms * 1000);
+    --num_building;
+    OP_REQUIRES(ctx, !fail, absl::InternalError("build failed"));
+    ++num_built;
+  }
+
+  void Compute(OpKernelContext* ctx) override {}
+};
+
+REGISTER_KERNEL_BUILDER(Name("GraphMgrTestBuild").Device(DEVICE_CPU), BuildOp);
+
+// Adds the partition of CPU:2, which the registered graphs do not use.
+class AddPartitionPass : public GraphOptimizationPass {
+ public:
+  absl::Status Run(const GraphOptimizationPassOptions& options) override {
+    NodeDef node_def;
+    TF_RETURN_IF_ERROR(NodeDefBuilder("added", "GraphMgrTestBuild")
+                           .Attr("delay_ms", 100)
+                           .Device(kCpu2)
+                           .Finalize(&node_def));
+    auto graph = std::make_unique<Graph>(OpRegistry::Global());
+    TF_ASSIGN_OR_RETURN(Node * node, graph->AddNode(std::move(node_def)));
+    node->set_assigned_device_name(kCpu2);
+    FixupSourceAndSinkEdges(graph.get());
+    (*options.partition_graphs)[kCpu2] = std::move(graph);
+    return absl::OkStatus();
+  }
+};
+
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::POST_PARTITIONING, 0,
+                      AddPartitionPass);
+
+void AddBuildNode(const std::string& name, const std::string& device,
+                  int delay_ms, bool fail, GraphDef* graph) {
+  TF_CHECK_OK(NodeDefBuilder(name, "GraphMgrTestBuild")
+                  .Attr("delay_ms", delay_ms)
+                  .Attr("fail", fail)
+                  .Device(device)
+                  .Finalize(graph->add_node()));
+}
+
+class GraphMgrTest : public ::testing::Test {
+ protected:
+  GraphMgrTest() {
+    // The partitions are built on a pool even on a single core machine.
+    setenv("TF_GRAPH_MGR_REGISTER_THREADS", "4", /*overwrite=*/1);
+    SessionOptions options;
+    options.config.mutable_device_count()->insert({"CPU", 3});
+    std::vector<std::unique_ptr<Device>> devices;
+    TF_CHECK_OK(DeviceFactory::AddDevices(
+        options, "/job:localhost/replica:0/task:0", &devices));
+    device_mgr_ = std::make_unique<StaticDeviceMgr>(std::move(devices));
+    env_.env = Env::Default();
+    env_.device_mgr = device_mgr_.get();
+    graph_mgr_ = std::make_unique<GraphMgr>(&env_, device_mgr_.get());
+    num_building = 0;
+    max_building = 0;
+    num_built = 0;
+  }
+
+  absl::Status Register(const GraphDef& graph, std::string* graph_handle) {
+    return graph_mgr_->Register(kSession, graph, GraphOptions(),
+                                DebugOptions(), ConfigProto(),
+                                /*collective_graph_key=*/0,
+                                /*session=*/nullptr, /*cluster_flr=*/nullptr,
+                                graph_handle);
+  }
+
+  // Returns whether the kernel of `node_name` was built on `device_name`.
+  bool KernelBuilt(const std::string& device_name,
+                   const std::string& node_name) {
+    Device* device;
+    TF_CHECK_OK(device_mgr_->LookupDevice(device_name, &device));
+    OpKernel* kernel = nullptr;
+    return device->op_segment()
+        ->FindOrCreate(kSession, node_name, &kernel,
+                       [](OpKernel**) {
+                         return absl::NotFoundError("not built");
+                       })
+        .ok();
+  }
+
+  WorkerEnv env_;
+  std::unique_ptr<DeviceMgr> device_mgr_;
+  std::unique_ptr<GraphMgr> graph_mgr_;
+};
+
+TEST_F(GraphMgrTest, BuildsPartitionsConcurrently) {
+  GraphDef graph;
+  AddBuildNode("a", kCpu0, /*delay_ms=*/100, /*fail=*/false, &graph);
+  AddBuildNode("b", kCpu1, /*delay_ms=*/100, /*fail=*/false, &graph);
+  std::string graph_handle;
+  TF_ASSERT_OK(Register(graph, &graph_handle));
+
+  // The partition added after partitioning is built along with the others.
+  EXPECT_EQ(num_built.load(), 3);
+  EXPECT_GT(max_building.load(), 1);
+  EXPECT_TRUE(KernelBuilt(kCpu0, "a"));
+  EXPECT_TRUE(KernelBuilt(kCpu1, "b"));
+  EXPECT_TRUE(KernelBuilt(kCpu2, "added"));
+  TF_EXPECT_OK(graph_mgr_->Deregister(graph_handle));
+}
+
+TEST_F(GraphMgrTest, BuildErrorWaitsForOtherPartitions) {
+  GraphDef graph;
+  AddBuildNode("a", kCpu0, /*delay_ms=*/200, /*fail=*/false, &graph);
+  AddBuildNode("b", kCpu1, /*delay_ms=*/0, /*fail=*/true, &graph);
+  std::string graph_handle;
+  absl::Status status = Register(graph, &graph_handle);
+  EXPECT_TRUE(absl::IsInternal(status)) << status;
+  EXPECT_NE(status.message().find("build failed"), std::string::npos)
+      << status;
+
+  // The partitions still being built when "b" failed were finished before
+  // the graph was dropped.
+  EXPECT_EQ(num_building.load(), 0);
+  EXPECT_EQ(num_built.load(), 2);
+
+  // The devices are left usable.
+  GraphDef other_graph;
+  AddBuildNode("c", kCpu1, /*delay_ms=*/0, /*fail=*/false, &other_graph);
+  TF_ASSERT_OK(Register(other_graph, &graph_handle));
+  EXPECT_TRUE(KernelBuilt(kCpu1, "c"));
+  TF_EXPECT_OK(graph_mgr_->Deregister(graph_handle));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,14 +15,24 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_tensor_coding.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "absl/status/status.h"
 #include "xla/tsl/lib/core/status_test_util.h"
+#include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
@@ -111,4 +121,77 @@ TEST_F(GrpcTensorCodingTest, LargeTensor) {
   EXPECT_EQ(s.code(), absl::StatusCode::kInternal);
 }
 
+class CpuDevice : public DeviceBase {
+ public:
+  CpuDevice() : DeviceBase(Env::Default()) { attr_.set_device_type("CPU"); }
+
+  const DeviceAttributes& attributes() const override { return attr_; }
+
+  Allocator* GetAllocator(AllocatorAttributes attr) override {
+    return cpu_allocator();
+  }
+
+ private:
+  DeviceAttributes attr_;
+};
+
+// Returns the bytes of `buf` split into slices of at most `slice_size` bytes.
+::grpc::ByteBuffer Fragment(const ::grpc::ByteBuffer& buf, int slice_size) {
+  std::vector<::grpc::Slice> slices;
+  (void)buf.Dump(&slices);
+  std::string bytes;
+  for (const auto& s : slices) {
+    bytes.append(reinterpret_cast<const char*>(s.begin()), s.size());
+  }
+  std::vector<::grpc::Slice> fragments;
+  for (size_t i = 0; i < bytes.size(); i += slice_size) {
+    fragments.emplace_back(bytes.data() + i,
+                           std::min<size_t>(slice_size, bytes.size() - i));
+  }
+  return ::grpc::ByteBuffer(fragments.data(), fragments.size());
+}
+
+TEST_F(GrpcTensorCodingTest, SharesContiguousTensorContent) {
+  Tensor t(DT_FLOAT, TensorShape({64, 1024}));
+  test::FillIota<float>(&t, 0.0f);
+  ::grpc::ByteBuffer buf;
+  TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, t,
+                                              /*require_ack=*/false, &buf));
+  CpuDevice device;
+
+  // The encoding shares the backing store of the large tensor, which is
+  // shared again when parsing.
+  TensorResponse response;
+  response.InitAlloc(&device, AllocatorAttributes());
+  ASSERT_TRUE(GrpcMaybeParseTensorResponse(&buf, &response));
+  EXPECT_EQ(response.tensor().tensor_data().data(), t.tensor_data().data());
+  buf.Clear();
+  test::ExpectTensorEqual<float>(response.tensor(), t);
+
+  // Memory that may be copied to a GPU is not shared.
+  AllocatorAttributes gpu_compatible;
+  gpu_compatible.set_gpu_compatible(true);
+  TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, t,
+                                              /*require_ack=*/false, &buf));
+  response.InitAlloc(&device, gpu_compatible);
+  ASSERT_TRUE(GrpcMaybeParseTensorResponse(&buf, &response));
+  EXPECT_NE(response.tensor().tensor_data().data(), t.tensor_data().data());
+  test::ExpectTensorEqual<float>(response.tensor(), t);
+}
+
+TEST_F(GrpcTensorCodingTest, CopiesFragmentedTensorContent) {
+  Tensor t(DT_FLOAT, TensorShape({64, 1024}));
+  test::FillIota<float>(&t, 0.0f);
+  ::grpc::ByteBuffer buf;
+  TF_ASSERT_OK(grpc::EncodeTensorToByteBuffer(/*is_dead=*/false, t,
+                                              /*require_ack=*/false, &buf));
+  ::grpc::ByteBuffer fragmented = Fragment(buf, 4096);
+  CpuDevice device;
+  TensorResponse response;
+  response.InitAlloc(&device, AllocatorAttributes());
+  ASSERT_TRUE(GrpcMaybeParseTensorResponse(&fragmented, &response));
+  EXPECT_NE(response.tensor().tensor_data().data(), t.tensor_data().data());
+  test::ExpectTensorEqual<float>(response.tensor(), t);
+}
+
 }  // namespace tensorflow
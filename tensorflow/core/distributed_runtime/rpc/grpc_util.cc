@@ -15,9 +15,68 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grpcpp/support/slice.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/refcount.h"
 
 namespace tensorflow {
+namespace {
+
+// A TensorBuffer aliasing bytes of a gRPC slice, which it keeps alive.
+class GrpcSliceBuffer : public TensorBuffer {
+ public:
+  GrpcSliceBuffer(::grpc::Slice slice, const uint8_t* data, size_t size)
+      : TensorBuffer(const_cast<uint8_t*>(data)),
+        slice_(std::move(slice)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("GrpcSlice");
+  }
+  // The slice may be shared with the sender, so the memory must not be
+  // forwarded to kernels that write their outputs in place.
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const ::grpc::Slice slice_;
+  const size_t size_;
+};
+
+}  // namespace
+
+core::RefCountPtr<TensorBuffer> GrpcByteSource::ShareBytes(int64_t offset,
+                                                           int64_t num_bytes) {
+  std::vector<::grpc::Slice> slices;
+  if (!buffer_->Dump(&slices).ok()) return nullptr;
+  for (::grpc::Slice& slice : slices) {
+    const int64_t slice_size = slice.size();
+    if (offset >= slice_size) {
+      offset -= slice_size;
+      continue;
+    }
+    // The bytes span several slices, fall back to copying them.
+    if (offset + num_bytes > slice_size) return nullptr;
+    const uint8_t* data = slice.begin() + offset;
+    if (reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment !=
+        0) {
+      return nullptr;
+    }
+    return core::RefCountPtr<TensorBuffer>(
+        new GrpcSliceBuffer(std::move(slice), data, num_bytes));
+  }
+  return nullptr;
+}
 
 bool GrpcMaybeParseTensorResponse(::grpc::ByteBuffer* src,
                                   TensorResponse* dst) {
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_UTIL_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_UTIL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -24,9 +25,11 @@ limitations under the License.
 #include "grpcpp/support/byte_buffer.h"
 #include "xla/tsl/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/refcount.h"
 
 namespace tensorflow {
 // NOLINTBEGIN(misc-unused-using-decls)
@@ -50,6 +53,13 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  // Shares the bytes if they lie within a single slice of the buffer and are
+  // aligned, which they are when the sender shared the backing store of a
+  // large tensor (see EncodeTensorToByteBuffer) or when the transport
+  // received them in one piece.
+  core::RefCountPtr<TensorBuffer> ShareBytes(int64_t offset,
+                                             int64_t num_bytes) override;
+
  private:
   void DeleteStream() {
     if (stream_) {
@@ -24,6 +24,7 @@ limitations under the License.
 #include "grpcpp/alarm.h"
 #include "grpcpp/server_builder.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "xla/tsl/distributed_runtime/rpc/async_service_interface.h"
@@ -59,6 +60,7 @@ limitations under the License.
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/tracing.h"
 
 namespace tensorflow {
@@ -151,6 +153,7 @@ class GrpcWorkerServiceThread {
     SETUP_FOR_REQUEST(RunGraph, 100, true);
     SETUP_FOR_REQUEST(CleanupGraph, 100, false);
     SETUP_FOR_REQUEST(MarkRecvFinished, 10, false);
+    SETUP_FOR_REQUEST(RecvTensorBatch, 100, true);
 
     // TODO(ncteisen): Determine a better policy for enqueuing the
     // appropriate number of each request type.
@@ -287,6 +290,25 @@ class GrpcWorkerServiceThread {
     EnqueueRecvTensorRequestRaw();
   }
 
+  void RecvTensorBatchHandler(
+      WorkerCall<RecvTensorBatchRequest, RecvTensorBatchResponse>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->RecvTensorBatchAsync(
+          call_opts, &call->request, &call->response,
+          [call, call_opts](const absl::Status& s) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(3) << "Bad response from RecvTensorBatch:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(RecvTensorBatch, true);
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -431,6 +453,7 @@ class GrpcWorkerService : public tsl::AsyncServiceInterface {
 
 GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
     : Worker(worker_env),
+      batch_response_cache_(std::make_unique<RpcResponseCache>()),
       recv_buf_max_chunk_(
           config.experimental().recv_buf_max_chunk() > 0
               ? config.experimental().recv_buf_max_chunk()
@@ -441,8 +464,21 @@ GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
 }
 
 void GrpcWorker::EnableResponseCache() {
-  VLOG(3) << "Enabling gRPC tensor response cache.";
-  response_cache_ = std::make_unique<RpcResponseCache>();
+  // Bounds the bytes of the cached tensors, 0 means unbounded.
+  int64_t max_bytes = 0;
+  absl::Status status =
+      ReadInt64FromEnvVar("TF_RPC_RESPONSE_CACHE_MAX_BYTES", 0, &max_bytes);
+  if (!status.ok()) {
+    LOG(ERROR) << "Ignoring TF_RPC_RESPONSE_CACHE_MAX_BYTES: " << status;
+    max_bytes = 0;
+  } else if (max_bytes < 0) {
+    LOG(ERROR) << "Ignoring negative TF_RPC_RESPONSE_CACHE_MAX_BYTES: "
+               << max_bytes;
+    max_bytes = 0;
+  }
+  VLOG(3) << "Enabling gRPC tensor response cache with a budget of "
+          << max_bytes << " bytes.";
+  response_cache_ = std::make_unique<RpcResponseCache>(max_bytes);
 }
 
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
@@ -500,27 +536,29 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
     }
   };
 
-  auto fail = [&rendezvous_done](const absl::Status& status) {
-    rendezvous_done(Tensor(), false, status);
-  };
-
   absl::Status s = recent_request_ids_.TrackUnique(
       request_id, "RecvTensor (GrpcWorker)", *request);
   if (!s.ok()) {
-    fail(s);
+    rendezvous_done(Tensor(), false, s);
     return;
   }
+  RecvLocalTensorAsync(opts, request, std::move(rendezvous_done));
+}
 
+void GrpcWorker::RecvLocalTensorAsync(CallOptions* opts,
+                                      const RecvTensorRequest* request,
+                                      RpcResponseCache::FinishResponseCB done) {
+  const int64_t step_id = request->step_id();
   const std::string& key = request->rendezvous_key();
   TRACEPRINTF("RecvTensor: %lld %s", step_id, key);
   Rendezvous::ParsedKey parsed;
-  s = Rendezvous::ParseKey(key, &parsed);
+  absl::Status s = Rendezvous::ParseKey(key, &parsed);
   Device* src_dev = nullptr;
   if (s.ok()) {
     s = PrepareRecvTensor(parsed, &src_dev);
   }
   if (!s.ok()) {
-    fail(s);
+    done(Tensor(), false, s);
     return;
   }
 
@@ -532,17 +570,21 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
   // failures, and the client might not observe any errors or cancellations but
   // simply waits for the responses. Aborting the step would report an error to
   // the client, and avoid permanent hanging in distributed function execution.
-  opts->SetCancelCallback([this, step_id]() {
-    LOG(WARNING) << "RecvTensor cancelled for " << step_id;
-    AbortStep(step_id);
-  });
+  if (opts != nullptr) {
+    opts->SetCancelCallback([this, step_id]() {
+      LOG(WARNING) << "RecvTensor cancelled for " << step_id;
+      AbortStep(step_id);
+    });
+  }
   env_->rendezvous_mgr->RecvLocalAsync(
       step_id, parsed,
-      [opts, rendezvous_done, src_dev, request](
+      [opts, rendezvous_done = std::move(done), src_dev, request](
           const absl::Status& status, const Rendezvous::Args& send_args,
           const Rendezvous::Args& recv_args, const Tensor& val,
           const bool is_dead) {
-        opts->ClearCancelCallback();
+        if (opts != nullptr) {
+          opts->ClearCancelCallback();
+        }
         if (!status.ok()) {
           return rendezvous_done(val, is_dead, status);
         }
@@ -578,6 +620,137 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
       });
 }
 
+namespace {
+// The state of a RecvTensorBatch call. It is shared with the callbacks of its
+// tensors, which may run after the call responded.
+struct RecvTensorBatchCall {
+  // A copy of the request, which the callbacks of pending tensors refer to.
+  RecvTensorBatchRequest request;
+  CallOptions* opts;
+  RecvTensorBatchResponse* response;
+  StatusCallback done;
+
+  mutex mu;
+  int num_pending TF_GUARDED_BY(mu) = 0;
+  bool timer_started TF_GUARDED_BY(mu) = false;
+  bool responded TF_GUARDED_BY(mu) = false;
+  std::vector<RecvTensorBatchResponse::Item> items TF_GUARDED_BY(mu);
+};
+}  // namespace
+
+void GrpcWorker::RecvTensorBatchAsync(CallOptions* opts,
+                                      const RecvTensorBatchRequest* request,
+                                      RecvTensorBatchResponse* response,
+                                      StatusCallback done) {
+  if (request->requests().empty()) {
+    done(absl::OkStatus());
+    return;
+  }
+  auto call = std::make_shared<RecvTensorBatchCall>();
+  call->request = *request;
+  call->opts = opts;
+  call->response = response;
+  call->done = std::move(done);
+  call->num_pending = request->requests_size();
+
+  // Responds with the tensors received so far. Those are handed out, and no
+  // longer kept for a later batch.
+  auto respond = [this, call]() {
+    std::vector<RecvTensorBatchResponse::Item> items;
+    {
+      mutex_lock l(call->mu);
+      if (call->responded) return;
+      call->responded = true;
+      items.swap(call->items);
+    }
+    call->opts->ClearCancelCallback();
+    for (RecvTensorBatchResponse::Item& item : items) {
+      batch_response_cache_->EraseRequestId(item.request_id());
+      *call->response->add_items() = std::move(item);
+    }
+    call->done(absl::OkStatus());
+  };
+
+  // As for RecvTensor, cancelling the RPC aborts the steps of the tensors.
+  absl::flat_hash_set<int64_t> step_ids;
+  for (const RecvTensorRequest& item : request->requests()) {
+    step_ids.insert(item.step_id());
+  }
+  opts->SetCancelCallback([this, step_ids = std::move(step_ids)]() {
+    for (int64_t step_id : step_ids) {
+      LOG(WARNING) << "RecvTensorBatch cancelled for " << step_id;
+      AbortStep(step_id);
+    }
+  });
+
+  for (const RecvTensorRequest& item : call->request.requests()) {
+    const int64_t request_id = item.request_id();
+    auto item_done = [this, call, respond, request_id](
+                         const Tensor& tensor, bool is_dead,
+                         const absl::Status& status) {
+      RecvTensorBatchResponse::Item result;
+      result.set_request_id(request_id);
+      if (status.ok()) {
+        RecvTensorResponse* response = result.mutable_response();
+        tensor.AsProtoTensorContent(response->mutable_tensor());
+        response->set_is_dead(is_dead);
+        response->set_send_start_micros(env_->env->NowMicros());
+      } else {
+        result.set_status_code(static_cast<error::Code>(status.code()));
+        result.set_status_error_message(std::string(status.message()));
+      }
+      const int64_t partial_response_micros =
+          call->request.partial_response_micros();
+      bool respond_now = false;
+      bool start_timer = false;
+      {
+        mutex_lock l(call->mu);
+        // A tensor that misses the response stays in the cache.
+        if (call->responded) return;
+        call->items.push_back(std::move(result));
+        if (--call->num_pending == 0 || partial_response_micros <= 0) {
+          respond_now = true;
+        } else if (!call->timer_started) {
+          call->timer_started = true;
+          start_timer = true;
+        }
+      }
+      if (respond_now) {
+        respond();
+      } else if (start_timer) {
+        env_->env->SchedClosureAfter(partial_response_micros, respond);
+      }
+    };
+
+    if (request_id == 0) {
+      item_done(Tensor(), false,
+                absl::InvalidArgumentError(
+                    "RecvTensorBatch requires non-zero request ids"));
+      continue;
+    }
+    // A tensor requested again, because it was pending when an earlier batch
+    // responded, is taken from the cache rather than received again.
+    if (batch_response_cache_->QueueRequest(request_id, item.step_id(),
+                                            item_done)) {
+      continue;
+    }
+    // `call` keeps `item` alive until the tensor is received.
+    auto rendezvous_done = [this, call, request_id](
+                               const Tensor& tensor, bool is_dead,
+                               const absl::Status& status) {
+      batch_response_cache_->RequestFinished(request_id, tensor, is_dead,
+                                             status);
+    };
+    absl::Status s = recent_request_ids_.TrackUnique(
+        request_id, "RecvTensorBatch (GrpcWorker)", item);
+    if (!s.ok()) {
+      rendezvous_done(Tensor(), false, s);
+      continue;
+    }
+    RecvLocalTensorAsync(/*opts=*/nullptr, &item, std::move(rendezvous_done));
+  }
+}
+
 namespace {
 // If RecvBufRespExtra.tensor_content is a single large string, then gRPC
 // can stall on the recv side when the string buffer needs to be enlarged,
@@ -760,6 +933,9 @@ void GrpcWorker::CleanupGraphAsync(const CleanupGraphRequest* request,
     // a worker crashes before acking a request.
     response_cache_->CleanEntriesForStep(request->step_id());
   }
+  // Tensors of the step that were never requested again, e.g. because the
+  // receiver aborted.
+  batch_response_cache_->CleanEntriesForStep(request->step_id());
   Worker::CleanupGraphAsync(request, response, done);
 }
 
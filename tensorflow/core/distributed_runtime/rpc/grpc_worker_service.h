@@ -51,6 +51,14 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Receives the tensors of a batch of RecvTensor requests. Tensors that are
+  // not available in time for the response are kept in
+  // `batch_response_cache_` until they are requested again.
+  void RecvTensorBatchAsync(CallOptions* opts,
+                            const RecvTensorBatchRequest* request,
+                            RecvTensorBatchResponse* response,
+                            StatusCallback done) override;
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override;
 
@@ -68,7 +76,17 @@ class GrpcWorker : public Worker {
   void RemoveCacheEntryForId(int64_t request_id);
 
  private:
+  // Receives the tensor of `request` from the local rendezvous, copied to
+  // host memory if it was produced on an accelerator. If `opts` is not null,
+  // cancelling it while the tensor is pending aborts the step.
+  void RecvLocalTensorAsync(CallOptions* opts,
+                            const RecvTensorRequest* request,
+                            RpcResponseCache::FinishResponseCB done);
+
   std::unique_ptr<RpcResponseCache> response_cache_;
+  // Unlike `response_cache_`, always enabled and unbounded: RecvTensorBatch
+  // relies on it to hand out tensors across calls.
+  const std::unique_ptr<RpcResponseCache> batch_response_cache_;
   const int32_t recv_buf_max_chunk_;
 };
 
@@ -16,7 +16,12 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
@@ -34,15 +39,22 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+class RpcRecvTensorCall;
+struct RpcRecvTensorBatch;
+
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
-  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id)
-      : BaseRemoteRendezvous(env, step_id) {}
+  RpcRemoteRendezvous(const WorkerEnv* env, int64_t step_id,
+                      int64_t batch_window_micros)
+      : BaseRemoteRendezvous(env, step_id),
+        batch_window_micros_(batch_window_micros) {}
 
  protected:
   void RecvFromRemoteAsync(const Rendezvous::ParsedKey& parsed,
@@ -50,8 +62,38 @@ class RpcRemoteRendezvous : public BaseRemoteRendezvous {
                            DoneCallback done) override;
 
  private:
+  // A started call, and the callback to run when it is done.
+  using PendingRecv = std::pair<RpcRecvTensorCall*, std::function<void()>>;
+
+  // The most calls sent in one RecvTensorBatch RPC. A batch is sent as soon
+  // as it is full.
+  static constexpr int kMaxBatchSize = 256;
+
   ~RpcRemoteRendezvous() override {}
 
+  // Adds `call` to the batch of calls to its worker, which is sent
+  // `batch_window_micros_` after its first call was added.
+  void AddToBatch(RpcRecvTensorCall* call, std::function<void()> recv_done);
+
+  // Sends the batch of calls to `worker`, if any.
+  void FlushBatch(const std::string& worker);
+
+  // Sends `recvs`, which are all to the same worker, in one RecvTensorBatch
+  // RPC.
+  void StartBatch(std::vector<PendingRecv> recvs);
+
+  // Completes the calls of `batch` that are in its response, and sends the
+  // others again.
+  void BatchDone(const std::shared_ptr<RpcRecvTensorBatch>& batch,
+                 const absl::Status& s);
+
+  const int64_t batch_window_micros_;
+
+  mutex batch_mu_;
+  // The calls waiting to be sent, by worker.
+  absl::flat_hash_map<std::string, std::vector<PendingRecv>> pending_batches_
+      TF_GUARDED_BY(batch_mu_);
+
   RpcRemoteRendezvous(const RpcRemoteRendezvous&) = delete;
   void operator=(const RpcRemoteRendezvous&) = delete;
 };
@@ -125,6 +167,25 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     wi_ = nullptr;
   }
 
+  // Completes the call with `item` of a RecvTensorBatch response. Leaves
+  // `item` with unspecified contents.
+  void FinishFromBatch(RecvTensorBatchResponse::Item* item) {
+    absl::Status s(static_cast<absl::StatusCode>(item->status_code()),
+                   item->status_error_message());
+    if (s.ok()) {
+      s = resp_.InitFrom(item->mutable_response());
+      // The tensor of a dead node has no content to parse.
+      if (resp_.metadata().is_dead()) s = absl::OkStatus();
+    }
+    UpdateStatus(s);
+  }
+
+  void UpdateStatus(const absl::Status& s) {
+    if (s.ok()) return;
+    mutex_lock l(mu_);
+    status_.Update(s);
+  }
+
   const Tensor& tensor() const { return resp_.tensor(); }
 
   bool is_dead() const { return resp_.metadata().is_dead(); }
@@ -233,6 +294,22 @@ static RpcRecvTensorFreeList* get_call_freelist() {
   return call_freelist;
 }
 
+// A RecvTensorBatch RPC, and the calls whose tensors it receives.
+struct RpcRecvTensorBatch {
+  CallOptions opts;
+  RecvTensorBatchRequest req;
+  RecvTensorBatchResponse resp;
+  std::vector<std::pair<RpcRecvTensorCall*, std::function<void()>>> recvs;
+
+  // Whichever of the RPC callback and the abort check after sending the RPC
+  // finishes last handles the response, so that the check never looks at
+  // calls that are already done.
+  mutex mu;
+  bool abort_checked TF_GUARDED_BY(mu) = false;
+  bool rpc_done TF_GUARDED_BY(mu) = false;
+  absl::Status status TF_GUARDED_BY(mu);
+};
+
 void RpcRemoteRendezvous::RecvFromRemoteAsync(
     const Rendezvous::ParsedKey& parsed, const Rendezvous::Args& recv_args,
     DoneCallback done) {
@@ -293,7 +370,7 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
 
   // Start "call".
   Ref();
-  call->Start([this, call, recv_args, worker_cache]() {
+  auto recv_done = [this, call, recv_args, worker_cache]() {
     // Removes "call" from calls_. Prevent StartAbort().
     DeregisterCall(call, recv_args);
     // If StartAbort was called prior to DeregisterCall, then the
@@ -306,18 +383,159 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     call->done()(s, Args(), call->recv_args(), call->tensor(), call->is_dead());
     get_call_freelist()->Release(call);
     Unref();
-  });
+  };
+  if (batch_window_micros_ > 0) {
+    AddToBatch(call, std::move(recv_done));
+  } else {
+    call->Start(std::move(recv_done));
+  }
+}
+
+void RpcRemoteRendezvous::AddToBatch(RpcRecvTensorCall* call,
+                                     std::function<void()> recv_done) {
+  const std::string worker = call->src_worker_;
+  std::vector<PendingRecv> full_batch;
+  bool schedule_flush = false;
+  {
+    mutex_lock l(batch_mu_);
+    std::vector<PendingRecv>& pending = pending_batches_[worker];
+    schedule_flush = pending.empty();
+    pending.emplace_back(call, std::move(recv_done));
+    if (pending.size() >= kMaxBatchSize) {
+      full_batch.swap(pending);
+    }
+  }
+  if (!full_batch.empty()) {
+    StartBatch(std::move(full_batch));
+  } else if (schedule_flush) {
+    Ref();
+    env_->env->SchedClosureAfter(batch_window_micros_, [this, worker]() {
+      FlushBatch(worker);
+      Unref();
+    });
+  }
+}
+
+void RpcRemoteRendezvous::FlushBatch(const std::string& worker) {
+  std::vector<PendingRecv> batch;
+  {
+    mutex_lock l(batch_mu_);
+    auto it = pending_batches_.find(worker);
+    if (it == pending_batches_.end()) return;
+    batch.swap(it->second);
+  }
+  if (!batch.empty()) StartBatch(std::move(batch));
+}
+
+void RpcRemoteRendezvous::StartBatch(std::vector<PendingRecv> recvs) {
+  auto batch = std::make_shared<RpcRecvTensorBatch>();
+  for (PendingRecv& recv : recvs) {
+    RpcRecvTensorCall* call = recv.first;
+    // The rendezvous was aborted while the call was waiting.
+    if (!call->status().ok()) {
+      recv.second();
+      continue;
+    }
+    *batch->req.add_requests() = call->req_;
+    call->resp_.InitAlloc(call->dst_device_, call->alloc_attrs_);
+    // Aborting the rendezvous aborts all of its calls, so aborting one
+    // cancels the whole batch. The callback is cleared in BatchDone().
+    call->opts_.SetCancelCallback([batch]() { batch->opts.StartCancel(); });
+    batch->recvs.push_back(std::move(recv));
+  }
+  if (batch->recvs.empty()) return;
+  // Let the worker wait for the other tensors as long as the calls waited
+  // for each other here.
+  batch->req.set_partial_response_micros(batch_window_micros_);
+
+  Ref();
+  WorkerInterface* wi = batch->recvs.front().first->wi_;
+  wi->RecvTensorBatchAsync(
+      &batch->opts, &batch->req, &batch->resp,
+      [this, batch](const absl::Status& s) {
+        {
+          mutex_lock l(batch->mu);
+          batch->rpc_done = true;
+          batch->status = s;
+          if (!batch->abort_checked) return;
+        }
+        BatchDone(batch, s);
+      });
+
+  // As in RpcRecvTensorCall::StartRTCall, check for an abort that happened
+  // before the RPC registered its cancellation with `batch->opts`.
+  for (const PendingRecv& recv : batch->recvs) {
+    if (!recv.first->status().ok()) {
+      batch->opts.StartCancel();
+      break;
+    }
+  }
+  absl::Status s;
+  {
+    mutex_lock l(batch->mu);
+    batch->abort_checked = true;
+    if (!batch->rpc_done) return;
+    s = batch->status;
+  }
+  BatchDone(batch, s);
+}
+
+void RpcRemoteRendezvous::BatchDone(
+    const std::shared_ptr<RpcRecvTensorBatch>& batch, const absl::Status& s) {
+  for (PendingRecv& recv : batch->recvs) {
+    recv.first->opts_.ClearCancelCallback();
+  }
+  if (absl::IsUnimplemented(s)) {
+    // The worker does not support RecvTensorBatch.
+    for (PendingRecv& recv : batch->recvs) {
+      recv.first->Start(std::move(recv.second));
+    }
+    Unref();
+    return;
+  }
+
+  absl::flat_hash_map<int64_t, RecvTensorBatchResponse::Item*> items;
+  for (RecvTensorBatchResponse::Item& item : *batch->resp.mutable_items()) {
+    items[item.request_id()] = &item;
+  }
+  std::vector<PendingRecv> still_pending;
+  for (PendingRecv& recv : batch->recvs) {
+    RpcRecvTensorCall* call = recv.first;
+    call->UpdateStatus(s);
+    auto it = items.find(call->req_.request_id());
+    if (it != items.end()) {
+      call->FinishFromBatch(it->second);
+    } else if (call->status().ok()) {
+      // The tensor was not available in time for the response.
+      still_pending.push_back(std::move(recv));
+      continue;
+    }
+    recv.second();
+  }
+  if (!still_pending.empty()) {
+    StartBatch(std::move(still_pending));
+  }
+  Unref();
 }
 
 }  // namespace
 
 RpcRendezvousMgr::RpcRendezvousMgr(const WorkerEnv* env)
-    : BaseRendezvousMgr(env) {}
+    : BaseRendezvousMgr(env) {
+  absl::Status status = ReadInt64FromEnvVar(
+      "TF_RPC_RECV_TENSOR_BATCH_WINDOW_US", 0,
+      &recv_tensor_batch_window_micros_);
+  if (!status.ok()) {
+    LOG(ERROR) << "Ignoring TF_RPC_RECV_TENSOR_BATCH_WINDOW_US: " << status;
+    recv_tensor_batch_window_micros_ = 0;
+  }
+}
 
 tsl::core::RefCountPtr<BaseRemoteRendezvous> RpcRendezvousMgr::Create(
     int64_t step_id, const WorkerEnv* worker_env) {
   return tsl::core::RefCountPtr<BaseRemoteRendezvous>(
-      new RpcRemoteRendezvous(worker_env, step_id));
+      new RpcRemoteRendezvous(worker_env, step_id,
+                              recv_tensor_batch_window_micros_));
 }
 
 }  // end namespace tensorflow
@@ -42,6 +42,10 @@ class DeviceMgr;
 //
 // Tensors sent and recved through rendezvous managed by this
 // RendezvousMgr must have keys generated by Rendezvous::CreateKey.
+//
+// If the environment variable TF_RPC_RECV_TENSOR_BATCH_WINDOW_US is set to a
+// positive number of microseconds, the tensors a step receives from the same
+// worker within that window are requested with one RecvTensorBatch RPC.
 class RpcRendezvousMgr : public BaseRendezvousMgr {
  public:
   explicit RpcRendezvousMgr(const WorkerEnv* env);
@@ -51,6 +55,8 @@ class RpcRendezvousMgr : public BaseRendezvousMgr {
       int64_t step_id, const WorkerEnv* worker_env) override;
 
  private:
+  int64_t recv_tensor_batch_window_micros_ = 0;
+
   RpcRendezvousMgr(const RpcRendezvousMgr&) = delete;
   void operator=(const RpcRendezvousMgr&) = delete;
 };
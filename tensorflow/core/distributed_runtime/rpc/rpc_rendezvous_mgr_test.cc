@@ -15,6 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/test_utils.h"
@@ -66,6 +74,63 @@ class DummyWorker : public TestWorkerInterface {
       done(absl::OkStatus());
     });
   }
+
+  // Unless batching is enabled, falls back to the default implementation,
+  // which fails with UNIMPLEMENTED. Otherwise responds with the tensors of
+  // the first half of the requests (at least one), as if the others were not
+  // available yet. The tensors are the rendezvous keys.
+  void RecvTensorBatchAsync(CallOptions* opts,
+                            const RecvTensorBatchRequest* request,
+                            RecvTensorBatchResponse* response,
+                            StatusCallback done) override {
+    {
+      mutex_lock l(mu_);
+      if (!batching_) {
+        TestWorkerInterface::RecvTensorBatchAsync(opts, request, response,
+                                                  std::move(done));
+        return;
+      }
+      ++num_batches_;
+      if (hold_batches_) {
+        opts->SetCancelCallback([opts, done]() {
+          SchedClosure([opts, done]() {
+            opts->ClearCancelCallback();
+            done(absl::CancelledError("RecvTensorBatch cancelled"));
+          });
+        });
+        return;
+      }
+    }
+    SchedClosure([request, response, done = std::move(done)]() {
+      const int num_ready = std::max(1, request->requests_size() / 2);
+      for (int i = 0; i < num_ready; ++i) {
+        const RecvTensorRequest& recv = request->requests(i);
+        RecvTensorBatchResponse::Item* item = response->add_items();
+        item->set_request_id(recv.request_id());
+        V(recv.rendezvous_key())
+            .AsProtoTensorContent(item->mutable_response()->mutable_tensor());
+      }
+      done(absl::OkStatus());
+    });
+  }
+
+  void set_batching(bool batching, bool hold_batches = false) {
+    mutex_lock l(mu_);
+    batching_ = batching;
+    hold_batches_ = hold_batches;
+  }
+
+  int num_batches() {
+    mutex_lock l(mu_);
+    return num_batches_;
+  }
+
+ private:
+  mutex mu_;
+  bool batching_ TF_GUARDED_BY(mu_) = false;
+  // Whether batches are only completed by cancelling them.
+  bool hold_batches_ TF_GUARDED_BY(mu_) = false;
+  int num_batches_ TF_GUARDED_BY(mu_) = 0;
 };
 
 // Fake cache implementation for WorkerEnv.
@@ -74,11 +139,7 @@ class DummyWorkerCache : public WorkerCacheInterface {
   void ListWorkersInJob(const std::string& job_name,
                         std::vector<std::string>* workers) const override {}
   WorkerInterface* GetOrCreateWorker(const std::string& target) override {
-    if (dummy_remote_worker_ == nullptr) {
-      // Ownership transferred to WorkerFreeList
-      dummy_remote_worker_ = new DummyWorker;
-    }
-    return dummy_remote_worker_;
+    return worker();
   }
   absl::Status GetEagerClientCache(
       std::unique_ptr<eager::EagerClientCache>* eager_client_cache) override {
@@ -96,6 +157,15 @@ class DummyWorkerCache : public WorkerCacheInterface {
                               DeviceLocality* locality,
                               StatusCallback done) override {}
 
+ public:
+  DummyWorker* worker() {
+    if (dummy_remote_worker_ == nullptr) {
+      // Ownership transferred to WorkerFreeList
+      dummy_remote_worker_ = new DummyWorker;
+    }
+    return dummy_remote_worker_;
+  }
+
  private:
   DummyWorker* dummy_remote_worker_ = nullptr;
 };
@@ -105,7 +175,9 @@ static Device* CreateDevice(const char* type, const char* name) {
    public:
     explicit FakeDevice(const DeviceAttributes& attr) : Device(nullptr, attr) {}
     absl::Status Sync() override { return absl::OkStatus(); }
-    Allocator* GetAllocator(AllocatorAttributes) override { return nullptr; }
+    Allocator* GetAllocator(AllocatorAttributes) override {
+      return cpu_allocator();
+    }
   };
   DeviceAttributes attr;
   attr.set_name(name);
@@ -343,4 +415,101 @@ TEST_F(RpcRendezvousMgrTest, RemoteRecvAsyncMany) {
   rmgr_.Cleanup(step_id);
 }
 
+// Receives `num_requests` tensors with `rmgr`, batching them, and returns
+// their values, or the first error.
+absl::StatusOr<std::vector<std::string>> RecvBatched(
+    RpcRendezvousMgr* rmgr, WorkerSession* worker_session,
+    int64_t step_id, int num_requests) {
+  tsl::core::RefCountPtr<RemoteRendezvous> rendez = rmgr->Find(step_id);
+  TF_RETURN_IF_ERROR(rendez->Initialize(worker_session));
+  mutex mu;
+  absl::Status status;
+  std::vector<std::string> values(num_requests);
+  BlockingCounter counter(num_requests);
+  for (int i = 0; i < num_requests; ++i) {
+    const Rendezvous::ParsedKey key = MakeKey(Rendezvous::CreateKey(
+        "/job:worker/replica:1/task:2/cpu:0", 7890,
+        "/job:mnist/replica:1/task:2/cpu:1", absl::StrCat("foo", i),
+        FrameAndIter(0, 0)));
+    rendez->RecvAsync(key, Rendezvous::Args(),
+                      [&, i](const absl::Status& s, const Rendezvous::Args&,
+                             const Rendezvous::Args&, const Tensor& val,
+                             const bool) {
+                        {
+                          mutex_lock l(mu);
+                          status.Update(s);
+                          if (s.ok() && val.dtype() == DT_STRING) {
+                            values[i] = V(val);
+                          }
+                        }
+                        counter.DecrementCount();
+                      });
+  }
+  counter.Wait();
+  rmgr->Cleanup(step_id);
+  if (!status.ok()) return status;
+  return values;
+}
+
+class RpcRendezvousMgrBatchTest : public RpcRendezvousMgrTest {
+ protected:
+  RpcRendezvousMgrBatchTest() {
+    setenv("TF_RPC_RECV_TENSOR_BATCH_WINDOW_US", "1000", /*overwrite=*/1);
+    batching_rmgr_ = std::make_unique<RpcRendezvousMgr>(&env);
+    unsetenv("TF_RPC_RECV_TENSOR_BATCH_WINDOW_US");
+  }
+
+  std::unique_ptr<RpcRendezvousMgr> batching_rmgr_;
+};
+
+TEST_F(RpcRendezvousMgrBatchTest, RecvBatched) {
+  cache_->worker()->set_batching(true);
+  const int num_requests = 100;
+  auto values = RecvBatched(batching_rmgr_.get(), &worker_session_, 123,
+                            num_requests);
+  TF_ASSERT_OK(values.status());
+  for (int i = 0; i < num_requests; ++i) {
+    EXPECT_EQ((*values)[i], Rendezvous::CreateKey(
+                                "/job:worker/replica:1/task:2/cpu:0", 7890,
+                                "/job:mnist/replica:1/task:2/cpu:1",
+                                absl::StrCat("foo", i), FrameAndIter(0, 0)));
+  }
+  // The worker only responds with half of a batch at a time, so the rest is
+  // requested again in smaller batches.
+  EXPECT_GT(cache_->worker()->num_batches(), 1);
+  EXPECT_LT(cache_->worker()->num_batches(), num_requests);
+}
+
+TEST_F(RpcRendezvousMgrBatchTest, FallsBackWithoutBatching) {
+  const int num_requests = 10;
+  auto values = RecvBatched(batching_rmgr_.get(), &worker_session_, 123,
+                            num_requests);
+  TF_ASSERT_OK(values.status());
+  EXPECT_EQ(cache_->worker()->num_batches(), 0);
+}
+
+TEST_F(RpcRendezvousMgrBatchTest, AbortCancelsBatch) {
+  cache_->worker()->set_batching(true, /*hold_batches=*/true);
+  const int64_t step_id = 123;
+  tsl::core::RefCountPtr<RemoteRendezvous> rendez =
+      batching_rmgr_->Find(step_id);
+  TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+  const Rendezvous::ParsedKey key = MakeKey(Rendezvous::CreateKey(
+      "/job:worker/replica:1/task:2/cpu:0", 7890,
+      "/job:mnist/replica:1/task:2/cpu:1", "foo", FrameAndIter(0, 0)));
+  absl::Notification n;
+  rendez->RecvAsync(key, Rendezvous::Args(),
+                    [&n](const absl::Status& s, const Rendezvous::Args&,
+                         const Rendezvous::Args&, const Tensor&, const bool) {
+                      EXPECT_TRUE(absl::IsAborted(s)) << s;
+                      n.Notify();
+                    });
+  while (cache_->worker()->num_batches() == 0) {
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+  rendez->StartAbort(absl::AbortedError("Aborted"));
+  n.WaitForNotification();
+  batching_rmgr_->Cleanup(step_id);
+}
+
 }  // namespace tensorflow
@@ -15,9 +15,14 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_response_cache.h"
 
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
 #include "absl/log/log.h"
 #include "absl/types/optional.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
 #include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
@@ -26,6 +31,37 @@ auto* tf_response_cache_hits = monitoring::Counter<0>::New(
     "/tensorflow/rpc/service/response_cache_hits",
     "Number of times the tensor response cache was used.");
 
+auto* tf_response_cache_misses = monitoring::Counter<0>::New(
+    "/tensorflow/rpc/service/response_cache_misses",
+    "Number of requests the tensor response cache had no response for.");
+
+auto* tf_response_cache_evictions = monitoring::Counter<0>::New(
+    "/tensorflow/rpc/service/response_cache_evictions",
+    "Number of responses evicted to keep the tensor response cache within "
+    "its byte budget.");
+
+auto* tf_response_cache_bytes = monitoring::Gauge<int64_t, 0>::New(
+    "/tensorflow/rpc/service/response_cache_bytes",
+    "Bytes of the tensors held by the tensor response caches.");
+
+namespace {
+
+// The bytes held by all the caches of the process.
+std::atomic<int64_t> total_bytes_held{0};
+
+void UpdateBytesHeld(int64_t delta) {
+  if (delta == 0) return;
+  tf_response_cache_bytes->GetCell()->Set(total_bytes_held.fetch_add(delta) +
+                                          delta);
+}
+
+}  // namespace
+
+RpcResponseCache::~RpcResponseCache() {
+  mutex_lock m(mu_);
+  UpdateBytesHeld(-bytes_held_);
+}
+
 bool RpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
                                     const FinishResponseCB& cb) {
   VLOG(1) << "RpcResponseCache Lookup " << request_id;
@@ -36,6 +72,7 @@ bool RpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
 
   if (entry.state == ResponseCacheEntry::State::FINISHED) {
     VLOG(1) << "Reuse cached response for " << request_id;
+    TouchStepLocked(entry.step_id);
 
     // Make a copy of the ResponseCacheEntry so that we can run FinishResponse
     // outside the critical section. FinishResponse can be potentially
@@ -57,6 +94,7 @@ bool RpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
   if (entry.state == ResponseCacheEntry::State::ACTIVE) {
     VLOG(1) << "Found active request for " << request_id
             << ".  Adding entry to response queue.";
+    TouchStepLocked(entry.step_id);
     mu_.unlock();
 
     tf_response_cache_hits->GetCell()->IncrementBy(1);
@@ -69,7 +107,11 @@ bool RpcResponseCache::QueueRequest(int64_t request_id, int64_t step_id,
             << ", running user computation.";
     entry.step_id = step_id;
     entry.state = ResponseCacheEntry::State::ACTIVE;
+    TouchStepLocked(step_id);
+    steps_[step_id].request_ids.insert(request_id);
     mu_.unlock();
+
+    tf_response_cache_misses->GetCell()->IncrementBy(1);
     return false;
   }
 }
@@ -98,12 +140,16 @@ void RpcResponseCache::RequestFinished(int64_t request_id, const Tensor& tensor,
     entry.is_dead = is_dead;
     entry.response_status = status;
     entry.state = ResponseCacheEntry::State::FINISHED;
+    bytes_held_ += entry.bytes();
+    UpdateBytesHeld(entry.bytes());
+    TouchStepLocked(entry.step_id);
 
     // We copy the extra work out of the critical section in order to avoid
     // serializing the work for sending response.
     entry_copy = entry;
 
     entry.callbacks.clear();
+    EvictLocked();
   }
 
   for (auto& cb : entry_copy.callbacks) {
@@ -113,20 +159,19 @@ void RpcResponseCache::RequestFinished(int64_t request_id, const Tensor& tensor,
 
 void RpcResponseCache::EraseRequestId(int64_t request_id) {
   mutex_lock m(mu_);
-  response_cache_.erase(request_id);
+  EraseLocked(request_id);
 }
 
 void RpcResponseCache::CleanEntriesForStep(int64_t step_id) {
   mutex_lock m(mu_);
-  // Remove all cache entries whose step id is the given step_id
-  for (auto it = response_cache_.begin(), last = response_cache_.end();
-       it != last;) {
-    if (it->second.step_id == step_id) {
-      VLOG(1) << "Erase stale RpcResponseCache entry " << it->first;
-      it = response_cache_.erase(it);
-    } else {
-      ++it;
-    }
+  auto it = steps_.find(step_id);
+  if (it == steps_.end()) return;
+  // Erasing the last entry of the step erases `it`.
+  std::vector<int64_t> request_ids(it->second.request_ids.begin(),
+                                   it->second.request_ids.end());
+  for (int64_t request_id : request_ids) {
+    VLOG(1) << "Erase stale RpcResponseCache entry " << request_id;
+    EraseLocked(request_id);
   }
 }
 
@@ -135,4 +180,56 @@ int64_t RpcResponseCache::size() {
   return response_cache_.size();
 }
 
+int64_t RpcResponseCache::bytes_held() {
+  mutex_lock m(mu_);
+  return bytes_held_;
+}
+
+void RpcResponseCache::TouchStepLocked(int64_t step_id) {
+  auto [it, inserted] = steps_.try_emplace(step_id);
+  if (inserted) {
+    it->second.lru_position = step_lru_.insert(step_lru_.end(), step_id);
+  } else {
+    step_lru_.splice(step_lru_.end(), step_lru_, it->second.lru_position);
+  }
+}
+
+void RpcResponseCache::EraseLocked(int64_t request_id) {
+  auto it = response_cache_.find(request_id);
+  if (it == response_cache_.end()) return;
+  bytes_held_ -= it->second.bytes();
+  UpdateBytesHeld(-it->second.bytes());
+  auto step_it = steps_.find(it->second.step_id);
+  if (step_it != steps_.end()) {
+    step_it->second.request_ids.erase(request_id);
+    if (step_it->second.request_ids.empty()) {
+      step_lru_.erase(step_it->second.lru_position);
+      steps_.erase(step_it);
+    }
+  }
+  response_cache_.erase(it);
+}
+
+void RpcResponseCache::EvictLocked() {
+  if (max_bytes_ <= 0) return;
+  for (auto step_it = step_lru_.begin();
+       bytes_held_ > max_bytes_ && step_it != step_lru_.end();) {
+    // Evicting the last entry of the step erases it from `step_lru_`.
+    const int64_t step_id = *step_it++;
+    std::vector<int64_t> evictable;
+    for (int64_t request_id : steps_[step_id].request_ids) {
+      if (response_cache_[request_id].bytes() > 0) {
+        evictable.push_back(request_id);
+      }
+    }
+    for (int64_t request_id : evictable) {
+      if (bytes_held_ <= max_bytes_) break;
+      VLOG(1) << "Evict RpcResponseCache entry " << request_id << " of step "
+              << step_id;
+      EraseLocked(request_id);
+      tf_response_cache_evictions->GetCell()->IncrementBy(1);
+    }
+  }
+}
+
 }  // namespace tensorflow
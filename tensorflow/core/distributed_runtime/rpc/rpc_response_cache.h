@@ -15,10 +15,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RPC_RESPONSE_CACHE_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_RPC_RESPONSE_CACHE_H_
 
+#include <cstdint>
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -30,6 +34,11 @@ limitations under the License.
 // responses and reply to duplicate requests from the cache. The cache will be
 // cleaned when the MarkRecvFinishedRequest is received from the receiver or the
 // session step is completed.
+//
+// The cache can be given a budget for the bytes of the tensors it holds. Past
+// it, finished responses are evicted, starting with the steps that were least
+// recently used; a duplicate request for an evicted response runs the method
+// again.
 namespace tensorflow {
 
 // Track and cache the state of worker service RPCs.  An RPC can be in 3 states:
@@ -43,6 +52,10 @@ class RpcResponseCache {
   using FinishResponseCB = std::function<void(
       const Tensor& tensor, bool is_dead, const absl::Status& status)>;
 
+  // `max_bytes` bounds the bytes of the cached tensors, 0 means unbounded.
+  explicit RpcResponseCache(int64_t max_bytes = 0) : max_bytes_(max_bytes) {}
+  ~RpcResponseCache();
+
   // Add the given request to the cache.
   // If the request is in the cache,
   //    If it is finished, invoke `cb` immediately
@@ -66,6 +79,9 @@ class RpcResponseCache {
 
   int64_t size();
 
+  // The bytes of the tensors of the finished responses.
+  int64_t bytes_held();
+
  private:
   struct ResponseCacheEntry {
     enum class State {
@@ -83,13 +99,37 @@ class RpcResponseCache {
     void FinishResponse(const FinishResponseCB& cb) const {
       cb(tensor, is_dead, response_status);
     }
+    // The bytes the entry counts against the budget.
+    int64_t bytes() const {
+      return state == State::FINISHED ? tensor.TotalBytes() : 0;
+    }
     std::vector<FinishResponseCB> callbacks;
   };
 
+  struct StepEntries {
+    absl::flat_hash_set<int64_t> request_ids;
+    // Position of the step in `step_lru_`.
+    std::list<int64_t>::iterator lru_position;
+  };
+
+  // Marks `step_id` as the most recently used step.
+  void TouchStepLocked(int64_t step_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Erases the entry of `request_id`, if any.
+  void EraseLocked(int64_t request_id) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Evicts finished entries until the budget is met.
+  void EvictLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int64_t max_bytes_;
+
   mutex mu_;
   // response_cache_ is expected to be small, as entries are cleared immediately
   // on ack from the receiver.
   gtl::FlatMap<int64_t, ResponseCacheEntry> response_cache_ TF_GUARDED_BY(mu_);
+  // The requests of `response_cache_` by step.
+  absl::flat_hash_map<int64_t, StepEntries> steps_ TF_GUARDED_BY(mu_);
+  // The steps of `steps_`, least recently used first.
+  std::list<int64_t> step_lru_ TF_GUARDED_BY(mu_);
+  int64_t bytes_held_ TF_GUARDED_BY(mu_) = 0;
 };
 
 }  // namespace tensorflow
@@ -0,0 +1,116 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/distributed_runtime/rpc/rpc_response_cache.h"
+
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// A float tensor of `bytes` bytes filled with `value`.
+Tensor MakeTensor(int64_t bytes, float value) {
+  Tensor tensor(DT_FLOAT, TensorShape({bytes / 4}));
+  tensor.flat<float>().setConstant(value);
+  return tensor;
+}
+
+// Runs request `request_id` of `step_id` through `cache`, finishing it with
+// `tensor` if the cache has no response for it. Returns whether the cache
+// had one, and the tensor the request is answered with in `response`.
+bool Request(RpcResponseCache* cache, int64_t request_id, int64_t step_id,
+             const Tensor& tensor, Tensor* response) {
+  auto cb = [response](const Tensor& t, bool is_dead,
+                       const absl::Status& status) { *response = t; };
+  if (cache->QueueRequest(request_id, step_id, cb)) return true;
+  cache->RequestFinished(request_id, tensor, false, absl::OkStatus());
+  return false;
+}
+
+TEST(RpcResponseCacheTest, ReusesFinishedResponses) {
+  RpcResponseCache cache;
+  Tensor response;
+  EXPECT_FALSE(Request(&cache, 1, 10, MakeTensor(16, 1), &response));
+  test::ExpectTensorEqual<float>(response, MakeTensor(16, 1));
+  EXPECT_TRUE(Request(&cache, 1, 10, MakeTensor(16, 2), &response));
+  test::ExpectTensorEqual<float>(response, MakeTensor(16, 1));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.bytes_held(), 16);
+
+  cache.EraseRequestId(1);
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.bytes_held(), 0);
+}
+
+TEST(RpcResponseCacheTest, CleansEntriesForStep) {
+  RpcResponseCache cache;
+  Tensor response;
+  Request(&cache, 1, 10, MakeTensor(16, 1), &response);
+  Request(&cache, 2, 10, MakeTensor(16, 2), &response);
+  Request(&cache, 3, 11, MakeTensor(16, 3), &response);
+  EXPECT_EQ(cache.bytes_held(), 48);
+
+  cache.CleanEntriesForStep(10);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.bytes_held(), 16);
+  EXPECT_FALSE(Request(&cache, 1, 10, MakeTensor(16, 4), &response));
+  EXPECT_TRUE(Request(&cache, 3, 11, MakeTensor(16, 4), &response));
+  test::ExpectTensorEqual<float>(response, MakeTensor(16, 3));
+}
+
+TEST(RpcResponseCacheTest, EvictsLeastRecentlyUsedSteps) {
+  RpcResponseCache cache(/*max_bytes=*/64);
+  Tensor response;
+  Request(&cache, 1, 10, MakeTensor(32, 1), &response);
+  Request(&cache, 2, 11, MakeTensor(16, 2), &response);
+  // Step 10 becomes the most recently used.
+  EXPECT_TRUE(Request(&cache, 1, 10, Tensor(), &response));
+  Request(&cache, 3, 12, MakeTensor(32, 3), &response);
+
+  // Only step 11 had to be evicted to stay within 64 bytes.
+  EXPECT_EQ(cache.bytes_held(), 64);
+  EXPECT_TRUE(Request(&cache, 1, 10, Tensor(), &response));
+  test::ExpectTensorEqual<float>(response, MakeTensor(32, 1));
+  EXPECT_TRUE(Request(&cache, 3, 12, Tensor(), &response));
+  EXPECT_FALSE(Request(&cache, 2, 11, MakeTensor(16, 4), &response));
+}
+
+TEST(RpcResponseCacheTest, KeepsActiveRequests) {
+  RpcResponseCache cache(/*max_bytes=*/16);
+  Tensor first, second;
+  auto first_cb = [&first](const Tensor& t, bool is_dead,
+                           const absl::Status& status) { first = t; };
+  auto second_cb = [&second](const Tensor& t, bool is_dead,
+                             const absl::Status& status) { second = t; };
+  EXPECT_FALSE(cache.QueueRequest(1, 10, first_cb));
+  EXPECT_TRUE(cache.QueueRequest(1, 10, second_cb));
+  // Evicting the finished response of another step makes room for it.
+  Tensor response;
+  Request(&cache, 2, 11, MakeTensor(16, 2), &response);
+  cache.RequestFinished(1, MakeTensor(16, 1), false, absl::OkStatus());
+
+  test::ExpectTensorEqual<float>(first, MakeTensor(16, 1));
+  test::ExpectTensorEqual<float>(second, MakeTensor(16, 1));
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_EQ(cache.bytes_held(), 16);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -14,7 +14,9 @@ limitations under the License.
 ==============================================================================*/
 
 #include <cstdio>
+#include <ctime>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -240,6 +242,47 @@ static void BM_RPC(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_RPC)->ArgPair(30, 2)->ArgPair(30, 1000)->ArgPair(30, 100000);
 
+// Measures the throughput of RecvTensor RPCs between two workers, and the
+// CPU time of the whole process they cost.  Arg: the number of floats in the
+// tensor sent.
+static void BM_TensorTransfer(::testing::benchmark::State& state) {
+  const int tensor_size = state.range(0);
+  const Cluster* cluster = GetCluster();
+
+  // With one stage of width 2, the input is sent to the second worker and
+  // its sum is sent back to the first one.
+  std::unique_ptr<Session> session(NewSession(cluster->options));
+  GraphDef def = CreateGraphDef(1 /*num_stages*/, 2 /*width*/, tensor_size,
+                                true /*multi-device*/, cluster);
+  graph::SetDefaultDevice(cluster->devices[0].name(), &def);
+  TF_CHECK_OK(session->Create(def));
+  Tensor x(DT_FLOAT, TensorShape({tensor_size, 1}));
+  x.flat<float>().setZero();
+  std::vector<Tensor> outputs;
+  for (int i = 0; i < 3; i++) {
+    outputs.clear();
+    TF_CHECK_OK(session->Run({{"x", x}}, {"y:0"}, {}, &outputs));
+  }
+
+  const std::clock_t start_cpu = std::clock();
+  for (auto s : state) {
+    outputs.clear();
+    TF_CHECK_OK(session->Run({{"x", x}}, {"y:0"}, {}, &outputs));
+  }
+  const double cpu_seconds =
+      static_cast<double>(std::clock() - start_cpu) / CLOCKS_PER_SEC;
+  const double bytes = 2.0 * state.iterations() * tensor_size * sizeof(float);
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.counters["cpu_seconds_per_GB"] = cpu_seconds / (bytes / 1e9);
+  TF_CHECK_OK(session->Close());
+}
+BENCHMARK(BM_TensorTransfer)
+    ->UseRealTime()
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24);
+
 static void BM_SingleDevice(::testing::benchmark::State& state) {
   const int width = state.range(0);
   const int num_stages = state.range(1);
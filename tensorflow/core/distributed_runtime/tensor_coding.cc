@@ -23,7 +23,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/refcount.h"
 
 namespace tensorflow {
 
@@ -34,6 +36,7 @@ void TensorResponse::Clear() {
   device_ = nullptr;
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
+  share_content_ = false;
   already_used_ = false;
   ClearTensor();
 }
@@ -51,6 +54,9 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
   if (alloc_attrs_.on_host() || da.device_type() == "CPU") {
     on_host_ = true;
   }
+  // Memory that may be copied to an accelerator later has to come from
+  // allocator_, e.g. to be pinned.
+  share_content_ = da.device_type() == "CPU" && !alloc_attrs_.gpu_compatible();
   allocator_ = device_->GetAllocator(alloc_attrs_);
 }
 
@@ -152,7 +158,8 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 }  // namespace
 
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -211,12 +218,23 @@ bool TensorResponse::ParseTensorSubmessage(
                  .ok()) {
           return false;
         }
+        if (num_bytes !=
+            shape.num_elements() * DataTypeSize(tensor_meta->dtype())) {
+          return false;
+        }
+        // Avoid copying the content if the source can share it, which is
+        // the case for large tensors that arrive in one aligned chunk.
+        core::RefCountPtr<TensorBuffer> shared;
+        if (share_content_ && num_bytes > 0) {
+          shared = source->ShareBytes(input->CurrentPosition(), num_bytes);
+        }
+        if (shared) {
+          if (!input->Skip(num_bytes)) return false;
+          tensor_ = Tensor(tensor_meta->dtype(), shape, std::move(shared));
+          break;
+        }
         Tensor t(allocator_, tensor_meta->dtype(), shape);
         absl::string_view buf = t.tensor_data();
-        if (static_cast<size_t>(num_bytes) != buf.size()) return false;
-        // TODO(jeff,sanjay): Figure out a way to avoid this copy if
-        // the underlying ZeroCopyInputStream data is properly aligned
-        // and compatible with what allocator_ wants.
         if (!input->ReadRaw(const_cast<char*>(buf.data()), num_bytes))
           return false;
         tensor_ = std::move(t);
@@ -249,7 +267,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
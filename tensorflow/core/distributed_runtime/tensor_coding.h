@@ -16,10 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_CODING_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_CODING_H_
 
+#include <cstdint>
+
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
@@ -63,6 +66,16 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // Return a buffer that shares the `num_bytes` bytes at `offset` in the
+    // serialized RecvTensorResponse, so that the tensor content can be used
+    // without copying it, or nullptr if they cannot be shared (e.g. they are
+    // not contiguous in memory, or not aligned as Tensor requires).  The
+    // returned buffer must keep the bytes alive and unmodified.
+    virtual core::RefCountPtr<TensorBuffer> ShareBytes(int64_t offset,
+                                                       int64_t num_bytes) {
+      return nullptr;
+    }
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -91,12 +104,16 @@ class TensorResponse {
   DeviceBase* device() const { return device_; }
 
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
   bool on_host_ = false;
+  // Whether the tensor content may be shared with the source rather than
+  // copied into memory from allocator_.
+  bool share_content_ = false;
   DeviceBase* device_ = nullptr;
   AllocatorAttributes alloc_attrs_;
   Allocator* allocator_ = nullptr;
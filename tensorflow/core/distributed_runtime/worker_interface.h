@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 
+#include "absl/status/status.h"
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/message_wrappers.h"
@@ -107,6 +108,17 @@ class WorkerInterface {
                                TensorResponse* response,
                                StatusCallback done) = 0;
 
+  // Receives the tensors of several RecvTensor requests with one call. See
+  // RecvTensorBatchRequest for why the response may only contain some of
+  // them. Implementations that do not support it fail with UNIMPLEMENTED, and
+  // callers fall back to RecvTensorAsync().
+  virtual void RecvTensorBatchAsync(CallOptions* opts,
+                                    const RecvTensorBatchRequest* request,
+                                    RecvTensorBatchResponse* response,
+                                    StatusCallback done) {
+    done(absl::UnimplementedError("RecvTensorBatch is not supported"));
+  }
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done) = 0;
 
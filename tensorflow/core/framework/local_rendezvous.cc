@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/local_rendezvous.h"
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -193,9 +194,9 @@ absl::Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
   auto& bucket = table_buckets_[bucket_index];
   bucket.mu.lock();
 
-  if (auto s = status(); !s.ok()) {
+  if (TF_PREDICT_FALSE(aborted_.load(std::memory_order_acquire))) {
     bucket.mu.unlock();
-    return s;
+    return status();
   }
 
   auto it = bucket.table.insert({key_hash.table_hash(), ItemQueue()}).first;
@@ -268,10 +269,10 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
   auto& bucket = table_buckets_[bucket_index];
   bucket.mu.lock();
 
-  if (auto s = status(); !s.ok()) {
+  if (TF_PREDICT_FALSE(aborted_.load(std::memory_order_acquire))) {
     bucket.mu.unlock();
     // Rendezvous has been aborted.
-    done(s, Rendezvous::Args(), recv_args, Tensor(), false);
+    done(status(), Rendezvous::Args(), recv_args, Tensor(), false);
     return;
   }
 
@@ -454,6 +455,10 @@ void LocalRendezvous::DoAbort(const absl::Status& status) {
     mutex_lock l(mu_);
     status_.Update(status);
   }
+  // Send and RecvAsync read the flag under the lock of a bucket. As the lock
+  // is taken below, those that run after the items of the bucket were
+  // removed see it, and do not add items that would never be aborted.
+  aborted_.store(true, std::memory_order_release);
 
   // OUT_OF_RANGE implies a normal end of sequence (e.g. for tf.data),
   // so we suppress the warning to avoid log noise.
@@ -841,6 +841,19 @@ absl::Status OpKernelContext::allocate_output(int index,
       op_kernel().name_view(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
+  if (params_->planned_output_allocator != nullptr && attr.value == 0 &&
+      attr.scope_id == 0 && !track_allocations() &&
+      params_->planned_output_allocator->AllocateOutput(
+          params_->planned_output_node_id, index, type, shape,
+          output_tensor.get())) {
+    if (params_->log_memory) {
+      LogMemory::RecordTensorAllocation(params_->op_kernel->name(),
+                                        params_->step_id, *output_tensor);
+    }
+    outputs_[index] = TensorValue(output_tensor.release());
+    *output = outputs_[index].tensor;
+    return absl::OkStatus();
+  }
   absl::Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor.release());
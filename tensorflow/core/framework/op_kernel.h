@@ -569,6 +569,19 @@ struct GraphCollector {
   }
 };
 
+// Serves op outputs from memory whose placement was decided before the step
+// started, e.g. by a static memory plan computed by the executor.
+class PlannedOutputAllocator {
+ public:
+  virtual ~PlannedOutputAllocator() = default;
+
+  // Returns true and sets `*tensor` if output `output_index` of node `node_id`
+  // has a planned slot that can hold a tensor of `type` and `shape`. Returns
+  // false if the caller should allocate the output from the device allocator.
+  virtual bool AllocateOutput(int node_id, int output_index, DataType type,
+                              const TensorShape& shape, Tensor* tensor) = 0;
+};
+
 class OpKernelContext {
  public:
   // The first element of a WrappedAllocator is a "base" Allocator and
@@ -705,6 +718,11 @@ class OpKernelContext {
 
     // For access to distributed coordination service.
     tsl::CoordinationServiceAgent* coordination_service_agent = nullptr;
+
+    // If not null, `allocate_output()` first tries to serve outputs from this
+    // allocator, identifying the running node by `planned_output_node_id`.
+    PlannedOutputAllocator* planned_output_allocator = nullptr;
+    int planned_output_node_id = -1;
   };
 
   // params must outlive the OpKernelContext.
@@ -15,7 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/framework/rendezvous.h"
 
+#include <vector>
+
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/cancellation.h"
@@ -28,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -115,6 +119,23 @@ const Rendezvous::ParsedKey& KeyBar() {
   return *key;
 }
 
+// The key of edge `e` sent by thread `t` in SendRecvEdges.
+const Rendezvous::ParsedKey& EdgeKey(int t, int e) {
+  constexpr int kMaxThreads = 16;
+  constexpr int kMaxEdges = 1000;
+  static const auto* keys = [] {
+    auto* keys = new std::vector<Rendezvous::ParsedKey>();
+    keys->reserve(kMaxThreads * kMaxEdges);
+    for (int i = 0; i < kMaxThreads * kMaxEdges; ++i) {
+      keys->push_back(MakeKey(absl::StrCat("edge_", i)));
+    }
+    return keys;
+  }();
+  CHECK_LT(t, kMaxThreads);
+  CHECK_LT(e, kMaxEdges);
+  return (*keys)[t * kMaxEdges + e];
+}
+
 TEST_F(LocalRendezvousTest, SendRecv) {
   Rendezvous::Args args;
   TF_ASSERT_OK(rendez_->Send(KeyFoo(), args, V("hello"), false));
@@ -432,6 +453,50 @@ TEST_F(LocalRendezvousTest, TransferDummyDeviceContext) {
   args1.device_context->Unref();
 }
 
+// Sends and receives a value over each of `num_edges` keys from each of
+// `num_threads` threads, receiving every other value before it is sent.
+void SendRecvEdges(Rendezvous* rendez, int num_threads, int num_edges,
+                   thread::ThreadPool* pool) {
+  BlockingCounter counter(num_threads);
+  for (int t = 0; t < num_threads; ++t) {
+    pool->Schedule([rendez, num_edges, t, &counter]() {
+      Rendezvous::Args args;
+      for (int e = 0; e < num_edges; ++e) {
+        const Rendezvous::ParsedKey& key = EdgeKey(t, e);
+        Tensor val(DT_INT64, TensorShape({}));
+        val.scalar<int64_t>()() = t * num_edges + e;
+        Tensor received;
+        bool is_dead = false;
+        if (e % 2 == 0) {
+          TF_CHECK_OK(rendez->Send(key, args, val, false));
+          TF_CHECK_OK(rendez->Recv(key, args, &received, &is_dead));
+        } else {
+          rendez->RecvAsync(
+              key, args,
+              [&received](const absl::Status& s, const Rendezvous::Args&,
+                          const Rendezvous::Args&, const Tensor& v, bool) {
+                TF_CHECK_OK(s);
+                received = v;
+              });
+          TF_CHECK_OK(rendez->Send(key, args, val, false));
+        }
+        CHECK_EQ(received.scalar<int64_t>()(), val.scalar<int64_t>()());
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+}
+
+TEST(LocalRendezvousContentionTest, ManyEdgesFromManyThreads) {
+  thread::ThreadPool pool(Env::Default(), "test", 8);
+  for (int num_shards : {1, 16}) {
+    Rendezvous* rendez = NewLocalRendezvous(num_shards);
+    SendRecvEdges(rendez, 8, 1000, &pool);
+    rendez->Unref();
+  }
+}
+
 void BM_SendRecv(::testing::benchmark::State& state) {
   Rendezvous* rendez = NewLocalRendezvous();
   Tensor orig = V("val");
@@ -517,5 +582,27 @@ void BM_PingPong(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PingPong)->Arg(100)->Arg(200)->Arg(300);
 
+// Args: the number of threads, each using 1000 keys, and the number of shards
+// of the rendezvous.
+void BM_ContendedSendRecv(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const int num_shards = state.range(1);
+  constexpr int kNumEdges = 1000;
+  thread::ThreadPool pool(Env::Default(), "test", num_threads);
+  for (auto s : state) {
+    Rendezvous* rendez = NewLocalRendezvous(num_shards);
+    SendRecvEdges(rendez, num_threads, kNumEdges, &pool);
+    rendez->Unref();
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads * kNumEdges);
+}
+BENCHMARK(BM_ContendedSendRecv)
+    ->UseRealTime()
+    ->ArgPair(1, 1)
+    ->ArgPair(4, 1)
+    ->ArgPair(16, 1)
+    ->ArgPair(4, 16)
+    ->ArgPair(16, 16);
+
 }  // namespace
 }  // namespace tensorflow
@@ -0,0 +1,352 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_bucketing_optimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/attr_value.pb.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/costs/graph_properties.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/op_types.h"
+#include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/grappler/utils/frame.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/device_name_utils.h"
+
+namespace tensorflow {
+namespace grappler {
+
+namespace {
+
+constexpr char kCollectiveBucketing[] = "CollectiveBucketing";
+
+// The attributes that ops must share to be reduced together.
+constexpr const char* kBucketAttrs[] = {
+    "T",
+    "merge_op",
+    "final_op",
+    "communication_hint",
+    "timeout_seconds",
+    "is_stateless",
+    "max_subdivs_per_device",
+};
+
+// A CollectiveReduceV2 that can be bucketed.
+struct Candidate {
+  NodeDef* node;
+  int32_t instance_key;
+  TensorShape shape;
+  int64_t bytes;
+};
+
+struct Bucket {
+  std::vector<const Candidate*> members;
+  int64_t bytes = 0;
+};
+
+bool IsCpuDevice(const std::string& device) {
+  DeviceNameUtils::ParsedName parsed;
+  return DeviceNameUtils::ParseFullName(device, &parsed) && parsed.has_type &&
+         parsed.type == DEVICE_CPU;
+}
+
+// Returns whether `input` is fed by a scalar int32 constant, and sets `value`
+// to it.
+bool GetScalarInput(const ImmutableNodeMap& node_map, const std::string& input,
+                    int32_t* value) {
+  const NodeDef* producer = node_map.GetNode(input);
+  Tensor tensor;
+  if (producer != nullptr && IsConstant(*producer) &&
+      producer->attr().contains("value") &&
+      tensor.FromProto(producer->attr().at("value").tensor()) &&
+      tensor.dtype() == DT_INT32 && tensor.NumElements() == 1) {
+    *value = tensor.flat<int32_t>()(0);
+    return true;
+  }
+  return false;
+}
+
+// Returns the value of the scalar int32 constant feeding `input`, or the
+// input itself, so that ops reading the group of equal constants match.
+std::string ScalarInputKey(const ImmutableNodeMap& node_map,
+                           const std::string& input) {
+  int32_t value;
+  if (GetScalarInput(node_map, input, &value)) return absl::StrCat("=", value);
+  return input;
+}
+
+std::string BucketKey(const ImmutableNodeMap& node_map, const NodeDef& node) {
+  std::string key = absl::StrCat(node.device(), ";",
+                                 ScalarInputKey(node_map, node.input(1)), ";",
+                                 ScalarInputKey(node_map, node.input(2)));
+  for (const char* attr : kBucketAttrs) {
+    auto it = node.attr().find(attr);
+    absl::StrAppend(&key, ";",
+                    it == node.attr().end() ? "" : it->second.DebugString());
+  }
+  return key;
+}
+
+// Returns whether adding `node` to `buckets[index]` creates a cycle once each
+// bucket is merged into a single op: whether a path leaving a member of the
+// bucket, or `node`, comes back to one of them. Paths also go from any member
+// of another bucket to any other, since those are merged too. `bucket_of`
+// maps the members of `buckets` to their index.
+bool CreatesCycle(const ImmutableNodeMap& node_map,
+                  const absl::flat_hash_map<const NodeDef*, int>& bucket_of,
+                  const std::vector<Bucket>& buckets, int index,
+                  const NodeDef* node) {
+  absl::flat_hash_set<const NodeDef*> members = {node};
+  for (const Candidate* member : buckets[index].members) {
+    members.insert(member->node);
+  }
+  absl::flat_hash_set<int> merged = {index};
+  absl::flat_hash_set<const NodeDef*> visited;
+  std::deque<const NodeDef*> queue;
+  auto visit_outputs = [&](const NodeDef* current) {
+    for (const NodeDef* fanout : node_map.GetOutputs(current->name())) {
+      if (visited.insert(fanout).second) queue.push_back(fanout);
+    }
+  };
+  for (const NodeDef* member : members) visit_outputs(member);
+  while (!queue.empty()) {
+    const NodeDef* current = queue.front();
+    queue.pop_front();
+    if (members.contains(current)) return true;
+    auto it = bucket_of.find(current);
+    if (it != bucket_of.end() && merged.insert(it->second).second) {
+      for (const Candidate* member : buckets[it->second].members) {
+        if (visited.insert(member->node).second) queue.push_back(member->node);
+      }
+    }
+    visit_outputs(current);
+  }
+  return false;
+}
+
+void AddConstNode(const std::string& name, const std::string& device,
+                  const Tensor& value, GraphDef* graph) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op("Const");
+  node->set_device(device);
+  (*node->mutable_attr())["dtype"].set_type(value.dtype());
+  value.AsProtoTensorContent(
+      (*node->mutable_attr())["value"].mutable_tensor());
+}
+
+NodeDef* AddNode(const std::string& name, const std::string& op,
+                 const std::string& device, GraphDef* graph) {
+  NodeDef* node = graph->add_node();
+  node->set_name(name);
+  node->set_op(op);
+  node->set_device(device);
+  return node;
+}
+
+void SetReshape(const std::string& tensor, const std::string& shape,
+                DataType dtype, NodeDef* node) {
+  node->set_op("Reshape");
+  node->clear_input();
+  node->add_input(tensor);
+  node->add_input(shape);
+  node->clear_attr();
+  (*node->mutable_attr())["T"].set_type(dtype);
+  (*node->mutable_attr())["Tshape"].set_type(DT_INT64);
+}
+
+// Replaces the members of `bucket` with the slices of one CollectiveReduceV2
+// of their flattened and concatenated inputs. The members keep their names,
+// so that their consumers are unchanged.
+void RewriteBucket(const Bucket& bucket, const std::string& base,
+                   GraphDef* graph) {
+  const NodeDef& first = *bucket.members.front()->node;
+  const std::string& device = first.device();
+  const DataType dtype = first.attr().at("T").type();
+  const int num_members = bucket.members.size();
+
+  const std::string flat_shape = absl::StrCat(base, "/flat_shape");
+  AddConstNode(flat_shape, device, Tensor(int64_t{-1}), graph);
+  const std::string axis = absl::StrCat(base, "/axis");
+  AddConstNode(axis, device, Tensor(int32_t{0}), graph);
+
+  NodeDef* concat =
+      AddNode(absl::StrCat(base, "/concat"), "ConcatV2", device, graph);
+  Tensor sizes(DT_INT64, TensorShape({num_members}));
+  std::vector<std::string> control_inputs;
+  absl::flat_hash_set<std::string> seen_control_inputs;
+  for (int i = 0; i < num_members; ++i) {
+    const NodeDef& member = *bucket.members[i]->node;
+    NodeDef* flatten = AddNode(absl::StrCat(base, "/flatten_", i), "Reshape",
+                               device, graph);
+    SetReshape(member.input(0), flat_shape, dtype, flatten);
+    concat->add_input(flatten->name());
+    sizes.vec<int64_t>()(i) = bucket.members[i]->shape.num_elements();
+    for (const std::string& input : member.input()) {
+      if (IsControlInput(input) && seen_control_inputs.insert(input).second) {
+        control_inputs.push_back(input);
+      }
+    }
+  }
+  concat->add_input(axis);
+  (*concat->mutable_attr())["N"].set_i(num_members);
+  (*concat->mutable_attr())["T"].set_type(dtype);
+  (*concat->mutable_attr())["Tidx"].set_type(DT_INT32);
+
+  // The reduction takes the group and instance of the first member, which has
+  // the smallest instance key.
+  NodeDef* reduce =
+      AddNode(absl::StrCat(base, "/reduce"), first.op(), device, graph);
+  *reduce->mutable_attr() = first.attr();
+  reduce->add_input(concat->name());
+  for (int i = 1; i <= 3; ++i) reduce->add_input(first.input(i));
+  for (const std::string& input : control_inputs) reduce->add_input(input);
+
+  const std::string sizes_name = absl::StrCat(base, "/sizes");
+  AddConstNode(sizes_name, device, sizes, graph);
+  NodeDef* split =
+      AddNode(absl::StrCat(base, "/split"), "SplitV", device, graph);
+  split->add_input(reduce->name());
+  split->add_input(sizes_name);
+  split->add_input(axis);
+  (*split->mutable_attr())["num_split"].set_i(num_members);
+  (*split->mutable_attr())["T"].set_type(dtype);
+  (*split->mutable_attr())["Tlen"].set_type(DT_INT64);
+
+  for (int i = 0; i < num_members; ++i) {
+    const Candidate& member = *bucket.members[i];
+    const TensorShape& shape = member.shape;
+    Tensor dims(DT_INT64, TensorShape({shape.dims()}));
+    for (int d = 0; d < shape.dims(); ++d) {
+      dims.vec<int64_t>()(d) = shape.dim_size(d);
+    }
+    const std::string shape_name = absl::StrCat(base, "/shape_", i);
+    AddConstNode(shape_name, device, dims, graph);
+    SetReshape(absl::StrCat(split->name(), ":", i), shape_name, dtype,
+               member.node);
+  }
+}
+
+}  // namespace
+
+absl::Status CollectiveBucketingOptimizer::Optimize(
+    Cluster* cluster, const GrapplerItem& item, GraphDef* optimized_graph) {
+  *optimized_graph = item.graph;
+
+  // Bucketed ops keep their names and outputs, so fetched ones are fine too.
+  std::vector<NodeDef*> reduces;
+  for (NodeDef& node : *optimized_graph->mutable_node()) {
+    if (node.op() == "CollectiveReduceV2" && IsCpuDevice(node.device()) &&
+        node.attr().contains("T") &&
+        (!node.attr().contains("Nordering_token") ||
+         node.attr().at("Nordering_token").i() == 0)) {
+      reduces.push_back(&node);
+    }
+  }
+  if (reduces.size() < 2) return absl::AbortedError("Nothing to do.");
+
+  // Reductions in loops are left alone, since the constants added for the
+  // buckets would live outside of their frame.
+  FrameView frame_view;
+  TF_RETURN_IF_ERROR(frame_view.InferFromGraph(*optimized_graph));
+  GraphProperties properties(item);
+  TF_RETURN_IF_ERROR(properties.InferStatically(
+      /*assume_valid_feeds=*/false, /*aggressive_shape_inference=*/false,
+      /*include_tensor_values=*/false));
+  const ImmutableNodeMap node_map(optimized_graph);
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(reduces.size());
+  for (NodeDef* node : reduces) {
+    if (frame_view.IsInFrame(*node)) continue;
+    // The other members of the group must build the same buckets, which is
+    // only known from constant group and instance keys.
+    int32_t group_key;
+    int32_t instance_key;
+    if (!GetScalarInput(node_map, node->input(2), &group_key) ||
+        !GetScalarInput(node_map, node->input(3), &instance_key)) {
+      continue;
+    }
+    const auto& input_props = properties.GetInputProperties(node->name());
+    if (input_props.empty()) continue;
+    const PartialTensorShape partial_shape(input_props[0].shape());
+    TensorShape shape;
+    if (!partial_shape.AsTensorShape(&shape)) continue;
+    const DataType dtype = node->attr().at("T").type();
+    candidates.push_back({node, instance_key, shape,
+                          shape.num_elements() * DataTypeSize(dtype)});
+  }
+  // Buckets are filled in the order of the instance keys, which the members
+  // of a group share, rather than in an order that depends on the local
+  // graph. Keys are usually assigned in the order the reduced tensors are
+  // created, e.g. from the last layer to the first one for gradients.
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.instance_key < b.instance_key;
+            });
+
+  std::vector<Bucket> buckets;
+  absl::flat_hash_map<const NodeDef*, int> bucket_of;
+  absl::flat_hash_map<std::string, int> open_buckets;
+  for (const Candidate& candidate : candidates) {
+    const std::string key = BucketKey(node_map, *candidate.node);
+    auto it = open_buckets.find(key);
+    // A bucket is closed when it is full, or when adding the candidate would
+    // create a cycle, e.g. when the candidate depends on one of its members,
+    // or on a bucket that depends on one of them.
+    if (it == open_buckets.end() ||
+        buckets[it->second].bytes + candidate.bytes > bucket_bytes_ ||
+        CreatesCycle(node_map, bucket_of, buckets, it->second,
+                     candidate.node)) {
+      buckets.emplace_back();
+      it = open_buckets.insert_or_assign(key, buckets.size() - 1).first;
+    }
+    Bucket& bucket = buckets[it->second];
+    bucket.members.push_back(&candidate);
+    bucket.bytes += candidate.bytes;
+    bucket_of[candidate.node] = it->second;
+  }
+
+  bool changed = false;
+  for (const Bucket& bucket : buckets) {
+    if (bucket.members.size() < 2) continue;
+    std::string base = AddPrefixToNodeName(
+        bucket.members.front()->node->name(), kCollectiveBucketing);
+    VLOG(2) << "Bucketing " << bucket.members.size() << " reductions of "
+            << bucket.bytes << " bytes into " << base;
+    RewriteBucket(bucket, base, optimized_graph);
+    changed = true;
+  }
+  if (!changed) return absl::AbortedError("Nothing to do.");
+  return absl::OkStatus();
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,73 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_OPTIMIZER_H_
+#define TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_OPTIMIZER_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Merges the CollectiveReduceV2 ops of a CPU device, e.g. the all-reduces of
+// the gradients of a model, into buckets of at most
+// `CollectiveBucketingOptions::bucket_bytes`.
+//
+// The inputs of the ops of a bucket are flattened and concatenated, reduced
+// with one CollectiveReduceV2, and split back into the original ops, which
+// become Reshapes of the result. Ops are bucketed in the order of their
+// instance keys, which usually follows the order backprop produces the
+// gradients, so that each bucket is launched as soon as its last gradient is
+// ready and overlaps with the computation of the next ones.
+//
+// Only ops with the same attributes, group and device, constant group and
+// instance keys, fully defined input shapes and no ordering tokens are
+// bucketed together. The reduction of a bucket uses the smallest instance key
+// of its ops. Every member of a group runs this pass on its own graph, so
+// they must reduce the same shapes under the same instance keys, with the
+// same dependencies between them and the same `bucket_bytes`, as replicas do.
+// They then build the same buckets.
+class CollectiveBucketingOptimizer : public GraphOptimizer {
+ public:
+  // The bucket size used when `bucket_bytes` is not set.
+  static constexpr int64_t kDefaultBucketBytes = 4 << 20;
+
+  CollectiveBucketingOptimizer() = default;
+  CollectiveBucketingOptimizer(RewriterConfig::Toggle opt_level,
+                               const CollectiveBucketingOptions& opts)
+      : bucket_bytes_(opts.bucket_bytes() > 0 ? opts.bucket_bytes()
+                                              : kDefaultBucketBytes) {}
+  ~CollectiveBucketingOptimizer() override = default;
+
+  std::string name() const override { return "collective_bucketing"; };
+
+  bool UsesFunctionLibrary() const override { return false; }
+
+  absl::Status Optimize(Cluster* cluster, const GrapplerItem& item,
+                        GraphDef* optimized_graph) override;
+
+ private:
+  int64_t bucket_bytes_ = kDefaultBucketBytes;
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_OPTIMIZERS_COLLECTIVE_BUCKETING_OPTIMIZER_H_
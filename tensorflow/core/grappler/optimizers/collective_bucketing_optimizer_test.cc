@@ -0,0 +1,326 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/optimizers/collective_bucketing_optimizer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/cc/ops/standard_ops.h"
+#include "tensorflow/core/framework/graph.pb.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/grappler/grappler_item.h"
+#include "tensorflow/core/grappler/utils/grappler_test.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/protobuf/rewriter_config.pb.h"
+#include "tensorflow/core/public/session.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+constexpr char kCpu0[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+
+// Adds a CollectiveReduceV2 of `input` with the group of the "group_size"
+// and "group_key" nodes and the instance of `instance_key`.
+void AddReduce(const std::string& name, const std::string& input,
+               const std::string& instance_key, const std::string& device,
+               GraphDef* graph) {
+  TF_CHECK_OK(NodeDefBuilder(name, "CollectiveReduceV2")
+                  .Input(input, 0, DT_FLOAT)
+                  .Input("group_size", 0, DT_INT32)
+                  .Input("group_key", 0, DT_INT32)
+                  .Input(instance_key, 0, DT_INT32)
+                  .Input(std::vector<NodeDefBuilder::NodeOut>{})
+                  .Attr("merge_op", "Add")
+                  .Attr("final_op", "Id")
+                  .Device(device)
+                  .Finalize(graph->add_node()));
+}
+
+class CollectiveBucketingOptimizerTest : public GrapplerTest {
+ protected:
+  // Builds reductions of "a" (24 bytes), "b" (16 bytes) and "c" (20 bytes),
+  // named "reduce_a", "reduce_b" and "reduce_c", on a group of one device.
+  // With `chain`, "reduce_b" reduces the result of "reduce_a" instead.
+  GrapplerItem MakeItem(bool chain) {
+    Scope s = Scope::NewRootScope().WithDevice(kCpu0);
+    ops::Const(s.WithOpName("group_size"), 1);
+    ops::Const(s.WithOpName("group_key"), 1);
+    for (int i = 1; i <= 3; ++i) {
+      ops::Const(s.WithOpName(absl::StrCat("instance_key_", i)), i);
+    }
+    ops::Const(s.WithOpName("a"), {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f},
+               {2, 3});
+    ops::Const(s.WithOpName("b"), {7.0f, 8.0f, 9.0f, 10.0f}, {4});
+    ops::Const(s.WithOpName("c"), {11.0f, 12.0f, 13.0f, 14.0f, 15.0f}, {5});
+    GrapplerItem item;
+    TF_CHECK_OK(s.ToGraphDef(&item.graph));
+    AddReduce("reduce_a", "a", "instance_key_1", kCpu0, &item.graph);
+    AddReduce("reduce_b", chain ? "reduce_a" : "b", "instance_key_2", kCpu0,
+              &item.graph);
+    AddReduce("reduce_c", "c", "instance_key_3", kCpu0, &item.graph);
+    item.fetch = {"reduce_a", "reduce_b", "reduce_c"};
+    return item;
+  }
+};
+
+TEST_F(CollectiveBucketingOptimizerTest, BucketsReductions) {
+  GrapplerItem item = MakeItem(/*chain=*/false);
+  CollectiveBucketingOptions opts;
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+
+  // All three fit in the default bucket.
+  EXPECT_EQ(CountOpNodes(output, "CollectiveReduceV2"), 1);
+  EXPECT_EQ(CountOpNodes(output, "ConcatV2"), 1);
+  EXPECT_EQ(CountOpNodes(output, "SplitV"), 1);
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors.size(), tensors_expected.size());
+  for (int i = 0; i < tensors.size(); ++i) {
+    test::ExpectTensorEqual<float>(tensors[i], tensors_expected[i]);
+  }
+}
+
+TEST_F(CollectiveBucketingOptimizerTest, BucketBytes) {
+  GrapplerItem item = MakeItem(/*chain=*/false);
+  CollectiveBucketingOptions opts;
+  opts.set_bucket_bytes(40);
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+
+  // "a" and "b" fill the first bucket, and "c" is left alone.
+  EXPECT_EQ(CountOpNodes(output, "CollectiveReduceV2"), 2);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduce_c") EXPECT_EQ(node.op(), "CollectiveReduceV2");
+    if (node.name() == "reduce_a" || node.name() == "reduce_b") {
+      EXPECT_EQ(node.op(), "Reshape");
+    }
+  }
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors.size(), tensors_expected.size());
+  for (int i = 0; i < tensors.size(); ++i) {
+    test::ExpectTensorEqual<float>(tensors[i], tensors_expected[i]);
+  }
+}
+
+TEST_F(CollectiveBucketingOptimizerTest, DependentReductions) {
+  GrapplerItem item = MakeItem(/*chain=*/true);
+  CollectiveBucketingOptions opts;
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+
+  // "reduce_b" depends on "reduce_a", so it starts a new bucket, which
+  // "reduce_c" joins.
+  EXPECT_EQ(CountOpNodes(output, "CollectiveReduceV2"), 2);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduce_a") EXPECT_EQ(node.op(), "CollectiveReduceV2");
+    if (node.name() == "reduce_b") EXPECT_EQ(node.op(), "Reshape");
+    if (node.name() == "reduce_c") EXPECT_EQ(node.op(), "Reshape");
+  }
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors.size(), tensors_expected.size());
+  for (int i = 0; i < tensors.size(); ++i) {
+    test::ExpectTensorEqual<float>(tensors[i], tensors_expected[i]);
+  }
+}
+
+TEST_F(CollectiveBucketingOptimizerTest, DependenciesBetweenBuckets) {
+  // "reduce_2" reduces the result of "reduce_3", and "reduce_4" the one of
+  // "reduce_1". Bucketing {1, 2} and {3, 4} would make each bucket wait for
+  // the other one.
+  Scope s = Scope::NewRootScope().WithDevice(kCpu0);
+  ops::Const(s.WithOpName("group_size"), 1);
+  ops::Const(s.WithOpName("group_key"), 1);
+  for (int i = 1; i <= 4; ++i) {
+    ops::Const(s.WithOpName(absl::StrCat("instance_key_", i)), i);
+  }
+  ops::Const(s.WithOpName("x"), {1.0f, 2.0f, 3.0f, 4.0f}, {4});
+  ops::Const(s.WithOpName("y"), {5.0f, 6.0f, 7.0f, 8.0f}, {4});
+  GrapplerItem item;
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+  AddReduce("reduce_1", "x", "instance_key_1", kCpu0, &item.graph);
+  AddReduce("reduce_2", "reduce_3", "instance_key_2", kCpu0, &item.graph);
+  AddReduce("reduce_3", "y", "instance_key_3", kCpu0, &item.graph);
+  AddReduce("reduce_4", "reduce_1", "instance_key_4", kCpu0, &item.graph);
+  item.fetch = {"reduce_1", "reduce_2", "reduce_3", "reduce_4"};
+
+  CollectiveBucketingOptions opts;
+  opts.set_bucket_bytes(32);
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+
+  // "reduce_1" and "reduce_2" fill the first bucket, and "reduce_4" cannot
+  // join "reduce_3" in the second one.
+  EXPECT_EQ(CountOpNodes(output, "CollectiveReduceV2"), 3);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduce_1" || node.name() == "reduce_2") {
+      EXPECT_EQ(node.op(), "Reshape");
+    }
+    if (node.name() == "reduce_3" || node.name() == "reduce_4") {
+      EXPECT_EQ(node.op(), "CollectiveReduceV2");
+    }
+  }
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors.size(), tensors_expected.size());
+  for (int i = 0; i < tensors.size(); ++i) {
+    test::ExpectTensorEqual<float>(tensors[i], tensors_expected[i]);
+  }
+}
+
+TEST_F(CollectiveBucketingOptimizerTest, BucketsInInstanceKeyOrder) {
+  GrapplerItem item = MakeItem(/*chain=*/false);
+  // Reverse the instance keys, so that "c" comes first.
+  for (NodeDef& node : *item.graph.mutable_node()) {
+    if (node.name() == "reduce_a") node.set_input(3, "instance_key_3");
+    if (node.name() == "reduce_c") node.set_input(3, "instance_key_1");
+  }
+  CollectiveBucketingOptions opts;
+  opts.set_bucket_bytes(40);
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  TF_ASSERT_OK(optimizer.Optimize(/*cluster=*/nullptr, item, &output));
+
+  // "c" and "b" fill the first bucket, which takes the instance of "c", and
+  // "a" is left alone.
+  EXPECT_EQ(CountOpNodes(output, "CollectiveReduceV2"), 2);
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "reduce_a") EXPECT_EQ(node.op(), "CollectiveReduceV2");
+    if (node.name() == "reduce_b" || node.name() == "reduce_c") {
+      EXPECT_EQ(node.op(), "Reshape");
+    }
+    if (node.op() == "CollectiveReduceV2" && node.name() != "reduce_a") {
+      EXPECT_EQ(node.input(3), "instance_key_1");
+    }
+  }
+
+  auto tensors_expected = EvaluateNodes(item.graph, item.fetch);
+  auto tensors = EvaluateNodes(output, item.fetch);
+  ASSERT_EQ(tensors.size(), tensors_expected.size());
+  for (int i = 0; i < tensors.size(); ++i) {
+    test::ExpectTensorEqual<float>(tensors[i], tensors_expected[i]);
+  }
+}
+
+TEST_F(CollectiveBucketingOptimizerTest, NothingToDo) {
+  GrapplerItem item = MakeItem(/*chain=*/false);
+  CollectiveBucketingOptions opts;
+  opts.set_bucket_bytes(1);
+  CollectiveBucketingOptimizer optimizer(RewriterConfig::ON, opts);
+  GraphDef output;
+  absl::Status status =
+      optimizer.Optimize(/*cluster=*/nullptr, item, &output);
+  EXPECT_TRUE(absl::IsAborted(status)) << status;
+}
+
+// All-reduces `num_tensors` random tensors of `num_elements` floats across
+// the 4 CPU devices of a session, the way replicas all-reduce their
+// gradients, with or without collective bucketing.
+void CollectiveReduceBenchmark(::testing::benchmark::State& state,
+                               bool bucketing) {
+  constexpr int kNumDevices = 4;
+  const int num_tensors = state.range(0);
+  const int num_elements = state.range(1);
+
+  Scope s = Scope::NewRootScope();
+  ops::Const(s.WithOpName("group_size"), kNumDevices);
+  ops::Const(s.WithOpName("group_key"), 1);
+  for (int i = 0; i < num_tensors; ++i) {
+    ops::Const(s.WithOpName(absl::StrCat("instance_key_", i)), i + 1);
+  }
+  for (int d = 0; d < kNumDevices; ++d) {
+    Scope device_scope = s.WithDevice(
+        absl::StrCat("/job:localhost/replica:0/task:0/device:CPU:", d));
+    for (int i = 0; i < num_tensors; ++i) {
+      ops::RandomUniform(
+          device_scope.WithOpName(absl::StrCat("grad_", d, "_", i)),
+          ops::Const(device_scope, {num_elements}), DT_FLOAT);
+    }
+  }
+  GraphDef graph;
+  TF_CHECK_OK(s.ToGraphDef(&graph));
+  std::vector<std::string> targets;
+  for (int d = 0; d < kNumDevices; ++d) {
+    for (int i = 0; i < num_tensors; ++i) {
+      targets.push_back(absl::StrCat("reduce_", d, "_", i));
+      AddReduce(targets.back(), absl::StrCat("grad_", d, "_", i),
+                absl::StrCat("instance_key_", i),
+                absl::StrCat("/job:localhost/replica:0/task:0/device:CPU:", d),
+                &graph);
+    }
+  }
+
+  SessionOptions options;
+  (*options.config.mutable_device_count())["CPU"] = kNumDevices;
+  RewriterConfig* rewriter_config =
+      options.config.mutable_graph_options()->mutable_rewrite_options();
+  rewriter_config->set_collective_bucketing(bucketing ? RewriterConfig::ON
+                                                      : RewriterConfig::OFF);
+  std::unique_ptr<Session> session(NewSession(options));
+  TF_CHECK_OK(session->Create(graph));
+  // Warm up, so that groups and instances are resolved.
+  TF_CHECK_OK(session->Run({}, {}, targets, nullptr));
+
+  for (auto st : state) {
+    TF_CHECK_OK(session->Run({}, {}, targets, nullptr));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          kNumDevices * num_tensors * num_elements *
+                          sizeof(float));
+  TF_CHECK_OK(session->Close());
+}
+
+void BM_CollectiveReduce(::testing::benchmark::State& state) {
+  CollectiveReduceBenchmark(state, /*bucketing=*/false);
+}
+
+void BM_CollectiveReduceBucketed(::testing::benchmark::State& state) {
+  CollectiveReduceBenchmark(state, /*bucketing=*/true);
+}
+
+// The devices run on other threads, so wall time is what is compared.
+#define BM_COLLECTIVE_REDUCE(BM) \
+  BENCHMARK(BM)                  \
+      ->UseRealTime()            \
+      ->ArgPair(64, 256)         \
+      ->ArgPair(64, 16384)       \
+      ->ArgPair(16, 262144)
+
+BM_COLLECTIVE_REDUCE(BM_CollectiveReduce);
+BM_COLLECTIVE_REDUCE(BM_CollectiveReduceBucketed);
+
+}  // namespace
+}  // namespace grappler
+}  // namespace tensorflow
@@ -57,6 +57,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/arithmetic_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/auto_mixed_precision.h"
 #include "tensorflow/core/grappler/optimizers/auto_parallel.h"
+#include "tensorflow/core/grappler/optimizers/collective_bucketing_optimizer.h"
 #include "tensorflow/core/grappler/optimizers/common_subgraph_elimination.h"
 #include "tensorflow/core/grappler/optimizers/constant_folding.h"
 #include "tensorflow/core/grappler/optimizers/custom_graph_optimizer_registry.h"
@@ -129,7 +130,7 @@ int NumIterations(const RewriterConfig& cfg) {
 // Check if optimizer is allowed to run only once.
 bool IsRunOnceOptimizer(const std::string& name) {
   return name == "layout" || name == "memory_optimizer" ||
-         name == "loop_optimizer" ||
+         name == "loop_optimizer" || name == "collective_bucketing" ||
          absl::StartsWith(name, "auto_mixed_precision");
 }
 
@@ -285,6 +286,9 @@ std::unique_ptr<GraphOptimizer> MetaOptimizer::MakeNewOptimizer(
                                       cfg_.scoped_allocator_opts()));
   MK_OPT("pin_to_host", "pin_to_host_optimization",
          new PinToHostOptimizer(cfg_.pin_to_host_optimization()));
+  MK_OPT("collective_bucketing", "collective_bucketing",
+         new CollectiveBucketingOptimizer(cfg_.collective_bucketing(),
+                                          cfg_.collective_bucketing_opts()));
 
   return std::unique_ptr<GraphOptimizer>();
 }
@@ -511,6 +515,12 @@ absl::Status MetaOptimizer::InitializeOptimizers(
     optimizers->push_back(
         std::make_unique<AutoParallel>(cfg_.auto_parallel().num_replicas()));
   }
+  // Plugins cannot turn this one on, only off.
+  if (USER_IS_ON(collective_bucketing) &&
+      PLUGIN_NOT_OFF(collective_bucketing)) {
+    optimizers->push_back(std::make_unique<CollectiveBucketingOptimizer>(
+        cfg_.collective_bucketing(), cfg_.collective_bucketing_opts()));
+  }
 
 #ifndef ENABLE_MKL
   if (BOTH_ARE_ON(scoped_allocator_optimization)) {
@@ -666,6 +676,7 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
     PRINT_CFG(loop_optimization)
     PRINT_CFG(dependency_optimization)
     PRINT_CFG(scoped_allocator_optimization)
+    PRINT_CFG(collective_bucketing)
 #undef PRINT_CFG
     user_cfg.toggle_config["auto_mixed_precision"] =
         AutoMixedPrecisionEnabled(cfg_.auto_mixed_precision())
@@ -721,6 +732,7 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
       PRINT_CFG("memory", "memory_optimization")
       PRINT_CFG("autoparallel", "auto_parallel")
       PRINT_CFG("scoped_allocator", "scoped_allocator_optimization")
+      PRINT_CFG("collective_bucketing", "collective_bucketing")
 #undef PRINT_CFG
     }
   }
@@ -755,7 +767,8 @@ void MetaOptimizer::PrintUserAndPluginConfigs(
         pair.first == "auto_mixed_precision_mkl" ||
         pair.first == "auto_mixed_precision_cpu" ||
         pair.first == "pin_to_host_optimization" ||
-        pair.first == "scoped_allocator_optimization") {
+        pair.first == "scoped_allocator_optimization" ||
+        pair.first == "collective_bucketing") {
       // These optimizers are turned off by default.
       // TODO(penporn): Remove the hard-coded length and change it to max length
       // of all option strings.
@@ -1382,6 +1395,7 @@ bool MetaOptimizerEnabled(const ConfigProto& cfg) {
          rewrite_cfg.scoped_allocator_optimization() == RewriterConfig::ON ||
 #endif
          rewrite_cfg.pin_to_host_optimization() == RewriterConfig::ON ||
+         rewrite_cfg.collective_bucketing() == RewriterConfig::ON ||
          AutoMixedPrecisionEnabled(rewrite_cfg.auto_mixed_precision()) ||
          AutoMixedPrecisionEnabled(
              rewrite_cfg.auto_mixed_precision_onednn_bfloat16()) ||
@@ -21,6 +21,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/status/status.h"
@@ -125,6 +126,14 @@ int32_t NumBatchThreadsFromEnvironmentWithDefault(
   return (val && absl::SimpleAtoi(val, &num)) ? num : default_num_batch_threads;
 }
 
+// Returns true if TF_BATCHING_ENABLE_ZERO_COPY enables zero-copy batching, see
+// `BatchResourceBase::set_enable_zero_copy_batching`.
+bool ZeroCopyBatchingFromEnvironment() {
+  bool enable = false;
+  const char* val = std::getenv("TF_BATCHING_ENABLE_ZERO_COPY");
+  return val && absl::SimpleAtob(val, &enable) && enable;
+}
+
 static thread::ThreadPool* GetOrCreateBatchThreadsPool() {
   static thread::ThreadPool* shared_thread_pool = [&]() -> thread::ThreadPool* {
     serving::BoundedExecutor::Options options;
@@ -193,7 +202,10 @@ class BatchResource : public serving::BatchResourceBase {
                   /*enable_batching_task_lazy_cancellation=*/false,
                   /*batch_padding_policy=*/"PAD_UP",
                   /*num_warmup_batch_threads=*/0,
-                  /*per_criticality_batch_timeout_micros=*/{}, resource);
+                  /*per_criticality_batch_timeout_micros=*/{},
+                  /*latency_slo_micros=*/0, /*enable_fair_sharing=*/false,
+                  /*fair_share_weight=*/1.0,
+                  /*max_queueing_delay_micros=*/0, resource);
   }
 
   static absl::Status Create(
@@ -212,10 +224,13 @@ class BatchResource : public serving::BatchResourceBase {
       bool enable_batching_task_lazy_cancellation,
       absl::string_view batch_padding_policy, int32_t num_warmup_batch_threads,
       const std::vector<int64_t>& per_criticality_batch_timeout_micros,
+      int64_t latency_slo_micros, bool enable_fair_sharing,
+      double fair_share_weight, int64_t max_queueing_delay_micros,
       std::unique_ptr<BatchResource>* resource) {
     BatcherT::Options batcher_options;
     batcher_options.num_batch_threads = num_batch_threads;
     batcher_options.num_warmup_batch_threads = num_warmup_batch_threads;
+    batcher_options.enable_fair_sharing = enable_fair_sharing;
     if (mixed_priority_batching_policy ==
         serving::MixedPriorityBatchingPolicy::kPriorityMerge) {
       batcher_options.use_global_scheduler = true;
@@ -231,7 +246,9 @@ class BatchResource : public serving::BatchResourceBase {
               << batcher_options.num_warmup_batch_threads
               << ", use_global_scheduler="
               << batcher_options.use_global_scheduler
-              << ", rank_queues=" << batcher_options.rank_queues;
+              << ", rank_queues=" << batcher_options.rank_queues
+              << ", enable_fair_sharing="
+              << batcher_options.enable_fair_sharing;
     std::shared_ptr<BatcherT> batcher;
     TF_RETURN_IF_ERROR(BatcherT::Create(batcher_options, &batcher));
 
@@ -248,7 +265,8 @@ class BatchResource : public serving::BatchResourceBase {
             enable_priority_aware_batch_scheduler,
             enable_priority_aware_batch_scheduler_resplit,
             enable_batching_task_lazy_cancellation,
-            per_criticality_batch_timeout_micros),
+            per_criticality_batch_timeout_micros, latency_slo_micros,
+            fair_share_weight, max_queueing_delay_micros),
         allowed_batch_sizes));
     return absl::OkStatus();
   }
@@ -382,6 +400,38 @@ BatchFunctionKernel::BatchFunctionKernel(OpKernelConstruction* c)
         c, c->GetAttr("num_warmup_batch_threads", &num_warmup_batch_threads_));
   }
 
+  if (c->HasAttr("latency_slo_micros")) {
+    OP_REQUIRES_OK(c, c->GetAttr("latency_slo_micros", &latency_slo_micros_));
+  }
+  OP_REQUIRES(c,
+              (batch_padding_policy_ == serving::kLatencySloPolicy) ==
+                  (latency_slo_micros_ > 0),
+              errors::InvalidArgument(
+                  "latency_slo_micros must be positive iff "
+                  "batch_padding_policy is ",
+                  serving::kLatencySloPolicy, "; got latency_slo_micros=",
+                  latency_slo_micros_, " and batch_padding_policy=",
+                  batch_padding_policy_));
+
+  if (c->HasAttr("enable_fair_sharing")) {
+    OP_REQUIRES_OK(c, c->GetAttr("enable_fair_sharing", &enable_fair_sharing_));
+  }
+  if (c->HasAttr("fair_share_weight")) {
+    OP_REQUIRES_OK(c, c->GetAttr("fair_share_weight", &fair_share_weight_));
+  }
+  if (c->HasAttr("max_queueing_delay_micros")) {
+    OP_REQUIRES_OK(c, c->GetAttr("max_queueing_delay_micros",
+                                 &max_queueing_delay_micros_));
+  }
+
+  if (c->HasAttr("sequence_length_buckets")) {
+    OP_REQUIRES_OK(
+        c, c->GetAttr("sequence_length_buckets", &sequence_length_buckets_));
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_inputs", &sequence_inputs_));
+    OP_REQUIRES_OK(c, c->GetAttr("sequence_outputs", &sequence_outputs_));
+    OP_REQUIRES_OK(c, ValidateSequenceLengthBucketing(c));
+  }
+
   // Helper function `SetAdaptiveBatchSchedulerOptions` calls
   // `OP_REQUIRES_OK`, which exits the current function upon error.
   // So validate status of `op-kernel-construction`.
@@ -489,6 +539,10 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
+      new_resource->set_enable_zero_copy_batching(
+          ZeroCopyBatchingFromEnvironment());
+      new_resource->set_sequence_length_bucketing(
+          sequence_length_buckets_, sequence_inputs_, sequence_outputs_);
       *r = new_resource.release();
       return absl::OkStatus();
     };
@@ -511,10 +565,15 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
           enable_priority_aware_batch_scheduler_resplit_,
           enable_batching_task_lazy_cancellation_, batch_padding_policy_,
           num_warmup_batch_threads_, per_criticality_batch_timeout_micros_,
-          &new_resource));
+          latency_slo_micros_, enable_fair_sharing_, fair_share_weight_,
+          max_queueing_delay_micros_, &new_resource));
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
+      new_resource->set_enable_zero_copy_batching(
+          ZeroCopyBatchingFromEnvironment());
+      new_resource->set_sequence_length_bucketing(
+          sequence_length_buckets_, sequence_inputs_, sequence_outputs_);
       *r = new_resource.release();
       return absl::OkStatus();
     };
@@ -667,6 +726,55 @@ absl::Status BatchFunctionKernel::ValidateAllowedBatchSizes() const {
   return absl::OkStatus();
 }
 
+// Validates the sequence length bucketing attrs.
+absl::Status BatchFunctionKernel::ValidateSequenceLengthBucketing(
+    OpKernelConstruction* c) const {
+  if (sequence_length_buckets_.empty()) {
+    if (!sequence_inputs_.empty() || !sequence_outputs_.empty()) {
+      return absl::InvalidArgumentError(
+          "sequence_inputs and sequence_outputs require "
+          "sequence_length_buckets");
+    }
+    return absl::OkStatus();
+  }
+  for (int64_t bucket : sequence_length_buckets_) {
+    if (bucket <= 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "sequence_length_buckets must be positive; got ", bucket));
+    }
+  }
+  if (sequence_inputs_.empty()) {
+    return absl::InvalidArgumentError(
+        "sequence_length_buckets requires at least one sequence_inputs entry");
+  }
+  DataTypeVector tin;
+  TF_RETURN_IF_ERROR(c->GetAttr("Tin", &tin));
+  DataTypeVector tout;
+  TF_RETURN_IF_ERROR(c->GetAttr("Tout", &tout));
+  for (int32_t index : sequence_inputs_) {
+    if (index < 0 || index >= static_cast<int32_t>(tin.size())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("sequence_inputs entry ", index, " is out of range; ",
+                       tin.size(), " in_tensors"));
+    }
+  }
+  std::vector<int32_t> sorted_inputs = sequence_inputs_;
+  std::sort(sorted_inputs.begin(), sorted_inputs.end());
+  if (std::adjacent_find(sorted_inputs.begin(), sorted_inputs.end()) !=
+      sorted_inputs.end()) {
+    return absl::InvalidArgumentError(
+        "sequence_inputs must not have duplicate entries");
+  }
+  for (int32_t index : sequence_outputs_) {
+    if (index < 0 || index >= static_cast<int32_t>(tout.size())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("sequence_outputs entry ", index, " is out of range; ",
+                       tout.size(), " out_tensors"));
+    }
+  }
+  return absl::OkStatus();
+}
+
 // Initialize vars by reading from op-kernel-construction.
 // Vars
 // - enable_adaptive_batch_threads_
@@ -778,6 +886,8 @@ class BatchKernel : public AsyncOpKernel {
               /*has_process_batch_function=*/false, num_batch_threads_,
               max_batch_size_, batch_timeout_micros_, max_enqueued_batches_,
               allowed_batch_sizes_, false, &new_resource));
+          new_resource->set_enable_zero_copy_batching(
+              ZeroCopyBatchingFromEnvironment());
           *r = new_resource.release();
           return absl::OkStatus();
         };
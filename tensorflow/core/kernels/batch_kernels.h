@@ -80,6 +80,10 @@ class BatchFunctionKernel : public AsyncOpKernel {
   // to `max_batch_size_`.
   absl::Status ValidateAllowedBatchSizes() const;
 
+  // Validates the sequence_length_buckets, sequence_inputs and
+  // sequence_outputs attrs against the inputs and outputs of the op.
+  absl::Status ValidateSequenceLengthBucketing(OpKernelConstruction* c) const;
+
   // Validates 'per_criticality_batch_timeout_micros_'. The entries must be
   // either empty or of size equal to the number of criticalities.
   absl::Status ValidatePerCriticalityBatchTimeoutMicros() const;
@@ -117,6 +121,13 @@ class BatchFunctionKernel : public AsyncOpKernel {
   std::string mixed_priority_policy_;
   std::string batch_padding_policy_;
   int32_t num_warmup_batch_threads_ = 0;
+  int64_t latency_slo_micros_ = 0;
+  bool enable_fair_sharing_ = false;
+  float fair_share_weight_ = 1.0;
+  int64_t max_queueing_delay_micros_ = 0;
+  std::vector<int64_t> sequence_length_buckets_;
+  std::vector<int32_t> sequence_inputs_;
+  std::vector<int32_t> sequence_outputs_;
   NameAttrList func_;
   absl::optional<FunctionLibraryRuntime::Handle> fhandle_ TF_GUARDED_BY(mu_);
   bool enable_large_batch_splitting_ = false;
@@ -0,0 +1,147 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// Returns the number of bytes in one 0th-dimension row of `tensor`.
+int64_t RowBytes(const Tensor& tensor) {
+  const int64_t num_rows = tensor.dim_size(0);
+  return num_rows == 0 ? 0 : tensor.TotalBytes() / num_rows;
+}
+
+}  // namespace
+
+/*static*/ bool BatchInputBuffer::CanStage(absl::Span<const Tensor> inputs) {
+  if (inputs.empty()) return false;
+  for (const Tensor& input : inputs) {
+    if (input.dims() == 0 || !DataTypeCanUseMemcpy(input.dtype()) ||
+        input.dim_size(0) != inputs[0].dim_size(0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*static*/ absl::StatusOr<std::shared_ptr<BatchInputBuffer>>
+BatchInputBuffer::Create(Allocator* allocator, absl::Span<const Tensor> inputs,
+                         int64_t num_rows) {
+  DCHECK(CanStage(inputs));
+  std::vector<Tensor> tensors;
+  tensors.reserve(inputs.size());
+  for (const Tensor& input : inputs) {
+    TensorShape shape = input.shape();
+    shape.set_dim(0, num_rows);
+    Tensor tensor(allocator, input.dtype(), shape);
+    if (!tensor.IsInitialized()) {
+      return absl::ResourceExhaustedError(
+          absl::StrCat("Failed to allocate a batch input buffer of shape ",
+                       shape.DebugString()));
+    }
+    tensors.push_back(std::move(tensor));
+  }
+  return std::shared_ptr<BatchInputBuffer>(
+      new BatchInputBuffer(std::move(tensors), num_rows));
+}
+
+bool BatchInputBuffer::IsCompatible(absl::Span<const Tensor> inputs) const {
+  if (inputs.size() != tensors_.size()) return false;
+  for (int i = 0; i < inputs.size(); ++i) {
+    const Tensor& input = inputs[i];
+    const Tensor& tensor = tensors_[i];
+    if (input.dtype() != tensor.dtype() || input.dims() != tensor.dims()) {
+      return false;
+    }
+    for (int d = 1; d < input.dims(); ++d) {
+      if (input.dim_size(d) != tensor.dim_size(d)) return false;
+    }
+  }
+  return true;
+}
+
+int64_t BatchInputBuffer::Reserve(int64_t rows) {
+  absl::MutexLock lock(mu_);
+  if (next_row_ + rows > num_rows_) return -1;
+  const int64_t row = next_row_;
+  next_row_ += rows;
+  return row;
+}
+
+bool BatchInputBuffer::ReserveAt(int64_t row, int64_t rows) {
+  absl::MutexLock lock(mu_);
+  if (next_row_ != row || row + rows > num_rows_) return false;
+  next_row_ += rows;
+  return true;
+}
+
+void BatchInputBuffer::CopyFrom(absl::Span<const Tensor> inputs,
+                                int64_t row) {
+  DCHECK(IsCompatible(inputs));
+  for (int i = 0; i < inputs.size(); ++i) {
+    DCHECK_LE(row + inputs[i].dim_size(0), num_rows_);
+    const absl::string_view data = inputs[i].tensor_data();
+    std::memcpy(RowData(i, row), data.data(), data.size());
+  }
+}
+
+void BatchInputBuffer::FillFromRow(int64_t src_row, int64_t row,
+                                   int64_t rows) {
+  DCHECK_LE(row + rows, num_rows_);
+  for (int i = 0; i < tensors_.size(); ++i) {
+    const int64_t row_bytes = RowBytes(tensors_[i]);
+    const char* src = RowData(i, src_row);
+    for (int64_t r = row; r < row + rows; ++r) {
+      std::memcpy(RowData(i, r), src, row_bytes);
+    }
+  }
+}
+
+std::optional<Tensor> BatchInputBuffer::Slice(int input_index, int64_t row,
+                                              int64_t rows) const {
+  Tensor slice = tensors_[input_index].Slice(row, row + rows);
+  if (!slice.IsAligned()) return std::nullopt;
+  return slice;
+}
+
+char* BatchInputBuffer::RowData(int input_index, int64_t row) const {
+  const Tensor& tensor = tensors_[input_index];
+  return const_cast<char*>(tensor.tensor_data().data()) +
+         row * RowBytes(tensor);
+}
+
+}  // namespace serving
+}  // namespace tensorflow
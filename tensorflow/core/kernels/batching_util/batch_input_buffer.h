@@ -0,0 +1,99 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+namespace serving {
+
+// A pre-allocated staging area that batch tasks copy their inputs into when
+// they are enqueued. Each batching input gets one tensor of `num_rows` rows,
+// and tasks reserve consecutive rows of all of them at once. A batch formed
+// from tasks holding consecutive rows of the same buffer is then a slice of
+// the buffer, so it does not need to be concatenated on the batch thread.
+//
+// Reservations are never released; a buffer is freed once the tasks and
+// batches referring to it are done. Thread-safe.
+class BatchInputBuffer {
+ public:
+  // Returns true if `inputs` can be staged in a buffer, i.e. they all have at
+  // least one dimension, the same number of rows and a memcpy-able dtype.
+  static bool CanStage(absl::Span<const Tensor> inputs);
+
+  // Allocates a buffer for inputs with the dtypes and the inner dimensions of
+  // `inputs`, which can hold `num_rows` rows.
+  // REQUIRES: CanStage(inputs).
+  static absl::StatusOr<std::shared_ptr<BatchInputBuffer>> Create(
+      Allocator* allocator, absl::Span<const Tensor> inputs, int64_t num_rows);
+
+  // Returns true if the rows of `inputs` can be staged in this buffer.
+  bool IsCompatible(absl::Span<const Tensor> inputs) const;
+
+  int64_t num_rows() const { return num_rows_; }
+
+  // Reserves the next `rows` rows. Returns the first reserved row, or -1 if
+  // the buffer does not have `rows` unreserved rows left.
+  int64_t Reserve(int64_t rows);
+
+  // Reserves rows [`row`, `row` + `rows`) if they are the next unreserved
+  // rows. Returns false otherwise.
+  bool ReserveAt(int64_t row, int64_t rows);
+
+  // Copies the rows of `inputs` to the buffer, starting at row `row`.
+  // REQUIRES: The rows were reserved by the caller and IsCompatible(inputs).
+  void CopyFrom(absl::Span<const Tensor> inputs, int64_t row);
+
+  // Copies row `src_row` of every input to rows [`row`, `row` + `rows`).
+  // REQUIRES: The destination rows were reserved by the caller.
+  void FillFromRow(int64_t src_row, int64_t row, int64_t rows);
+
+  // Returns rows [`row`, `row` + `rows`) of input `input_index`, which alias
+  // the buffer. Returns nullopt if the slice would not be aligned, in which
+  // case it can't be passed to kernels as is.
+  std::optional<Tensor> Slice(int input_index, int64_t row,
+                              int64_t rows) const;
+
+ private:
+  BatchInputBuffer(std::vector<Tensor> tensors, int64_t num_rows)
+      : tensors_(std::move(tensors)), num_rows_(num_rows) {}
+
+  // Returns the address of row `row` of input `input_index`.
+  char* RowData(int input_index, int64_t row) const;
+
+  const std::vector<Tensor> tensors_;
+  const int64_t num_rows_;
+
+  absl::Mutex mu_;
+  int64_t next_row_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_H_
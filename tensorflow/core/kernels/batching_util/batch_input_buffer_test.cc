@@ -0,0 +1,123 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// Rows of 16 floats keep every slice aligned.
+Tensor Rows(int num_rows, float value) {
+  Tensor tensor(DT_FLOAT, TensorShape({num_rows, 16}));
+  test::FillFn<float>(&tensor, [value](int i) { return value + i; });
+  return tensor;
+}
+
+TEST(BatchInputBufferTest, CanStage) {
+  EXPECT_TRUE(BatchInputBuffer::CanStage({Rows(2, 0), Rows(2, 0)}));
+  EXPECT_FALSE(BatchInputBuffer::CanStage({}));
+  EXPECT_FALSE(BatchInputBuffer::CanStage({Rows(2, 0), Rows(3, 0)}));
+  EXPECT_FALSE(BatchInputBuffer::CanStage({test::AsScalar<float>(1)}));
+  EXPECT_FALSE(BatchInputBuffer::CanStage(
+      {test::AsTensor<tstring>({"a", "b"}, TensorShape({2}))}));
+}
+
+TEST(BatchInputBufferTest, CopiesTasksToConsecutiveRows) {
+  absl::StatusOr<std::shared_ptr<BatchInputBuffer>> buffer =
+      BatchInputBuffer::Create(cpu_allocator(), {Rows(1, 0)}, 8);
+  TF_ASSERT_OK(buffer.status());
+  EXPECT_EQ((*buffer)->num_rows(), 8);
+
+  const Tensor first = Rows(2, 0);
+  const Tensor second = Rows(3, 100);
+  ASSERT_TRUE((*buffer)->IsCompatible({first}));
+  ASSERT_EQ((*buffer)->Reserve(2), 0);
+  ASSERT_EQ((*buffer)->Reserve(3), 2);
+  (*buffer)->CopyFrom({second}, 2);
+  (*buffer)->CopyFrom({first}, 0);
+
+  std::optional<Tensor> slice = (*buffer)->Slice(0, 0, 2);
+  ASSERT_TRUE(slice.has_value());
+  test::ExpectTensorEqual<float>(*slice, first);
+  slice = (*buffer)->Slice(0, 2, 3);
+  ASSERT_TRUE(slice.has_value());
+  test::ExpectTensorEqual<float>(*slice, second);
+
+  // The slices alias the buffer.
+  std::optional<Tensor> batch = (*buffer)->Slice(0, 0, 5);
+  ASSERT_TRUE(batch.has_value());
+  EXPECT_TRUE(batch->SharesBufferWith(*slice));
+}
+
+TEST(BatchInputBufferTest, ReservesOnlyAvailableRows) {
+  absl::StatusOr<std::shared_ptr<BatchInputBuffer>> buffer =
+      BatchInputBuffer::Create(cpu_allocator(), {Rows(1, 0)}, 4);
+  TF_ASSERT_OK(buffer.status());
+
+  EXPECT_EQ((*buffer)->Reserve(3), 0);
+  EXPECT_EQ((*buffer)->Reserve(2), -1);
+  EXPECT_FALSE((*buffer)->ReserveAt(2, 1));
+  EXPECT_TRUE((*buffer)->ReserveAt(3, 1));
+  EXPECT_EQ((*buffer)->Reserve(1), -1);
+}
+
+TEST(BatchInputBufferTest, FillsPaddingFromRow) {
+  absl::StatusOr<std::shared_ptr<BatchInputBuffer>> buffer =
+      BatchInputBuffer::Create(cpu_allocator(), {Rows(1, 0)}, 4);
+  TF_ASSERT_OK(buffer.status());
+  const Tensor row = Rows(1, 7);
+  ASSERT_EQ((*buffer)->Reserve(1), 0);
+  (*buffer)->CopyFrom({row}, 0);
+  ASSERT_TRUE((*buffer)->ReserveAt(1, 3));
+  (*buffer)->FillFromRow(0, 1, 3);
+
+  for (int r = 0; r < 4; ++r) {
+    std::optional<Tensor> slice = (*buffer)->Slice(0, r, 1);
+    ASSERT_TRUE(slice.has_value());
+    test::ExpectTensorEqual<float>(*slice, row);
+  }
+}
+
+TEST(BatchInputBufferTest, IsCompatible) {
+  absl::StatusOr<std::shared_ptr<BatchInputBuffer>> buffer =
+      BatchInputBuffer::Create(cpu_allocator(), {Rows(1, 0)}, 4);
+  TF_ASSERT_OK(buffer.status());
+
+  EXPECT_TRUE((*buffer)->IsCompatible({Rows(3, 0)}));
+  EXPECT_FALSE((*buffer)->IsCompatible({Rows(3, 0), Rows(3, 0)}));
+  EXPECT_FALSE(
+      (*buffer)->IsCompatible({Tensor(DT_FLOAT, TensorShape({3, 8}))}));
+  EXPECT_FALSE(
+      (*buffer)->IsCompatible({Tensor(DT_INT32, TensorShape({3, 16}))}));
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -18,6 +18,7 @@ limitations under the License.
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <map>
@@ -28,6 +29,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/bind_front.h"
@@ -41,6 +43,7 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "xla/tsl/platform/criticality.h"
 #include "tensorflow/core/common_runtime/cost_constants.h"
 #include "tensorflow/core/common_runtime/cost_measurement.h"
@@ -56,6 +59,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
@@ -90,6 +94,11 @@ constexpr int64_t kCriticalCapacityFractionDenom = 4;
 constexpr int64_t kSheddablePlusCapacityFractionDenom = 8;
 constexpr int64_t kSheddableCapacityFractionDenom = 16;
 
+// The number of maximum-size batches an input buffer can hold. Larger buffers
+// are allocated less often, and make it less likely for a batch to straddle
+// two buffers, which forces a copy.
+constexpr int64_t kBatchesPerInputBuffer = 4;
+
 using ::tensorflow::concat_split_util::Concat;
 using ::tensorflow::concat_split_util::Split;
 using TensorMatrix = std::vector<std::vector<Tensor>>;
@@ -476,6 +485,67 @@ absl::Status ConcatSplitTaskOutput(TensorMatrix& split_task_output,
   return Concat(context, to_concatenate, output_tensor);
 }
 
+// Splits `tensor` along the 0th dimension into slices of `sizes` rows, which
+// alias the buffer of `tensor`. Returns false if any of the slices would not
+// be aligned, in which case `tensor` needs to be split by copying.
+bool SplitIntoAlignedSlices(const Tensor& tensor,
+                            absl::Span<const int64_t> sizes,
+                            std::vector<Tensor>* slices) {
+  std::vector<Tensor> result;
+  result.reserve(sizes.size());
+  int64_t start = 0;
+  for (const int64_t size : sizes) {
+    result.push_back(tensor.Slice(start, start + size));
+    if (!result.back().IsAligned()) return false;
+    start += size;
+  }
+  *slices = std::move(result);
+  return true;
+}
+
+// Copies `input` to `output`, which has the same shape except along dimension
+// 1, truncating each row or padding it with zeros to the length of `output`.
+absl::Status ResizeSequence(const Tensor& input, Tensor& output) {
+  if (!DataTypeCanUseMemcpy(input.dtype())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Sequence length bucketing doesn't support tensors of "
+                     "type ",
+                     DataTypeString(input.dtype())));
+  }
+  const int64_t num_rows = input.dim_size(0);
+  if (num_rows == 0) return absl::OkStatus();
+
+  // Each row is contiguous, so its padding is a suffix of it.
+  const int64_t row_bytes = input.TotalBytes() / num_rows;
+  const int64_t resized_row_bytes = output.TotalBytes() / num_rows;
+  const int64_t copied_bytes = std::min(row_bytes, resized_row_bytes);
+  const char* src = input.tensor_data().data();
+  char* dst = const_cast<char*>(output.tensor_data().data());
+  for (int64_t row = 0; row < num_rows; ++row) {
+    std::memcpy(dst, src, copied_bytes);
+    std::memset(dst + copied_bytes, 0, resized_row_bytes - copied_bytes);
+    src += row_bytes;
+    dst += resized_row_bytes;
+  }
+  return absl::OkStatus();
+}
+
+// Slices `output`, computed from inputs padded to a sequence length bucket,
+// back to `sequence_length` along dimension 1.
+absl::Status UnpadSequence(int64_t sequence_length, Tensor& output) {
+  if (output.dims() < 2 || output.dim_size(1) < sequence_length) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Sequence output of shape ", output.shape().DebugString(),
+        " can't be sliced to sequence length ", sequence_length));
+  }
+  TensorShape shape = output.shape();
+  shape.set_dim(1, sequence_length);
+  Tensor unpadded(output.dtype(), shape);
+  TF_RETURN_IF_ERROR(ResizeSequence(output, unpadded));
+  output = std::move(unpadded);
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 std::unique_ptr<BatchResourceBase::BatchTask>
@@ -495,6 +565,9 @@ BatchResourceBase::BatchTask::CreateSplitTask(
   task->is_partial = true;
   task->start_time = this->start_time;
   task->request_cost = this->request_cost;
+  task->input_buffer = this->input_buffer;
+  task->input_buffer_row = this->input_buffer_row;
+  task->unpadded_sequence_length = this->unpadded_sequence_length;
   task->forced_warmup_batch_size = this->forced_warmup_batch_size;
   task->rpc_deadline = this->rpc_deadline;
   task->is_rpc_cancelled = this->is_rpc_cancelled;
@@ -676,9 +749,15 @@ absl::Status BatchResourceBase::RegisterInput(
     batch_components->request_cost = request_cost_accessor->GetRequestCost();
   }
 
+  std::string queue_name = batcher_queue_name;
+  if (!sequence_length_buckets_.empty()) {
+    TF_RETURN_IF_ERROR(
+        BucketBySequenceLength(context, *batch_components, queue_name));
+  }
+
   BatcherQueueT* batcher_queue;
   TF_RETURN_IF_ERROR(LookupOrCreateBatcherQueue(
-      /* queue_name= */ batcher_queue_name,
+      /* queue_name= */ queue_name,
       /* model_name= */ GetModelName(context),
       /* op_name= */ context->op_kernel().name(), /* queue= */ &batcher_queue));
 
@@ -702,6 +781,10 @@ absl::Status BatchResourceBase::RegisterInput(
   const std::string model_name = GetModelName(context);
   const std::string op_name = context->op_kernel().name();
 
+  if (enable_zero_copy_batching_ && forced_warmup_batch_size == 0) {
+    TF_RETURN_IF_ERROR(StageInputs(queue_name, context, *batch_components));
+  }
+
   absl::Status schedule_status = batcher_queue->Schedule(&batch_components);
 
   // Export per-criticality queue utilization metrics for the priority aware
@@ -717,6 +800,108 @@ absl::Status BatchResourceBase::RegisterInput(
   return schedule_status;
 }
 
+absl::Status BatchResourceBase::BucketBySequenceLength(
+    OpKernelContext* context, BatchTask& task, std::string& queue_name) const {
+  std::optional<int64_t> sequence_length;
+  for (int32_t index : sequence_inputs_) {
+    if (index < 0 || index >= static_cast<int32_t>(task.inputs.size())) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Sequence input index ", index, " is out of range; ",
+                       task.inputs.size(), " batching inputs"));
+    }
+    const Tensor& input = task.inputs[index];
+    if (input.dims() < 2) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Sequence input ", index,
+                       " must have a sequence dimension; has shape ",
+                       input.shape().DebugString()));
+    }
+    if (!sequence_length.has_value()) {
+      sequence_length = input.dim_size(1);
+    } else if (input.dim_size(1) != *sequence_length) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Sequence inputs must have the same sequence length; input ", index,
+          " has shape ", input.shape().DebugString(), " but the length is ",
+          *sequence_length));
+    }
+  }
+  if (!sequence_length.has_value()) return absl::OkStatus();
+
+  auto bucket = absl::c_lower_bound(sequence_length_buckets_, *sequence_length);
+  if (bucket == sequence_length_buckets_.end()) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Sequence length ", *sequence_length,
+        " exceeds the largest sequence length bucket, ",
+        sequence_length_buckets_.back()));
+  }
+  if (*bucket != *sequence_length) {
+    for (int32_t index : sequence_inputs_) {
+      Tensor& input = task.inputs[index];
+      TensorShape shape = input.shape();
+      shape.set_dim(1, *bucket);
+      Tensor padded;
+      TF_RETURN_IF_ERROR(context->allocate_temp(input.dtype(), shape, &padded));
+      TF_RETURN_IF_ERROR(ResizeSequence(input, padded));
+      input = std::move(padded);
+    }
+    task.unpadded_sequence_length = *sequence_length;
+  }
+  absl::StrAppend(&queue_name, "/sequence_length_", *bucket);
+  return absl::OkStatus();
+}
+
+absl::Status BatchResourceBase::StageInputs(const std::string& queue_name,
+                                            OpKernelContext* context,
+                                            BatchTask& task) {
+  if (!BatchInputBuffer::CanStage(task.inputs)) {
+    return absl::OkStatus();
+  }
+  const int64_t num_rows = task.size();
+  const int64_t max_batch_size =
+      batcher_ ? batcher_queue_options_.max_execution_batch_size
+               : adaptive_batcher_queue_options_.max_batch_size;
+
+  std::shared_ptr<BatchInputBuffer> buffer;
+  int64_t row = -1;
+  {
+    mutex_lock l(input_buffers_mu_);
+    std::shared_ptr<BatchInputBuffer>& current = input_buffers_[queue_name];
+    if (current != nullptr && current->IsCompatible(task.inputs)) {
+      row = current->Reserve(num_rows);
+    }
+    if (row < 0) {
+      TF_ASSIGN_OR_RETURN(
+          current, BatchInputBuffer::Create(
+                       context->get_allocator(AllocatorAttributes()),
+                       task.inputs,
+                       std::max(num_rows,
+                                kBatchesPerInputBuffer * max_batch_size)));
+      row = current->Reserve(num_rows);
+    }
+    buffer = current;
+  }
+  // The reserved rows belong to this task, so concurrent tasks copy their
+  // inputs in parallel, outside of the lock.
+  buffer->CopyFrom(task.inputs, row);
+  // The task refers to its staged rows from now on, so that its original
+  // inputs can be released and batches that are concatenated anyway copy from
+  // the buffer. Unaligned rows can't be passed to kernels, in which case the
+  // original inputs are kept.
+  std::vector<Tensor> staged_inputs;
+  staged_inputs.reserve(task.inputs.size());
+  for (int i = 0; i < task.inputs.size(); ++i) {
+    std::optional<Tensor> slice = buffer->Slice(i, row, num_rows);
+    if (!slice.has_value()) break;
+    staged_inputs.push_back(*std::move(slice));
+  }
+  if (staged_inputs.size() == task.inputs.size()) {
+    task.inputs = std::move(staged_inputs);
+  }
+  task.input_buffer = std::move(buffer);
+  task.input_buffer_row = row;
+  return absl::OkStatus();
+}
+
 /*static*/ BatchResourceBase::BatcherT::QueueOptions
 BatchResourceBase::GetBatcherQueueOptions(
     int32_t num_batch_threads, int32_t max_batch_size,
@@ -754,13 +939,18 @@ BatchResourceBase::GetBatcherQueueOptions(
     bool enable_priority_aware_batch_scheduler,
     bool enable_priority_aware_batch_scheduler_resplit,
     bool enable_batching_task_lazy_cancellation,
-    const std::vector<int64_t>& per_criticality_batch_timeout_micros) {
+    const std::vector<int64_t>& per_criticality_batch_timeout_micros,
+    int64_t latency_slo_micros, double fair_share_weight,
+    int64_t max_queueing_delay_micros) {
   BatcherT::QueueOptions batcher_queue_options;
   batcher_queue_options.input_batch_size_limit = max_batch_size;
   batcher_queue_options.max_enqueued_batches = max_enqueued_batches;
   batcher_queue_options.batch_timeout_micros = batch_timeout_micros;
   batcher_queue_options.batch_padding_policy =
       std::string(batch_padding_policy);
+  batcher_queue_options.latency_slo_micros = latency_slo_micros;
+  batcher_queue_options.fair_share_weight = fair_share_weight;
+  batcher_queue_options.max_queueing_delay_micros = max_queueing_delay_micros;
   if (low_priority_max_batch_size > 0) {
     batcher_queue_options.enable_priority_queue = true;
   }
@@ -775,6 +965,10 @@ BatchResourceBase::GetBatcherQueueOptions(
             << ", "
             << "disable_padding=" << disable_padding << ", "
             << "batch_padding_policy=" << batch_padding_policy << ", "
+            << "latency_slo_micros=" << latency_slo_micros << ", "
+            << "fair_share_weight=" << fair_share_weight << ", "
+            << "max_queueing_delay_micros=" << max_queueing_delay_micros
+            << ", "
             << "low_priority_max_batch_size=" << low_priority_max_batch_size
             << ", "
             << "low_priority_batch_timeout_micros="
@@ -986,6 +1180,12 @@ absl::Status BatchResourceBase::ConcatInputTensors(
   RecordBatchSize(batch.size(), GetModelName(context),
                   context->op_kernel().name());
 
+  if (enable_zero_copy_batching_ && !just_for_warmup &&
+      SliceStagedInputTensors(batch, unbatched_tasks, padding_amount,
+                              concatenated_tensors)) {
+    return absl::OkStatus();
+  }
+
   // All tasks should have the same number of input edges.
   const int num_inputs = batch.task(0).inputs.size();
   concatenated_tensors->reserve(num_inputs);
@@ -1039,6 +1239,55 @@ absl::Status BatchResourceBase::ConcatInputTensors(
   return absl::OkStatus();
 }
 
+bool BatchResourceBase::SliceStagedInputTensors(
+    const BatchT& batch,
+    const std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks,
+    int padding_amount, std::vector<Tensor>* concatenated_tensors) const {
+  const BatchTask& first_task = batch.task(0);
+  BatchInputBuffer* buffer = first_task.input_buffer.get();
+  if (buffer == nullptr) {
+    return false;
+  }
+  const int64_t first_row = first_task.input_buffer_row;
+  int64_t next_row = first_row;
+  auto occupies_next_rows = [buffer, &next_row](const BatchTask& task) {
+    if (task.input_buffer.get() != buffer ||
+        task.input_buffer_row != next_row) {
+      return false;
+    }
+    next_row += task.size();
+    return true;
+  };
+  for (int i = 0; i < batch.num_tasks(); ++i) {
+    if (!occupies_next_rows(batch.task(i))) return false;
+  }
+  for (const std::unique_ptr<BatchTask>& task : unbatched_tasks) {
+    if (!occupies_next_rows(*task)) return false;
+  }
+  if (next_row + padding_amount > buffer->num_rows()) {
+    return false;
+  }
+
+  const int num_inputs = first_task.inputs.size();
+  std::vector<Tensor> slices;
+  slices.reserve(num_inputs);
+  for (int i = 0; i < num_inputs; ++i) {
+    std::optional<Tensor> slice =
+        buffer->Slice(i, first_row, next_row - first_row + padding_amount);
+    if (!slice.has_value()) return false;
+    slices.push_back(*std::move(slice));
+  }
+  // Padding can only be added in place if no other task has reserved the rows
+  // following the batch yet. As with concatenation, the first row of the batch
+  // is used as the data for padding.
+  if (padding_amount > 0) {
+    if (!buffer->ReserveAt(next_row, padding_amount)) return false;
+    buffer->FillFromRow(first_row, next_row, padding_amount);
+  }
+  *concatenated_tensors = std::move(slices);
+  return true;
+}
+
 /*static*/ absl::Status BatchResourceBase::SplitInputTask(
     std::unique_ptr<BatchTask>* input_task_ptr, int open_batch_remaining_slot,
     int max_batch_size, std::vector<std::unique_ptr<BatchTask>>* output_tasks) {
@@ -1125,6 +1374,13 @@ absl::Status BatchResourceBase::ConcatInputTensors(
     subtask->output = split_task_output;
     output_tasks->push_back(std::move(subtask));
   }
+  if (input_task->input_buffer != nullptr) {
+    int64_t row = input_task->input_buffer_row;
+    for (int i = 0; i < num_batches; ++i) {
+      (*output_tasks)[i]->input_buffer_row = row;
+      row += task_sizes[i];
+    }
+  }
 
   const int num_input_tensors = input_task->inputs.size();
   std::vector<int64_t> output_task_sizes(task_sizes.begin(), task_sizes.end());
@@ -1134,15 +1390,22 @@ absl::Status BatchResourceBase::ConcatInputTensors(
   for (int i = 0; i < num_input_tensors; ++i) {
     std::vector<Tensor> split_tensors;
     const Tensor& input_tensor = input_task->inputs[i];
+    // Tasks with staged inputs are in zero-copy mode, in which the subtasks
+    // alias the input as long as the slices are aligned.
     // TODO(b/154140947):
     // Figure out the optimal implementation of Split, by using
     // 'Tensor::Slice' and eliminating unnecessary memcpy as much as possible.
-    const absl::Status split_status = Split(input_task->context, input_tensor,
-                                            output_task_sizes, &split_tensors);
-    if (!split_status.ok()) {
-      return absl::InternalError(
-          absl::StrCat("When splitting input, Tensor split operation failed: ",
-                       split_status.message()));
+    if (input_task->input_buffer == nullptr ||
+        !SplitIntoAlignedSlices(input_tensor, output_task_sizes,
+                                &split_tensors)) {
+      const absl::Status split_status =
+          Split(input_task->context, input_tensor, output_task_sizes,
+                &split_tensors);
+      if (!split_status.ok()) {
+        return absl::InternalError(absl::StrCat(
+            "When splitting input, Tensor split operation failed: ",
+            split_status.message()));
+      }
     }
     if (split_tensors.size() != output_task_sizes.size()) {
       return absl::InternalError(absl::StrCat(
@@ -1218,12 +1481,16 @@ absl::Status BatchResourceBase::SplitOutputTensors(
     }
 
     std::vector<Tensor> split_tensor;
-    const absl::Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
-    DCHECK(split_status.ok()) << split_status;
-    if (!split_status.ok()) {
-      return absl::InternalError(absl::StrCat("Tensor split operation failed: ",
-                                              split_status.message()));
+    if (!enable_zero_copy_batching_ ||
+        !SplitIntoAlignedSlices(output_tensor, task_sizes_plus_optional_padding,
+                                &split_tensor)) {
+      const absl::Status split_status = tensor::Split(
+          output_tensor, task_sizes_plus_optional_padding, &split_tensor);
+      DCHECK(split_status.ok()) << split_status;
+      if (!split_status.ok()) {
+        return absl::InternalError(absl::StrCat(
+            "Tensor split operation failed: ", split_status.message()));
+      }
     }
     DCHECK_EQ(split_tensor.size(), task_sizes_plus_optional_padding.size());
     if (split_tensor.size() != task_sizes_plus_optional_padding.size()) {
@@ -1234,8 +1501,13 @@ absl::Status BatchResourceBase::SplitOutputTensors(
     }
 
     // Ignore a possible final split_tensors entry containing the padding.
+    const bool is_sequence_output = absl::c_linear_search(sequence_outputs_, i);
     for (int j = 0; j < batch->num_tasks(); ++j) {
       BatchTask& task = *(batch->mutable_task(j));
+      if (is_sequence_output && task.unpadded_sequence_length.has_value()) {
+        TF_RETURN_IF_ERROR(
+            UnpadSequence(*task.unpadded_sequence_length, split_tensor[j]));
+      }
       if (task.is_partial) {
         std::vector<Tensor>& tensor_vector = (*task.output)[task.split_index];
         tensor_vector[i] = std::move(split_tensor[j]);
@@ -1244,6 +1516,12 @@ absl::Status BatchResourceBase::SplitOutputTensors(
       }
     }
     for (int j = 0; j < unbatched_tasks.size(); ++j) {
+      if (is_sequence_output &&
+          unbatched_tasks[j]->unpadded_sequence_length.has_value()) {
+        TF_RETURN_IF_ERROR(
+            UnpadSequence(*unbatched_tasks[j]->unpadded_sequence_length,
+                          split_tensor[batch->num_tasks() + j]));
+      }
       // The unbatched tasks are not split, so no need to handle the partial
       // case separately.
       unbatched_tasks[j]->context->set_output(
@@ -1350,6 +1628,7 @@ void BatchResourceBase::ProcessFuncBatch(
   // Releases the cleanup method here, because the callback of the function
   // library runtime will handle it now.
   finally.release();
+  const absl::Time processing_start_time = absl::Now();
   ProcessFuncBatchImpl(last_task, args, &combined_outputs,
                        [&](const absl::Status& run_status) {
                          absl::Status final_status;
@@ -1367,6 +1646,13 @@ void BatchResourceBase::ProcessFuncBatch(
                            return;
                          }
                          if (last_task.forced_warmup_batch_size == 0) {
+                           // Warmup batches are left out, as they include
+                           // one-off initialization costs.
+                           GlobalBatchStatsRegistry()
+                               .model(model_name, op_name)
+                               .batch_size(processed_size)
+                               .processing_time()
+                               .Register(absl::Now() - processing_start_time);
                            final_status = SplitOutputTensors(
                                combined_outputs, batch.get(), unbatched_tasks);
                          }
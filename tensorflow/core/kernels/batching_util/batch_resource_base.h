@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -25,6 +26,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/blocking_counter.h"
@@ -37,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/batching_util/adaptive_shared_batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
@@ -123,6 +126,16 @@ class BatchResourceBase : public ResourceBase {
 
     bool is_partial = false;
 
+    // If zero-copy batching is enabled, the buffer `inputs` were copied to when
+    // the task was enqueued, and the first row they occupy in it. Tasks that
+    // occupy consecutive rows of one buffer are batched without a copy.
+    std::shared_ptr<BatchInputBuffer> input_buffer;
+    int64_t input_buffer_row = 0;
+
+    // If the inputs were padded to a sequence length bucket, the sequence
+    // length they had before. See set_sequence_length_bucketing().
+    std::optional<int64_t> unpadded_sequence_length;
+
     uint64 start_time;
 
     // Absolute RPC deadline. When set, the task is considered expired if
@@ -248,6 +261,40 @@ class BatchResourceBase : public ResourceBase {
 
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
+  // If enabled, each task copies its inputs into a buffer shared by the tasks
+  // of its queue when it is enqueued, and a batch of tasks occupying
+  // consecutive rows of the buffer is a slice of it, rather than being
+  // concatenated on the batch thread. Likewise, the outputs of each task are
+  // slices of the batched outputs rather than copies, which keeps the batched
+  // outputs alive until the outputs of all its tasks are released. Batches
+  // fall back to copying when slicing is not possible, e.g. when the tasks
+  // are not consecutive or the slices are not aligned.
+  //
+  // Must be called before any input is registered.
+  void set_enable_zero_copy_batching(bool enable_zero_copy_batching) {
+    enable_zero_copy_batching_ = enable_zero_copy_batching;
+  }
+
+  // If `buckets` is non-empty, tasks are bucketed by sequence length to bound
+  // the padding of variable-length sequences. The sequence length of a task is
+  // dimension 1 of its inputs at `sequence_inputs`, which must all have it.
+  // Those inputs are padded with zeros to the smallest of `buckets` that fits
+  // them, and the task is only batched with tasks of the same bucket, in a
+  // queue of their own. Its outputs at `sequence_outputs` are sliced back to
+  // the sequence length of the task along dimension 1. Tasks longer than the
+  // largest bucket are rejected.
+  //
+  // Must be called before any input is registered.
+  void set_sequence_length_bucketing(std::vector<int64_t> buckets,
+                                     std::vector<int32_t> sequence_inputs,
+                                     std::vector<int32_t> sequence_outputs) {
+    absl::c_sort(buckets);
+    buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+    sequence_length_buckets_ = std::move(buckets);
+    sequence_inputs_ = std::move(sequence_inputs);
+    sequence_outputs_ = std::move(sequence_outputs);
+  }
+
   using CreateBatchTaskFn =
       std::function<StatusOr<std::unique_ptr<BatchTask>>()>;
 
@@ -287,7 +334,9 @@ class BatchResourceBase : public ResourceBase {
       bool enable_priority_aware_batch_scheduler,
       bool enable_priority_aware_batch_scheduler_resplit,
       bool enable_batching_task_lazy_cancellation,
-      const std::vector<int64_t>& per_criticality_batch_timeout_micros);
+      const std::vector<int64_t>& per_criticality_batch_timeout_micros,
+      int64_t latency_slo_micros = 0, double fair_share_weight = 1.0,
+      int64_t max_queueing_delay_micros = 0);
 
   static AdaptiveBatcherT::QueueOptions GetAdaptiveBatcherQueueOptions(
       int32_t max_batch_size, int32_t batch_timeout_micros,
@@ -382,6 +431,27 @@ class BatchResourceBase : public ResourceBase {
       OpKernelContext* context,
       std::vector<Tensor>* concatenated_tensors) const;
 
+  // Pads the inputs of 'task' to their sequence length bucket, and appends the
+  // bucket to 'queue_name'. See set_sequence_length_bucketing().
+  Status BucketBySequenceLength(OpKernelContext* context, BatchTask& task,
+                                string& queue_name) const;
+
+  // Copies the inputs of 'task' into the input buffer of the queue named
+  // 'queue_name', allocating a new buffer if it is full or the inputs have
+  // different shapes, and replaces them with slices of the buffer. Inputs that
+  // can't be copied with memcpy are not staged.
+  Status StageInputs(const string& queue_name, OpKernelContext* context,
+                     BatchTask& task);
+
+  // If the tasks of the batch and 'unbatched_tasks' occupy consecutive rows of
+  // one input buffer and 'padding_amount' rows can be reserved right after
+  // them, sets 'concatenated_tensors' to slices of the buffer and returns
+  // true. Returns false otherwise, and the inputs need to be concatenated.
+  bool SliceStagedInputTensors(
+      const BatchT& batch,
+      const std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks,
+      int padding_amount, std::vector<Tensor>* concatenated_tensors) const;
+
   Status SplitOutputTensors(
       const std::vector<Tensor>& combined_outputs, BatchT* batch,
       std::vector<std::unique_ptr<BatchTask>>& unbatched_tasks) const;
@@ -446,6 +516,20 @@ class BatchResourceBase : public ResourceBase {
   std::map<string, std::unique_ptr<BatcherQueueT>> batcher_queues_
       TF_GUARDED_BY(batcher_queues_mu_);
 
+  // See set_enable_zero_copy_batching().
+  bool enable_zero_copy_batching_ = false;
+
+  // See set_sequence_length_bucketing().
+  std::vector<int64_t> sequence_length_buckets_;
+  std::vector<int32_t> sequence_inputs_;
+  std::vector<int32_t> sequence_outputs_;
+
+  // The buffer new tasks of each queue copy their inputs to, keyed on queue
+  // name.
+  mutable mutex input_buffers_mu_;
+  std::map<string, std::shared_ptr<BatchInputBuffer>> input_buffers_
+      TF_GUARDED_BY(input_buffers_mu_);
+
   std::vector<int32> allowed_batch_sizes_;
   // A concatenated string of <allowed_batch_sizes_>, separated by ",". This is
   // used to record batching parameter.
@@ -33,6 +33,7 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -52,6 +53,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
@@ -1681,6 +1683,206 @@ TEST_F(BatchResourceBaseTest, ConfiguredBatchPaddingPolicyMetric) {
   my_batch_resource->Unref();
 }
 
+TEST_F(BatchResourceBaseTest, ZeroCopyBatchingAliasesBatchedTensors) {
+  using BatchTask = BatchResourceBase::BatchTask;
+
+  // Returns the batched first input as the only output, and keeps the input
+  // of the last task.
+  class EchoBatchResource : public BatchResourceBase {
+   public:
+    using BatchResourceBase::BatchResourceBase;
+
+    std::string DebugString() const override { return "EchoBatchResource"; }
+
+    Tensor last_task_input() const {
+      absl::MutexLock lock(mu_);
+      return last_task_input_;
+    }
+
+   protected:
+    void ProcessFuncBatchImpl(
+        const BatchTask& last_task, absl::Span<const Tensor> inputs,
+        std::vector<Tensor>* combined_outputs,
+        std::function<void(const absl::Status&)> done) const override {
+      {
+        absl::MutexLock lock(mu_);
+        last_task_input_ = last_task.inputs[0];
+      }
+      combined_outputs->push_back(inputs[0]);
+      done(absl::OkStatus());
+    }
+
+   private:
+    mutable absl::Mutex mu_;
+    mutable Tensor last_task_input_ ABSL_GUARDED_BY(mu_);
+  };
+
+  std::shared_ptr<SharedBatchScheduler<BatchTask>> batcher;
+  TF_ASSERT_OK(SharedBatchScheduler<BatchTask>::Create({}, &batcher));
+  // Two tasks of two rows fill a batch, so it is processed right away.
+  tsl::core::RefCountPtr<EchoBatchResource> batch_resource(
+      new EchoBatchResource(
+          /*has_process_batch_function=*/true, batcher,
+          BatchResourceBase::GetBatcherQueueOptions(
+              /*num_batch_threads=*/1, /*max_batch_size=*/4,
+              /*batch_timeout_micros=*/10'000'000,
+              /*max_enqueued_batches=*/10, /*allowed_batch_sizes=*/{},
+              /*enable_large_batch_splitting=*/false,
+              /*disable_padding=*/false),
+          /*allowed_batch_sizes=*/{}));
+  batch_resource->set_enable_zero_copy_batching(true);
+
+  // Rows of 8 int64 values keep the slices aligned.
+  std::vector<Tensor> inputs = {
+      test::AsTensor<int64_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                               14, 15},
+                              TensorShape({2, 8})),
+      test::AsTensor<int64_t>({16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27,
+                               28, 29, 30, 31},
+                              TensorShape({2, 8}))};
+  std::vector<std::vector<TensorValue>> input_values;
+  std::vector<std::unique_ptr<OpKernelContext::Params>> params;
+  std::vector<std::unique_ptr<OpKernelContext>> contexts;
+  for (Tensor& input : inputs) {
+    input_values.push_back(
+        {TensorValue(&input), TensorValue(&input), TensorValue(&input)});
+    params.push_back(std::make_unique<OpKernelContext::Params>());
+    params.back()->device = device_.get();
+    params.back()->op_kernel = batch_kernel_.get();
+    params.back()->inputs = input_values.back();
+    params.back()->session_metadata = &session_metadata_;
+    contexts.push_back(std::make_unique<OpKernelContext>(params.back().get()));
+  }
+
+  absl::BlockingCounter done(inputs.size());
+  for (int i = 0; i < contexts.size(); ++i) {
+    TF_ASSERT_OK(batch_resource->RegisterInput(
+        /*guid=*/i, contexts[i].get(), "queue",
+        []() -> absl::StatusOr<std::unique_ptr<BatchTask>> {
+          return std::make_unique<BatchTask>();
+        },
+        [&done]() { done.DecrementCount(); }));
+  }
+  done.Wait();
+
+  for (int i = 0; i < contexts.size(); ++i) {
+    TF_ASSERT_OK(contexts[i]->status());
+    test::ExpectTensorEqual<int64_t>(*contexts[i]->mutable_output(0),
+                                     inputs[i]);
+    // The batch was staged in the input buffer, so the outputs are slices of
+    // the buffer rather than of the inputs.
+    EXPECT_FALSE(contexts[i]->mutable_output(0)->SharesBufferWith(inputs[i]));
+  }
+  EXPECT_TRUE(contexts[0]->mutable_output(0)->SharesBufferWith(
+      *contexts[1]->mutable_output(0)));
+  // The tasks refer to their staged rows instead of their original inputs.
+  const Tensor last_task_input = batch_resource->last_task_input();
+  EXPECT_FALSE(last_task_input.SharesBufferWith(inputs[1]));
+  EXPECT_TRUE(
+      last_task_input.SharesBufferWith(*contexts[1]->mutable_output(0)));
+}
+
+TEST_F(BatchResourceBaseTest, SequenceLengthBucketing) {
+  using BatchTask = BatchResourceBase::BatchTask;
+
+  // Records the shapes of the batches it echoes back.
+  class EchoBatchResource : public BatchResourceBase {
+   public:
+    using BatchResourceBase::BatchResourceBase;
+
+    std::string DebugString() const override { return "EchoBatchResource"; }
+
+    std::vector<TensorShape> batch_shapes() const {
+      absl::MutexLock lock(mu_);
+      return batch_shapes_;
+    }
+
+   protected:
+    void ProcessFuncBatchImpl(
+        const BatchTask& /* last_task */, absl::Span<const Tensor> inputs,
+        std::vector<Tensor>* combined_outputs,
+        std::function<void(const absl::Status&)> done) const override {
+      {
+        absl::MutexLock lock(mu_);
+        batch_shapes_.push_back(inputs[0].shape());
+      }
+      combined_outputs->push_back(inputs[0]);
+      done(absl::OkStatus());
+    }
+
+   private:
+    mutable absl::Mutex mu_;
+    mutable std::vector<TensorShape> batch_shapes_ ABSL_GUARDED_BY(mu_);
+  };
+
+  std::shared_ptr<SharedBatchScheduler<BatchTask>> batcher;
+  TF_ASSERT_OK(SharedBatchScheduler<BatchTask>::Create({}, &batcher));
+  tsl::core::RefCountPtr<EchoBatchResource> batch_resource(
+      new EchoBatchResource(
+          /*has_process_batch_function=*/true, batcher,
+          BatchResourceBase::GetBatcherQueueOptions(
+              /*num_batch_threads=*/1, /*max_batch_size=*/2,
+              /*batch_timeout_micros=*/1000,
+              /*max_enqueued_batches=*/10, /*allowed_batch_sizes=*/{},
+              /*enable_large_batch_splitting=*/false,
+              /*disable_padding=*/false),
+          /*allowed_batch_sizes=*/{}));
+  batch_resource->set_sequence_length_bucketing(
+      /*buckets=*/{8, 4}, /*sequence_inputs=*/{0}, /*sequence_outputs=*/{0});
+
+  // The first two tasks share the bucket of length 4. The last one is longer
+  // than the largest bucket.
+  std::vector<Tensor> inputs = {
+      test::AsTensor<int32_t>({1, 2, 3}, TensorShape({1, 3})),
+      test::AsTensor<int32_t>({4, 5, 6, 7}, TensorShape({1, 4})),
+      test::AsTensor<int32_t>({8, 9, 10, 11, 12}, TensorShape({1, 5})),
+      test::AsTensor<int32_t>({1, 2, 3, 4, 5, 6, 7, 8, 9},
+                              TensorShape({1, 9}))};
+  std::vector<std::vector<TensorValue>> input_values;
+  std::vector<std::unique_ptr<OpKernelContext::Params>> params;
+  std::vector<std::unique_ptr<OpKernelContext>> contexts;
+  for (Tensor& input : inputs) {
+    input_values.push_back(
+        {TensorValue(&input), TensorValue(&input), TensorValue(&input)});
+    params.push_back(std::make_unique<OpKernelContext::Params>());
+    params.back()->device = device_.get();
+    params.back()->op_kernel = batch_kernel_.get();
+    params.back()->inputs = input_values.back();
+    params.back()->session_metadata = &session_metadata_;
+    contexts.push_back(std::make_unique<OpKernelContext>(params.back().get()));
+  }
+
+  absl::BlockingCounter done(3);
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(batch_resource->RegisterInput(
+        /*guid=*/i, contexts[i].get(), "queue",
+        []() -> absl::StatusOr<std::unique_ptr<BatchTask>> {
+          return std::make_unique<BatchTask>();
+        },
+        [&done]() { done.DecrementCount(); }));
+  }
+  const absl::Status too_long_status = batch_resource->RegisterInput(
+      /*guid=*/3, contexts[3].get(), "queue",
+      []() -> absl::StatusOr<std::unique_ptr<BatchTask>> {
+        return std::make_unique<BatchTask>();
+      },
+      []() {});
+  EXPECT_EQ(too_long_status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(too_long_status.message(),
+              ::testing::HasSubstr("exceeds the largest sequence length"));
+  done.Wait();
+
+  // The outputs are sliced back to the sequence length of their inputs.
+  for (int i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(contexts[i]->status());
+    test::ExpectTensorEqual<int32_t>(*contexts[i]->mutable_output(0),
+                                     inputs[i]);
+  }
+  EXPECT_THAT(batch_resource->batch_shapes(),
+              ::testing::UnorderedElementsAre(TensorShape({2, 4}),
+                                              TensorShape({1, 8})));
+}
+
 struct MaxExecutionBatchSizeTestParams {
   std::string test_name;
   bool enable_large_batch_splitting;
@@ -75,20 +75,83 @@ int32_t GetPrevAllowedBatchSize(int batch_size,
   return *result;
 }
 
+namespace {
+
+// Chooses between padding `candidate_size` tasks up to `pad_up_size` and
+// batching down to `batch_down_size` under the LATENCY_SLO policy.
+int ApplyLatencySloPolicy(int candidate_size, int pad_up_size,
+                          int batch_down_size,
+                          const std::vector<int32_t>& allowed_batch_sizes,
+                          bool disable_padding,
+                          ModelBatchStats& model_batch_stats,
+                          int64_t latency_slo_micros,
+                          int64_t batch_age_micros) {
+  std::optional<absl::Duration> pad_up_time =
+      EstimateBatchProcessingTime(model_batch_stats, pad_up_size);
+  std::optional<absl::Duration> batch_down_time =
+      EstimateBatchProcessingTime(model_batch_stats, batch_down_size);
+  if (!pad_up_time.has_value() || !batch_down_time.has_value()) {
+    // Nothing has been learned yet.
+    return candidate_size;
+  }
+  // How long the oldest task of the batch can still wait for its outputs.
+  const absl::Duration slack =
+      absl::Microseconds(latency_slo_micros - batch_age_micros);
+
+  if (*pad_up_time > slack) {
+    // Padding up misses the SLO for every task in the batch. Batching down
+    // still meets it for the tasks that stay in the batch, if it is enough
+    // faster; otherwise, process everything as soon as possible.
+    return *batch_down_time <= slack ? batch_down_size : candidate_size;
+  }
+
+  // Both sizes meet the SLO. Batch down only if it processes requests more
+  // cheaply and the trimmed tasks still meet the SLO in the next batch, even
+  // if that one has to wait for this one to finish.
+  if (*batch_down_time / batch_down_size >= *pad_up_time / candidate_size) {
+    return candidate_size;
+  }
+  std::optional<absl::Duration> remainder_time = EstimateBatchProcessingTime(
+      model_batch_stats,
+      GetNextAllowedBatchSize(candidate_size - batch_down_size,
+                              allowed_batch_sizes, disable_padding));
+  if (!remainder_time.has_value() ||
+      *batch_down_time + *remainder_time > slack) {
+    return candidate_size;
+  }
+  return batch_down_size;
+}
+
+}  // namespace
+
 int ApplyBatchPaddingPolicy(int candidate_size,
                             const std::vector<int32_t>& allowed_batch_sizes,
                             bool disable_padding,
                             absl::string_view batch_padding_policy,
-                            ModelBatchStats* model_batch_stats) {
+                            ModelBatchStats* model_batch_stats,
+                            int64_t latency_slo_micros,
+                            int64_t batch_age_micros) {
   if (candidate_size == 0) {
     return candidate_size;
   }
   if (batch_padding_policy == kPadUpPolicy) {
     return candidate_size;
   }
-  bool minimize_tpu_cost_per_request;
+  bool minimize_tpu_cost_per_request = false;
+  bool meet_latency_slo = false;
   if (batch_padding_policy == kBatchDownPolicy) {
     minimize_tpu_cost_per_request = false;
+  } else if (batch_padding_policy == kLatencySloPolicy) {
+    if (model_batch_stats == nullptr || latency_slo_micros <= 0) {
+      LOG_FIRST_N(ERROR, 1)
+          << kLatencySloPolicy
+          << " batch padding policy has been chosen but no ModelBatchStats "
+             "or no positive latency SLO passed to the batch scheduler; will "
+             "fall back on the "
+          << kPadUpPolicy << " policy.";
+      return candidate_size;
+    }
+    meet_latency_slo = true;
   } else if (batch_padding_policy == kMinimizeTpuCostPerRequestPolicy) {
     if (model_batch_stats == nullptr) {
       LOG_FIRST_N(ERROR, 1)
@@ -120,6 +183,13 @@ int ApplyBatchPaddingPolicy(int candidate_size,
                             // available).
   }
 
+  if (meet_latency_slo) {
+    return ApplyLatencySloPolicy(candidate_size, pad_up_size, batch_down_size,
+                                 allowed_batch_sizes, disable_padding,
+                                 *model_batch_stats, latency_slo_micros,
+                                 batch_age_micros);
+  }
+
   if (minimize_tpu_cost_per_request) {
     // TODO: b/325954758 - Consider logging a warning here or elsewhere if
     // a larger batch doesn't cost meaningfully cheaper than a smaller batch.
@@ -156,6 +226,53 @@ int ApplyBatchPaddingPolicy(int candidate_size,
   return batch_down_size;
 }
 
+std::optional<absl::Duration> EstimateBatchProcessingTime(
+    ModelBatchStats& model_batch_stats, int batch_size) {
+  // The closest batch sizes with an estimate below and above `batch_size`.
+  int32_t lower_size = 0;
+  absl::Duration lower_time;
+  int32_t upper_size = 0;
+  absl::Duration upper_time;
+  for (int32_t size : model_batch_stats.BatchSizes()) {
+    std::optional<absl::Duration> time =
+        model_batch_stats.batch_size(size).processing_time().p99();
+    if (!time.has_value()) continue;
+    if (size == batch_size) return time;
+    if (size < batch_size && size > lower_size) {
+      lower_size = size;
+      lower_time = *time;
+    } else if (size > batch_size && (upper_size == 0 || size < upper_size)) {
+      upper_size = size;
+      upper_time = *time;
+    }
+  }
+
+  if (lower_size == 0 && upper_size == 0) return std::nullopt;
+  if (upper_size == 0) return lower_time * batch_size / lower_size;
+  if (lower_size == 0) return upper_time;
+  return lower_time + (upper_time - lower_time) * (batch_size - lower_size) /
+                          (upper_size - lower_size);
+}
+
+int64_t GetLatencySloBatchTimeoutMicros(
+    int batch_size, const std::vector<int32_t>& allowed_batch_sizes,
+    bool disable_padding, int64_t latency_slo_micros,
+    int64_t batch_timeout_micros, ModelBatchStats* model_batch_stats) {
+  if (model_batch_stats == nullptr || latency_slo_micros <= 0 ||
+      batch_size <= 0) {
+    return batch_timeout_micros;
+  }
+  std::optional<absl::Duration> processing_time = EstimateBatchProcessingTime(
+      *model_batch_stats,
+      GetNextAllowedBatchSize(batch_size, allowed_batch_sizes,
+                              disable_padding));
+  if (!processing_time.has_value()) {
+    return batch_timeout_micros;
+  }
+  return std::max<int64_t>(
+      0, latency_slo_micros - absl::ToInt64Microseconds(*processing_time));
+}
+
 namespace internal {
 
 void RecordLazyCancelledTaskMetrics(int64_t size, absl::string_view reason) {
@@ -46,11 +46,38 @@ int GetPrevAllowedBatchSize(int batch_size,
 
 // Applies the batch padding policy to the candidate size and returns the target
 // size depending on the policy.
+//
+// `latency_slo_micros` and `batch_age_micros` (the time since the first task of
+// the batch was enqueued) are only used by the LATENCY_SLO policy.
 int ApplyBatchPaddingPolicy(int candidate_size,
                             const std::vector<int32_t>& allowed_batch_sizes,
                             bool disable_padding,
                             absl::string_view batch_padding_policy,
-                            ModelBatchStats* model_batch_stats);
+                            ModelBatchStats* model_batch_stats,
+                            int64_t latency_slo_micros = 0,
+                            int64_t batch_age_micros = 0);
+
+// Returns the estimated p99 wall time it takes to process a batch of
+// `batch_size`, learned from the processing times registered in
+// `model_batch_stats`. Batch sizes without enough samples are estimated by
+// linear interpolation between the closest batch sizes with enough samples.
+// Beyond the largest of those, the processing time is assumed to grow in
+// proportion to the batch size; below the smallest, it is assumed not to
+// shrink.
+//
+// Returns std::nullopt if no batch size has enough samples.
+std::optional<absl::Duration> EstimateBatchProcessingTime(
+    ModelBatchStats& model_batch_stats, int batch_size);
+
+// Returns how long a batch of `batch_size` tasks may stay open, counting from
+// the enqueue time of its first task, under the LATENCY_SLO policy: the
+// latency SLO minus the estimated processing time of the batch once padded, so
+// that the first task still completes within the SLO. Returns
+// `batch_timeout_micros` until processing times have been learned.
+int64_t GetLatencySloBatchTimeoutMicros(
+    int batch_size, const std::vector<int32_t>& allowed_batch_sizes,
+    bool disable_padding, int64_t latency_slo_micros,
+    int64_t batch_timeout_micros, ModelBatchStats* model_batch_stats);
 
 // Constants containing possible values for the batch_padding_policy argument
 // of MaybeBatchDown. This argument specifies the policy that a batch scheduler
@@ -65,11 +92,17 @@ int ApplyBatchPaddingPolicy(int candidate_size,
 //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
 //     real request. In this case, it would compare (batch_16_cost / 16) and
 //     (batch_32_cost / 18).
+//   - LATENCY_SLO: chooses between PAD_UP and BATCH_DOWN from the processing
+//     times learned for each batch size, so as to meet a p99 latency target
+//     while processing requests as cheaply as possible. Batch schedulers using
+//     this policy also close batches once waiting longer would miss the
+//     target (see GetLatencySloBatchTimeoutMicros).
 //
 inline constexpr absl::string_view kBatchDownPolicy = "BATCH_DOWN";
 inline constexpr absl::string_view kPadUpPolicy = "PAD_UP";
 inline constexpr absl::string_view kMinimizeTpuCostPerRequestPolicy =
     "MINIMIZE_TPU_COST_PER_REQUEST";
+inline constexpr absl::string_view kLatencySloPolicy = "LATENCY_SLO";
 
 // Trims the batch to the next allowed batch size when possible and when
 // configured by batch_padding_policy.
@@ -82,14 +115,16 @@ void MaybeBatchDown(Batch<TaskType>& batch,
                     bool disable_padding,
                     absl::string_view batch_padding_policy,
                     ModelBatchStats* model_batch_stats,
-                    std::vector<std::unique_ptr<TaskType>>& out_trimmed_tasks) {
+                    std::vector<std::unique_ptr<TaskType>>& out_trimmed_tasks,
+                    int64_t latency_slo_micros = 0,
+                    int64_t batch_age_micros = 0) {
   if (batch.empty()) {
     return;
   }
   int32_t batch_size = batch.size();
-  int32_t target_size =
-      ApplyBatchPaddingPolicy(batch_size, allowed_batch_sizes, disable_padding,
-                              batch_padding_policy, model_batch_stats);
+  int32_t target_size = ApplyBatchPaddingPolicy(
+      batch_size, allowed_batch_sizes, disable_padding, batch_padding_policy,
+      model_batch_stats, latency_slo_micros, batch_age_micros);
   if (target_size < batch_size) {
     batch.TryTrimToNewSize(target_size, out_trimmed_tasks);
   }
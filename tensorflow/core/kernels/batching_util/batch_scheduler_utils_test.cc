@@ -245,6 +245,116 @@ TEST(ApplyBatchPaddingPolicyTest,
             3);
 }
 
+// Registers enough samples for `batch_size` to have a processing time estimate.
+void RegisterProcessingTime(ModelBatchStats& model_batch_stats, int batch_size,
+                            absl::Duration processing_time) {
+  for (int i = 0; i < LatencyTracker::kMinSampleCount; ++i) {
+    model_batch_stats.batch_size(batch_size).processing_time().Register(
+        processing_time);
+  }
+}
+
+TEST(ApplyBatchPaddingPolicyTest, LatencySloPadsUpWithinSlo) {
+  ModelBatchStats model_batch_stats;
+  RegisterProcessingTime(model_batch_stats, 2, absl::Milliseconds(6));
+  RegisterProcessingTime(model_batch_stats, 4, absl::Milliseconds(7));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/5000),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest, LatencySloBatchesDownWhenCheaper) {
+  ModelBatchStats model_batch_stats;
+  RegisterProcessingTime(model_batch_stats, 2, absl::Milliseconds(7));
+  RegisterProcessingTime(model_batch_stats, 4, absl::Milliseconds(12));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/5000),
+            2);
+  // The trimmed task would miss the SLO.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/7000),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest, LatencySloBatchesDownToMeetSlo) {
+  ModelBatchStats model_batch_stats;
+  RegisterProcessingTime(model_batch_stats, 2, absl::Milliseconds(6));
+  RegisterProcessingTime(model_batch_stats, 4, absl::Milliseconds(7));
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/13500),
+            2);
+  // Neither size meets the SLO anymore.
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/15000),
+            3);
+}
+
+TEST(ApplyBatchPaddingPolicyTest, LatencySloWithoutStatsPadsUp) {
+  ModelBatchStats model_batch_stats;
+
+  EXPECT_EQ(ApplyBatchPaddingPolicy(
+                3, {2, 4}, false, kLatencySloPolicy, &model_batch_stats,
+                /*latency_slo_micros=*/20000, /*batch_age_micros=*/19000),
+            3);
+  EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false, kLatencySloPolicy,
+                                    nullptr, /*latency_slo_micros=*/20000),
+            3);
+}
+
+TEST(EstimateBatchProcessingTimeTest, NoSamples) {
+  ModelBatchStats model_batch_stats;
+  model_batch_stats.batch_size(4).processing_time().Register(
+      absl::Milliseconds(1));
+
+  EXPECT_FALSE(EstimateBatchProcessingTime(model_batch_stats, 4).has_value());
+}
+
+TEST(EstimateBatchProcessingTimeTest, Interpolates) {
+  ModelBatchStats model_batch_stats;
+  RegisterProcessingTime(model_batch_stats, 2, absl::Milliseconds(4));
+  RegisterProcessingTime(model_batch_stats, 6, absl::Milliseconds(8));
+
+  EXPECT_EQ(*EstimateBatchProcessingTime(model_batch_stats, 2),
+            absl::Milliseconds(4));
+  EXPECT_EQ(*EstimateBatchProcessingTime(model_batch_stats, 3),
+            absl::Milliseconds(5));
+  EXPECT_EQ(*EstimateBatchProcessingTime(model_batch_stats, 1),
+            absl::Milliseconds(4));
+  EXPECT_EQ(*EstimateBatchProcessingTime(model_batch_stats, 12),
+            absl::Milliseconds(16));
+}
+
+TEST(GetLatencySloBatchTimeoutMicrosTest, UsesSlackOfPaddedBatch) {
+  ModelBatchStats model_batch_stats;
+  RegisterProcessingTime(model_batch_stats, 4, absl::Milliseconds(7));
+
+  EXPECT_EQ(GetLatencySloBatchTimeoutMicros(
+                3, {2, 4}, false, /*latency_slo_micros=*/20000,
+                /*batch_timeout_micros=*/1000, &model_batch_stats),
+            13000);
+  EXPECT_EQ(GetLatencySloBatchTimeoutMicros(
+                3, {2, 4}, false, /*latency_slo_micros=*/5000,
+                /*batch_timeout_micros=*/1000, &model_batch_stats),
+            0);
+}
+
+TEST(GetLatencySloBatchTimeoutMicrosTest, FallsBackToBatchTimeout) {
+  ModelBatchStats model_batch_stats;
+
+  EXPECT_EQ(GetLatencySloBatchTimeoutMicros(
+                3, {2, 4}, false, /*latency_slo_micros=*/20000,
+                /*batch_timeout_micros=*/1000, &model_batch_stats),
+            1000);
+}
+
 TEST(ApplyBatchPaddingPolicyTest, UnsupportedPolicy) {
   EXPECT_EQ(ApplyBatchPaddingPolicy(3, {2, 4}, false, "UNSUPPORTED", nullptr),
             3);
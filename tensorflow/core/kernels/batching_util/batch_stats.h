@@ -50,6 +50,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_STATS_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_STATS_H_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <optional>
@@ -115,6 +117,61 @@ class CostTracker {
   absl::Duration sample_sum_ TF_GUARDED_BY(mu_);
 };
 
+// Tracks the tail of the most recent registered latency samples, so that the
+// estimate follows changes in load and in the model.
+//
+// Thread-safe.
+class LatencyTracker {
+ public:
+  // The number of most recent samples the estimates are computed from.
+  static constexpr int kWindowSize = 128;
+
+  // The number of samples needed before p99() returns an estimate.
+  static constexpr int kMinSampleCount = 8;
+
+  // Registers a latency sample.
+  void Register(absl::Duration latency) {
+    DCHECK_GE(latency, absl::ZeroDuration());
+
+    mutex_lock l(mu_);
+    samples_[sample_count_ % kWindowSize] = latency;
+    sample_count_++;
+
+    // Recomputing the percentile here keeps p99() cheap; it is queried far
+    // more often than samples are registered (once per processed batch).
+    const int64_t window = std::min<int64_t>(sample_count_, kWindowSize);
+    std::array<absl::Duration, kWindowSize> sorted;
+    std::copy_n(samples_.begin(), window, sorted.begin());
+    const int64_t index = (window * 99 + 99) / 100 - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + index,
+                     sorted.begin() + window);
+    p99_ = sorted[index];
+  }
+
+  // Returns the 99th percentile of the last kWindowSize samples.
+  //
+  // Returns std::nullopt if fewer than kMinSampleCount samples have been
+  // registered.
+  std::optional<absl::Duration> p99() const {
+    mutex_lock l(mu_);
+    if (sample_count_ < kMinSampleCount) return std::nullopt;
+    return p99_;
+  }
+
+  int64_t sample_count() const {
+    mutex_lock l(mu_);
+    return sample_count_;
+  }
+
+ private:
+  mutable mutex mu_;
+
+  // A ring buffer of the last kWindowSize samples.
+  std::array<absl::Duration, kWindowSize> samples_ TF_GUARDED_BY(mu_);
+  int64_t sample_count_ TF_GUARDED_BY(mu_) = 0;
+  absl::Duration p99_ TF_GUARDED_BY(mu_);
+};
+
 // Tracks statistics for a particular model and batch size.
 //
 // Thread-safe.
@@ -122,8 +179,13 @@ class BatchSizeStats {
  public:
   CostTracker& tpu_cost() { return tpu_cost_; };
 
+  // The wall time it takes to process a batch of this size, from the moment
+  // the batch is handed to the model until its outputs are available.
+  LatencyTracker& processing_time() { return processing_time_; };
+
  private:
   CostTracker tpu_cost_;
+  LatencyTracker processing_time_;
 };
 
 // Tracks statistics for a particular model.
@@ -188,6 +250,43 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  // The time batches of this model wait in the batch queue, from the enqueue
+  // time of their first task until a batch thread picks them up.
+  LatencyTracker& queueing_delay() { return queueing_delay_; }
+
+  // Registers that a batch thread spent `time` processing a batch of this
+  // model. Together with the same figure for the other models sharing the
+  // batch threads, this gives the share of batch thread time each model gets.
+  void RegisterBatchProcessingTime(absl::Duration time) {
+    cumulative_batch_processing_micros_.fetch_add(
+        absl::ToInt64Microseconds(time), std::memory_order_relaxed);
+  }
+
+  absl::Duration cumulative_batch_processing_time() const {
+    return absl::Microseconds(
+        cumulative_batch_processing_micros_.load(std::memory_order_relaxed));
+  }
+
+  // Registers that the batch queue rejected a task of size `size` to shed
+  // load.
+  void RegisterShedSize(int64_t size) {
+    cumulative_shed_size_.fetch_add(size, std::memory_order_relaxed);
+  }
+
+  int64_t cumulative_shed_size() const {
+    return cumulative_shed_size_.load(std::memory_order_relaxed);
+  }
+
+  // The relative share of batch thread time this model is entitled to when
+  // its batch queue competes with other queues.
+  void SetFairShareWeight(double weight) {
+    fair_share_weight_.store(weight, std::memory_order_relaxed);
+  }
+
+  double fair_share_weight() const {
+    return fair_share_weight_.load(std::memory_order_relaxed);
+  }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +311,16 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  LatencyTracker queueing_delay_;
+
+  // The total time batch threads spent processing batches of this model.
+  std::atomic<int64_t> cumulative_batch_processing_micros_ = 0;
+
+  // The total size of the tasks rejected to shed load.
+  std::atomic<int64_t> cumulative_shed_size_ = 0;
+
+  std::atomic<double> fair_share_weight_ = 1.0;
 };
 
 // Tracks batch statistics for all models.
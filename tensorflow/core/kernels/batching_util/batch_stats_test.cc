@@ -69,6 +69,37 @@ TEST(BatchStatsTest, CostTrackerMeanIsCorrect) {
   ASSERT_EQ(*tracker.mean(), absl::Hours(6));
 }
 
+TEST(BatchStatsTest, LatencyTrackerNeedsMinSampleCount) {
+  LatencyTracker tracker;
+  for (int i = 1; i < LatencyTracker::kMinSampleCount; ++i) {
+    tracker.Register(absl::Milliseconds(i));
+  }
+  EXPECT_FALSE(tracker.p99().has_value());
+
+  tracker.Register(absl::Milliseconds(1));
+  EXPECT_EQ(tracker.sample_count(), LatencyTracker::kMinSampleCount);
+  EXPECT_EQ(*tracker.p99(), absl::Milliseconds(7));
+}
+
+TEST(BatchStatsTest, LatencyTrackerP99IsCorrect) {
+  LatencyTracker tracker;
+  for (int i = 100; i >= 1; --i) {
+    tracker.Register(absl::Milliseconds(i));
+  }
+
+  EXPECT_EQ(*tracker.p99(), absl::Milliseconds(99));
+}
+
+TEST(BatchStatsTest, LatencyTrackerForgetsOldSamples) {
+  LatencyTracker tracker;
+  tracker.Register(absl::Seconds(10));
+  for (int i = 0; i < LatencyTracker::kWindowSize; ++i) {
+    tracker.Register(absl::Milliseconds(1));
+  }
+
+  EXPECT_EQ(*tracker.p99(), absl::Milliseconds(1));
+}
+
 TEST(BatchStatsTest, ProcessedSizeIsCorrect) {
   ModelBatchStats stats;
 
@@ -78,6 +109,20 @@ TEST(BatchStatsTest, ProcessedSizeIsCorrect) {
   ASSERT_EQ(stats.cumulative_processed_size(), 12);
 }
 
+TEST(BatchStatsTest, FairShareStatsAreCorrect) {
+  ModelBatchStats stats;
+  EXPECT_EQ(stats.fair_share_weight(), 1.0);
+
+  stats.SetFairShareWeight(2.5);
+  stats.RegisterBatchProcessingTime(absl::Milliseconds(3));
+  stats.RegisterBatchProcessingTime(absl::Milliseconds(4));
+  stats.RegisterShedSize(2);
+
+  EXPECT_EQ(stats.fair_share_weight(), 2.5);
+  EXPECT_EQ(stats.cumulative_batch_processing_time(), absl::Milliseconds(7));
+  EXPECT_EQ(stats.cumulative_shed_size(), 2);
+}
+
 TEST(BatchStatsTest, ModelOpNamesAreCorrect) {
   BatchStatsRegistry stats;
 
@@ -163,6 +163,14 @@ class SharedBatchScheduler
     // will be prioritized based on a (priority, arrival_time) key.
     bool rank_queues = false;
 
+    // If true, when multiple queues have available batches to process, they
+    // share the batch threads by weighted fair queueing: the next batch comes
+    // from the queue that received the least batch processing time relative
+    // to its QueueOptions::fair_share_weight. The processing time of a batch
+    // is estimated from the recent batches of its queue. Queues that were
+    // idle do not accumulate credit. Takes precedence over `rank_queues`.
+    bool enable_fair_sharing = false;
+
     // If true, Create() will return a global instance of the scheduler. Only
     // the options provided in the first Create() call will be used to
     // initialize the global scheduler.
@@ -276,6 +284,33 @@ class SharedBatchScheduler
     // requested.
     ModelBatchStats* model_batch_stats = nullptr;
 
+    // The p99 latency target, from enqueueing a task to the end of processing
+    // its batch, that the LATENCY_SLO padding policy aims for. With that
+    // policy, the open batch is closed once waiting any longer would miss the
+    // target given the processing times learned in `model_batch_stats`, and
+    // `batch_timeout_micros` is only used until those are known.
+    //
+    // Must be positive iff `batch_padding_policy` is LATENCY_SLO. Ignored when
+    // `enable_priority_aware_batch_scheduler` is true.
+    int64_t latency_slo_micros = 0;
+
+    // The relative share of batch thread time this queue is entitled to when
+    // it competes with other queues. Used iff the scheduler's
+    // `enable_fair_sharing` is true. Must be positive.
+    double fair_share_weight = 1.0;
+
+    // If positive, Schedule() sheds load by rejecting tasks with an UNAVAILABLE
+    // error when the time they would wait in the queue is estimated to exceed
+    // this many microseconds, rather than accepting tasks that are likely to
+    // miss their deadlines. The estimate is the number of batches ahead of the
+    // task times the recent interval between batches of this queue getting
+    // processed while it was backlogged, so it accounts for competition with
+    // other queues.
+    //
+    // Ignored for low priority tasks and when
+    // `enable_priority_aware_batch_scheduler` is true.
+    int64_t max_queueing_delay_micros = 0;
+
     // If true, queue implementation would split high priority and low priority
     // inputs into two sub queues.
     bool enable_priority_queue = false;
@@ -377,6 +412,12 @@ class SharedBatchScheduler
 
   mutex mu_;
 
+  // The fair-share virtual time of the queue most recently picked when
+  // `enable_fair_sharing` is true. Queues that fell behind it while idle are
+  // brought up to it, so that they don't get to monopolize the batch threads
+  // once they become busy.
+  double fair_share_virtual_time_ TF_GUARDED_BY(mu_) = 0;
+
   // A list of queues. (We use std::list instead of std::vector to ensure that
   // iterators are not invalidated by adding/removing elements. It also offers
   // efficient removal of elements from the middle.)
@@ -880,6 +921,22 @@ class Queue {
   // batch and if so will return the priority of that batch.
   std::optional<BatchPriorityKey> PeekBatchPriority() const;
 
+  // Returns the estimated batch processing time charged to this queue so far,
+  // in microseconds, divided by its fair-share weight.
+  double fair_share_virtual_time() const;
+
+  // Returns the estimated time it takes to process a batch of this queue, in
+  // microseconds, or std::nullopt if it is not known yet.
+  std::optional<double> batch_processing_micros() const;
+
+  // Charges the estimated processing time of a batch just returned by
+  // ScheduleBatch() to the queue's fair share, starting from
+  // `start_virtual_time` (which is at least fair_share_virtual_time()).
+  // `default_batch_processing_micros` is charged until the queue has an
+  // estimate of its own.
+  void ChargeFairShare(double start_virtual_time,
+                       double default_batch_processing_micros);
+
   // Retrieves the low priority tasks that can be padded to a high priority
   // batch of the specified size.
   std::vector<std::unique_ptr<TaskType>> GetLowPriorityTasksForPadding(
@@ -962,6 +1019,15 @@ class Queue {
   // lock on 'mu_'.
   size_t SchedulingCapacityInternal() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Returns an UNAVAILABLE error if a task enqueued now is estimated to wait
+  // longer than `max_queueing_delay_micros` before being processed.
+  absl::Status ValidateQueueingDelay(const TaskType& task)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Updates the interval between batches of this queue being processed,
+  // given that a batch is being scheduled now.
+  void UpdateDispatchInterval() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   // Returns an error if queue doesn't have capacity for this task.
   //
   // `task` must outlive this method.
@@ -1069,6 +1135,25 @@ class Queue {
   // Incremented in ScheduleBatch() and decremented in ProcessBatch().
   int num_batches_being_processed_ TF_GUARDED_BY(mu_) = 0;
 
+  // See fair_share_virtual_time().
+  double fair_share_virtual_time_ TF_GUARDED_BY(mu_) = 0;
+
+  // A moving average of the time it takes to process a batch of this queue,
+  // in microseconds, or -1 if it is not known yet. Seeded from
+  // `model_batch_stats` when the model has processed batches before, e.g.
+  // when a new version of it is loaded.
+  double batch_processing_micros_ TF_GUARDED_BY(mu_) = -1;
+
+  // A moving average of the interval between batches of this queue being
+  // scheduled while more batches were waiting, in microseconds, or -1 if it
+  // has not been measured yet. Used to estimate queueing delays.
+  double dispatch_interval_micros_ TF_GUARDED_BY(mu_) = -1;
+
+  // The time the last batch was scheduled, and whether more batches were
+  // waiting then.
+  uint64_t last_dispatch_time_micros_ TF_GUARDED_BY(mu_) = 0;
+  bool backlogged_at_last_dispatch_ TF_GUARDED_BY(mu_) = false;
+
   // Used by CloseAndWaitUntilEmpty() to wait until the queue is empty, for
   // the case in which the queue is not empty when CloseAndWaitUntilEmpty()
   // starts. When ProcessBatch() dequeues the last batch and makes the queue
@@ -1197,6 +1282,21 @@ absl::Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.fair_share_weight <= 0) {
+    return errors::InvalidArgument("fair_share_weight must be positive; was ",
+                                   options.fair_share_weight);
+  }
+  if (options.max_queueing_delay_micros < 0) {
+    return errors::InvalidArgument(
+        "max_queueing_delay_micros must be non-negative; was ",
+        options.max_queueing_delay_micros);
+  }
+  if (options.batch_padding_policy == kLatencySloPolicy &&
+      options.latency_slo_micros <= 0) {
+    return errors::InvalidArgument(
+        "latency_slo_micros must be positive with the ", kLatencySloPolicy,
+        " batch padding policy; was ", options.latency_slo_micros);
+  }
 
   if (options.enable_large_batch_splitting &&
       options.split_input_task_func == nullptr) {
@@ -1325,6 +1425,12 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
   internal::Queue<TaskType>* queue_for_batch = nullptr;
   std::optional<typename internal::Queue<TaskType>::BatchPriorityKey>
       batch_priority_key;
+  // The virtual time of `queue_for_batch` when `enable_fair_sharing` is true.
+  std::optional<double> min_virtual_time;
+  // The sum and count of the known batch processing times of the queues, to
+  // charge queues that have no estimate yet the average.
+  double total_batch_processing_micros = 0;
+  int num_batch_processing_estimates = 0;
   const int num_queues = queues_.size();
   for (int num_queues_tried = 0;
        !BatchExists(batch_to_process) && num_queues_tried < num_queues;
@@ -1339,7 +1445,27 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
 
     bool queue_has_work = false;
 
-    if (options_.rank_queues) {
+    if (options_.enable_fair_sharing) {
+      std::optional<double> batch_processing_micros =
+          (*next_queue_to_schedule_)->batch_processing_micros();
+      if (batch_processing_micros.has_value()) {
+        total_batch_processing_micros += *batch_processing_micros;
+        ++num_batch_processing_estimates;
+      }
+      queue_has_work = (*next_queue_to_schedule_)->PeekBatchPriority()
+                           .has_value();
+      if (queue_has_work) {
+        const double virtual_time =
+            std::max(fair_share_virtual_time_,
+                     (*next_queue_to_schedule_)->fair_share_virtual_time());
+        // Ties go to the first queue in round-robin order.
+        if (!min_virtual_time.has_value() ||
+            virtual_time < *min_virtual_time) {
+          min_virtual_time = virtual_time;
+          queue_for_batch = next_queue_to_schedule_->get();
+        }
+      }
+    } else if (options_.rank_queues) {
       auto key = (*next_queue_to_schedule_)->PeekBatchPriority();
       queue_has_work = key.has_value();
       if (key.has_value() && (!batch_priority_key.has_value() ||
@@ -1372,7 +1498,19 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     }
   }
 
-  if (options_.rank_queues && batch_priority_key.has_value()) {
+  if (min_virtual_time.has_value()) {
+    batch_to_process = queue_for_batch->ScheduleBatch();
+    if (BatchExists(batch_to_process)) {
+      fair_share_virtual_time_ = *min_virtual_time;
+      // Without any estimate, charging every queue a unit cost makes them
+      // take turns.
+      queue_for_batch->ChargeFairShare(
+          *min_virtual_time,
+          num_batch_processing_estimates > 0
+              ? total_batch_processing_micros / num_batch_processing_estimates
+              : 1.0);
+    }
+  } else if (options_.rank_queues && batch_priority_key.has_value()) {
     batch_to_process = queue_for_batch->ScheduleBatch();
   }
 
@@ -1469,6 +1607,14 @@ Queue<TaskType>::Queue(
   traceme_context_id_counter_ = (absl::GetCurrentTimeNanos() & 0xFFFFFFFF)
                                 << 32;
   GetBatches().emplace_back(new Batch<TaskType>);
+  if (options_.model_batch_stats != nullptr) {
+    options_.model_batch_stats->SetFairShareWeight(options_.fair_share_weight);
+    std::optional<absl::Duration> processing_time = EstimateBatchProcessingTime(
+        *options_.model_batch_stats, max_execution_batch_size_);
+    if (processing_time.has_value()) {
+      batch_processing_micros_ = absl::ToDoubleMicroseconds(*processing_time);
+    }
+  }
 }
 
 template <typename TaskType>
@@ -1672,6 +1818,7 @@ absl::Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         TF_RETURN_IF_ERROR(ValidateLowPriorityTaskQueueCapacity(**task));
         low_priority_tasks_.AddTask(std::move(*task), env_->NowMicros());
       } else {
+        TF_RETURN_IF_ERROR(ValidateQueueingDelay(**task));
         TF_RETURN_IF_ERROR(ScheduleWithoutOrEagerSplitImpl(task));
       }
 
@@ -1755,6 +1902,45 @@ size_t Queue<TaskType>::SchedulingCapacityInternal() const {
          open_batch_capacity;
 }
 
+template <typename TaskType>
+absl::Status Queue<TaskType>::ValidateQueueingDelay(const TaskType& task) {
+  if (options_.max_queueing_delay_micros <= 0 ||
+      dispatch_interval_micros_ < 0) {
+    return absl::OkStatus();
+  }
+  // The closed batches ahead of the open one.
+  const int64_t num_batches_ahead = GetBatches().size() - 1;
+  const double estimated_delay_micros =
+      num_batches_ahead * dispatch_interval_micros_;
+  if (estimated_delay_micros <= options_.max_queueing_delay_micros) {
+    return absl::OkStatus();
+  }
+  if (options_.model_batch_stats != nullptr) {
+    options_.model_batch_stats->RegisterShedSize(task.size());
+  }
+  return errors::Unavailable(
+      "The batch scheduling queue to which this task was submitted is "
+      "shedding load; estimated queueing delay is ",
+      static_cast<int64_t>(estimated_delay_micros),
+      " microseconds but max_queueing_delay_micros is ",
+      options_.max_queueing_delay_micros,
+      " (num_enqueued_batches=", num_batches_ahead, ")");
+}
+
+template <typename TaskType>
+void Queue<TaskType>::UpdateDispatchInterval() {
+  const uint64_t now_micros = env_->NowMicros();
+  if (backlogged_at_last_dispatch_) {
+    const double interval_micros = now_micros - last_dispatch_time_micros_;
+    dispatch_interval_micros_ =
+        dispatch_interval_micros_ < 0
+            ? interval_micros
+            : 0.8 * dispatch_interval_micros_ + 0.2 * interval_micros;
+  }
+  last_dispatch_time_micros_ = now_micros;
+  backlogged_at_last_dispatch_ = GetBatches().size() > 1;
+}
+
 template <typename TaskType>
 absl::Status Queue<TaskType>::ValidateBatchTaskQueueCapacity(
     TaskType* task) const {
@@ -1865,7 +2051,9 @@ Queue<TaskType>::ScheduleBatch() {
               /* disable_padding= */ options_.disable_padding,
               /* batch_padding_policy= */ options_.batch_padding_policy,
               /* model_batch_stats= */ options_.model_batch_stats,
-              /* out_trimmed_tasks= */ trimmed_tasks);
+              /* out_trimmed_tasks= */ trimmed_tasks,
+              /* latency_slo_micros= */ options_.latency_slo_micros,
+              /* batch_age_micros= */ env_->NowMicros() - old_batch_time);
 
           StartNewBatch();
 
@@ -1902,6 +2090,7 @@ Queue<TaskType>::ScheduleBatch() {
         // There is at least one closed batch that is ready to be scheduled.
         batch_to_schedule = std::move(batches.front());
         batches.pop_front();
+        UpdateDispatchInterval();
       }
 
       if (batch_to_schedule == nullptr) {
@@ -1976,6 +2165,20 @@ void Queue<TaskType>::ProcessBatch(
       tsl::profiler::ContextType::kSharedBatchScheduler,
       batch->traceme_context_id());
 
+  // Warmup batches are left out of the fair-share and queueing statistics.
+  bool is_warmup_batch = false;
+  if constexpr (std::is_base_of_v<BatchTask, TaskType>) {
+    is_warmup_batch = !batch->empty() && batch->task(0).is_warmup();
+  }
+  const uint64_t start_time_micros = env_->NowMicros();
+  std::optional<uint64_t> enqueue_time_micros = batch->EarliestTaskStartTime();
+  if (!is_warmup_batch && options_.model_batch_stats != nullptr &&
+      enqueue_time_micros.has_value() &&
+      *enqueue_time_micros <= start_time_micros) {
+    options_.model_batch_stats->queueing_delay().Register(
+        absl::Microseconds(start_time_micros - *enqueue_time_micros));
+  }
+
   if (std::holds_alternative<ProcessBatchCallbackWithoutPaddingTasks>(
           process_batch_callback_)) {
     std::get<ProcessBatchCallbackWithoutPaddingTasks>(process_batch_callback_)(
@@ -1985,8 +2188,20 @@ void Queue<TaskType>::ProcessBatch(
         std::move(batch), std::move(padding_task));
   }
 
+  const uint64_t processing_micros = env_->NowMicros() - start_time_micros;
+  if (!is_warmup_batch && options_.model_batch_stats != nullptr) {
+    options_.model_batch_stats->RegisterBatchProcessingTime(
+        absl::Microseconds(processing_micros));
+  }
+
   {
     mutex_lock l(mu_);
+    if (!is_warmup_batch) {
+      batch_processing_micros_ =
+          batch_processing_micros_ < 0
+              ? processing_micros
+              : 0.8 * batch_processing_micros_ + 0.2 * processing_micros;
+    }
     --num_batches_being_processed_;
     if (empty_notification_ != nullptr && IsEmptyInternal()) {
       empty_notification_->Notify();
@@ -1994,6 +2209,31 @@ void Queue<TaskType>::ProcessBatch(
   }
 }
 
+template <typename TaskType>
+double Queue<TaskType>::fair_share_virtual_time() const {
+  mutex_lock l(mu_);
+  return fair_share_virtual_time_;
+}
+
+template <typename TaskType>
+std::optional<double> Queue<TaskType>::batch_processing_micros() const {
+  mutex_lock l(mu_);
+  if (batch_processing_micros_ < 0) return std::nullopt;
+  return batch_processing_micros_;
+}
+
+template <typename TaskType>
+void Queue<TaskType>::ChargeFairShare(double start_virtual_time,
+                                      double default_batch_processing_micros) {
+  mutex_lock l(mu_);
+  DCHECK_GE(start_virtual_time, fair_share_virtual_time_);
+  const double batch_processing_micros = batch_processing_micros_ < 0
+                                             ? default_batch_processing_micros
+                                             : batch_processing_micros_;
+  fair_share_virtual_time_ =
+      start_virtual_time + batch_processing_micros / options_.fair_share_weight;
+}
+
 template <typename TaskType>
 bool Queue<TaskType>::IsEmpty() const {
   mutex_lock l(mu_);
@@ -2122,6 +2362,16 @@ Queue<TaskType>::PeekBatchPriorityImpl() const {
     return std::nullopt;
   }
 
+  if (options_.batch_padding_policy == kLatencySloPolicy) {
+    // Close the batch once waiting any longer would make its oldest task miss
+    // the latency SLO.
+    effective_batch_timeout_micros = GetLatencySloBatchTimeoutMicros(
+        std::min(effective_batch_size, max_execution_batch_size()),
+        options_.allowed_batch_sizes, options_.disable_padding,
+        options_.latency_slo_micros, effective_batch_timeout_micros,
+        options_.model_batch_stats);
+  }
+
   bool schedulable = closed_ ||
                      effective_batch_size >= max_execution_batch_size() ||
                      env_->NowMicros() >= effective_start_time_micros +
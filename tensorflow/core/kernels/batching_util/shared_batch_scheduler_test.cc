@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
 
+#include <atomic>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
@@ -1201,6 +1202,235 @@ TEST_P(SharedBatchSchedulerTest, BatchPaddingPolicyBatchDown) {
 INSTANTIATE_TEST_SUITE_P(Parameter, SharedBatchSchedulerTest,
                          ::testing::Bool());
 
+TEST(SharedBatchSchedulerFairSharingTest, CheapQueueIsNotStarved) {
+  test_util::FakeClockEnv env(Env::Default());
+  absl::Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Scheduler::Options options;
+    options.num_batch_threads = 1;
+    options.env = &env;
+    options.enable_fair_sharing = true;
+    std::shared_ptr<Scheduler> scheduler;
+    TF_ASSERT_OK(Scheduler::Create(options, &scheduler));
+
+    constexpr int kNumTasksPerQueue = 10;
+    absl::Notification gate_entered, gate_released, all_processed;
+    mutex mu;
+    std::vector<std::string> processed;
+    // The first batch blocks the only batch thread until both queues are
+    // backlogged. Batches of `expensive` take 10 times longer to process than
+    // batches of `cheap`.
+    auto make_callback = [&](const std::string& name, int64_t cost_micros) {
+      return [&, name, cost_micros](std::unique_ptr<Batch<FakeTask>> batch) {
+        if (!gate_entered.HasBeenNotified()) {
+          gate_entered.Notify();
+          gate_released.WaitForNotification();
+        } else {
+          mutex_lock l(mu);
+          processed.push_back(name);
+          if (processed.size() == 2 * kNumTasksPerQueue) {
+            all_processed.Notify();
+          }
+        }
+        env.AdvanceByMicroseconds(cost_micros);
+      };
+    };
+
+    // Every task makes a batch of its own.
+    QueueOptions queue_options = CreateQueueOptions(
+        /*max_execution_batch_size=*/1, /*input_batch_size_limit=*/1,
+        /*batch_timeout_micros=*/0, /*max_enqueued_batches=*/20,
+        /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Queue> expensive,
+        CreateQueue(scheduler, queue_options,
+                    make_callback("expensive", /*cost_micros=*/1000)));
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<Queue> cheap,
+        CreateQueue(scheduler, queue_options,
+                    make_callback("cheap", /*cost_micros=*/100)));
+
+    TF_ASSERT_OK(ScheduleTask(1, expensive.get()));
+    gate_entered.WaitForNotification();
+    for (int i = 0; i < kNumTasksPerQueue; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, expensive.get()));
+      TF_ASSERT_OK(ScheduleTask(1, cheap.get()));
+    }
+    gate_released.Notify();
+    all_processed.WaitForNotification();
+
+    // With equal weights, all the cheap batches cost less than one expensive
+    // batch, so they are all processed before the second expensive one.
+    {
+      mutex_lock l(mu);
+      int num_expensive_before_last_cheap = 0;
+      int num_expensive = 0;
+      for (const std::string& name : processed) {
+        if (name == "expensive") {
+          ++num_expensive;
+        } else {
+          num_expensive_before_last_cheap = num_expensive;
+        }
+      }
+      EXPECT_LE(num_expensive_before_last_cheap, 1);
+    }
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerFairSharingTest, ShedsLoadBeforeQueueingDelay) {
+  test_util::FakeClockEnv env(Env::Default());
+  absl::Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Scheduler> scheduler,
+        CreateSharedBatchScheduler(/*num_batch_threads=*/1, &env));
+
+    // Batches take 1ms to process. The first and the fifth batch block the
+    // batch thread until they are released.
+    absl::Notification first_gate_entered, first_gate_released;
+    absl::Notification second_gate_entered, second_gate_released;
+    absl::Notification first_tasks_processed;
+    std::atomic<int> num_processed = 0;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      const int n = num_processed.fetch_add(1);
+      if (n == 0) {
+        first_gate_entered.Notify();
+        first_gate_released.WaitForNotification();
+      } else if (n == 4) {
+        second_gate_entered.Notify();
+        second_gate_released.WaitForNotification();
+      }
+      env.AdvanceByMicroseconds(1000);
+      if (n == 3) first_tasks_processed.Notify();
+    };
+
+    ModelBatchStats model_batch_stats;
+    QueueOptions queue_options = CreateQueueOptions(
+        /*max_execution_batch_size=*/1, /*input_batch_size_limit=*/1,
+        /*batch_timeout_micros=*/0, /*max_enqueued_batches=*/20,
+        /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+    queue_options.max_queueing_delay_micros = 2500;
+    queue_options.model_batch_stats = &model_batch_stats;
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Queue> queue,
+                            CreateQueue(scheduler, queue_options, callback));
+
+    // Let the queue learn how fast its batches get processed when backlogged.
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    first_gate_entered.WaitForNotification();
+    for (int i = 0; i < 3; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    }
+    first_gate_released.Notify();
+    first_tasks_processed.WaitForNotification();
+
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    second_gate_entered.WaitForNotification();
+    // The queue accepts tasks as long as there are at most two batches, i.e.
+    // 2ms of processing, ahead of them.
+    for (int i = 0; i < 4; ++i) {
+      TF_EXPECT_OK(ScheduleTask(1, queue.get()));
+    }
+    absl::Status status = ScheduleTask(1, queue.get());
+    EXPECT_EQ(status.code(), absl::StatusCode::kUnavailable);
+    EXPECT_THAT(status.message(), HasSubstr("shedding load"));
+    EXPECT_EQ(model_batch_stats.cumulative_shed_size(), 1);
+    EXPECT_GT(model_batch_stats.queueing_delay().sample_count(), 0);
+    second_gate_released.Notify();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST(SharedBatchSchedulerLatencySloTest, RequiresPositiveSlo) {
+  TF_ASSERT_OK_AND_ASSIGN(std::shared_ptr<Scheduler> scheduler,
+                          CreateSharedBatchScheduler(/*num_batch_threads=*/1));
+
+  QueueOptions queue_options = CreateQueueOptions(
+      /*max_execution_batch_size=*/4, /*input_batch_size_limit=*/4,
+      /*batch_timeout_micros=*/1000, /*max_enqueued_batches=*/2,
+      /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+  queue_options.batch_padding_policy = std::string(kLatencySloPolicy);
+  absl::StatusOr<std::unique_ptr<Queue>> queue = CreateQueue(
+      scheduler, queue_options, [](std::unique_ptr<Batch<FakeTask>> batch) {});
+  EXPECT_EQ(queue.status().code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(queue.status().message(),
+              HasSubstr("latency_slo_micros must be positive"));
+
+  queue_options.latency_slo_micros = 500;
+  TF_EXPECT_OK(CreateQueue(scheduler, queue_options,
+                           [](std::unique_ptr<Batch<FakeTask>> batch) {})
+                   .status());
+}
+
+TEST(SharedBatchSchedulerLatencySloTest, ClosesBatchBeforeMissingSlo) {
+  test_util::FakeClockEnv env(Env::Default());
+  absl::Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    absl::Notification first_batch_processed, second_batch_processed;
+    std::atomic<int> num_processed = 0;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      if (num_processed.fetch_add(1) == 0) {
+        first_batch_processed.Notify();
+      } else {
+        second_batch_processed.Notify();
+      }
+    };
+
+    TF_ASSERT_OK_AND_ASSIGN(
+        std::shared_ptr<Scheduler> scheduler,
+        CreateSharedBatchScheduler(/*num_batch_threads=*/1, &env));
+
+    ModelBatchStats model_batch_stats;
+    QueueOptions queue_options = CreateQueueOptions(
+        /*max_execution_batch_size=*/4, /*input_batch_size_limit=*/4,
+        /*batch_timeout_micros=*/1000, /*max_enqueued_batches=*/2,
+        /*enable_large_batch_splitting=*/false, /*split_func=*/nullptr);
+    queue_options.batch_padding_policy = std::string(kLatencySloPolicy);
+    queue_options.latency_slo_micros = 300;
+    queue_options.model_batch_stats = &model_batch_stats;
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<Queue> queue,
+                            CreateQueue(scheduler, queue_options, callback));
+
+    // Until processing times are known, the batch timeout applies.
+    TF_ASSERT_OK(ScheduleTask(/*task_size=*/1, queue.get()));
+    env.AdvanceByMicroseconds(999);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(first_batch_processed.HasBeenNotified());
+    env.AdvanceByMicroseconds(1);
+    first_batch_processed.WaitForNotification();
+
+    // Once batches are known to take 100us, a batch waits at most the
+    // remaining 200us of the SLO.
+    for (int i = 0; i < LatencyTracker::kMinSampleCount; ++i) {
+      model_batch_stats.batch_size(4).processing_time().Register(
+          absl::Microseconds(100));
+    }
+    TF_ASSERT_OK(ScheduleTask(/*task_size=*/1, queue.get()));
+    env.AdvanceByMicroseconds(199);
+    Env::Default()->SleepForMicroseconds(10 * 1000 /* 10 milliseconds */);
+    EXPECT_FALSE(second_batch_processed.HasBeenNotified());
+    env.AdvanceByMicroseconds(1);
+    second_batch_processed.WaitForNotification();
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 class SharedBatchSchedulerPriorityTest
     : public ::testing::TestWithParam<
           std::tuple<bool, MixedPriorityBatchingPolicy>>,
@@ -40,6 +40,7 @@ limitations under the License.
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/scoped_memory_debug_annotation.h"
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
 
 namespace tensorflow {
 
@@ -86,6 +87,11 @@ ConstantOp::ConstantOp(OpKernelConstruction* ctx)
       absl::InvalidArgumentError(absl::StrCat(
           "Type mismatch between value (", DataTypeString(tensor_.dtype()),
           ") and dtype (", DataTypeString(ctx->output_type(0)), ")")));
+  // Large host constants are often the same across the models of a process.
+  if (ctx->device_type() == DEVICE_CPU &&
+      SharedTensorStore::EnabledByEnvironment()) {
+    tensor_ = SharedTensorStore::Global()->Intern(tensor_);
+  }
 }
 
 void ConstantOp::Compute(OpKernelContext* ctx) {
@@ -0,0 +1,486 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+
+namespace tensorflow {
+namespace {
+
+enum class MicroOp {
+  kIdentity,
+  kNeg,
+  kAbs,
+  kAdd,
+  kSub,
+  kMul,
+  kDiv,
+  kMaximum,
+  kMinimum,
+  kGreater,
+  kGreaterEqual,
+  kLess,
+  kLessEqual,
+  kEqual,
+  kNotEqual,
+  kLogicalAnd,
+  kLogicalOr,
+  kLogicalNot,
+  kSelect,
+  kCast,
+};
+
+struct MicroOpInfo {
+  MicroOp op;
+  int num_operands;
+};
+
+// Keep in sync with the ops accepted by MicroOpBundlingPass.
+const absl::flat_hash_map<std::string, MicroOpInfo>& MicroOps() {
+  static const auto* const ops =
+      new absl::flat_hash_map<std::string, MicroOpInfo>({
+          {"Identity", {MicroOp::kIdentity, 1}},
+          {"Neg", {MicroOp::kNeg, 1}},
+          {"Abs", {MicroOp::kAbs, 1}},
+          {"Add", {MicroOp::kAdd, 2}},
+          {"AddV2", {MicroOp::kAdd, 2}},
+          {"Sub", {MicroOp::kSub, 2}},
+          {"Mul", {MicroOp::kMul, 2}},
+          {"RealDiv", {MicroOp::kDiv, 2}},
+          {"Maximum", {MicroOp::kMaximum, 2}},
+          {"Minimum", {MicroOp::kMinimum, 2}},
+          {"Greater", {MicroOp::kGreater, 2}},
+          {"GreaterEqual", {MicroOp::kGreaterEqual, 2}},
+          {"Less", {MicroOp::kLess, 2}},
+          {"LessEqual", {MicroOp::kLessEqual, 2}},
+          {"Equal", {MicroOp::kEqual, 2}},
+          {"NotEqual", {MicroOp::kNotEqual, 2}},
+          {"LogicalAnd", {MicroOp::kLogicalAnd, 2}},
+          {"LogicalOr", {MicroOp::kLogicalOr, 2}},
+          {"LogicalNot", {MicroOp::kLogicalNot, 1}},
+          {"Select", {MicroOp::kSelect, 3}},
+          {"SelectV2", {MicroOp::kSelect, 3}},
+          {"Cast", {MicroOp::kCast, 1}},
+      });
+  return *ops;
+}
+
+bool IsNumeric(DataType dtype) {
+  return dtype == DT_FLOAT || dtype == DT_DOUBLE || dtype == DT_INT32 ||
+         dtype == DT_INT64;
+}
+
+// A register holds one scalar of the type recorded for it at construction.
+union Register {
+  float f;
+  double d;
+  int32_t i32;
+  int64_t i64;
+  bool b;
+};
+
+template <typename T>
+T& As(Register& r);
+template <>
+float& As<float>(Register& r) {
+  return r.f;
+}
+template <>
+double& As<double>(Register& r) {
+  return r.d;
+}
+template <>
+int32_t& As<int32_t>(Register& r) {
+  return r.i32;
+}
+template <>
+int64_t& As<int64_t>(Register& r) {
+  return r.i64;
+}
+template <>
+bool& As<bool>(Register& r) {
+  return r.b;
+}
+
+struct Instruction {
+  MicroOp op;
+  // The type of the first operand for all ops but Select, where it is the
+  // type of the second one.
+  DataType operand_type;
+  DataType type;
+  int dst;
+  int operands[3];
+};
+
+template <typename Src>
+void CastTo(Src value, DataType dst_type, Register* dst) {
+  switch (dst_type) {
+    case DT_FLOAT:
+      dst->f = static_cast<float>(value);
+      break;
+    case DT_DOUBLE:
+      dst->d = static_cast<double>(value);
+      break;
+    case DT_INT32:
+      dst->i32 = static_cast<int32_t>(value);
+      break;
+    case DT_INT64:
+      dst->i64 = static_cast<int64_t>(value);
+      break;
+    case DT_BOOL:
+      dst->b = static_cast<bool>(value);
+      break;
+    default:
+      break;
+  }
+}
+
+// Matches the semantics of the corresponding cwise kernels on scalars.
+template <typename T>
+void Evaluate(const Instruction& inst, Register* regs) {
+  Register& dst = regs[inst.dst];
+  const T a = As<T>(regs[inst.operands[0]]);
+  if (inst.op == MicroOp::kIdentity) {
+    As<T>(dst) = a;
+    return;
+  }
+  if (inst.op == MicroOp::kCast) {
+    CastTo(a, inst.type, &dst);
+    return;
+  }
+  if constexpr (std::is_same_v<T, bool>) {
+    switch (inst.op) {
+      case MicroOp::kLogicalNot:
+        dst.b = !a;
+        break;
+      case MicroOp::kLogicalAnd:
+        dst.b = a && regs[inst.operands[1]].b;
+        break;
+      case MicroOp::kLogicalOr:
+        dst.b = a || regs[inst.operands[1]].b;
+        break;
+      case MicroOp::kEqual:
+        dst.b = a == regs[inst.operands[1]].b;
+        break;
+      case MicroOp::kNotEqual:
+        dst.b = a != regs[inst.operands[1]].b;
+        break;
+      default:
+        break;
+    }
+  } else {
+    if (inst.op == MicroOp::kNeg) {
+      As<T>(dst) = -a;
+      return;
+    }
+    if (inst.op == MicroOp::kAbs) {
+      As<T>(dst) = Eigen::numext::abs(a);
+      return;
+    }
+    const T b = As<T>(regs[inst.operands[1]]);
+    switch (inst.op) {
+      case MicroOp::kAdd:
+        As<T>(dst) = a + b;
+        break;
+      case MicroOp::kSub:
+        As<T>(dst) = a - b;
+        break;
+      case MicroOp::kMul:
+        As<T>(dst) = a * b;
+        break;
+      case MicroOp::kDiv:
+        As<T>(dst) = a / b;
+        break;
+      case MicroOp::kMaximum:
+        As<T>(dst) =
+            Eigen::internal::scalar_max_op<T, T, Eigen::PropagateNaN>()(a, b);
+        break;
+      case MicroOp::kMinimum:
+        As<T>(dst) =
+            Eigen::internal::scalar_min_op<T, T, Eigen::PropagateNaN>()(a, b);
+        break;
+      case MicroOp::kGreater:
+        dst.b = a > b;
+        break;
+      case MicroOp::kGreaterEqual:
+        dst.b = a >= b;
+        break;
+      case MicroOp::kLess:
+        dst.b = a < b;
+        break;
+      case MicroOp::kLessEqual:
+        dst.b = a <= b;
+        break;
+      case MicroOp::kEqual:
+        dst.b = a == b;
+        break;
+      case MicroOp::kNotEqual:
+        dst.b = a != b;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// Returns the result type of `op` applied to operands of `operand_type`, or
+// an error if the combination is not supported.
+absl::Status ResultType(const std::string& name, MicroOp op,
+                        DataType operand_type, DataType* result_type) {
+  bool supported = false;
+  switch (op) {
+    case MicroOp::kIdentity:
+    case MicroOp::kSelect:
+      supported = true;
+      *result_type = operand_type;
+      break;
+    case MicroOp::kNeg:
+    case MicroOp::kAbs:
+    case MicroOp::kAdd:
+    case MicroOp::kSub:
+    case MicroOp::kMul:
+    case MicroOp::kMaximum:
+    case MicroOp::kMinimum:
+      supported = IsNumeric(operand_type);
+      *result_type = operand_type;
+      break;
+    case MicroOp::kDiv:
+      supported = operand_type == DT_FLOAT || operand_type == DT_DOUBLE;
+      *result_type = operand_type;
+      break;
+    case MicroOp::kGreater:
+    case MicroOp::kGreaterEqual:
+    case MicroOp::kLess:
+    case MicroOp::kLessEqual:
+      supported = IsNumeric(operand_type);
+      *result_type = DT_BOOL;
+      break;
+    case MicroOp::kEqual:
+    case MicroOp::kNotEqual:
+      supported = true;
+      *result_type = DT_BOOL;
+      break;
+    case MicroOp::kLogicalAnd:
+    case MicroOp::kLogicalOr:
+    case MicroOp::kLogicalNot:
+      supported = operand_type == DT_BOOL;
+      *result_type = DT_BOOL;
+      break;
+    case MicroOp::kCast:
+      // The result type is given by the instruction.
+      supported = true;
+      break;
+  }
+  if (!supported) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported operand type ", DataTypeString(operand_type),
+                     " for op ", name));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+class MicroOpBundleOp : public OpKernel {
+ public:
+  explicit MicroOpBundleOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    std::vector<std::string> ops;
+    DataTypeVector op_types;
+    std::vector<int32_t> op_num_operands;
+    std::vector<int32_t> op_operands;
+    OP_REQUIRES_OK(context, context->GetAttr("ops", &ops));
+    OP_REQUIRES_OK(context, context->GetAttr("op_types", &op_types));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("op_num_operands", &op_num_operands));
+    OP_REQUIRES_OK(context, context->GetAttr("op_operands", &op_operands));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("result_registers", &result_registers_));
+    OP_REQUIRES(context,
+                ops.size() == op_types.size() &&
+                    ops.size() == op_num_operands.size(),
+                errors::InvalidArgument(
+                    "ops, op_types and op_num_operands must have the same "
+                    "length"));
+
+    // The type of every register, so that operands can be type checked once
+    // here instead of on every step.
+    register_types_.assign(context->input_types().begin(),
+                           context->input_types().end());
+    int next_operand = 0;
+    for (int i = 0; i < static_cast<int>(ops.size()); ++i) {
+      auto it = MicroOps().find(ops[i]);
+      OP_REQUIRES(context, it != MicroOps().end(),
+                  errors::InvalidArgument("Unsupported op: ", ops[i]));
+      const MicroOpInfo& info = it->second;
+      OP_REQUIRES(
+          context, op_num_operands[i] == info.num_operands,
+          errors::InvalidArgument("Op ", ops[i], " takes ", info.num_operands,
+                                  " operands, got ", op_num_operands[i]));
+      OP_REQUIRES(context,
+                  next_operand + info.num_operands <=
+                      static_cast<int>(op_operands.size()),
+                  errors::InvalidArgument("Too few op_operands"));
+
+      Instruction inst;
+      inst.op = info.op;
+      inst.type = op_types[i];
+      inst.dst = static_cast<int>(register_types_.size());
+      DataType types[3];
+      for (int j = 0; j < info.num_operands; ++j) {
+        const int operand = op_operands[next_operand++];
+        OP_REQUIRES(context, operand >= 0 && operand < inst.dst,
+                    errors::InvalidArgument("Op ", i, " (", ops[i],
+                                            ") reads undefined register ",
+                                            operand));
+        inst.operands[j] = operand;
+        types[j] = register_types_[operand];
+      }
+      if (inst.op == MicroOp::kSelect) {
+        OP_REQUIRES(context, types[0] == DT_BOOL && types[1] == types[2],
+                    errors::InvalidArgument("Invalid operand types for ",
+                                            ops[i]));
+        inst.operand_type = types[1];
+      } else {
+        inst.operand_type = types[0];
+        for (int j = 1; j < info.num_operands; ++j) {
+          OP_REQUIRES(context, types[j] == types[0],
+                      errors::InvalidArgument("Mismatched operand types for ",
+                                              ops[i]));
+        }
+      }
+      DataType result_type = inst.type;
+      OP_REQUIRES_OK(context, ResultType(ops[i], inst.op, inst.operand_type,
+                                         &result_type));
+      OP_REQUIRES(context, result_type == inst.type,
+                  errors::InvalidArgument(
+                      "Op ", ops[i], " produces ", DataTypeString(result_type),
+                      ", but op_types says ", DataTypeString(inst.type)));
+      register_types_.push_back(inst.type);
+      instructions_.push_back(inst);
+    }
+    OP_REQUIRES(context,
+                next_operand == static_cast<int>(op_operands.size()),
+                errors::InvalidArgument("Too many op_operands"));
+
+    OP_REQUIRES(context,
+                static_cast<int>(result_registers_.size()) == num_outputs(),
+                errors::InvalidArgument(
+                    "result_registers must have one entry per output"));
+    for (int i = 0; i < num_outputs(); ++i) {
+      const int reg = result_registers_[i];
+      OP_REQUIRES(context,
+                  reg >= 0 && reg < static_cast<int>(register_types_.size()),
+                  errors::InvalidArgument("Invalid result register ", reg));
+      OP_REQUIRES(context, register_types_[reg] == output_type(i),
+                  errors::InvalidArgument("Result ", i, " has type ",
+                                          DataTypeString(register_types_[reg]),
+                                          ", expected ",
+                                          DataTypeString(output_type(i))));
+    }
+  }
+
+  void Compute(OpKernelContext* context) override {
+    absl::InlinedVector<Register, 64> regs(register_types_.size());
+    for (int i = 0; i < num_inputs(); ++i) {
+      const Tensor& input = context->input(i);
+      OP_REQUIRES(context, TensorShapeUtils::IsScalar(input.shape()),
+                  errors::InvalidArgument("Input ", i,
+                                          " must be a scalar, got shape ",
+                                          input.shape().DebugString()));
+      switch (input.dtype()) {
+#define LOAD_INPUT(T)                     \
+  case DataTypeToEnum<T>::value:          \
+    As<T>(regs[i]) = input.scalar<T>()(); \
+    break;
+        TF_CALL_float(LOAD_INPUT);
+        TF_CALL_double(LOAD_INPUT);
+        TF_CALL_int32(LOAD_INPUT);
+        TF_CALL_int64(LOAD_INPUT);
+        TF_CALL_bool(LOAD_INPUT);
+#undef LOAD_INPUT
+        default:
+          break;
+      }
+    }
+
+    for (const Instruction& inst : instructions_) {
+      if (inst.op == MicroOp::kSelect) {
+        regs[inst.dst] = regs[inst.operands[0]].b ? regs[inst.operands[1]]
+                                                   : regs[inst.operands[2]];
+        continue;
+      }
+      switch (inst.operand_type) {
+#define EVALUATE(T)             \
+  case DataTypeToEnum<T>::value:    \
+    Evaluate<T>(inst, regs.data()); \
+    break;
+        TF_CALL_float(EVALUATE);
+        TF_CALL_double(EVALUATE);
+        TF_CALL_int32(EVALUATE);
+        TF_CALL_int64(EVALUATE);
+        TF_CALL_bool(EVALUATE);
+#undef EVALUATE
+        default:
+          break;
+      }
+    }
+
+    for (int i = 0; i < num_outputs(); ++i) {
+      Tensor* output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(i, TensorShape({}), &output));
+      Register& reg = regs[result_registers_[i]];
+      switch (output->dtype()) {
+#define STORE_OUTPUT(T)                 \
+  case DataTypeToEnum<T>::value:        \
+    output->scalar<T>()() = As<T>(reg); \
+    break;
+        TF_CALL_float(STORE_OUTPUT);
+        TF_CALL_double(STORE_OUTPUT);
+        TF_CALL_int32(STORE_OUTPUT);
+        TF_CALL_int64(STORE_OUTPUT);
+        TF_CALL_bool(STORE_OUTPUT);
+#undef STORE_OUTPUT
+        default:
+          break;
+      }
+    }
+  }
+
+ private:
+  DataTypeVector register_types_;
+  std::vector<Instruction> instructions_;
+  std::vector<int32_t> result_registers_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("_MicroOpBundle").Device(DEVICE_CPU),
+                        MicroOpBundleOp);
+
+}  // namespace tensorflow
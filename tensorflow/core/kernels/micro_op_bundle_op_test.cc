@@ -0,0 +1,121 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class MicroOpBundleOpTest : public OpsTestBase {
+ protected:
+  absl::Status Init(const DataTypeVector& input_types,
+                    const DataTypeVector& result_types,
+                    const std::vector<std::string>& ops,
+                    const DataTypeVector& op_types,
+                    const std::vector<int32_t>& op_num_operands,
+                    const std::vector<int32_t>& op_operands,
+                    const std::vector<int32_t>& result_registers) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("bundle", "_MicroOpBundle")
+                           .Input(FakeInput(input_types))
+                           .Attr("Tresults", result_types)
+                           .Attr("ops", ops)
+                           .Attr("op_types", op_types)
+                           .Attr("op_num_operands", op_num_operands)
+                           .Attr("op_operands", op_operands)
+                           .Attr("result_registers", result_registers)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(MicroOpBundleOpTest, EvaluatesProgram) {
+  // r2 = x + y; r3 = r2 > x; r4 = r3 ? r2 : y; r5 = cast<int32>(r3)
+  TF_ASSERT_OK(Init({DT_FLOAT, DT_FLOAT}, {DT_FLOAT, DT_INT32},
+                    {"AddV2", "Greater", "Select", "Cast"},
+                    {DT_FLOAT, DT_BOOL, DT_FLOAT, DT_INT32}, {2, 2, 3, 1},
+                    {0, 1, 2, 0, 3, 2, 1, 3}, {4, 5}));
+
+  AddInputFromArray<float>(TensorShape({}), {1.0f});
+  AddInputFromArray<float>(TensorShape({}), {2.0f});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<float>(*GetOutput(0),
+                                 test::AsScalar<float>(3.0f));
+  test::ExpectTensorEqual<int32_t>(*GetOutput(1), test::AsScalar<int32_t>(1));
+}
+
+TEST_F(MicroOpBundleOpTest, OutputsCanBeInputs) {
+  TF_ASSERT_OK(Init({DT_INT64}, {DT_INT64, DT_INT64}, {"Neg"}, {DT_INT64},
+                    {1}, {0}, {0, 1}));
+
+  AddInputFromArray<int64_t>(TensorShape({}), {7});
+  TF_ASSERT_OK(RunOpKernel());
+  test::ExpectTensorEqual<int64_t>(*GetOutput(0), test::AsScalar<int64_t>(7));
+  test::ExpectTensorEqual<int64_t>(*GetOutput(1),
+                                   test::AsScalar<int64_t>(-7));
+}
+
+TEST_F(MicroOpBundleOpTest, MaximumPropagatesNaN) {
+  TF_ASSERT_OK(Init({DT_DOUBLE, DT_DOUBLE}, {DT_DOUBLE}, {"Maximum"},
+                    {DT_DOUBLE}, {2}, {0, 1}, {2}));
+
+  AddInputFromArray<double>(TensorShape({}), {1.0});
+  AddInputFromArray<double>(TensorShape({}), {std::nan("")});
+  TF_ASSERT_OK(RunOpKernel());
+  EXPECT_TRUE(std::isnan(GetOutput(0)->scalar<double>()()));
+}
+
+TEST_F(MicroOpBundleOpTest, RejectsNonScalarInputs) {
+  TF_ASSERT_OK(Init({DT_INT32}, {DT_INT32}, {"Abs"}, {DT_INT32}, {1}, {0},
+                    {1}));
+
+  AddInputFromArray<int32_t>(TensorShape({2}), {1, -1});
+  const absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::StrContains(s.message(), "must be a scalar")) << s;
+}
+
+TEST_F(MicroOpBundleOpTest, RejectsUnsupportedOps) {
+  const absl::Status s = Init({DT_FLOAT}, {DT_FLOAT}, {"Exp"}, {DT_FLOAT},
+                              {1}, {0}, {1});
+  EXPECT_TRUE(absl::StrContains(s.message(), "Unsupported op")) << s;
+}
+
+TEST_F(MicroOpBundleOpTest, RejectsTypeMismatches) {
+  const absl::Status s =
+      Init({DT_FLOAT, DT_INT32}, {DT_FLOAT}, {"Add"}, {DT_FLOAT}, {2}, {0, 1},
+           {2});
+  EXPECT_TRUE(absl::StrContains(s.message(), "Mismatched operand types")) << s;
+}
+
+TEST_F(MicroOpBundleOpTest, RejectsForwardReferences) {
+  const absl::Status s =
+      Init({DT_FLOAT}, {DT_FLOAT}, {"Neg"}, {DT_FLOAT}, {1}, {1}, {1});
+  EXPECT_TRUE(absl::StrContains(s.message(), "undefined register")) << s;
+}
+
+}  // namespace
+}  // namespace tensorflow
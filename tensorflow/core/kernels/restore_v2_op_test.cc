@@ -14,26 +14,36 @@ limitations under the License.
 ==============================================================================*/
 
 #include <complex>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/public/session_options.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
 namespace tensorflow {
 namespace {
@@ -355,6 +365,81 @@ TEST_F(RestoreV2OpTest, RestoreAfterSaveV2) { RunTest("SaveV2"); }
 // For backward compatibility.
 TEST_F(RestoreV2OpTest, RestoreAfterSaveSlicesV1) { RunTest("SaveSlices"); }
 TEST_F(RestoreV2OpTest, RestoreAfterSaveV1) { RunTest("Save"); }
+// Restores with parallel readers and memory mapped tensors.
+TEST_F(RestoreV2OpTest, RestoreAfterSaveV2WithReadersAndMmap) {
+  tensorflow::setenv("TF_RESTORE_NUM_READERS", "4", 1 /* overwrite */);
+  tensorflow::setenv("TF_RESTORE_USE_MMAP", "1", 1 /* overwrite */);
+  RunTest("SaveV2");
+  tensorflow::unsetenv("TF_RESTORE_NUM_READERS");
+  tensorflow::unsetenv("TF_RESTORE_USE_MMAP");
+}
+
+// Writes a checkpoint of `num_tensors` float tensors of `tensor_bytes` bytes
+// each, aligned so that they can be memory mapped.
+std::string WriteCheckpoint(int num_tensors, int64_t tensor_bytes) {
+  const std::string prefix = io::JoinPath(
+      testing::TmpDir(), absl::StrCat("restore_", num_tensors, "_tensors"));
+  BundleWriter::Options options;
+  options.data_alignment = EIGEN_MAX_ALIGN_BYTES;
+  BundleWriter writer(Env::Default(), prefix, options);
+  Tensor tensor(DT_FLOAT,
+                TensorShape({tensor_bytes / static_cast<int64_t>(
+                                                sizeof(float))}));
+  tensor.flat<float>().setRandom();
+  for (int i = 0; i < num_tensors; ++i) {
+    TF_CHECK_OK(writer.Add(absl::StrCat("tensor_", i), tensor));
+  }
+  TF_CHECK_OK(writer.Finish());
+  return prefix;
+}
+
+Graph* RestoreGraph(const std::string& prefix, int num_tensors) {
+  Graph* graph = new Graph(OpRegistry::Global());
+  Tensor tensor_names(DT_STRING, TensorShape({num_tensors}));
+  Tensor shape_and_slices(DT_STRING, TensorShape({num_tensors}));
+  for (int i = 0; i < num_tensors; ++i) {
+    tensor_names.flat<tstring>()(i) = absl::StrCat("tensor_", i);
+  }
+  TF_CHECK_OK(
+      NodeBuilder(graph->NewName("restore"), "RestoreV2")
+          .Input(test::graph::Constant(graph, test::AsScalar<tstring>(prefix)))
+          .Input(test::graph::Constant(graph, tensor_names))
+          .Input(test::graph::Constant(graph, shape_and_slices))
+          .Attr("dtypes", DataTypeVector(num_tensors, DT_FLOAT))
+          .Finalize(graph, nullptr));
+  return graph;
+}
+
+// Restores a 256MiB checkpoint made of `num_tensors` tensors, as a model server
+// does when it starts. The checkpoint is in the page cache; drop the cache
+// before running the benchmark to measure restores from disk.
+void BM_RestoreV2ColdStart(::testing::benchmark::State& state) {
+  const int num_tensors = state.range(0);
+  const int num_readers = state.range(1);
+  const bool use_mmap = state.range(2);
+  const int64_t tensor_bytes = (int64_t{256} << 20) / num_tensors;
+  const std::string prefix = WriteCheckpoint(num_tensors, tensor_bytes);
+
+  tensorflow::setenv("TF_RESTORE_NUM_READERS",
+                     absl::StrCat(num_readers).c_str(), 1 /* overwrite */);
+  tensorflow::setenv("TF_RESTORE_USE_MMAP", use_mmap ? "1" : "0",
+                     1 /* overwrite */);
+  test::Benchmark("cpu", RestoreGraph(prefix, num_tensors),
+                  /*old_benchmark_api=*/false)
+      .Run(state);
+  tensorflow::unsetenv("TF_RESTORE_NUM_READERS");
+  tensorflow::unsetenv("TF_RESTORE_USE_MMAP");
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_tensors * tensor_bytes);
+}
+BENCHMARK(BM_RestoreV2ColdStart)
+    ->UseRealTime()
+    ->Args({16, 0, false})
+    ->Args({16, 8, false})
+    ->Args({16, 8, true})
+    ->Args({4096, 0, false})
+    ->Args({4096, 8, false})
+    ->Args({4096, 8, true});
 
 }  // namespace
 }  // namespace tensorflow
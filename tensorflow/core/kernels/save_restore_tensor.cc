@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <unordered_map>
@@ -32,8 +33,11 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -260,13 +264,16 @@ const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 struct RestoreOp {
   RestoreOp(OpKernelContext* context, int idx, const std::string& tensor_name,
             const std::string& shape_and_slice,
-            const std::string& reader_prefix, DataType dtype)
+            const std::string& reader_prefix, DataType dtype, bool use_mmap,
+            bool share_tensors)
       : context(context),
         idx(idx),
         tensor_name(tensor_name),
         shape_and_slice(shape_and_slice),
         reader_prefix(reader_prefix),
-        dtype(dtype) {}
+        dtype(dtype),
+        use_mmap(use_mmap),
+        share_tensors(share_tensors) {}
 
   // Move-only. It does not make sense to "run()" a copied RestoreOp.
   RestoreOp(const RestoreOp&) = delete;
@@ -287,7 +294,10 @@ struct RestoreOp {
 
   // Run this restore operation using a new BundleReader.
   void run_with_new_reader(BundleCache* cache) {
-    BundleReader reader(tsl::Env::Default(), reader_prefix, {cache, false});
+    BundleReader::Options options;
+    options.cache = cache;
+    options.use_mmap = use_mmap;
+    BundleReader reader(tsl::Env::Default(), reader_prefix, options);
     if (!reader.status().ok()) {
       status = reader.status();
       return;
@@ -304,7 +314,12 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
-    if (shape_and_slice.empty()) {
+    if (shape_and_slice.empty() && use_mmap) {
+      Tensor mapped;
+      TF_RETURN_IF_ERROR(reader->LookupMapped(tensor_name, &mapped));
+      context->set_output(idx, std::move(mapped));
+      restored_tensor = context->mutable_output(idx);
+    } else if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -331,6 +346,11 @@ struct RestoreOp {
       TF_RETURN_IF_ERROR(
           reader->LookupSlice(tensor_name, parsed_slice, restored_tensor));
     }
+    if (shape_and_slice.empty() && share_tensors) {
+      context->set_output(
+          idx, SharedTensorStore::Global()->Intern(*restored_tensor));
+      restored_tensor = context->mutable_output(idx);
+    }
     if (VLOG_IS_ON(5)) {
       if (restored_tensor->dtype() == DT_FLOAT) {
         const float* t_data = restored_tensor->flat<float>().data();
@@ -358,16 +378,94 @@ struct RestoreOp {
   std::string shape_and_slice;
   std::string reader_prefix;
   DataType dtype;
+  bool use_mmap;
+  bool share_tensors;
 
   absl::Status status;
 };
 
+// Returns the pool restoring ranges of tensors, shared by the restores of the
+// process. Reading is I/O bound, so it has at least 16 threads; ranges beyond
+// its size wait for a thread.
+thread::ThreadPool* RestoreReaderPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      tsl::Env::Default(), "restore_tensors",
+      std::max(port::MaxParallelism(), 16));
+  return pool;
+}
+
+// Runs `restore_ops`, sorted for sequential access, with up to `num_readers`
+// readers, each of which runs a contiguous range of about the same number of
+// `restore_bytes`.
+absl::Status RunRestoreOpsInRanges(std::vector<RestoreOp>& restore_ops,
+                                   absl::Span<const int64_t> restore_bytes,
+                                   int num_readers, const std::string& prefix,
+                                   const BundleReader::Options& options) {
+  if (restore_ops.empty()) return absl::OkStatus();
+  const int64_t total_bytes =
+      std::accumulate(restore_bytes.begin(), restore_bytes.end(), int64_t{0});
+  std::vector<absl::Span<RestoreOp>> ranges;
+  size_t begin = 0;
+  int64_t bytes = 0;
+  for (size_t i = 0; i < restore_ops.size(); ++i) {
+    bytes += restore_bytes[i];
+    const int64_t num_ranges = ranges.size() + 1;
+    if (i + 1 == restore_ops.size() ||
+        (num_ranges < num_readers &&
+         bytes * num_readers >= total_bytes * num_ranges)) {
+      ranges.push_back(
+          absl::MakeSpan(restore_ops).subspan(begin, i + 1 - begin));
+      begin = i + 1;
+    }
+  }
+  VLOG(1) << "Restoring " << restore_ops.size() << " tensors of "
+          << total_bytes << " bytes with " << ranges.size() << " readers";
+
+  std::vector<absl::Status> statuses(ranges.size());
+  auto restore_range = [&](size_t r) {
+    BundleReader reader(tsl::Env::Default(), prefix, options);
+    statuses[r] = reader.status();
+    for (RestoreOp& op : ranges[r]) {
+      if (!statuses[r].ok()) return;
+      statuses[r] = op.run(&reader);
+    }
+  };
+  // The caller restores the first range.
+  BlockingCounter counter(ranges.size() - 1);
+  for (size_t r = 1; r < ranges.size(); ++r) {
+    RestoreReaderPool()->Schedule([&, r]() {
+      restore_range(r);
+      counter.DecrementCount();
+    });
+  }
+  restore_range(0);
+  counter.Wait();
+  for (const absl::Status& status : statuses) {
+    TF_RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CheckRestoredDtypes(OpKernelContext* context,
+                                 const std::vector<RestoreOp>& restore_ops) {
+  for (const RestoreOp& restore_op : restore_ops) {
+    if (restore_op.dtype != context->mutable_output(restore_op.idx)->dtype()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
+          DataTypeString(restore_op.dtype), " does not equal restored dtype ",
+          DataTypeString(context->mutable_output(restore_op.idx)->dtype())));
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                               const Tensor& tensor_names,
                               const Tensor& shape_and_slices,
-                              absl::Span<const DataType> dtypes) {
+                              absl::Span<const DataType> dtypes,
+                              const RestoreTensorsV2Options& options) {
   const std::string& prefix_string = prefix.scalar<tstring>()();
 
   const auto& tensor_names_flat = tensor_names.flat<tstring>();
@@ -377,23 +475,31 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
   restore_ops.reserve(tensor_names_flat.size());
   for (int i = 0; i < tensor_names_flat.size(); ++i) {
     restore_ops.push_back({context, i, tensor_names_flat(i),
-                           shape_and_slices_flat(i), prefix_string, dtypes[i]});
+                           shape_and_slices_flat(i), prefix_string, dtypes[i],
+                           options.use_mmap, options.share_tensors});
   }
 
   tsl::Env* const env = tsl::Env::Default();
   BundleCache cache(env);
-  BundleReader default_reader(env, prefix_string, {&cache, false});
+  BundleReader::Options reader_options;
+  reader_options.cache = &cache;
+  reader_options.use_mmap = options.use_mmap;
+  BundleReader default_reader(env, prefix_string, reader_options);
   TF_RETURN_IF_ERROR(default_reader.status());
 
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
       restore_ops, [](const RestoreOp& op) { return op.tensor_name; }));
 
   std::vector<std::string> mismatched_errors;
+  std::vector<int64_t> restore_bytes;
+  restore_bytes.reserve(restore_ops.size());
   for (const RestoreOp& restore_op : restore_ops) {
     TensorShape restored_full_shape;
     DataType original_dtype;
     TF_RETURN_IF_ERROR(default_reader.LookupDtypeAndShape(
         restore_op.tensor_name, &original_dtype, &restored_full_shape));
+    restore_bytes.push_back(restored_full_shape.num_elements() *
+                            DataTypeSize(original_dtype));
     if (restore_op.dtype != original_dtype) {
       std::string error_msg = strings::StrCat(
           "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
@@ -407,6 +513,13 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     return absl::InvalidArgumentError(error_msg);
   }
 
+  if (options.num_readers > 0) {
+    TF_RETURN_IF_ERROR(RunRestoreOpsInRanges(restore_ops, restore_bytes,
+                                             options.num_readers,
+                                             prefix_string, reader_options));
+    return CheckRestoredDtypes(context, restore_ops);
+  }
+
   // Split restore ops into two groups: large and small. We schedule
   // large ops first, to prevent them from waiting on the small op.
   std::vector<RestoreOp*> large_restore_ops;
@@ -471,16 +584,7 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     }
   }
 
-  for (const RestoreOp& restore_op : restore_ops) {
-    if (restore_op.dtype != context->mutable_output(restore_op.idx)->dtype()) {
-      return absl::InvalidArgumentError(absl::StrCat(
-          "tensor_name = ", restore_op.tensor_name, "; expected dtype ",
-          DataTypeString(restore_op.dtype), " does not equal restored dtype ",
-          DataTypeString(context->mutable_output(restore_op.idx)->dtype())));
-    }
-  }
-
-  return absl::OkStatus();
+  return CheckRestoredDtypes(context, restore_ops);
 }
 
 }  // namespace tensorflow
@@ -55,6 +55,22 @@ void RestoreTensor(OpKernelContext* context,
 
 // V2 checkpoint format.
 
+struct RestoreTensorsV2Options {
+  // If positive, the number of BundleReaders restoring tensors in parallel.
+  // Each of them reads a range of tensors that is contiguous in the data files,
+  // and the ranges hold about the same number of bytes.
+  int num_readers = 0;
+
+  // Whether to restore full tensors as memory mappings of the data files
+  // where possible; see BundleReader::LookupMapped().
+  bool use_mmap = false;
+
+  // Whether to share the buffers of restored full tensors with the identical
+  // tensors restored before, which lets the models loaded in a process keep a
+  // single copy of their common weights; see SharedTensorStore.
+  bool share_tensors = false;
+};
+
 // Invokes the V2 checkpoint read path to read tensors.
 //
 // "context" is only used for allocating outputs.  In particular, the inputs are
@@ -63,10 +79,10 @@ void RestoreTensor(OpKernelContext* context,
 //   * "prefix" has 1 element, DT_STRING.
 //   * "tensor_names" and "shape_and_slices" shaped {N}, both DT_STRING.
 //   * "dtypes" has N elements, the datatypes of the to-restore tensors.
-absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
-                              const Tensor& tensor_names,
-                              const Tensor& shape_and_slices,
-                              absl::Span<const DataType> dtypes);
+absl::Status RestoreTensorsV2(
+    OpKernelContext* context, const Tensor& prefix, const Tensor& tensor_names,
+    const Tensor& shape_and_slices, absl::Span<const DataType> dtypes,
+    const RestoreTensorsV2Options& options = RestoreTensorsV2Options());
 
 }  // namespace tensorflow
 
@@ -16,10 +16,16 @@ limitations under the License.
 // See docs in ../ops/io_ops.cc.
 
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <limits>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/base/const_init.h"
+#include "absl/synchronization/mutex.h"
+
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -32,9 +38,12 @@ limitations under the License.
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/refcount.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 
@@ -91,12 +100,66 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Returns the process-wide writer of async saves, creating it if `create` is
+// set. Returns null if it does not exist.
+AsyncBundleWriter* GetAsyncBundleWriter(bool create) {
+  static absl::Mutex mu(absl::kConstInit);
+  static AsyncBundleWriter* writer ABSL_GUARDED_BY(mu) = nullptr;
+  absl::MutexLock l(mu);
+  if (writer == nullptr && create) {
+    AsyncBundleWriter::Options options;
+    int64_t max_pending_mb;
+    absl::Status status = ReadInt64FromEnvVar(
+        "TF_ASYNC_CHECKPOINT_MAX_PENDING_MB", options.max_pending_bytes >> 20,
+        &max_pending_mb);
+    if (status.ok()) {
+      options.max_pending_bytes = max_pending_mb << 20;
+    } else {
+      LOG(ERROR) << "Ignoring TF_ASYNC_CHECKPOINT_MAX_PENDING_MB: " << status;
+    }
+    status = ReadBoolFromEnvVar("TF_ASYNC_CHECKPOINT_COPY_TENSORS",
+                                options.copy_tensors, &options.copy_tensors);
+    if (!status.ok()) {
+      LOG(ERROR) << "Ignoring TF_ASYNC_CHECKPOINT_COPY_TENSORS: " << status;
+    }
+    writer = new AsyncBundleWriter(Env::Default(), options);
+    // The writer is never destroyed, so pending checkpoints are completed
+    // when the process exits normally.
+    std::atexit([] {
+      absl::Status status = GetAsyncBundleWriter(/*create=*/false)
+                                ->WaitForAll();
+      if (!status.ok()) {
+        LOG(ERROR) << "Async checkpoint writes failed at exit: " << status;
+      }
+    });
+  }
+  return writer;
+}
+
+// Waits for pending async saves to `prefix`, and returns their error if any.
+absl::Status WaitForAsyncSave(absl::string_view prefix) {
+  AsyncBundleWriter* writer = GetAsyncBundleWriter(/*create=*/false);
+  if (writer == nullptr) return absl::OkStatus();
+  return writer->WaitFor(prefix);
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
+//
+// If the TF_ASYNC_CHECKPOINT_SAVE environment variable is set, the op returns
+// once the tensors are snapshotted, and the bundle is written in the
+// background by an AsyncBundleWriter. RestoreV2 and MergeV2Checkpoints wait for
+// pending writes to their inputs and fail if these writes failed, and pending
+// writes are completed when the process exits. Checkpoint callbacks run once
+// the bundle is complete, and not if its write failed.
 class SaveV2 : public OpKernel {
  public:
-  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context,
+                   ReadBoolFromEnvVar("TF_ASYNC_CHECKPOINT_SAVE", false,
+                                      &async_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& prefix = context->input(0);
@@ -112,14 +175,13 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<AsyncBundleWriter::Entry> entries(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
       const std::string& tensor_name = tensor_names_flat(i);
       const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
+      AsyncBundleWriter::Entry& entry = entries[i];
+      entry.key = tensor_name;
+      entry.tensor = tensor;
 
       if (!shape_and_slices_flat(i).empty()) {
         const std::string& shape_spec = shape_and_slices_flat(i);
@@ -137,10 +199,9 @@ class SaveV2 : public OpKernel {
                 "shape of the tensor to  save: ",
                 shape_spec, ", tensor: ", tensor.shape().DebugString())));
 
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
-      } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
+        entry.is_slice = true;
+        entry.full_shape = shape;
+        entry.slice = slice;
       }
 
       if (VLOG_IS_ON(5)) {
@@ -159,15 +220,12 @@ class SaveV2 : public OpKernel {
                   << tensor.NumElements();
         }
       }
-
-      VLOG(2) << "Done save of " << tensor_name;
     }
-    OP_REQUIRES_OK(context, writer.Finish());
-    VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
 
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager =
+        nullptr;
     ResourceMgr* resource_manager = context->resource_manager();
     if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
       OP_REQUIRES_OK(
           context,
           resource_manager
@@ -180,18 +238,70 @@ class SaveV2 : public OpKernel {
                     *out = new checkpoint::CheckpointCallbackManager();
                     return absl::OkStatus();
                   }));
-      checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
+    }
+    core::ScopedUnref unref(checkpoint_callback_manager);
+
+    if (async_) {
+      // The callback manager is kept alive until the bundle is written.
+      if (checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Ref();
+      }
+      GetAsyncBundleWriter(/*create=*/true)
+          ->Write(prefix_string, std::move(entries),
+                  [checkpoint_callback_manager,
+                   prefix_string](const absl::Status& status) {
+                    if (checkpoint_callback_manager == nullptr) return;
+                    if (status.ok()) {
+                      checkpoint_callback_manager->Save(prefix_string);
+                    }
+                    checkpoint_callback_manager->Unref();
+                  });
+    } else {
+      BundleWriter writer(Env::Default(), prefix_string);
+      OP_REQUIRES_OK(context, writer.status());
+      VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
+      for (const AsyncBundleWriter::Entry& entry : entries) {
+        VLOG(2) << "Starting save of " << entry.key;
+        if (entry.is_slice) {
+          OP_REQUIRES_OK(context,
+                         writer.AddSlice(entry.key, entry.full_shape,
+                                         entry.slice, entry.tensor));
+        } else {
+          OP_REQUIRES_OK(context, writer.Add(entry.key, entry.tensor));
+        }
+        VLOG(2) << "Done save of " << entry.key;
+      }
+      OP_REQUIRES_OK(context, writer.Finish());
+      VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
+      if (checkpoint_callback_manager != nullptr) {
+        checkpoint_callback_manager->Save(prefix_string);
+      }
     }
   }
+
+ private:
+  bool async_;
 };
 REGISTER_KERNEL_BUILDER(Name("SaveV2").Device(DEVICE_CPU), SaveV2);
 
 // Restores a list of named tensors from a tensor bundle (V2 checkpoint format).
+//
+// The TF_RESTORE_NUM_READERS environment variable sets the number of bundle
+// readers restoring tensors in parallel, TF_RESTORE_USE_MMAP makes restored
+// tensors refer to memory mappings of local checkpoints where possible, and
+// TF_SHARE_IDENTICAL_TENSORS shares identical restored tensors across the
+// models of the process; see RestoreTensorsV2Options.
 class RestoreV2 : public OpKernel {
  public:
   explicit RestoreV2(OpKernelConstruction* context) : OpKernel(context) {
     OP_REQUIRES_OK(context, context->GetAttr("dtypes", &dtypes_));
+    int64_t num_readers;
+    OP_REQUIRES_OK(context, ReadInt64FromEnvVar("TF_RESTORE_NUM_READERS", 0,
+                                                &num_readers));
+    restore_options_.num_readers = static_cast<int>(num_readers);
+    OP_REQUIRES_OK(context, ReadBoolFromEnvVar("TF_RESTORE_USE_MMAP", false,
+                                               &restore_options_.use_mmap));
+    restore_options_.share_tensors = SharedTensorStore::EnabledByEnvironment();
   }
 
   void Compute(OpKernelContext* context) override {
@@ -207,6 +317,7 @@ class RestoreV2 : public OpKernel {
     if (!context->status().ok()) return;
 
     const std::string& prefix_string = prefix.scalar<tstring>()();
+    OP_REQUIRES_OK(context, WaitForAsyncSave(prefix_string));
 
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
@@ -231,8 +342,10 @@ class RestoreV2 : public OpKernel {
       return;
     }
     // If found, invokes the V2 reader.
-    OP_REQUIRES_OK(context, RestoreTensorsV2(context, prefix, tensor_names,
-                                             shape_and_slices, dtypes_));
+    OP_REQUIRES_OK(context,
+                   RestoreTensorsV2(context, prefix, tensor_names,
+                                    shape_and_slices, dtypes_,
+                                    restore_options_));
 
     ResourceMgr* resource_manager = context->resource_manager();
     if (resource_manager != nullptr) {
@@ -258,6 +371,7 @@ class RestoreV2 : public OpKernel {
  private:
   // Expected dtypes of the to-restore tensors.
   std::vector<DataType> dtypes_;
+  RestoreTensorsV2Options restore_options_;
 };
 REGISTER_KERNEL_BUILDER(Name("RestoreV2").Device(DEVICE_CPU), RestoreV2);
 
@@ -287,6 +401,9 @@ class MergeV2Checkpoints : public OpKernel {
 
     const absl::Span<const tstring> input_prefixes =
         absl::Span<const tstring>(checkpoint_prefixes.flat<tstring>());
+    for (const tstring& input_prefix : input_prefixes) {
+      OP_REQUIRES_OK(context, WaitForAsyncSave(input_prefix));
+    }
     Env* env = Env::Default();
     const std::string& merged_prefix = destination_prefix.scalar<tstring>()();
     OP_REQUIRES_OK(context,
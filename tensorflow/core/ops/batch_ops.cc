@@ -88,11 +88,15 @@ REGISTER_OP("BatchFunction")
     //     to either PAD_UP or BATCH_DOWN so as to minimize the TPU costs per
     //     real request. In this case, it would compare (batch_16_cost / 16) and
     //     (batch_32_cost / 18).
+    //   - LATENCY_SLO: close a batch once waiting any longer would miss
+    //     `latency_slo_micros` given the learned batch processing times, and
+    //     BATCH_DOWN only when that keeps every request within the SLO.
     //
     // WARNING: Not all batch schedulers might support this attribute.
     .Attr(
         "batch_padding_policy: "
-        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST'} = 'PAD_UP'")
+        "{'PAD_UP', 'BATCH_DOWN', 'MINIMIZE_TPU_COST_PER_REQUEST', "
+        "'LATENCY_SLO'} = 'PAD_UP'")
     .Attr("Tin: list(type)")
     .Attr("Tcaptured: list(type) >= 0")
     .Attr("Tout: list(type)")
@@ -122,6 +126,27 @@ REGISTER_OP("BatchFunction")
     // If greater than zero, a separate thread pool with this number of threads
     // is used for processing warmup requests.
     .Attr("num_warmup_batch_threads: int = 0")
+    // The latency target, in microseconds, of the LATENCY_SLO batch padding
+    // policy. Must be positive iff `batch_padding_policy` is LATENCY_SLO.
+    .Attr("latency_slo_micros: int = 0")
+    // If true, the queues of the batch scheduler share its threads by weighted
+    // fair queueing instead of round robin, weighted by `fair_share_weight`.
+    .Attr("enable_fair_sharing: bool = false")
+    // The relative share of batch thread time of this op's queue when
+    // `enable_fair_sharing` is true. Must be positive.
+    .Attr("fair_share_weight: float = 1.0")
+    // If positive, inputs are rejected with an UNAVAILABLE error when they are
+    // estimated to wait longer than this many microseconds to be processed.
+    .Attr("max_queueing_delay_micros: int = 0")
+    // If non-empty, inputs are batched only with inputs of similar sequence
+    // length to bound their padding. The sequence length is dimension 1 of the
+    // `in_tensors` at `sequence_inputs`, which are padded with zeros to the
+    // smallest of these lengths that fits them. The `out_tensors` at
+    // `sequence_outputs` are sliced back to the original sequence length.
+    // Inputs longer than the largest bucket are rejected.
+    .Attr("sequence_length_buckets: list(int) = []")
+    .Attr("sequence_inputs: list(int) = []")
+    .Attr("sequence_outputs: list(int) = []")
     // TODO(apassos): Fix this shape inference function. It requires shape
     // inference of function calls.
     .SetShapeFn(shape_inference::UnknownShape)
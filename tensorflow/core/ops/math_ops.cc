@@ -354,6 +354,36 @@ REGISTER_OP("_UnaryOpsComposition")
 expected to create these operators.
 )doc");
 
+// Evaluates a straight-line program of scalar ops. Registers
+// `[0, len(args))` hold the inputs. Instruction `i` applies `ops[i]` to the
+// registers named by the next `op_num_operands[i]` entries of `op_operands`
+// and writes its result, of type `op_types[i]`, to register `len(args) + i`.
+// Output `j` is register `result_registers[j]`.
+REGISTER_OP("_MicroOpBundle")
+    .Input("args: Targs")
+    .Output("results: Tresults")
+    .Attr("Targs: list({float, double, int32, int64, bool}) >= 1")
+    .Attr("Tresults: list({float, double, int32, int64, bool}) >= 1")
+    .Attr("ops: list(string) >= 1")
+    .Attr("op_types: list(type) >= 1")
+    .Attr("op_num_operands: list(int) >= 1")
+    .Attr("op_operands: list(int) >= 1")
+    .Attr("result_registers: list(int) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int i = 0; i < c->num_inputs(); ++i) {
+        shape_inference::ShapeHandle unused;
+        TF_RETURN_IF_ERROR(c->WithRank(c->input(i), 0, &unused));
+      }
+      for (int i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->Scalar());
+      }
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+*NOTE*: Do not invoke this operator directly in Python. Graph rewrite pass is
+expected to create these operators.
+)doc");
+
 #undef UNARY
 #undef UNARY_REAL
 #undef UNARY_COMPLEX
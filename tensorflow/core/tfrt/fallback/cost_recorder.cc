@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -73,6 +74,45 @@ absl::Status CostRecorder::WriteToFile() const {
                                     measured_cost_path, op_cost_map_proto);
 }
 
+absl::Status CostRecorder::WriteNodeCostsToFile(
+    const std::string& path,
+    const absl::flat_hash_map<int64_t, std::string>& node_names) const {
+  // Serializes the read-modify-write of the client graphs sharing the file.
+  static mutex file_mutex(LINKER_INITIALIZED);
+  mutex_lock file_lock(file_mutex);
+  OpCostMapProto op_cost_map_proto;
+  if (tensorflow::Env::Default()->FileExists(path).ok()) {
+    if (absl::Status status = tensorflow::ReadTextProto(
+            tensorflow::Env::Default(), path, &op_cost_map_proto);
+        !status.ok()) {
+      LOG(WARNING) << "Overwriting the unreadable op costs in " << path << ": "
+                   << status;
+      op_cost_map_proto.Clear();
+    }
+  }
+  {
+    tf_shared_lock l(op_cost_map_mutex_);
+    for (const auto& [op_key, op_cost] : op_cost_map_) {
+      const auto iter = node_names.find(op_key);
+      if (iter == node_names.end() || iter->second.empty()) continue;
+      const uint64_t avg_op_cost = op_cost.first / op_cost.second;
+      (*op_cost_map_proto.mutable_node_cost_map())[iter->second] = avg_op_cost;
+    }
+  }
+  return tensorflow::WriteTextProto(tensorflow::Env::Default(), path,
+                                    op_cost_map_proto);
+}
+
+absl::StatusOr<absl::flat_hash_map<std::string, uint64_t>>
+CostRecorder::ReadNodeCostsFromFile(const std::string& path) {
+  OpCostMapProto op_cost_map_proto;
+  TF_RETURN_IF_ERROR(tensorflow::ReadTextProto(tensorflow::Env::Default(),
+                                               path, &op_cost_map_proto));
+  return absl::flat_hash_map<std::string, uint64_t>(
+      op_cost_map_proto.node_cost_map().begin(),
+      op_cost_map_proto.node_cost_map().end());
+}
+
 size_t CostRecorder::size() const {
   tf_shared_lock l(op_cost_map_mutex_);
   return op_cost_map_.size();
@@ -20,10 +20,12 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -31,6 +33,11 @@ limitations under the License.
 namespace tensorflow {
 namespace tfrt_stub {
 
+// The attribute of the nodes of a graph that holds their costs measured by a
+// previous load of the model. The cost analysis of the TFRT compiler prefers it
+// to its static estimates.
+inline constexpr char kMeasuredCostAttrName[] = "_tfrt_measured_cost";
+
 // Thread-safe.
 // Maintains the execution durations by `op_key`. Note that `op_key` is only
 // unique within a model.
@@ -50,6 +57,19 @@ class CostRecorder {
   // TODO(b/263837451): Fix the op_key unstableness during serialization.
   absl::Status WriteToFile() const;
 
+  // Writes the op costs to `path` as the node costs of an `OpCostMapProto`,
+  // keyed by the node names in `node_names`, which maps op keys to the names
+  // of the nodes the ops come from. Ops without a node name are skipped. The
+  // costs are merged into the node costs already in the file, so that the
+  // client graphs of a model can share one file.
+  absl::Status WriteNodeCostsToFile(
+      const std::string& path,
+      const absl::flat_hash_map<int64_t, std::string>& node_names) const;
+
+  // Reads the node costs written by `WriteNodeCostsToFile()`.
+  static absl::StatusOr<absl::flat_hash_map<std::string, uint64_t>>
+  ReadNodeCostsFromFile(const std::string& path);
+
   size_t size() const;
 
   static const char* MesuredCostPathEnvVarName() {
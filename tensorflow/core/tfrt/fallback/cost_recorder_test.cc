@@ -99,6 +99,52 @@ TEST(CostRecorderTest, ProtoRecordsTest) {
             kTestAvgCost);
 }
 
+TEST(CostRecorderTest, NodeCostsTest) {
+  CostRecorder recorder;
+  recorder.RecordCost(kTestOpKey, kTestCost);
+  recorder.RecordCost(kTestOpKey, 2 * kTestCost);
+  // An op without a node name is not written.
+  recorder.RecordCost(kTestOpKey + 1, kTestCost);
+
+  std::string measured_cost_path;
+  tensorflow::Env::Default()->LocalTempFilename(&measured_cost_path);
+  TF_CHECK_OK(recorder.WriteNodeCostsToFile(measured_cost_path,
+                                            {{kTestOpKey, "test_node"}}));
+
+  auto node_costs = CostRecorder::ReadNodeCostsFromFile(measured_cost_path);
+  TF_CHECK_OK(node_costs.status());
+  ASSERT_EQ(node_costs->size(), 1);
+  EXPECT_EQ(node_costs->at("test_node"), kTestAvgCost);
+}
+
+TEST(CostRecorderTest, NodeCostsOfClientGraphsAreMerged) {
+  std::string measured_cost_path;
+  tensorflow::Env::Default()->LocalTempFilename(&measured_cost_path);
+
+  CostRecorder recorder_1;
+  recorder_1.RecordCost(kTestOpKey, kTestCost);
+  recorder_1.RecordCost(kTestOpKey + 1, kTestCost);
+  TF_CHECK_OK(recorder_1.WriteNodeCostsToFile(
+      measured_cost_path,
+      {{kTestOpKey, "node_1"}, {kTestOpKey + 1, "shared_node"}}));
+
+  // Another client graph with its own op keys.
+  CostRecorder recorder_2;
+  recorder_2.RecordCost(kTestOpKey, 2 * kTestCost);
+  recorder_2.RecordCost(kTestOpKey + 1, 3 * kTestCost);
+  TF_CHECK_OK(recorder_2.WriteNodeCostsToFile(
+      measured_cost_path,
+      {{kTestOpKey, "node_2"}, {kTestOpKey + 1, "shared_node"}}));
+
+  auto node_costs = CostRecorder::ReadNodeCostsFromFile(measured_cost_path);
+  TF_CHECK_OK(node_costs.status());
+  ASSERT_EQ(node_costs->size(), 3);
+  EXPECT_EQ(node_costs->at("node_1"), kTestCost);
+  EXPECT_EQ(node_costs->at("node_2"), 2 * kTestCost);
+  // The latest costs of a node win.
+  EXPECT_EQ(node_costs->at("shared_node"), 3 * kTestCost);
+}
+
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
@@ -96,6 +96,13 @@ struct GraphExecutionOptions {
     // Number of times to record costs before resetting Op cost estimates.
     // However, a reset always occurs after the first execution.
     int updates_per_interval = 1;
+
+    // If not empty, the op costs are written to this file, keyed by node name,
+    // whenever they are used to re-compile the executable. When the model is
+    // loaded again, the costs in the file are used from the first compilation,
+    // so the stream assignment starts from measured costs rather than static
+    // estimates.
+    std::string measured_cost_path;
   };
 
   CostAnalysisOptions cost_analysis_options;
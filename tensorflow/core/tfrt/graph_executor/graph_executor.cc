@@ -25,6 +25,7 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
@@ -38,6 +39,7 @@ limitations under the License.
 #include "absl/types/span.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "mlir/Dialect/Func/Extensions/AllExtensions.h"  // from @llvm-project
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
@@ -45,6 +47,7 @@ limitations under the License.
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
 #include "mlir/IR/DialectRegistry.h"  // from @llvm-project
 #include "mlir/IR/MLIRContext.h"  // from @llvm-project
+#include "mlir/IR/Operation.h"  // from @llvm-project
 #include "mlir/IR/OwningOpRef.h"  // from @llvm-project
 #include "tensorflow/compiler/mlir/tensorflow/dialect_registration.h"
 #include "tensorflow/compiler/mlir/tensorflow/ir/tf_saved_model.h"
@@ -52,10 +55,12 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tensorflow/translate/mlir_roundtrip_flags.h"
 #include "tensorflow/compiler/mlir/tensorflow/utils/error_util.h"
 #include "tensorflow/compiler/mlir/tf2xla/api/v2/graph_to_tf_executor.h"
+#include "tensorflow/compiler/mlir/tfrt/constants.h"
 #include "tensorflow/compiler/mlir/tfrt/transforms/mlrt/import_model.h"
 #include "tensorflow/compiler/mlir/tfrt/transforms/update_op_cost_in_tfrt_mlir.h"
 #include "tensorflow/compiler/mlir/tfrt/translate/import_model.h"
 #include "tensorflow/compiler/mlir/tfrt/translate/tfrt_compile_options.h"
+#include "tensorflow/compiler/mlir/utils/name_utils.h"
 #include "xla/tsl/concurrency/async_value_ref.h"
 #include "xla/tsl/lib/monitoring/sampler.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
@@ -65,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
@@ -134,6 +140,19 @@ StepId GetNextStepId() {
   return gen.GetNextStepId();
 }
 
+// Returns the names of the nodes that the ops with an `op_key_attr_name`
+// attribute in `module` come from, keyed by op key.
+absl::flat_hash_map<int64_t, std::string> GetNodeNamesByOpKey(
+    mlir::ModuleOp module, llvm::StringRef op_key_attr_name) {
+  absl::flat_hash_map<int64_t, std::string> node_names;
+  module.walk([&](mlir::Operation* op) {
+    if (auto op_key = op->getAttrOfType<mlir::IntegerAttr>(op_key_attr_name)) {
+      node_names[op_key.getInt()] = mlir::GetNameFromLoc(op->getLoc());
+    }
+  });
+  return node_names;
+}
+
 auto* graph_executor_mode = monitoring::Gauge<std::string, 2>::New(
     "/tfrt/graph_executor/mode",
     "Record the total number of imported savedmodel using different graph "
@@ -523,6 +542,20 @@ absl::StatusOr<std::unique_ptr<GraphExecutor>> GraphExecutor::Create(
   TfrtGraphExecutionState::Options graph_execution_state_options;
   graph_execution_state_options.run_placer_grappler_on_functions =
       options.run_placer_grappler_on_functions;
+  const std::string& measured_cost_path =
+      options.cost_analysis_options.measured_cost_path;
+  if (!measured_cost_path.empty() &&
+      tensorflow::Env::Default()->FileExists(measured_cost_path).ok()) {
+    auto measured_costs = CostRecorder::ReadNodeCostsFromFile(
+        measured_cost_path);
+    if (measured_costs.ok()) {
+      graph_execution_state_options.measured_costs =
+          *std::move(measured_costs);
+    } else {
+      LOG(WARNING) << "TFRT failed to read measured op costs from "
+                   << measured_cost_path << ": " << measured_costs.status();
+    }
+  }
 
   options.compile_options.fuse_get_resource_ops_in_hoisting =
       !options.enable_mlrt;
@@ -1054,6 +1087,24 @@ absl::Status GraphExecutor::LoadedClientGraph::UpdateCost(
     const CostRecorder& cost_recorder, const Runtime& runtime) {
   LOG(INFO) << "TFRT updating op costs of loaded client graph (" << this << ") "
             << name_;
+  const std::string& measured_cost_path =
+      graph_executor_->options().cost_analysis_options.measured_cost_path;
+  if (!measured_cost_path.empty()) {
+    // MLRT and BEF name the op key attribute differently.
+    const auto node_names =
+        executable_context()->IsForMlrt()
+            ? GetNodeNamesByOpKey(
+                  cost_analysis_data_.tf_mlir_with_op_keys.get(),
+                  tfrt_compiler::kOpKeyAttrName)
+            : GetNodeNamesByOpKey(cost_analysis_data_.tfrt_mlir.get(),
+                                  "op_key");
+    if (auto status =
+            cost_recorder.WriteNodeCostsToFile(measured_cost_path, node_names);
+        !status.ok()) {
+      LOG(WARNING) << "TFRT failed to write measured op costs to "
+                   << measured_cost_path << ": " << status;
+    }
+  }
   std::shared_ptr<ExecutableContext> new_executable_context = nullptr;
   if (executable_context()->IsForMlrt()) {
     auto tf_mlir_with_op_keys = ::mlir::OwningOpRef<mlir::ModuleOp>(
@@ -25,6 +25,7 @@ limitations under the License.
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
@@ -43,10 +44,14 @@ limitations under the License.
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 #include "tensorflow/core/runtime_fallback/kernel/kernel_fallback_compat_request_state.h"
+#include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/fallback/op_kernel_runner.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
@@ -450,6 +455,106 @@ TEST_P(GraphExecutorTest, Cancellation) {
   }
 }
 
+REGISTER_OP("TestBusyWait")
+    .Input("x: int32")
+    .Output("y: int32")
+    .Attr("micros: int")
+    .SetShapeFn(::tensorflow::shape_inference::UnchangedShape);
+
+// Spins for `micros` microseconds and forwards its input. Its cost does not
+// depend on the size of its input, so the compiler underestimates it unless
+// the cost is measured.
+class TestBusyWaitKernel : public OpKernel {
+ public:
+  explicit TestBusyWaitKernel(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("micros", &micros_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const uint64_t end_micros = Env::Default()->NowMicros() + micros_;
+    while (Env::Default()->NowMicros() < end_micros) {
+    }
+    ctx->set_output(0, ctx->input(0));
+  }
+
+ private:
+  int64_t micros_ = 0;
+};
+
+REGISTER_KERNEL_BUILDER(Name("TestBusyWait").Device(DEVICE_CPU),
+                        TestBusyWaitKernel);
+
+// Returns a graph of `width` independent TestBusyWait ops, named
+// "busy_wait_<i>", from "input" to an AddN named "output".
+absl::Status GetWideGraphDef(int width, int64_t micros, GraphDef& graph_def) {
+  tensorflow::GraphDefBuilder builder(
+      tensorflow::GraphDefBuilder::kFailImmediately);
+  tensorflow::Node* input = tensorflow::ops::SourceOp(
+      "Placeholder", builder.opts()
+                         .WithName("input")
+                         .WithAttr("dtype", tensorflow::DT_INT32)
+                         .WithAttr("shape", tensorflow::TensorShape({1})));
+  std::vector<tensorflow::NodeBuilder::NodeOut> branches;
+  for (int i = 0; i < width; ++i) {
+    // Distinct attributes keep Grappler from deduplicating the branches.
+    branches.push_back(tensorflow::ops::UnaryOp(
+        "TestBusyWait", input,
+        builder.opts()
+            .WithName(absl::StrCat("busy_wait_", i))
+            .WithAttr("micros", micros + i)));
+  }
+  tensorflow::NodeBuilder add_n("output", "AddN",
+                                builder.opts().op_registry());
+  add_n.Input(branches);
+  builder.opts().FinalizeBuilder(&add_n);
+  return builder.ToGraphDef(&graph_def);
+}
+
+TEST_P(GraphExecutorTest, MeasuredCosts) {
+  GraphDef graph_def;
+  TF_ASSERT_OK(GetWideGraphDef(/*width=*/2, /*micros=*/10, graph_def));
+
+  std::string measured_cost_path;
+  ASSERT_TRUE(Env::Default()->LocalTempFilename(&measured_cost_path));
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  GraphExecutor::Options options(runtime.get());
+  options.enable_mlrt = GetParam();
+  options.cost_analysis_options.version =
+      GraphExecutionOptions::CostAnalysisOptions::kOnce;
+  options.cost_analysis_options.measured_cost_path = measured_cost_path;
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto fallback_state,
+      tensorflow::tfrt_stub::FallbackState::Create(
+          CreateDefaultSessionOptions(options), graph_def.library()));
+  auto resource_context = std::make_unique<tfrt::ResourceContext>();
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto graph_executor,
+      GraphExecutor::Create(std::move(options), std::move(fallback_state),
+                            std::move(resource_context), graph_def,
+                            GetKernelRegistry()));
+
+  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  inputs.push_back({"input", CreateTfTensor<int32_t>(
+                                 /*shape=*/{1}, /*data=*/{1})});
+  std::vector<tensorflow::Tensor> outputs;
+  TF_ASSERT_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                   /*output_tensor_names=*/{"output"},
+                                   /*target_tensor_names=*/{}, &outputs));
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+              ::testing::ElementsAreArray({2}));
+
+  // The costs are written by node name, for the next load of the model.
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto measured_costs,
+      CostRecorder::ReadNodeCostsFromFile(measured_cost_path));
+  EXPECT_TRUE(measured_costs.contains("busy_wait_0"));
+  EXPECT_TRUE(measured_costs.contains("busy_wait_1"));
+}
+
 INSTANTIATE_TEST_SUITE_P(GraphExecutorTestSuite, GraphExecutorTest,
                          ::testing::Bool());
 
@@ -640,6 +745,67 @@ TEST_F(GraphExecutorTest, SyncExecute) {
   EXPECT_EQ(expected, results[0].Get<tfrt::DenseHostTensor>());
 }
 
+// Runs a wide graph whose ops the compiler considers cheap. With the costs
+// measured by a previous load, the ops are assigned to parallel streams instead
+// of being merged into one.
+void BM_WideGraph(::testing::benchmark::State& state) {
+  const bool use_measured_costs = state.range(0);
+  constexpr int kWidth = 8;
+
+  GraphDef graph_def;
+  TF_CHECK_OK(GetWideGraphDef(kWidth, /*micros=*/100, graph_def));
+
+  std::string measured_cost_path;
+  CHECK(Env::Default()->LocalTempFilename(&measured_cost_path));
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/kWidth);
+  auto create_graph_executor =
+      [&](GraphExecutionOptions::CostAnalysisOptions::CostAnalysisVersion
+              version) {
+        GraphExecutor::Options options(runtime.get());
+        options.enable_mlrt = true;
+        // Merges the streams of cheap ops like TfrtSession does.
+        options.compile_options.cost_threshold = 1024;
+        options.cost_analysis_options.version = version;
+        if (use_measured_costs) {
+          options.cost_analysis_options.measured_cost_path =
+              measured_cost_path;
+        }
+        auto fallback_state = tensorflow::tfrt_stub::FallbackState::Create(
+            CreateDefaultSessionOptions(options), graph_def.library());
+        TF_CHECK_OK(fallback_state.status());
+        auto graph_executor = GraphExecutor::Create(
+            std::move(options), *std::move(fallback_state),
+            std::make_unique<tfrt::ResourceContext>(), graph_def,
+            GetKernelRegistry());
+        TF_CHECK_OK(graph_executor.status());
+        return *std::move(graph_executor);
+      };
+
+  std::vector<std::pair<std::string, tensorflow::Tensor>> inputs;
+  inputs.push_back({"input", CreateTfTensor<int32_t>(
+                                 /*shape=*/{1}, /*data=*/{1})});
+  std::vector<tensorflow::Tensor> outputs;
+
+  if (use_measured_costs) {
+    // The first load of the model measures the costs.
+    auto graph_executor = create_graph_executor(
+        GraphExecutionOptions::CostAnalysisOptions::kOnce);
+    TF_CHECK_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                    /*output_tensor_names=*/{"output"},
+                                    /*target_tensor_names=*/{}, &outputs));
+  }
+
+  auto graph_executor = create_graph_executor(
+      GraphExecutionOptions::CostAnalysisOptions::kDisabled);
+  for (auto s : state) {
+    TF_CHECK_OK(graph_executor->Run(/*run_options=*/{}, inputs,
+                                    /*output_tensor_names=*/{"output"},
+                                    /*target_tensor_names=*/{}, &outputs));
+  }
+}
+BENCHMARK(BM_WideGraph)->ArgName("measured_costs")->Arg(0)->Arg(1);
+
 }  // namespace
 }  // namespace tfrt_stub
 }  // namespace tensorflow
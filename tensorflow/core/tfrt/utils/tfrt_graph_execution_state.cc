@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/utils/tfrt_graph_execution_state.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -47,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/util/dump_graph.h"
@@ -250,6 +252,23 @@ NodeDef CreateNewIdentityNode(const NodeDef& node,
   return identity;
 }
 
+// Sets the costs in `measured_costs` on the nodes of `graph` with the same
+// names. Nodes without a measured cost, e.g. the ones added since the costs
+// were measured, keep the static estimates of the compiler.
+void AnnotateMeasuredCosts(
+    const absl::flat_hash_map<std::string, uint64_t>& measured_costs,
+    Graph* graph) {
+  int num_annotated_nodes = 0;
+  for (Node* node : graph->op_nodes()) {
+    const auto iter = measured_costs.find(node->name());
+    if (iter == measured_costs.end()) continue;
+    node->AddAttr(kMeasuredCostAttrName, static_cast<int64_t>(iter->second));
+    ++num_annotated_nodes;
+  }
+  VLOG(1) << "TFRT set measured costs on " << num_annotated_nodes << " of "
+          << graph->num_op_nodes() << " nodes.";
+}
+
 }  // namespace
 
 absl::StatusOr<TfrtGraphExecutionState::OptimizationResult>
@@ -320,6 +339,10 @@ TfrtGraphExecutionState::CreateOptimizedGraph(
 
   result.grappler_duration = absl::Now() - grappler_start_time;
 
+  if (!options_.measured_costs.empty()) {
+    AnnotateMeasuredCosts(options_.measured_costs, result.graph.get());
+  }
+
   return result;
 }
 
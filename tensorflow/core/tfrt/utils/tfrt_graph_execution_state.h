@@ -16,12 +16,14 @@ limitations under the License.
 #define TENSORFLOW_CORE_TFRT_UTILS_TFRT_GRAPH_EXECUTION_STATE_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "tensorflow/compiler/mlir/tensorflow/translate/mlir_roundtrip_flags.h"
@@ -56,6 +58,11 @@ class TfrtGraphExecutionState {
   struct Options {
     bool run_placer_grappler_on_functions = false;
     bool run_placer_on_graph = true;
+    // The op costs measured by a previous load of the model, keyed by node
+    // name. They are set on the nodes of the optimized graphs, so that the
+    // stream assignment of the TFRT compiler uses them instead of its static
+    // estimates.
+    absl::flat_hash_map<std::string, uint64_t> measured_costs;
   };
 
   // Creates a `GraphExecutionState` given `graph_def` and `fallback_state`.
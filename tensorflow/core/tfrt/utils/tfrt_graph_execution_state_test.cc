@@ -46,6 +46,7 @@ limitations under the License.
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
+#include "tensorflow/core/tfrt/fallback/cost_recorder.h"
 #include "tensorflow/core/tfrt/fallback/fallback_state.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 
@@ -771,6 +772,51 @@ TEST_F(OptimizeGraphTest, MLIRBridgeCanBeDisabled) {
       1);
 }
 
+TEST_F(OptimizeGraphTest, SetMeasuredCosts) {
+  GraphDef graphdef;
+  {
+    auto scope = tensorflow::Scope::NewRootScope().WithDevice(
+        "/job:localhost/replica:0/task:0/device:CPU:0");
+
+    Output a = ops::Placeholder(scope.WithOpName("a"), DT_FLOAT);
+    Output b = ops::Sqrt(scope.WithOpName("b"), a);
+    Output c = ops::Identity(scope.WithOpName("c"), b);
+
+    TF_ASSERT_OK(scope.ToGraphDef(&graphdef));
+  }
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto fallback_state,
+      tensorflow::tfrt_stub::FallbackState::Create({}, graphdef.library()));
+
+  TfrtGraphExecutionState::Options options;
+  options.measured_costs = {{"b", 100}, {"removed_node", 10}};
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto graph_execution_state,
+      TfrtGraphExecutionState::Create(options, graphdef, *fallback_state));
+
+  tensorflow::GraphImportConfig graph_import_config;
+  graph_import_config.prune_unused_nodes = true;
+  graph_import_config.enable_shape_inference = false;
+  tensorflow::ArrayInfo array_info;
+  array_info.imported_dtype = DT_FLOAT;
+  array_info.shape.set_unknown_rank(true);
+  graph_import_config.inputs["a"] = array_info;
+  graph_import_config.outputs = {"c"};
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto optimized_graph,
+      graph_execution_state->CreateOptimizedGraph(graph_import_config));
+
+  absl::flat_hash_map<std::string, int64_t> measured_costs;
+  for (const Node* node : optimized_graph.graph->op_nodes()) {
+    if (const AttrValue* cost = node->attrs().Find(kMeasuredCostAttrName)) {
+      measured_costs[node->name()] = cost->i();
+    }
+  }
+  EXPECT_THAT(measured_costs, ElementsAre(Pair("b", 100)));
+}
+
 class ExtendGraphTest : public grappler::GrapplerTest {};
 
 TEST_F(ExtendGraphTest, ExtendGraph) {
@@ -0,0 +1,171 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+uint64_t TensorFingerprint(const Tensor& tensor) {
+  uint64_t fingerprint = Fingerprint64(tensor.tensor_data());
+  fingerprint = FingerprintCat64(fingerprint, tensor.dtype());
+  for (int64_t dim : tensor.shape().dim_sizes()) {
+    fingerprint = FingerprintCat64(fingerprint, dim);
+  }
+  return fingerprint;
+}
+
+bool SameContents(const Tensor& a, const Tensor& b) {
+  return a.dtype() == b.dtype() && a.shape() == b.shape() &&
+         a.tensor_data() == b.tensor_data();
+}
+
+}  // namespace
+
+class SharedTensorStore::SharedBuffer : public TensorBuffer {
+ public:
+  SharedBuffer(SharedTensorStore* store, uint64_t fingerprint,
+               const Tensor& tensor)
+      : TensorBuffer(DMAHelper::buffer(&tensor)->data()),
+        store_(store),
+        fingerprint_(fingerprint),
+        tensor_(tensor) {}
+
+  uint64_t fingerprint() const { return fingerprint_; }
+  const Tensor& tensor() const { return tensor_; }
+
+  // Acquires a reference, unless the last one was dropped already and the
+  // buffer is waiting to be removed from the store.
+  bool TryShare() const { return TryRef(); }
+
+  size_t size() const override { return root()->size(); }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(
+      AllocationDescription* proto) const override {
+    root()->FillAllocationDescription(proto);
+  }
+  bool GetAllocatedBytes(size_t* out_bytes) const override {
+    return root()->GetAllocatedBytes(out_bytes);
+  }
+  // Even the only user of the buffer must not update it in place, since
+  // Intern() may be comparing it, or about to share it, at the same time.
+  bool OwnsMemory() const override { return false; }
+  AllocatorMemoryType GetMemoryType() const override {
+    return root()->GetMemoryType();
+  }
+
+ private:
+  // Runs once the last reference is dropped, before the buffer is deleted.
+  void NotifyDeleted() const override { store_->Remove(this); }
+
+  const TensorBuffer* root() const { return DMAHelper::buffer(&tensor_); }
+
+  SharedTensorStore* const store_;
+  const uint64_t fingerprint_;
+  // The interned tensor, which holds the reference on the memory.
+  const Tensor tensor_;
+};
+
+SharedTensorStore::~SharedTensorStore() {
+  absl::MutexLock lock(mu_);
+  DCHECK(buffers_.empty()) << "SharedTensorStore destroyed while "
+                           << buffers_.size() << " buffers are in use";
+}
+
+SharedTensorStore* SharedTensorStore::Global() {
+  static SharedTensorStore* store = new SharedTensorStore();
+  return store;
+}
+
+bool SharedTensorStore::EnabledByEnvironment() {
+  static const bool enabled = [] {
+    bool share = false;
+    absl::Status status =
+        ReadBoolFromEnvVar("TF_SHARE_IDENTICAL_TENSORS", false, &share);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+    }
+    return share;
+  }();
+  return enabled;
+}
+
+Tensor SharedTensorStore::Intern(const Tensor& tensor) {
+  if (!tensor.IsInitialized() || !DataTypeCanUseMemcpy(tensor.dtype()) ||
+      tensor.TotalBytes() < min_bytes_) {
+    return tensor;
+  }
+  // Only whole buffers are stored, so that the store's reference is the only
+  // one left once the tensor is dropped.
+  const TensorBuffer* buffer = DMAHelper::buffer(&tensor);
+  if (buffer == nullptr || buffer->root_buffer() != buffer) {
+    return tensor;
+  }
+  // Fingerprinting dominates, so it is done outside the lock.
+  const uint64_t fingerprint = TensorFingerprint(tensor);
+
+  absl::MutexLock lock(mu_);
+  std::vector<SharedBuffer*>& candidates = buffers_[fingerprint];
+  for (SharedBuffer* candidate : candidates) {
+    // A buffer whose last reference was dropped cannot be deleted before it
+    // is removed under the lock, so it is safe to compare.
+    if (SameContents(candidate->tensor(), tensor) && candidate->TryShare()) {
+      ++stats_.num_hits;
+      stats_.num_shared_bytes += tensor.TotalBytes();
+      return Tensor(tensor.dtype(), tensor.shape(),
+                    core::RefCountPtr<TensorBuffer>(candidate));
+    }
+  }
+  auto* shared_buffer = new SharedBuffer(this, fingerprint, tensor);
+  candidates.push_back(shared_buffer);
+  ++stats_.num_tensors;
+  stats_.num_bytes += tensor.TotalBytes();
+  return Tensor(tensor.dtype(), tensor.shape(),
+                core::RefCountPtr<TensorBuffer>(shared_buffer));
+}
+
+void SharedTensorStore::Remove(const SharedBuffer* buffer) {
+  absl::MutexLock lock(mu_);
+  auto it = buffers_.find(buffer->fingerprint());
+  DCHECK(it != buffers_.end());
+  std::vector<SharedBuffer*>& buffers = it->second;
+  buffers.erase(std::find(buffers.begin(), buffers.end(), buffer));
+  if (buffers.empty()) buffers_.erase(it);
+  --stats_.num_tensors;
+  stats_.num_bytes -= buffer->tensor().TotalBytes();
+}
+
+SharedTensorStore::Stats SharedTensorStore::GetStats() const {
+  absl::MutexLock lock(mu_);
+  return stats_;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,102 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
+#define TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+
+// A content-addressed store of host tensors, which lets the models loaded in a
+// process share one buffer for each distinct weight. Typically several
+// versions or variants of a model are loaded at once, and most of their
+// variables and constants are identical.
+//
+// Tensors are keyed by their dtype, shape and a fingerprint of their bytes,
+// and are only shared once their bytes compare equal. The store does not hold
+// a reference on the buffers it shares: a buffer leaves the store as soon as
+// the last tensor referring to it is dropped, typically when the models using
+// it are unloaded. The returned tensors are copy-on-write: their buffers
+// report that they do not own their memory, so Tensor::RefCountIsOne() is
+// false even for a single user, and kernels and variables copy them rather
+// than update them in place.
+//
+// The store must outlive the tensors it returns. Thread-safe.
+class SharedTensorStore {
+ public:
+  // Tensors smaller than this are not worth the lookup.
+  static constexpr size_t kDefaultMinBytes = 4096;
+
+  explicit SharedTensorStore(size_t min_bytes = kDefaultMinBytes)
+      : min_bytes_(min_bytes) {}
+  ~SharedTensorStore();
+
+  SharedTensorStore(const SharedTensorStore&) = delete;
+  SharedTensorStore& operator=(const SharedTensorStore&) = delete;
+
+  // Returns the store of the process.
+  static SharedTensorStore* Global();
+
+  // Returns whether the TF_SHARE_IDENTICAL_TENSORS environment variable asks
+  // for restored variables and constants to be shared through Global().
+  static bool EnabledByEnvironment();
+
+  // Returns a tensor equal to `tensor` that shares its buffer with the tensors
+  // previously interned with the same contents, and adds `tensor` to the store
+  // if there are none. Returns `tensor` itself if it cannot be shared: when its
+  // dtype is not memcpy-able or when it is smaller than the minimum size.
+  Tensor Intern(const Tensor& tensor);
+
+  struct Stats {
+    // The tensors in the store and their bytes.
+    int64_t num_tensors = 0;
+    int64_t num_bytes = 0;
+    // The calls to Intern() that returned a stored tensor, and the bytes they
+    // did not have to keep.
+    int64_t num_hits = 0;
+    int64_t num_shared_bytes = 0;
+  };
+  Stats GetStats() const;
+
+ private:
+  // The buffer of a stored tensor, which removes itself from the store once
+  // its last reference is dropped.
+  class SharedBuffer;
+
+  // Removes `buffer` from the store.
+  void Remove(const SharedBuffer* buffer);
+
+  const size_t min_bytes_;
+
+  mutable absl::Mutex mu_;
+  // The stored buffers by fingerprint. Buffers with the same fingerprint but
+  // different contents are kept side by side. The store holds no reference
+  // on them.
+  absl::flat_hash_map<uint64_t, std::vector<SharedBuffer*>> buffers_
+      ABSL_GUARDED_BY(mu_);
+  Stats stats_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_SHARED_TENSOR_STORE_H_
@@ -0,0 +1,106 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/shared_tensor_store.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+Tensor MakeTensor(float value) {
+  Tensor tensor(DT_FLOAT, TensorShape({16, 16}));
+  tensor.flat<float>().setConstant(value);
+  return tensor;
+}
+
+TEST(SharedTensorStoreTest, SharesIdenticalTensors) {
+  SharedTensorStore store(/*min_bytes=*/0);
+  Tensor a = store.Intern(MakeTensor(1));
+  Tensor b = store.Intern(MakeTensor(1));
+  Tensor c = store.Intern(MakeTensor(2));
+  EXPECT_EQ(a.data(), b.data());
+  EXPECT_NE(a.data(), c.data());
+  test::ExpectTensorEqual<float>(b, MakeTensor(1));
+
+  // Same bytes, different shape.
+  Tensor reshaped(DT_FLOAT, TensorShape({256}));
+  reshaped.flat<float>().setConstant(1);
+  Tensor d = store.Intern(reshaped);
+  EXPECT_NE(d.data(), a.data());
+
+  SharedTensorStore::Stats stats = store.GetStats();
+  EXPECT_EQ(stats.num_tensors, 3);
+  EXPECT_EQ(stats.num_hits, 1);
+  EXPECT_EQ(stats.num_shared_bytes, a.TotalBytes());
+}
+
+TEST(SharedTensorStoreTest, SkipsSmallAndNonMemcpyTensors) {
+  SharedTensorStore store(/*min_bytes=*/2048);
+  Tensor small = test::AsTensor<float>({1, 2, 3});
+  Tensor small_copy = test::AsTensor<float>({1, 2, 3});
+  EXPECT_NE(store.Intern(small).data(), store.Intern(small_copy).data());
+
+  Tensor strings(DT_STRING, TensorShape({1024}));
+  EXPECT_EQ(store.Intern(strings).data(), strings.data());
+  EXPECT_EQ(store.GetStats().num_tensors, 0);
+}
+
+TEST(SharedTensorStoreTest, DropsTensorsOnceUnreferenced) {
+  SharedTensorStore store(/*min_bytes=*/0);
+  Tensor kept = store.Intern(MakeTensor(1));
+  store.Intern(MakeTensor(2));
+  EXPECT_EQ(store.GetStats().num_tensors, 1);
+  EXPECT_EQ(store.Intern(MakeTensor(1)).data(), kept.data());
+
+  // Slices keep the buffer alive.
+  Tensor slice = kept.Slice(0, 1);
+  kept = Tensor();
+  EXPECT_EQ(store.GetStats().num_tensors, 1);
+  slice = Tensor();
+  EXPECT_EQ(store.GetStats().num_tensors, 0);
+  EXPECT_EQ(store.GetStats().num_bytes, 0);
+
+  // A dropped tensor is stored again when it comes back.
+  Tensor restored = store.Intern(MakeTensor(1));
+  EXPECT_EQ(store.GetStats().num_tensors, 1);
+  test::ExpectTensorEqual<float>(restored, MakeTensor(1));
+}
+
+TEST(SharedTensorStoreTest, CopiesOnWrite) {
+  SharedTensorStore store(/*min_bytes=*/0);
+  Tensor a = store.Intern(MakeTensor(1));
+  // Kernels only update a tensor in place when it is the only user of its
+  // buffer, which a stored tensor never is.
+  EXPECT_FALSE(a.RefCountIsOne());
+  Tensor updated = a.RefCountIsOne() ? a : tensor::DeepCopy(a);
+  updated.flat<float>().setConstant(2);
+  EXPECT_NE(updated.data(), a.data());
+  test::ExpectTensorEqual<float>(a, MakeTensor(1));
+
+  // The stored contents are still those of the first tensor.
+  Tensor b = store.Intern(MakeTensor(1));
+  EXPECT_EQ(b.data(), a.data());
+  test::ExpectTensorEqual<float>(b, MakeTensor(1));
+  EXPECT_NE(store.Intern(MakeTensor(2)).data(), a.data());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,8 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <utility>
 
@@ -24,9 +26,11 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "xla/tsl/util/byte_swap_array.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/framework/variant.h"
@@ -434,6 +438,31 @@ absl::Status PadAlignment(tsl::BufferedWritableFile* out, int alignment,
   return status;
 }
 
+// A tensor buffer referring to a part of a memory mapped file. It does not own
+// its memory, so that the tensors it backs are never forwarded or updated in
+// place.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<const ReadOnlyMemoryRegion> region,
+                     const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("mmap");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  const std::shared_ptr<const ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
 }  // namespace
 
 BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
@@ -598,6 +627,120 @@ absl::Status BundleWriter::Finish() {
   return absl::OkStatus();
 }
 
+// Async writing of tensor bundles.
+
+struct AsyncBundleWriter::Handle::State {
+  absl::Mutex mu;
+  bool done TF_GUARDED_BY(mu) = false;
+  absl::Status status TF_GUARDED_BY(mu);
+};
+
+absl::Status AsyncBundleWriter::Handle::Wait() const {
+  absl::MutexLock l(state_->mu);
+  state_->mu.Await(absl::Condition(&state_->done));
+  return state_->status;
+}
+
+bool AsyncBundleWriter::Handle::IsDone() const {
+  absl::MutexLock l(state_->mu);
+  return state_->done;
+}
+
+static absl::Status WriteBundle(
+    Env* env, const std::string& prefix, const BundleWriter::Options& options,
+    const std::vector<AsyncBundleWriter::Entry>& entries) {
+  BundleWriter writer(env, prefix, options);
+  TF_RETURN_IF_ERROR(writer.status());
+  for (const AsyncBundleWriter::Entry& entry : entries) {
+    if (entry.is_slice) {
+      TF_RETURN_IF_ERROR(writer.AddSlice(entry.key, entry.full_shape,
+                                         entry.slice, entry.tensor));
+    } else {
+      TF_RETURN_IF_ERROR(writer.Add(entry.key, entry.tensor));
+    }
+  }
+  return writer.Finish();
+}
+
+AsyncBundleWriter::AsyncBundleWriter(Env* env, const Options& options)
+    : env_(env),
+      options_(options),
+      pool_(std::make_unique<thread::ThreadPool>(
+          env, "async_bundle_writer", std::max(options.num_threads, 1))) {}
+
+AsyncBundleWriter::~AsyncBundleWriter() { WaitForAll().IgnoreError(); }
+
+AsyncBundleWriter::Handle AsyncBundleWriter::Write(
+    absl::string_view prefix, std::vector<Entry> entries,
+    std::function<void(const absl::Status&)> done) {
+  std::string prefix_string(prefix);
+  int64_t bytes = 0;
+  for (const Entry& entry : entries) bytes += entry.tensor.TotalBytes();
+  auto state = std::make_shared<Handle::State>();
+  {
+    absl::MutexLock l(mu_);
+    while (pending_.contains(prefix_string) ||
+           (pending_bytes_ > 0 &&
+            pending_bytes_ + bytes > options_.max_pending_bytes)) {
+      cv_.Wait(&mu_);
+    }
+    pending_bytes_ += bytes;
+    pending_[prefix_string] = state;
+    failed_.erase(prefix_string);
+  }
+  if (options_.copy_tensors) {
+    for (Entry& entry : entries) entry.tensor = tensor::DeepCopy(entry.tensor);
+  }
+  VLOG(1) << "Scheduled async write of " << bytes << " bytes to "
+          << prefix_string;
+
+  pool_->Schedule([this, prefix = std::move(prefix_string),
+                   entries = std::move(entries), bytes, state,
+                   done = std::move(done)]() mutable {
+    absl::Status status =
+        WriteBundle(env_, prefix, options_.writer_options, entries);
+    // Releases the snapshot before admitting more writes.
+    entries.clear();
+    if (status.ok()) {
+      VLOG(1) << "Finished async write to " << prefix;
+    } else {
+      LOG(ERROR) << "Async write to " << prefix << " failed: " << status;
+    }
+    {
+      absl::MutexLock l(mu_);
+      pending_bytes_ -= bytes;
+      pending_.erase(prefix);
+      if (!status.ok()) failed_[prefix] = status;
+      cv_.SignalAll();
+    }
+    if (done) done(status);
+    absl::MutexLock l(state->mu);
+    state->status = std::move(status);
+    state->done = true;
+  });
+  return Handle(std::move(state));
+}
+
+absl::Status AsyncBundleWriter::WaitFor(absl::string_view prefix) {
+  const std::string prefix_string(prefix);
+  absl::MutexLock l(mu_);
+  while (pending_.contains(prefix_string)) cv_.Wait(&mu_);
+  auto it = failed_.find(prefix_string);
+  if (it == failed_.end()) return absl::OkStatus();
+  absl::Status status = std::move(it->second);
+  failed_.erase(it);
+  return status;
+}
+
+absl::Status AsyncBundleWriter::WaitForAll() {
+  absl::MutexLock l(mu_);
+  while (!pending_.empty()) cv_.Wait(&mu_);
+  absl::Status status;
+  for (const auto& [prefix, error] : failed_) status.Update(error);
+  failed_.clear();
+  return status;
+}
+
 // Merging tensor bundles.
 
 // Accumulator of metadata states during a merge.
@@ -797,6 +940,7 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
       index_cache_(nullptr),
       iter_(nullptr),
       need_to_swap_bytes_(false),
+      use_mmap_(options.use_mmap),
       enable_multi_threading_for_testing_(
           options.enable_multi_threading_for_testing) {
   if (cache_ == nullptr) {
@@ -1036,6 +1180,72 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
   return absl::OkStatus();
 }
 
+absl::Status BundleReader::GetMappedValue(const BundleEntryProto& entry,
+                                          Tensor* val, bool* mapped) {
+  *mapped = false;
+  if (!DataTypeCanUseMemcpy(entry.dtype()) || need_to_swap_bytes_ ||
+      entry.size() == 0) {
+    return absl::OkStatus();
+  }
+  const std::string filename =
+      DataFilename(prefix_, entry.shard_id(), num_shards_);
+  absl::string_view scheme, host, path;
+  io::ParseURI(filename, &scheme, &host, &path);
+  if (!scheme.empty() && scheme != "file") return absl::OkStatus();
+
+  std::shared_ptr<const ReadOnlyMemoryRegion> region;
+  if (absl::Status s = cache_->GetMemoryRegion(filename, &region); !s.ok()) {
+    // Not all file systems support memory mapping; fall back to reads.
+    VLOG(1) << "Unable to map " << filename << ": " << s;
+    return absl::OkStatus();
+  }
+  if (entry.offset() < 0 || entry.size() > region->length() ||
+      static_cast<uint64_t>(entry.offset()) >
+          region->length() - entry.size()) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(),
+        ": entry at offset ", entry.offset(), " of ", entry.size(),
+        " bytes exceeds the data file size of ", region->length(), " bytes"));
+  }
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES != 0) {
+    return absl::OkStatus();
+  }
+
+  auto* buffer = new MappedTensorBuffer(std::move(region), data, entry.size());
+  Tensor tensor(entry.dtype(), TensorShape(entry.shape()), buffer);
+  buffer->Unref();
+  if (entry.size() != tensor.TotalBytes()) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid size in bundle entry: key ", key(), "; stored size ",
+        entry.size(), "; expected size ", tensor.TotalBytes()));
+  }
+  const uint32_t actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return absl::DataLossError(absl::StrCat(
+        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
+        entry.size(), " bytes): Checksum does not match: stored ",
+        absl::StrFormat("%08u", crc32c::Unmask(entry.crc32c())),
+        " vs. calculated on the restored bytes ", actual_crc32c));
+  }
+  *val = std::move(tensor);
+  *mapped = true;
+  return absl::OkStatus();
+}
+
+absl::Status BundleReader::LookupMapped(absl::string_view key, Tensor* val) {
+  CHECK(val != nullptr);
+  BundleEntryProto entry;
+  TF_RETURN_IF_ERROR(GetBundleEntryProto(key, &entry));
+  if (use_mmap_ && entry.slices().empty()) {
+    bool mapped;
+    TF_RETURN_IF_ERROR(GetMappedValue(entry, val, &mapped));
+    if (mapped) return absl::OkStatus();
+  }
+  *val = Tensor(entry.dtype(), TensorShape(entry.shape()));
+  return Lookup(key, val);
+}
+
 absl::Status BundleReader::Lookup(absl::string_view key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1265,17 +1475,18 @@ std::string BundleReader::DebugString() {
 
 BundleCache::BundleCache(Env* env) : env_(env) {}
 
+BundleCache::FileState* BundleCache::GetFileState(const std::string& name) {
+  absl::MutexLock l(mu_);
+  auto& slot = opened_files_[name];
+  if (slot == nullptr) {
+    slot = std::make_unique<FileState>();
+  }
+  return slot.get();
+}
+
 BundleCache::FileState* BundleCache::EnsureOpened(std::string name) {
   // Get the file, opening it if necessary.
-  FileState* f;
-  {
-    absl::MutexLock l(mu_);
-    auto& slot = opened_files_[name];
-    if (slot == nullptr) {
-      slot = std::make_unique<FileState>();
-    }
-    f = slot.get();
-  }
+  FileState* f = GetFileState(name);
 
   // Open the file or wait for a concurrent open to complete. We do not hold
   // mu_ here to avoid blocking threads reading from other files.
@@ -1293,6 +1504,20 @@ absl::Status BundleCache::GetFile(const std::string& fname,
   return f->open_status;
 }
 
+absl::Status BundleCache::GetMemoryRegion(
+    const std::string& fname,
+    std::shared_ptr<const ReadOnlyMemoryRegion>* region) {
+  FileState* f = GetFileState(fname);
+  // As in EnsureOpened(), mu_ is not held while mapping the file.
+  absl::call_once(f->map_once, [this, &fname, f] {
+    std::unique_ptr<ReadOnlyMemoryRegion> mapped;
+    f->map_status = env_->NewReadOnlyMemoryRegionFromFile(fname, &mapped);
+    f->region = std::move(mapped);
+  });
+  *region = f->region;
+  return f->map_status;
+}
+
 namespace {
 inline char* AlignedMalloc(size_t size) {
   char* buffer = static_cast<char*>(
@@ -62,10 +62,12 @@ limitations under the License.
 #define TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_TENSOR_BUNDLE_H_
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -81,6 +83,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/io/cache.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
@@ -173,6 +176,100 @@ class BundleWriter {
   void operator=(const BundleWriter&) = delete;
 };
 
+// Writes bundles on background threads, so that the caller does not wait for
+// tensors to reach the file system.
+//
+// Write() snapshots the tensors of a bundle by retaining references to their
+// buffers instead of copying them. The snapshot is copy-on-write for resource
+// variables, whose updates copy a buffer that is still referenced elsewhere
+// before modifying it. Buffers that may be updated in place, such as those of
+// reference variables, must be copied by setting `Options::copy_tensors`.
+//
+// The bytes held by snapshots of pending writes are bounded by
+// `Options::max_pending_bytes`: Write() blocks until enough of the earlier
+// writes have completed. As BundleWriter renames its files into place when it
+// finishes, a bundle becomes visible only once it is complete.
+//
+// Thread-safe.
+class AsyncBundleWriter {
+ public:
+  struct Options {
+    Options() {}
+    BundleWriter::Options writer_options;
+    // Number of bundles written concurrently.
+    int num_threads{4};
+    // Bound on the bytes of tensors held by pending writes. A larger write is
+    // admitted once no other write is pending.
+    int64_t max_pending_bytes{int64_t{8} << 30};
+    // Whether to snapshot tensors by copying them.
+    bool copy_tensors{false};
+  };
+
+  // A tensor to write under `key`. If `is_slice` is set, `tensor` is the
+  // `slice` of a tensor of shape `full_shape`; see BundleWriter::AddSlice().
+  struct Entry {
+    std::string key;
+    Tensor tensor;
+    bool is_slice = false;
+    TensorShape full_shape;
+    TensorSlice slice;
+  };
+
+  // The completion handle of a write.
+  class Handle {
+   public:
+    // Blocks until the write has completed and returns its status.
+    absl::Status Wait() const;
+    bool IsDone() const;
+
+   private:
+    friend class AsyncBundleWriter;
+    struct State;
+    explicit Handle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+  };
+
+  explicit AsyncBundleWriter(Env* env, const Options& options = Options());
+
+  // Waits for all pending writes.
+  ~AsyncBundleWriter();
+
+  // Schedules writing `entries` to a bundle at `prefix`, after any pending
+  // write to the same prefix. Errors of the write are logged, and reported by
+  // the returned handle and by WaitFor(). If set, `done` is called with the
+  // status of the write once the bundle is complete on disk, before the handle
+  // is done.
+  Handle Write(absl::string_view prefix, std::vector<Entry> entries,
+               std::function<void(const absl::Status&)> done = nullptr);
+
+  // Waits for the pending write to `prefix`, if any. Returns the error of the
+  // last write to `prefix` if it failed and no later WaitFor() or
+  // WaitForAll() has reported it yet.
+  absl::Status WaitFor(absl::string_view prefix);
+
+  // Waits for all pending writes, and returns the first unreported error.
+  absl::Status WaitForAll();
+
+ private:
+  Env* const env_;  // Not owned.
+  const Options options_;
+
+  absl::Mutex mu_;
+  absl::CondVar cv_;  // Signaled when a write completes.
+  int64_t pending_bytes_ TF_GUARDED_BY(mu_) = 0;
+  absl::flat_hash_map<std::string, std::shared_ptr<Handle::State>> pending_
+      TF_GUARDED_BY(mu_);
+  std::map<std::string, absl::Status> failed_ TF_GUARDED_BY(mu_);
+
+  // Declared last, so that its threads are joined before the members they
+  // use are destroyed.
+  std::unique_ptr<thread::ThreadPool> pool_;
+
+  AsyncBundleWriter(const AsyncBundleWriter&) = delete;
+  void operator=(const AsyncBundleWriter&) = delete;
+};
+
 // Merges a set of bundles (given their prefixes) into a single bundle with the
 // given "merged_prefix".  The merged metadata is guaranteed to be consistent.
 //
@@ -217,6 +314,10 @@ class BundleReader {
 
     // For tests only.
     bool enable_multi_threading_for_testing = false;
+
+    // Whether LookupMapped() may return tensors backed by memory mappings of
+    // the data files.
+    bool use_mmap = false;
   };
   BundleReader(Env* env, absl::string_view prefix, Options options);
 
@@ -276,6 +377,18 @@ class BundleReader {
   // REQUIRES: status().ok() && Valid()
   absl::Status ReadCurrent(Tensor* val);
 
+  // Like Lookup(), but allocates "val" itself.  If Options::use_mmap is set,
+  // "val" refers to a read-only memory mapping of the data file when the
+  // file is local and the stored tensor is not partitioned, has a dtype that
+  // can be memcpy'd, has the endianness of this machine and starts at an
+  // offset aligned to EIGEN_MAX_ALIGN_BYTES (see
+  // BundleWriter::Options::data_alignment).  The mapping lives as long as
+  // "val" and its copies, which can not be updated in place.
+  //
+  // Validates the stored crc32c checksum against the restored bytes.
+  // REQUIRES: status().ok()
+  absl::Status LookupMapped(absl::string_view key, Tensor* val);
+
   // Looks up the slices of the tensor keyed by "key".  On OK, "slices"
   // is non-empty if and only if the tensor is a partitioned tensor.
   //
@@ -323,6 +436,11 @@ class BundleReader {
   // Usage for "val" follows the comment of "Lookup()".
   absl::Status GetValue(const BundleEntryProto& entry, Tensor* val);
 
+  // Sets "val" to a tensor backed by a memory mapping of the value described
+  // by "entry", if it can be mapped.  Sets "mapped" accordingly.
+  absl::Status GetMappedValue(const BundleEntryProto& entry, Tensor* val,
+                              bool* mapped);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -356,6 +474,8 @@ class BundleReader {
   // differs from that of the current system's processor architecture.
   bool need_to_swap_bytes_;
 
+  const bool use_mmap_;
+
   friend class TensorBundleAlignmentTest;  // For testing data alignment.
 
   bool enable_multi_threading_for_testing_ = false;
@@ -401,6 +521,13 @@ class BundleCache {
   // while the BundleCache lives.
   absl::Status GetFile(const std::string& fname, RandomAccessFile** file);
 
+  // Get a read-only memory mapping of fname. The mapping is shared by all
+  // callers, and remains valid while the BundleCache or any reference to it
+  // lives.
+  absl::Status GetMemoryRegion(
+      const std::string& fname,
+      std::shared_ptr<const ReadOnlyMemoryRegion>* region);
+
  private:
   // State for each opened file (opened on first read).
   struct FileState {
@@ -408,8 +535,14 @@ class BundleCache {
 
     std::unique_ptr<RandomAccessFile> file;
     absl::Status open_status;  // Records any error encountered on open
+
+    absl::once_flag map_once;  // Ensures file is mapped at most once.
+
+    std::shared_ptr<const ReadOnlyMemoryRegion> region;
+    absl::Status map_status;  // Records any error encountered on mapping
   };
 
+  FileState* GetFileState(const std::string& name);
   FileState* EnsureOpened(std::string name);
 
   Env* const env_;
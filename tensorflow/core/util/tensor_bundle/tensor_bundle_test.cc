@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined(_WIN32)
@@ -1327,6 +1328,186 @@ TEST(BundleCacheTest, ConcurrentGetFile) {
   }
 }
 
+TEST(TensorBundleTest, LookupMapped) {
+  {
+    BundleWriter::Options options;
+    options.data_alignment = 4096;
+    BundleWriter writer(Env::Default(), Prefix("mapped"), options);
+    TF_EXPECT_OK(writer.Add("aligned", Constant_100x100(1.f)));
+    TF_EXPECT_OK(writer.Add("string", Constant_2x3<tstring>("foo")));
+    TF_EXPECT_OK(writer.Finish());
+  }
+  {
+    BundleWriter writer(Env::Default(), Prefix("unaligned"));
+    TF_EXPECT_OK(writer.Add("first", Constant_2x3(1.f)));
+    TF_EXPECT_OK(writer.Add("second", Constant_2x3(2.f)));
+    TF_EXPECT_OK(writer.Finish());
+  }
+  BundleReader::Options options;
+  options.use_mmap = true;
+
+  BundleReader reader(Env::Default(), Prefix("mapped"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.LookupMapped("aligned", &val));
+  test::ExpectTensorEqual<float>(val, Constant_100x100(1.f));
+  // The tensor does not own its memory, and can thus not be updated in place.
+  EXPECT_FALSE(val.RefCountIsOne());
+  TF_ASSERT_OK(reader.LookupMapped("string", &val));
+  test::ExpectTensorEqual<tstring>(val, Constant_2x3<tstring>("foo"));
+  EXPECT_TRUE(absl::IsNotFound(reader.LookupMapped("bar", &val)));
+
+  BundleReader unaligned_reader(Env::Default(), Prefix("unaligned"), options);
+  TF_ASSERT_OK(unaligned_reader.status());
+  // The second tensor is stored at offset 24, and thus read.
+  TF_ASSERT_OK(unaligned_reader.LookupMapped("second", &val));
+  test::ExpectTensorEqual<float>(val, Constant_2x3(2.f));
+  EXPECT_TRUE(val.RefCountIsOne());
+}
+
+TEST(TensorBundleTest, LookupMappedChecksum) {
+  {
+    BundleWriter writer(Env::Default(), Prefix("mapped_corrupt"));
+    TF_EXPECT_OK(writer.Add("foo", Constant_2x3(1.f)));
+    TF_EXPECT_OK(writer.Finish());
+  }
+  const std::string datafile = DataFilename(Prefix("mapped_corrupt"), 0, 1);
+  std::string data;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), datafile, &data));
+  data[0] = ~data[0];
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), datafile, data));
+
+  BundleReader::Options options;
+  options.use_mmap = true;
+  BundleReader reader(Env::Default(), Prefix("mapped_corrupt"), options);
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  const absl::Status s = reader.LookupMapped("foo", &val);
+  EXPECT_TRUE(absl::IsDataLoss(s)) << s;
+}
+
+std::vector<AsyncBundleWriter::Entry> AsyncEntries(
+    const std::vector<std::pair<std::string, Tensor>>& tensors) {
+  std::vector<AsyncBundleWriter::Entry> entries;
+  for (const auto& [key, tensor] : tensors) {
+    AsyncBundleWriter::Entry entry;
+    entry.key = key;
+    entry.tensor = tensor;
+    entries.push_back(std::move(entry));
+  }
+  return entries;
+}
+
+TEST(AsyncBundleWriterTest, Basic) {
+  AsyncBundleWriter writer(Env::Default());
+  AsyncBundleWriter::Handle handle = writer.Write(
+      Prefix("async_basic"),
+      AsyncEntries({{"foo", Constant_2x3(1.f)}, {"bar", Constant_2x3(2)}}));
+  TF_ASSERT_OK(handle.Wait());
+  EXPECT_TRUE(handle.IsDone());
+
+  BundleReader reader(Env::Default(), Prefix("async_basic"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "foo", Constant_2x3(1.f));
+  Expect<int>(&reader, "bar", Constant_2x3(2));
+}
+
+TEST(AsyncBundleWriterTest, DoneRunsOnceBundleIsComplete) {
+  AsyncBundleWriter writer(Env::Default());
+  bool bundle_found = false;
+  AsyncBundleWriter::Handle handle = writer.Write(
+      Prefix("async_done"), AsyncEntries({{"foo", Constant_2x3(1.f)}}),
+      [&bundle_found](const absl::Status& status) {
+        TF_EXPECT_OK(status);
+        bundle_found =
+            Env::Default()->FileExists(MetaFilename(Prefix("async_done"))).ok();
+      });
+  TF_ASSERT_OK(handle.Wait());
+  EXPECT_TRUE(bundle_found);
+}
+
+TEST(AsyncBundleWriterTest, Slices) {
+  AsyncBundleWriter writer(Env::Default());
+  std::vector<AsyncBundleWriter::Entry> entries(2);
+  for (int i = 0; i < 2; ++i) {
+    entries[i].key = "foo";
+    entries[i].tensor = Constant<float>(i, TensorShape({1, 3}));
+    entries[i].is_slice = true;
+    entries[i].full_shape = TensorShape({2, 3});
+    entries[i].slice = TensorSlice::ParseOrDie(absl::StrCat(i, ",1:-"));
+  }
+  writer.Write(Prefix("async_slices"), std::move(entries));
+  TF_ASSERT_OK(writer.WaitFor(Prefix("async_slices")));
+
+  BundleReader reader(Env::Default(), Prefix("async_slices"));
+  TF_ASSERT_OK(reader.status());
+  Tensor val(DT_FLOAT, TensorShape({2, 3}));
+  TF_ASSERT_OK(reader.Lookup("foo", &val));
+  test::ExpectTensorEqual<float>(
+      val, test::AsTensor<float>({0, 0, 0, 1, 1, 1}, TensorShape({2, 3})));
+}
+
+TEST(AsyncBundleWriterTest, CopiedTensorsAreSnapshots) {
+  AsyncBundleWriter::Options options;
+  options.copy_tensors = true;
+  AsyncBundleWriter writer(Env::Default(), options);
+  Tensor t = Constant_100x100(1.f);
+  writer.Write(Prefix("async_copy"), AsyncEntries({{"foo", t}}));
+  // Updates the tensor in place, as an update of a reference variable would.
+  t.flat<float>().setConstant(2.f);
+  TF_ASSERT_OK(writer.WaitForAll());
+
+  BundleReader reader(Env::Default(), Prefix("async_copy"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "foo", Constant_100x100(1.f));
+}
+
+TEST(AsyncBundleWriterTest, ReportsErrors) {
+  AsyncBundleWriter writer(Env::Default());
+  AsyncBundleWriter::Handle handle = writer.Write(
+      Prefix("async_dup"),
+      AsyncEntries({{"foo", Constant_2x3(1.f)}, {"foo", Constant_2x3(2.f)}}));
+  absl::Status s = handle.Wait();
+  EXPECT_TRUE(absl::StrContains(s.ToString(), "duplicate key")) << s;
+  s = writer.WaitFor(Prefix("async_dup"));
+  EXPECT_TRUE(absl::StrContains(s.ToString(), "duplicate key")) << s;
+  // The error is reported once.
+  TF_EXPECT_OK(writer.WaitFor(Prefix("async_dup")));
+  TF_EXPECT_OK(writer.WaitForAll());
+}
+
+TEST(AsyncBundleWriterTest, BoundsPendingBytes) {
+  AsyncBundleWriter::Options options;
+  options.max_pending_bytes = 100 * 100 * sizeof(float);
+  AsyncBundleWriter writer(Env::Default(), options);
+  constexpr int kNumWrites = 8;
+  for (int i = 0; i < kNumWrites; ++i) {
+    writer.Write(Prefix(absl::StrCat("async_bounded_", i)),
+                 AsyncEntries({{"foo", Constant_100x100<float>(i)}}));
+  }
+  TF_ASSERT_OK(writer.WaitForAll());
+
+  for (int i = 0; i < kNumWrites; ++i) {
+    BundleReader reader(Env::Default(),
+                        Prefix(absl::StrCat("async_bounded_", i)));
+    TF_ASSERT_OK(reader.status());
+    Expect<float>(&reader, "foo", Constant_100x100<float>(i));
+  }
+}
+
+TEST(AsyncBundleWriterTest, WritesToSamePrefixAreOrdered) {
+  AsyncBundleWriter writer(Env::Default());
+  for (int i = 0; i < 4; ++i) {
+    writer.Write(Prefix("async_same"),
+                 AsyncEntries({{"foo", Constant_2x3<float>(i)}}));
+  }
+  TF_ASSERT_OK(writer.WaitFor(Prefix("async_same")));
+
+  BundleReader reader(Env::Default(), Prefix("async_same"));
+  TF_ASSERT_OK(reader.status());
+  Expect<float>(&reader, "foo", Constant_2x3<float>(3));
+}
+
 class TensorBundleAlignmentTest : public ::testing::Test {
  protected:
   template <typename T>
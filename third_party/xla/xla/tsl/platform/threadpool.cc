@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "xla/tsl/platform/threadpool.h"
 
+#include <algorithm>
 #include <cfenv>  // NOLINT
 #include <cstdint>
 #include <functional>
@@ -244,6 +245,41 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(
   counter.Wait();
 }
 
+void ThreadPool::ParallelForWithAffinity(
+    const int64_t total, const int64_t block_size,
+    const std::function<int64_t(int64_t)>& affinity,
+    const std::function<void(int64_t, int64_t)>& fn) {
+  const int num_shards_used =
+      NumShardsUsedByFixedBlockSizeScheduling(total, block_size);
+  if (num_shards_used == 1) {
+    fn(0, total);
+    return;
+  }
+  if (CurrentThreadId() != -1) {
+    // Work scheduled from a pool thread always lands on that thread's own
+    // queue, so the hint cannot be honored. Avoid blocking a worker on shards
+    // it cannot run by using the inline-capable fixed block size scheduler.
+    ParallelForFixedBlockSizeScheduling(total, block_size, fn);
+    return;
+  }
+
+  const int num_threads = NumThreads();
+  BlockingCounter counter(num_shards_used);
+  for (int shard = 0; shard < num_shards_used; ++shard) {
+    const int64_t first = shard * block_size;
+    const int64_t last = std::min(first + block_size, total);
+    int thread_hint = static_cast<int>(affinity(shard) % num_threads);
+    if (thread_hint < 0) thread_hint += num_threads;
+    ScheduleWithHint(
+        [&fn, &counter, first, last]() {
+          fn(first, last);
+          counter.DecrementCount();
+        },
+        thread_hint, thread_hint + 1);
+  }
+  counter.Wait();
+}
+
 void ThreadPool::ParallelFor(int64_t total, int64_t cost_per_unit,
                              const std::function<void(int64_t, int64_t)>& fn) {
   CHECK_GE(total, 0);
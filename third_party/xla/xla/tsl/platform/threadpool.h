@@ -198,6 +198,23 @@ class ThreadPool {
       int64_t block_size, int64_t total,
       const std::function<void(int64_t, int64_t)>& fn);
 
+  // Runs `fn` on `total` units of work split into shards of `block_size`
+  // units, like ParallelFor with SchedulingParams::Fixed(block_size), except
+  // that shard i is queued on the pool thread selected by `affinity(i)`.
+  //
+  // Callers should return a key that is stable across consecutive calls, such
+  // as the index of the output block the shard writes. Shards touching the
+  // same block then tend to run on the same thread, and so on the same core,
+  // finding their data still warm in its caches. Idle threads keep stealing
+  // queued shards from busy ones, so imbalanced work is still spread out.
+  //
+  // The hint is only honored when called from outside this pool. Calls from a
+  // pool thread fall back to fixed block size scheduling.
+  void ParallelForWithAffinity(
+      int64_t total, int64_t block_size,
+      const std::function<int64_t(int64_t shard)>& affinity,
+      const std::function<void(int64_t begin, int64_t end)>& fn);
+
   // Runs `fn` on `total` units of work in parallel. The number of parallel
   // tasks processing the work is determined by the scheduling parameters.
   //